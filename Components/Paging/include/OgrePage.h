@@ -59,9 +59,16 @@ namespace Ogre
         bool mModified;
 
         SceneNode* mDebugNode;
-        bool mInUnload;
+        /// Read by the background request to skip the work of cancelled loads
+        std::atomic<bool> mInUnload;
+        /// Set while the background request prepares the page
+        std::atomic<bool> mPreparing;
+        /// The section is gone, so the page deletes itself once its load returns
+        bool mDetached;
+        Real mLoadPriority;
 
         void updateDebugDisplay();
+        void destroyDebugNode();
 
         struct PageData : public PageAlloc
         {
@@ -119,6 +126,15 @@ namespace Ogre
         /// 'Touch' the page to let it know it's being used
         virtual void touch();
 
+        /// Get the priority of this page's load, lower values are loaded and finalised first
+        Real getLoadPriority() const { return mLoadPriority; }
+        /** Set the priority of this page's load.
+
+            The PageStrategy updates this every frame the page is requested, see
+            PagedWorldSection::requestPage.
+        */
+        void setLoadPriority(Real priority) { mLoadPriority = priority; }
+
         /** Load this page. 
         @param synchronous Whether to force this to happen synchronously.
         */
@@ -171,6 +187,22 @@ namespace Ogre
         /// Get the list of content collections
         const ContentCollectionList& getContentCollectionList() const;
 
+        /** Finish a background load on the main thread.
+
+            You should not call this method directly. The PagedWorldSection
+            queues background loads and finalises them within the budget set
+            with PageManager::setPageFinaliseTimeLimit.
+        */
+        void _finaliseLoad(const WorkQueue::Response* res);
+
+        /** Detach a page whose background load is still in progress from its section.
+
+            You should not call this method directly. It cancels the load and waits until
+            the background request no longer uses the section, the page then deletes itself
+            once the load returns to the main thread.
+        */
+        void _detachFromSection();
+
         /// Tell the page that it is modified
         void _notifyModified() { mModified = true; }
         bool isModified() const { return mModified; }
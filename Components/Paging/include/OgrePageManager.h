@@ -408,6 +408,50 @@ namespace Ogre
         /** Returns a list of cameras being tracked. */
         const CameraList& getCameraList() const;
 
+        /** Get the velocity of a tracked camera, measured over the last frame. */
+        const Vector3& getCameraVelocity(Camera* c) const;
+
+        /** Get where a tracked camera will be after the prefetch time at its current velocity. */
+        Vector3 getPredictedCameraPosition(Camera* c) const;
+
+        /** Set how many seconds ahead of a moving camera pages are loaded.
+
+            The standard strategies request the pages in range of the predicted
+            camera position as well as those in range of the current one, and
+            prioritise them by their distance to the predicted position. This
+            gives pages time to stream in before they come into view when moving
+            fast. The default of 0 only loads around the current position.
+        */
+        void setPrefetchTime(Real seconds) { mPrefetchTime = seconds; }
+        /** Get how many seconds ahead of a moving camera pages are loaded. */
+        Real getPrefetchTime() const { return mPrefetchTime; }
+
+        /** Set how many pages each section may load in the background at once.
+
+            Requests beyond this wait in the section's queue, which is reordered
+            every frame, so the most urgent pages are always started next. The
+            default of 0 starts all requested pages right away.
+        */
+        void setMaxConcurrentPageLoads(uint32 num) { mMaxConcurrentPageLoads = num; }
+        /** Get how many pages each section may load in the background at once. */
+        uint32 getMaxConcurrentPageLoads() const { return mMaxConcurrentPageLoads; }
+
+        /** Set the time per frame in milliseconds for finishing page loads on the main thread.
+
+            Once the budget is used up, further loaded pages wait for the next
+            frame, most urgent first. At least one page is finished per frame.
+            The default of 0 finishes all loaded pages right away.
+        */
+        void setPageFinaliseTimeLimit(uint32 ms) { mPageFinaliseTimeLimit = ms; }
+        /** Get the time per frame in milliseconds for finishing page loads on the main thread. */
+        uint32 getPageFinaliseTimeLimit() const { return mPageFinaliseTimeLimit; }
+
+        /** Returns whether there is time left this frame to finish another page load.
+
+            You should not call this method directly, it is used by PagedWorldSection.
+        */
+        bool _beginPageFinalisation();
+
         /** Set the debug display level.
 
             This setting controls how much debug information is displayed in the scene.
@@ -467,6 +511,20 @@ namespace Ogre
         uint8 mDebugDisplayLvl;
         bool mPagingEnabled;
 
+        struct CameraMotion
+        {
+            Vector3 position;
+            Vector3 velocity;
+        };
+        std::map<Camera*, CameraMotion> mCameraMotion;
+        Real mPrefetchTime;
+        uint32 mMaxConcurrentPageLoads;
+        uint32 mPageFinaliseTimeLimit;
+        uint64 mPageFinaliseDeadline;
+        bool mPageFinaliseStarted;
+
+        void updateCameraMotion(Real timeSinceLastFrame);
+
         Grid2DPageStrategy* mGrid2DPageStrategy;
         Grid3DPageStrategy* mGrid3DPageStrategy;
         SimplePageContentCollectionFactory* mSimpleCollectionFactory;
@@ -30,6 +30,7 @@ THE SOFTWARE.
 #define __Ogre_PageStrategy_H__
 
 #include "OgrePagingPrerequisites.h"
+#include "OgreVector.h"
 
 
 namespace Ogre
@@ -130,6 +131,22 @@ namespace Ogre
         @return The page ID
         */
         virtual PageID getPageID(const Vector3& worldPos, PagedWorldSection* section) = 0;
+    protected:
+        /** Estimates how far the camera has to travel to reach the given position.
+
+            The camera is assumed to move from its current towards its predicted position,
+            so positions around the camera come first, followed by those along its way.
+            Suitable as priority for PagedWorldSection::requestPage.
+        */
+        template <int dims>
+        static Real getTravelDistance(const Vector<dims, Real>& camPos, const Vector<dims, Real>& predictedPos,
+                                      const Vector<dims, Real>& target)
+        {
+            Vector<dims, Real> dir = predictedPos - camPos;
+            Real len = dir.normalise();
+            Real along = len > 0 ? Math::Clamp<Real>(dir.dotProduct(target - camPos), 0, len) : 0;
+            return along + target.distance(camPos + dir * along);
+        }
     };
 
     /*@}*/
@@ -31,6 +31,7 @@ THE SOFTWARE.
 
 #include "OgrePagingPrerequisites.h"
 #include "OgreAxisAlignedBox.h"
+#include "OgreWorkQueue.h"
 
 namespace Ogre
 {
@@ -80,10 +81,32 @@ namespace Ogre
         PageProvider* mPageProvider;
         SceneManager* mSceneMgr;
     private:
+        struct PageFinalisation
+        {
+            Page* page;
+            const WorkQueue::Response* response;
+        };
+        typedef std::vector<PageFinalisation> PageFinalisationList;
+        typedef std::vector<Page*> PageList;
+
+        /// Pages requested this frame which are not loaded yet, by lowest priority
+        std::map<PageID, Real> mPageRequests;
+        /// Background loads waiting to be finished on the main thread
+        PageFinalisationList mPageFinalisations;
+        /// Unloaded pages which are deleted once their background load finished
+        PageList mCancelledPages;
+
         /// Load data specific to a subtype of this class (if any)
         virtual void loadSubtypeData(StreamSerialiser& ser) {}
         virtual void saveSubtypeData(StreamSerialiser& ser) {}
 
+        /// Start the loads requested this frame in order of priority
+        void processPageRequests();
+        /// Finish queued background loads in order of priority within the frame budget
+        void finalisePageLoads();
+        /// Delete cancelled pages whose background load has finished
+        void deleteCancelledPages();
+
 
     public:
         static const uint32 CHUNK_ID;
@@ -177,6 +200,21 @@ namespace Ogre
         */
         virtual void loadPage(PageID pageID, bool forceSynchronous = false);
 
+        /** Ask for a page to be loaded this frame with the given priority.
+
+            This is what the PageStrategy calls for the pages it needs. Loaded
+            pages are held like with holdPage. Requests for other pages are
+            collected until the end of the frame, when the ones with the lowest
+            priority value are passed to loadPage, up to the limit set with
+            PageManager::setMaxConcurrentPageLoads. Requests which are not
+            repeated in the next frame are dropped, so the queue is reordered
+            every frame and pages that are no longer needed are never loaded.
+        @param pageID The page ID to load
+        @param priority Lower values are loaded first, e.g. the distance from the
+            predicted camera position
+        */
+        virtual void requestPage(PageID pageID, Real priority);
+
         /** Ask for a page to be unloaded with the given (section-relative) PageID
 
             You would not normally call this manually, the PageStrategy is in 
@@ -286,6 +324,13 @@ namespace Ogre
         */
         virtual StreamSerialiser* _writePageStream(PageID pageID);
 
+        /** Queue a finished background load of a Page to be finalised.
+
+            You should not call this method directly, it is called on the main
+            thread once the background part of Page::load is done.
+        */
+        void _queuePageFinalisation(Page* page, const WorkQueue::Response* res);
+
         /** Function for writing to a stream.
         */
         _OgrePagingExport friend std::ostream& operator <<( std::ostream& o, const PagedWorldSection& p );
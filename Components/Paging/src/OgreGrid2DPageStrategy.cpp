@@ -302,44 +302,34 @@ namespace Ogre
         int32 x, y;
         stratData->determineGridLocation(gridpos, &x, &y);
 
-        Real loadRadius = stratData->getLoadRadiusInCells();
-        Real holdRadius = stratData->getHoldRadiusInCells();
+        // also load around where the camera is heading
+        Vector2 predictedGridpos;
+        stratData->convertWorldToGridSpace(section->getManager()->getPredictedCameraPosition(cam),
+                                           predictedGridpos);
+        int32 px, py;
+        stratData->determineGridLocation(predictedGridpos, &px, &py);
+
+        int32 loadCells = (int32)Math::Ceil(stratData->getLoadRadiusInCells());
+        int32 holdCells = (int32)Math::Ceil(stratData->getHoldRadiusInCells());
         // scan the whole Hold range
-        Real fxmin = (Real)x - holdRadius;
-        Real fxmax = (Real)x + holdRadius;
-        Real fymin = (Real)y - holdRadius;
-        Real fymax = (Real)y + holdRadius;
-
-        int32 xmin = stratData->getCellRangeMinX();
-        int32 xmax = stratData->getCellRangeMaxX();
-        int32 ymin = stratData->getCellRangeMinY();
-        int32 ymax = stratData->getCellRangeMaxY();
-
-        // Round UP max, round DOWN min
-        xmin = fxmin < xmin ? xmin : (int32)floor(fxmin);
-        xmax = fxmax > xmax ? xmax : (int32)ceil(fxmax);
-        ymin = fymin < ymin ? ymin : (int32)floor(fymin);
-        ymax = fymax > ymax ? ymax : (int32)ceil(fymax);
-        // the inner, active load range
-        fxmin = (Real)x - loadRadius;
-        fxmax = (Real)x + loadRadius;
-        fymin = (Real)y - loadRadius;
-        fymax = (Real)y + loadRadius;
-        // Round UP max, round DOWN min
-        int32 loadxmin = fxmin < xmin ? xmin : (int32)floor(fxmin);
-        int32 loadxmax = fxmax > xmax ? xmax : (int32)ceil(fxmax);
-        int32 loadymin = fymin < ymin ? ymin : (int32)floor(fymin);
-        int32 loadymax = fymax > ymax ? ymax : (int32)ceil(fymax);
+        int32 xmin = std::max(stratData->getCellRangeMinX(), std::min(x, px) - holdCells);
+        int32 xmax = std::min(stratData->getCellRangeMaxX(), std::max(x, px) + holdCells);
+        int32 ymin = std::max(stratData->getCellRangeMinY(), std::min(y, py) - holdCells);
+        int32 ymax = std::min(stratData->getCellRangeMaxY(), std::max(y, py) + holdCells);
 
         for (int32 cy = ymin; cy <= ymax; ++cy)
         {
             for (int32 cx = xmin; cx <= xmax; ++cx)
             {
                 PageID pageID = stratData->calculatePageID(cx, cy);
-                if (cx >= loadxmin && cx <= loadxmax && cy >= loadymin && cy <= loadymax)
+                // the inner, active load range
+                if ((std::abs(cx - x) <= loadCells && std::abs(cy - y) <= loadCells) ||
+                    (std::abs(cx - px) <= loadCells && std::abs(cy - py) <= loadCells))
                 {
-                    // in the 'load' range, request it
-                    section->loadPage(pageID);
+                    // in the 'load' range, request it, soonest reached ones first
+                    Vector2 mid;
+                    stratData->getMidPointGridSpace(cx, cy, mid);
+                    section->requestPage(pageID, getTravelDistance(gridpos, predictedGridpos, mid));
                 }
                 else
                 {
@@ -348,10 +338,7 @@ namespace Ogre
                 }
                 // other pages will by inference be marked for unloading
             }
-        }   
-        
-
-
+        }
     }
     //---------------------------------------------------------------------
     PageStrategyData* Grid2DPageStrategy::createData()
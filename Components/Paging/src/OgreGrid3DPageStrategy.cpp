@@ -250,6 +250,8 @@ namespace Ogre
         const Vector3& pos = cam->getDerivedPosition();
         int32 x, y, z;
         stratData->determineGridLocation(pos, &x, &y, &z);
+        // load the pages the camera reaches soonest first
+        Vector3 predictedPos = section->getManager()->getPredictedCameraPosition(cam);
 
         Real loadRadius = stratData->getLoadRadius();
         Real holdRadius = stratData->getHoldRadius();
@@ -307,7 +309,7 @@ namespace Ogre
                         Ogre::AxisAlignedBox bbox(bl, bl+stratData->getCellSize());
 
                         if( cam->isVisible(bbox) )
-                            section->loadPage(pageID);
+                            section->requestPage(pageID, getTravelDistance(pos, predictedPos, bbox.getCenter()));
                         else
                             section->holdPage(pageID);
                     }
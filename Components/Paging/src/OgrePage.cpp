@@ -38,6 +38,7 @@ THE SOFTWARE.
 #include "OgrePageContentCollection.h"
 #include "OgreLogManager.h"
 #include <iomanip>
+#include <thread>
 
 namespace Ogre
 {
@@ -54,6 +55,9 @@ namespace Ogre
         , mModified(false)
         , mDebugNode(0)
         , mInUnload(false)
+        , mPreparing(false)
+        , mDetached(false)
+        , mLoadPriority(0)
     {
         touch();
     }
@@ -61,6 +65,11 @@ namespace Ogre
     Page::~Page()
     {
         destroyAllContentCollections();
+        destroyDebugNode();
+    }
+    //---------------------------------------------------------------------
+    void Page::destroyDebugNode()
+    {
         if (mDebugNode)
         {
             // destroy while we have the chance
@@ -185,8 +194,13 @@ namespace Ogre
                 Root::getSingleton().getWorkQueue()->addTask([this]() {
                     auto res = handleRequest(NULL, NULL);
                     Root::getSingleton().getWorkQueue()->addMainThreadTask([this, res]() {
-                        handleResponse(res, NULL);
-                        delete res;
+                        if (!mDetached)
+                        {
+                            mParent->_queuePageFinalisation(this, res);
+                            return;
+                        }
+                        _finaliseLoad(res);
+                        OGRE_DELETE this;
                     });
                 });
             }
@@ -207,6 +221,13 @@ namespace Ogre
         PageResponse res;
         res.pageData = OGRE_NEW PageData();
         WorkQueue::Response* response = 0;
+        // unloaded before we got to it, don't bother
+        mPreparing = true;
+        if (mInUnload)
+        {
+            mPreparing = false;
+            return OGRE_NEW WorkQueue::Response(req, false, res, "cancelled");
+        }
         try
         {
             prepareImpl(res.pageData);
@@ -218,6 +239,7 @@ namespace Ogre
             response = OGRE_NEW WorkQueue::Response(req, false, res,
                 e.getFullDescription());
         }
+        mPreparing = false;
 
         return response;
     }
@@ -236,12 +258,33 @@ namespace Ogre
             loadImpl();
         }
 
+        // anything left was not taken over because the load failed or was cancelled
+        for (auto cc : pres.pageData->collectionsToAdd)
+            delete cc;
         OGRE_DELETE pres.pageData;
 
         mDeferredProcessInProgress = false;
 
     }
     //---------------------------------------------------------------------
+    void Page::_finaliseLoad(const WorkQueue::Response* res)
+    {
+        handleResponse(res, NULL);
+        delete res;
+    }
+    //---------------------------------------------------------------------
+    void Page::_detachFromSection()
+    {
+        // a request that has not started yet sees mInUnload and leaves the section alone
+        unload();
+        while (mPreparing)
+            std::this_thread::yield();
+
+        destroyDebugNode();
+        mParent = 0;
+        mDetached = true;
+    }
+    //---------------------------------------------------------------------
     bool Page::prepareImpl(PageData* dataToPopulate)
     {
         // Procedural preparation
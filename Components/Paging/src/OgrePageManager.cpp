@@ -37,6 +37,7 @@ THE SOFTWARE.
 #include "OgreSimplePageContentCollection.h"
 #include "OgreStreamSerialiser.h"
 #include "OgreRoot.h"
+#include "OgreTimer.h"
 #include "OgrePageContent.h"
 #include <sstream>
 
@@ -49,6 +50,11 @@ namespace Ogre
         , mPageResourceGroup(ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME)
         , mDebugDisplayLvl(0)
         , mPagingEnabled(true)
+        , mPrefetchTime(0)
+        , mMaxConcurrentPageLoads(0)
+        , mPageFinaliseTimeLimit(0)
+        , mPageFinaliseDeadline(0)
+        , mPageFinaliseStarted(false)
         , mGrid2DPageStrategy(0)
         , mGrid3DPageStrategy(0)
         , mSimpleCollectionFactory(0)
@@ -493,6 +499,7 @@ namespace Ogre
         {
             c->removeListener(&mEventRouter);
             mCameraList.erase(i);
+            mCameraMotion.erase(c);
         }
     }
     //---------------------------------------------------------------------
@@ -506,6 +513,45 @@ namespace Ogre
         return mCameraList;
     }
     //---------------------------------------------------------------------
+    const Vector3& PageManager::getCameraVelocity(Camera* c) const
+    {
+        std::map<Camera*, CameraMotion>::const_iterator i = mCameraMotion.find(c);
+        return i != mCameraMotion.end() ? i->second.velocity : Vector3::ZERO;
+    }
+    //---------------------------------------------------------------------
+    Vector3 PageManager::getPredictedCameraPosition(Camera* c) const
+    {
+        return c->getDerivedPosition() + getCameraVelocity(c) * mPrefetchTime;
+    }
+    //---------------------------------------------------------------------
+    void PageManager::updateCameraMotion(Real timeSinceLastFrame)
+    {
+        for (auto c : mCameraList)
+        {
+            const Vector3& pos = c->getDerivedPosition();
+            std::pair<std::map<Camera*, CameraMotion>::iterator, bool> ret =
+                mCameraMotion.emplace(c, CameraMotion{pos, Vector3::ZERO});
+            CameraMotion& motion = ret.first->second;
+            if (!ret.second && timeSinceLastFrame > 0)
+                motion.velocity = (pos - motion.position) / timeSinceLastFrame;
+            motion.position = pos;
+        }
+    }
+    //---------------------------------------------------------------------
+    bool PageManager::_beginPageFinalisation()
+    {
+        if (!mPageFinaliseTimeLimit)
+            return true;
+
+        uint64 now = Root::getSingleton().getTimer()->getMicroseconds();
+        if (!mPageFinaliseStarted)
+        {
+            mPageFinaliseStarted = true;
+            mPageFinaliseDeadline = now + mPageFinaliseTimeLimit * 1000;
+            return true;
+        }
+        return now < mPageFinaliseDeadline;
+    }
     //---------------------------------------------------------------------
     void PageManager::EventRouter::cameraPreRenderScene(Camera* cam)
     {
@@ -518,6 +564,10 @@ namespace Ogre
     //---------------------------------------------------------------------
     bool PageManager::EventRouter::frameStarted(const FrameEvent& evt)
     {
+        // track cameras even without worlds, so a new world starts with valid predictions
+        pManager->updateCameraMotion(evt.timeSinceLastFrame);
+        pManager->mPageFinaliseStarted = false;
+
         if(pWorldMap->empty())
             return true;
 
@@ -223,6 +223,103 @@ namespace Ogre
             i->second->touch();
     }
     //---------------------------------------------------------------------
+    void PagedWorldSection::requestPage(PageID pageID, Real priority)
+    {
+        PageMap::iterator i = mPages.find(pageID);
+        if (i != mPages.end())
+        {
+            Page* page = i->second;
+            // several cameras may request the same page, keep the most urgent
+            bool requested = page->getFrameLastHeld() == Root::getSingleton().getNextFrameNumber();
+            page->setLoadPriority(requested ? std::min(page->getLoadPriority(), priority) : priority);
+            page->touch();
+            return;
+        }
+
+        std::pair<std::map<PageID, Real>::iterator, bool> ret = mPageRequests.emplace(pageID, priority);
+        if (!ret.second)
+            ret.first->second = std::min(ret.first->second, priority);
+    }
+    //---------------------------------------------------------------------
+    void PagedWorldSection::processPageRequests()
+    {
+        if (mPageRequests.empty())
+            return;
+
+        typedef std::pair<Real, PageID> PriorityPageID;
+        std::vector<PriorityPageID> requests;
+        requests.reserve(mPageRequests.size());
+        for (const auto& r : mPageRequests)
+            requests.emplace_back(r.second, r.first);
+        mPageRequests.clear();
+        std::sort(requests.begin(), requests.end());
+
+        uint32 maxLoads = getManager()->getMaxConcurrentPageLoads();
+        size_t numLoading = 0;
+        if (maxLoads)
+        {
+            for (const auto& p : mPages)
+                numLoading += p.second->isDeferredProcessInProgress();
+            for (auto p : mCancelledPages)
+                numLoading += p->isDeferredProcessInProgress();
+        }
+
+        for (const auto& r : requests)
+        {
+            if (maxLoads && numLoading >= maxLoads)
+                break;
+
+            loadPage(r.second);
+            if (Page* page = getPage(r.second))
+            {
+                page->setLoadPriority(r.first);
+                numLoading += page->isDeferredProcessInProgress();
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void PagedWorldSection::_queuePageFinalisation(Page* page, const WorkQueue::Response* res)
+    {
+        PageFinalisation f = {page, res};
+        mPageFinalisations.push_back(f);
+    }
+    //---------------------------------------------------------------------
+    void PagedWorldSection::finalisePageLoads()
+    {
+        if (mPageFinalisations.empty())
+            return;
+
+        std::stable_sort(mPageFinalisations.begin(), mPageFinalisations.end(),
+                         [](const PageFinalisation& a, const PageFinalisation& b)
+                         { return a.page->getLoadPriority() < b.page->getLoadPriority(); });
+
+        PageManager* mgr = getManager();
+        size_t numLeft = 0;
+        for (const auto& f : mPageFinalisations)
+        {
+            // cancelled loads just release their data, so they are not budgeted
+            bool cancelled = getPage(f.page->getID()) != f.page;
+            if (cancelled || mgr->_beginPageFinalisation())
+                f.page->_finaliseLoad(f.response);
+            else
+                mPageFinalisations[numLeft++] = f;
+        }
+        mPageFinalisations.resize(numLeft);
+    }
+    //---------------------------------------------------------------------
+    void PagedWorldSection::deleteCancelledPages()
+    {
+        PageList::iterator end = std::remove_if(mCancelledPages.begin(), mCancelledPages.end(),
+                                                [](Page* p)
+                                                {
+                                                    if (p->isDeferredProcessInProgress())
+                                                        return false;
+                                                    OGRE_DELETE p;
+                                                    return true;
+                                                });
+        mCancelledPages.erase(end, mCancelledPages.end());
+    }
+    //---------------------------------------------------------------------
     void PagedWorldSection::unloadPage(PageID pageID, bool sync)
     {
         if (!mParent->getManager()->getPagingOperationsEnabled())
@@ -236,8 +333,11 @@ namespace Ogre
 
             page->unload();
 
-            OGRE_DELETE page;
-            
+            // the background load still refers to the page, so delete it once that is done
+            if (page->isDeferredProcessInProgress())
+                mCancelledPages.push_back(page);
+            else
+                OGRE_DELETE page;
         }
     }
     //---------------------------------------------------------------------
@@ -311,16 +411,39 @@ namespace Ogre
         if (!mParent->getManager()->getPagingOperationsEnabled())
             return;
 
+        for (const auto& f : mPageFinalisations)
+        {
+            f.page->unload();
+            f.page->_finaliseLoad(f.response);
+        }
+        mPageFinalisations.clear();
+
+        // pages with a background load in flight outlive the section until it returns
         for (auto & p : mPages)
         {
-            OGRE_DELETE p.second;
+            if (p.second->isDeferredProcessInProgress())
+                p.second->_detachFromSection();
+            else
+                OGRE_DELETE p.second;
         }
         mPages.clear();
 
+        for (auto p : mCancelledPages)
+        {
+            if (p->isDeferredProcessInProgress())
+                p->_detachFromSection();
+            else
+                OGRE_DELETE p;
+        }
+        mCancelledPages.clear();
+        mPageRequests.clear();
+
     }
     //---------------------------------------------------------------------
     void PagedWorldSection::frameStart(Real timeSinceLastFrame)
     {
+        finalisePageLoads();
+
         mStrategy->frameStart(timeSinceLastFrame, this);
 
         for (auto & p : mPages)
@@ -331,6 +454,8 @@ namespace Ogre
     {
         mStrategy->frameEnd(timeElapsed, this);
 
+        processPageRequests();
+
         for (PageMap::iterator i = mPages.begin(); i != mPages.end(); )
         {
             // if this page wasn't used, unload
@@ -343,6 +468,7 @@ namespace Ogre
                 p->frameEnd(timeElapsed);
         }
 
+        deleteCancelledPages();
     }
     //---------------------------------------------------------------------
     void PagedWorldSection::notifyCamera(Camera* cam)
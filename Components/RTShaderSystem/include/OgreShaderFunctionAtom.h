@@ -215,6 +215,16 @@ public:
     /** Abstract method that writes a source code to the given output stream in the target shader language. */
     virtual void writeSourceCode(std::ostream& os, const String& targetLanguage) const = 0;
 
+    /** Appends a compact description of this atom to the given signature.
+
+        Programs with equal signatures must result in the same source code, which allows
+        ProgramManager to reuse GPU programs without generating it. The default implementation
+        covers the atom type, the function name and the operands, atoms that write additional
+        state must append it as well. Changing the signature layout requires increasing
+        the signature version of the persistent shader cache.
+    */
+    virtual void _appendSignature(String& sig) const;
+
 // Attributes.
 protected:
     /** Class default constructor. */
@@ -310,7 +320,11 @@ class _OgreRTSSExport BinaryOpAtom : public FunctionAtom
 {
     char mOp;
 public:
-    BinaryOpAtom(char op, int groupOrder) : mOp(op) { mGroupExecutionOrder = groupOrder; }
+    BinaryOpAtom(char op, int groupOrder) : mOp(op)
+    {
+        mFunctionName = op;
+        mGroupExecutionOrder = groupOrder;
+    }
     BinaryOpAtom(char op, const In& a, const In& b, const Out& dst, int groupOrder);
     void writeSourceCode(std::ostream& os, const String& targetLanguage) const override;
 };
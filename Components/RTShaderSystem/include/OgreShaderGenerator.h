@@ -150,6 +150,10 @@ public:
     /** 
     Set the output shader cache path. Generated shader code will be written to this path.
     In case of empty cache path shaders will be generated directly from system memory.
+
+    Additionally the signatures, sources and microcodes of the generated programs are stored in
+    the single file "RTShaderSystem.cache" at this path, which is loaded here and written when the
+    shader generator is destroyed. See ProgramManager::loadShaderCache.
     @param cachePath The cache path of the shader.  
     The default is empty cache path.
     */
@@ -383,6 +387,20 @@ public:
         validateMaterial(schemeName, mat.getName(), mat.getGroup());
     }
 
+    /**
+    Validate several materials of a scheme at once. This action will generate shader programs for the
+    techniques of the given scheme name.
+
+    Unlike calling validateMaterial for each of them, the CPU programs are generated concurrently
+    if parallel validation is enabled.
+    @param schemeName The scheme to validate.
+    @param materialNames The materials to validate.
+    @param groupName The source group name.
+    @see setParallelValidation
+    */
+    bool validateMaterials(const String& schemeName, const StringVector& materialNames,
+                           const String& groupName OGRE_RESOURCE_GROUP_INIT) const;
+
 	/**
 	Invalidate specific material scheme. This action will lead to shader regeneration of the technique belongs to the
 	given scheme name.
@@ -423,6 +441,22 @@ public:
     /** Return the current number of generated shaders. */
     size_t getShaderCount(GpuProgramType type) const;
 
+    /** Sets whether materials are validated in parallel using the WorkQueue workers.
+
+    When several techniques are validated at once, e.g. by validateScheme or validateMaterials,
+    the render states of their passes are linked on the calling thread first. The CPU programs
+    are then generated concurrently and finally the GPU programs are created on the calling
+    thread again. The results are identical to the serial validation.
+
+    This pays off for scenes with many materials. As SubRenderState::createCpuSubPrograms is
+    called from the worker threads, custom sub render states must be thread safe when this is
+    enabled.
+    */
+    void setParallelValidation(bool enabled) { mParallelValidation = enabled; }
+
+    /// Gets whether materials are validated in parallel
+    bool getParallelValidation() const { return mParallelValidation; }
+
     /** Set the vertex shader outputs compaction policy. 
     @see VSOutputCompactPolicy.
     @param policy The policy to set.
@@ -520,6 +554,14 @@ private:
         /** Build the render state and acquire the CPU/GPU programs */
         void buildTargetRenderState();
 
+        /** Build and link the render state of this pass, without creating its programs.
+        @return NULL, if no render state is required for this pass.
+        */
+        std::shared_ptr<TargetRenderState> createTargetRenderState();
+
+        /** Acquire the CPU/GPU programs of the given render state and attach it to this pass. */
+        void acquirePrograms(const std::shared_ptr<TargetRenderState>& targetRenderState);
+
         /** Get source pass. */
         Pass* getSrcPass() { return mSrcPass; }
 
@@ -576,6 +618,10 @@ private:
         /** Build the render state. */
         void buildTargetRenderState();
 
+        /** (Re)create the destination technique and its pass entries, without building their
+        render states. */
+        void createDestinationTechnique();
+
 		/** Build the render state for illumination passes. */
 		void buildIlluminationTargetRenderState();
 
@@ -702,6 +748,11 @@ private:
         */
         bool validate(const String& materialName, const String& groupName);
 
+        /** Validate several materials.
+        @see ShaderGenerator::validateMaterials.
+        */
+        void validate(const StringVector& materialNames, const String& groupName);
+
 		/** Validate illumination passes of the specific material.
 		@see ShaderGenerator::invalidateMaterialIlluminationPasses.
 		*/
@@ -736,6 +787,9 @@ private:
         /** Synchronize the fog settings of this scheme with the current settings of the scene. */
         void synchronizeWithFogSettings();
 
+        /** Build the render states of the given techniques, in parallel if enabled. */
+        void buildTargetRenderStates(const SGTechniqueList& techniques);
+
 
     protected:
         // Scheme name.
@@ -774,6 +828,9 @@ private:
     
     /** Destory the shader generator instance. */
     void _destroy();
+
+    /** Write the shader cache file to the shader cache path, if it changed. */
+    void saveShaderCacheFile();
  
     /** Called from the sub class of the RenderObjectLister when single object is rendered. */
     void notifyRenderSingleObject(Renderable* rend, const Pass* pass,  const AutoParamDataSource* source, const LightList* pLightList, bool suppressRenderStateChanges);
@@ -884,6 +941,8 @@ private:
     // A flag to indicate finalizing
     bool mIsFinalizing;
     bool mTargetLinearColours;
+    // Tells whether materials are validated in parallel
+    bool mParallelValidation;
 
     uint32 ID_RT_SHADER_SYSTEM;
 
@@ -84,10 +84,37 @@ public:
     */
     void releasePrograms(const ProgramSet* programSet);
 
+    /** Release the given GPU programs, unless they are still used by a ProgramSet.
+    @param programs Any programs, only the ones created by this manager are released.
+    */
+    void releasePrograms(const std::set<GpuProgramPtr>& programs);
+
     /** Flush the local GPU programs cache.
     */
     void flushGpuProgramsCache();
 
+    /** Load a shader cache previously written by @ref saveShaderCache.
+
+    The cache maps program signatures to the generated source code and, where the render system
+    exposes it, the compiled microcode. Programs found in it are neither generated nor compiled
+    again. The stream is kept in memory as a single block and only the matching entries are
+    decoded on lookup.
+    @param stream The stream to read the cache from.
+    @return false if the cache is invalid or was written by another Ogre version or device.
+    */
+    bool loadShaderCache(const DataStreamPtr& stream);
+
+    /** Save the signatures, sources and microcodes of the created programs.
+
+    Entries of a previously loaded cache are kept, even if they were not used in this run.
+    @param stream The stream to write the cache to.
+    */
+    void saveShaderCache(const DataStreamPtr& stream) const;
+
+    /** Returns true if programs were created that are not part of the loaded shader cache.
+    */
+    bool isShaderCacheDirty() const;
+
 private:
 
     //-----------------------------------------------------------------------------
@@ -124,10 +151,35 @@ private:
     */
     void destroyCpuProgram(Program* shaderProgram);
 
-    /** Create GPU programs for the given program set based on the CPU programs it contains.
+    /** Prepare the CPU programs of the given program set for GPU program creation.
+
+    Computes the signatures of the programs and generates the source code of the ones not
+    found in the signature cache. This does not touch any GPU resources and may be called
+    from worker threads, as long as createGpuPrograms is not called concurrently.
     @param programSet The program set container.
     */
+    void prepareGpuPrograms(ProgramSet* programSet);
+
+    /** Create GPU programs for the given program set based on the CPU programs it contains.
+    @param programSet The program set container. prepareGpuPrograms is called first,
+    unless that was already done.
+    */
     void createGpuPrograms(ProgramSet* programSet);
+
+    /** Generate the source code of the given CPU program. */
+    static String generateSourceCode(Program* shaderProgram, ProgramWriter* programWriter);
+
+    /** Generate a compact description of the given CPU program.
+
+    Programs with the same signature result in the same source code, so the signature
+    identifies the GPU program without generating its source code.
+    @param sig Receives the signature.
+    @param shaderProgram The CPU program instance.
+    @param language The target shader language.
+    @param profiles The profiles string for program compilation.
+    */
+    static void generateSignature(String& sig, Program* shaderProgram, const String& language,
+                                  const String& profiles);
         
     /** 
     Generates a unique hash from a string
@@ -138,14 +190,15 @@ private:
     static String generateHash(const String& programString, const String& defines);
 
     /** Create GPU program based on the give CPU program.
-    @param shaderProgram The CPU program instance.
+    @param programSet The program set container, prepared by prepareGpuPrograms.
+    @param type The type of the CPU program to use.
     @param programWriter The program writer instance.
     @param language The target shader language.
     @param profiles The profiles string for program compilation.
-    @param profilesList The profiles string for program compilation as string list.
     @param cachePath The output path to write the program into.
     */
-    GpuProgramPtr createGpuProgram(Program* shaderProgram, 
+    GpuProgramPtr createGpuProgram(ProgramSet* programSet,
+        GpuProgramType type,
         ProgramWriter* programWriter,
         const String& language,
         const String& profiles,
@@ -161,6 +214,12 @@ private:
     ProgramProcessorMap mProgramProcessorsMap;
     // The generated shaders.
     std::vector<GpuProgramPtr> mShaderList;
+    // Map between program signatures and the names of the generated shaders.
+    std::unordered_map<String, String> mSignatureCache;
+    // The loaded shader cache.
+    MemoryDataStreamPtr mShaderCacheData;
+    // Whether programs were generated that are not in the loaded shader cache.
+    bool mShaderCacheDirty;
     // The default program processors.
     ProgramProcessorList mDefaultProgramProcessors;
 
@@ -73,6 +73,12 @@ private:
     GpuProgramPtr mVSGpuProgram;
     // Fragment shader CPU program.
     GpuProgramPtr mPSGpuProgram;
+    // Signatures of the CPU programs, indexed by GpuProgramType.
+    String mSignatures[2];
+    // Generated source code of the CPU programs not found in the signature cache.
+    String mSources[2];
+    // Whether ProgramManager::prepareGpuPrograms was called.
+    bool mPrepared;
 
     friend class ProgramManager;
     friend class TargetRenderState;
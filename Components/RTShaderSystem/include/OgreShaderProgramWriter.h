@@ -88,8 +88,11 @@ protected:
     /** Write a function parameter. */
     void writeParameterSemantic(std::ostream& os, const ParameterPtr& parameter);
 
+    /** Redirect writes to inputs and uniforms to local copies
+    @param localRenames the local copies declared so far in the current function
+    */
     void redirectGlobalWrites(std::ostream& os, FunctionAtom* func, const ShaderParameterList& inputs,
-                              const UniformParameterList& uniform);
+                              const UniformParameterList& uniform, std::set<String>& localRenames);
 
     /** Write the program dependencies. */
     void writeProgramDependencies(std::ostream& os, Program* program);
@@ -100,8 +103,6 @@ protected:
     GpuConstTypeToStringMap mGpuConstTypeMap;
     // Map between parameter semantic to string value.
     ParamSemanticToStringMap mParamSemanticMap;
-
-    std::set<String> mLocalRenames;
 };
 
 /** @} */
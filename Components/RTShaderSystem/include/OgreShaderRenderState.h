@@ -163,6 +163,14 @@ public:
     */
     void addSubRenderStateInstance(SubRenderState* subRenderState);
 
+    /** Create the CPU programs of this render state and prepare them for acquirePrograms.
+
+    This does not modify any pass or GPU resources, so the programs of different render states
+    can be prepared concurrently on worker threads. Calling it is optional, acquirePrograms does
+    so if needed.
+    */
+    void preparePrograms();
+
     /** Acquire CPU/GPU programs set associated with the given render state and bind them to the pass.
     @param pass The pass to bind the programs to.
     */
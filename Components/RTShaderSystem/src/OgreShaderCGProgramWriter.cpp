@@ -151,9 +151,10 @@ void CGProgramWriter::writeSourceCode(std::ostream& os, Program* program)
         os << ";" << std::endl;
     }
 
+    std::set<String> localRenames;
     for (const auto& a : curFunction->getAtomInstances())
     {
-        redirectGlobalWrites(os, a, curFunction->getInputParameters(), program->getParameters());
+        redirectGlobalWrites(os, a, curFunction->getInputParameters(), program->getParameters(), localRenames);
         writeAtomInstance(os, a);
     }
 
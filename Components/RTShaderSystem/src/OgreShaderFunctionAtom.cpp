@@ -143,6 +143,26 @@ int FunctionAtom::getGroupExecutionOrder() const
     return mGroupExecutionOrder;
 }
 
+//-----------------------------------------------------------------------------
+void FunctionAtom::_appendSignature(String& sig) const
+{
+    sig += typeid(*this).name();
+    sig += '\0';
+    sig += mFunctionName;
+    sig += '\0';
+    for (const auto& op : mOperands)
+    {
+        const ParameterPtr& param = op.getParameter();
+        sig += param->toString();
+        sig += '\0';
+        sig += char(param->getType());
+        sig += char(op.getSemantic());
+        sig += char(op.getMask());
+        sig += char(op.getIndirectionLevel());
+    }
+    sig += '\0';
+}
+
 //-----------------------------------------------------------------------
 FunctionInvocation::FunctionInvocation(const String& functionName, int groupOrder,
                                        const String& returnType)
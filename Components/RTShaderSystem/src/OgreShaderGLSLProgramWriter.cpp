@@ -258,9 +258,10 @@ void GLSLProgramWriter::writeMainSourceCode(std::ostream& os, Program* program)
     }
     os << std::endl;
 
+    std::set<String> localRenames;
     for (const auto& pFuncInvoc : curFunction->getAtomInstances())
     {
-        redirectGlobalWrites(os, pFuncInvoc, inParams, parameterList);
+        redirectGlobalWrites(os, pFuncInvoc, inParams, parameterList, localRenames);
         for (auto& operand : pFuncInvoc->getOperandList())
         {
             const ParameterPtr& param = operand.getParameter();
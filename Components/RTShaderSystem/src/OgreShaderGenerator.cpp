@@ -25,6 +25,8 @@ THE SOFTWARE.
 -----------------------------------------------------------------------------
 */
 #include "OgreShaderPrecompiledHeaders.h"
+#include "OgreWorkQueue.h"
+#include "OgreFileSystemLayer.h"
 
 namespace Ogre {
 
@@ -111,6 +113,7 @@ protected:
 
 String ShaderGenerator::DEFAULT_SCHEME_NAME     = "ShaderGeneratorDefaultScheme";
 String ShaderGenerator::SGTechnique::UserKey    = "SGTechnique";
+static const char* SHADER_CACHE_FILENAME = "RTShaderSystem.cache";
 
 //-----------------------------------------------------------------------
 ShaderGenerator* ShaderGenerator::getSingletonPtr()
@@ -129,7 +132,8 @@ ShaderGenerator& ShaderGenerator::getSingleton()
 ShaderGenerator::ShaderGenerator() :
     mActiveSceneMgr(NULL), mShaderLanguage(""),
     mActiveViewportValid(false), mVSOutputCompactPolicy(VSOCP_LOW),
-    mCreateShaderOverProgrammablePass(false), mIsFinalizing(false), mTargetLinearColours(false)
+    mCreateShaderOverProgrammablePass(false), mIsFinalizing(false), mTargetLinearColours(false),
+    mParallelValidation(false)
 {
     mLightCount[0]              = 0;
     mLightCount[1]              = 0;
@@ -315,6 +319,9 @@ void ShaderGenerator::_destroy()
 
     mIsFinalizing = true;
 
+    // Before the programs are released by the technique entries.
+    saveShaderCacheFile();
+
     // Delete technique entries.
     for (auto& e : mTechniqueEntriesMap)
     {
@@ -1056,6 +1063,19 @@ bool ShaderGenerator::validateMaterial(const String& schemeName, const String& m
     return false;
 }
 
+//-----------------------------------------------------------------------------
+bool ShaderGenerator::validateMaterials(const String& schemeName, const StringVector& materialNames,
+                                        const String& groupName) const
+{
+    if (auto scheme = getScheme(schemeName))
+    {
+        scheme->validate(materialNames, groupName);
+        return true;
+    }
+
+    return false;
+}
+
 //-----------------------------------------------------------------------------
 bool ShaderGenerator::validateMaterialIlluminationPasses(const String& schemeName, const String& materialName,
                                                          const String& groupName) const
@@ -1146,6 +1166,7 @@ void ShaderGenerator::setShaderCachePath( const String& cachePath )
 
     if (mShaderCachePath != stdCachePath)
     {
+        saveShaderCacheFile();
         mShaderCachePath = stdCachePath;
 
         // Case this is a valid file path -> add as resource location in order to make sure that
@@ -1166,10 +1187,24 @@ void ShaderGenerator::setShaderCachePath( const String& cachePath )
             // Close and remove the test file.
             outFile.close();
             remove(outTestFileName.c_str());
+
+            String cacheFileName(mShaderCachePath + SHADER_CACHE_FILENAME);
+            if (mProgramManager && FileSystemLayer::fileExists(cacheFileName))
+                mProgramManager->loadShaderCache(Root::openFileStream(cacheFileName));
         }
     }
 }
 
+//-----------------------------------------------------------------------------
+void ShaderGenerator::saveShaderCacheFile()
+{
+    if (mShaderCachePath.empty() || !mProgramManager || !mProgramManager->isShaderCacheDirty())
+        return;
+
+    mProgramManager->saveShaderCache(Root::createFileStream(mShaderCachePath + SHADER_CACHE_FILENAME,
+                                                           RGN_DEFAULT, true));
+}
+
 //-----------------------------------------------------------------------------
 ShaderGenerator::SGMaterialIterator ShaderGenerator::findMaterialEntryIt(const String& materialName, const String& groupName)
 {
@@ -1303,7 +1338,14 @@ ShaderGenerator::SGPass::~SGPass()
 //-----------------------------------------------------------------------------
 void ShaderGenerator::SGPass::buildTargetRenderState()
 {
-    if(mSrcPass->isProgrammable() && !mParent->overProgrammablePass() && !isIlluminationPass()) return;
+    if (auto targetRenderState = createTargetRenderState())
+        acquirePrograms(targetRenderState);
+}
+
+//-----------------------------------------------------------------------------
+std::shared_ptr<TargetRenderState> ShaderGenerator::SGPass::createTargetRenderState()
+{
+    if(mSrcPass->isProgrammable() && !mParent->overProgrammablePass() && !isIlluminationPass()) return NULL;
     const String& schemeName = mParent->getDestinationTechniqueSchemeName();
     const RenderState* renderStateGlobal = ShaderGenerator::getSingleton().getRenderState(schemeName);
 
@@ -1343,6 +1385,12 @@ void ShaderGenerator::SGPass::buildTargetRenderState()
         targetRenderState->link(*mCustomRenderState, mSrcPass, mDstPass);
     }
 
+    return targetRenderState;
+}
+
+//-----------------------------------------------------------------------------
+void ShaderGenerator::SGPass::acquirePrograms(const std::shared_ptr<TargetRenderState>& targetRenderState)
+{
     targetRenderState->acquirePrograms(mDstPass);
     mDstPass->getUserObjectBindings().setUserAny(TargetRenderState::UserKey, targetRenderState);
 }
@@ -1482,6 +1530,22 @@ void ShaderGenerator::SGTechnique::destroySGPasses()
 
 //-----------------------------------------------------------------------------
 void ShaderGenerator::SGTechnique::buildTargetRenderState()
+{
+    createDestinationTechnique();
+
+    // Build render state for each pass.
+    for (auto *p : mPassEntries)
+    {
+	assert(!p->isIlluminationPass()); // this is not so important, but intended to be so here.
+        p->buildTargetRenderState();
+    }
+
+    // Turn off the build destination technique flag.
+    mBuildDstTechnique = false;
+}
+
+//-----------------------------------------------------------------------------
+void ShaderGenerator::SGTechnique::createDestinationTechnique()
 {
     // Remove existing destination technique and passes
     // in order to build it again from scratch.
@@ -1506,16 +1570,6 @@ void ShaderGenerator::SGTechnique::buildTargetRenderState()
     *mDstTechnique  = *mSrcTechnique;
     mDstTechnique->setSchemeName(mDstTechniqueSchemeName);
     createSGPasses();
-
-    // Build render state for each pass.
-    for (auto *p : mPassEntries)
-    {
-	assert(!p->isIlluminationPass()); // this is not so important, but intended to be so here.
-        p->buildTargetRenderState();
-    }
-
-    // Turn off the build destination technique flag.
-    mBuildDstTechnique = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -1665,16 +1719,93 @@ void ShaderGenerator::SGScheme::validate()
         return;
 
     // Build render state for each technique and acquire GPU programs.
+    SGTechniqueList techniques;
     for (SGTechnique* curTechEntry : mTechniqueEntries)
     {
         if (curTechEntry->getBuildDestinationTechnique())
-            curTechEntry->buildTargetRenderState();
+            techniques.push_back(curTechEntry);
     }
+    buildTargetRenderStates(techniques);
 
     // Mark this scheme as up to date.
     mOutOfDate = false;
 }
 
+//-----------------------------------------------------------------------------
+void ShaderGenerator::SGScheme::buildTargetRenderStates(const SGTechniqueList& techniques)
+{
+    if (!ShaderGenerator::getSingleton().getParallelValidation() || techniques.size() < 2)
+    {
+        for (SGTechnique* curTechEntry : techniques)
+            curTechEntry->buildTargetRenderState();
+        return;
+    }
+
+    // Keep the current programs alive while the destination techniques are recreated, so they can
+    // be reused instead of being created again.
+    std::set<GpuProgramPtr> currentPrograms;
+    for (SGTechnique* curTechEntry : techniques)
+    {
+        if (auto dstTechnique = curTechEntry->getDestinationTechnique())
+        {
+            for (auto pass : dstTechnique->getPasses())
+            {
+                for (auto type : {GPT_VERTEX_PROGRAM, GPT_FRAGMENT_PROGRAM})
+                {
+                    if (pass->hasGpuProgram(type))
+                        currentPrograms.insert(pass->getGpuProgram(type));
+                }
+            }
+        }
+    }
+
+    // Creating the destination passes and linking their render states modifies the materials.
+    std::vector<std::pair<SGPass*, std::shared_ptr<TargetRenderState>>> passes;
+    for (SGTechnique* curTechEntry : techniques)
+    {
+        curTechEntry->createDestinationTechnique();
+        for (SGPass* p : curTechEntry->getPassList())
+        {
+            if (auto targetRenderState = p->createTargetRenderState())
+                passes.emplace_back(p, targetRenderState);
+        }
+    }
+
+    // Generating the CPU programs only touches the render states themselves.
+    std::vector<std::exception_ptr> errors(passes.size());
+    Root::getSingleton().getWorkQueue()->parallelFor(
+        0, passes.size(), 8, [&passes, &errors](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                try
+                {
+                    passes[i].second->preparePrograms();
+                }
+                catch (...)
+                {
+                    errors[i] = std::current_exception();
+                }
+            }
+        });
+
+    // The GPU programs are created on the calling thread, in the same order as when validating serially.
+    std::exception_ptr error;
+    for (size_t i = 0; i < passes.size() && !error; ++i)
+    {
+        error = errors[i];
+        if (!error)
+            passes[i].first->acquirePrograms(passes[i].second);
+    }
+
+    ProgramManager::getSingleton().releasePrograms(currentPrograms);
+
+    if (error)
+        std::rethrow_exception(error);
+
+    for (SGTechnique* curTechEntry : techniques)
+        curTechEntry->setBuildDestinationTechnique(false);
+}
+
 //-----------------------------------------------------------------------------
 void ShaderGenerator::SGScheme::synchronizeWithLightSettings()
 {
@@ -1754,6 +1885,31 @@ bool ShaderGenerator::SGScheme::validate(const String& materialName, const Strin
 
     return false;
 }
+//-----------------------------------------------------------------------------
+void ShaderGenerator::SGScheme::validate(const StringVector& materialNames, const String& groupName)
+{
+    // Synchronize with light settings.
+    synchronizeWithLightSettings();
+
+    // Synchronize with fog settings.
+    synchronizeWithFogSettings();
+
+    // Find the desired techniques.
+    std::set<String> names(materialNames.begin(), materialNames.end());
+    bool doAutoDetect = groupName == ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME;
+    SGTechniqueList techniques;
+    for (auto *t : mTechniqueEntries)
+    {
+        const SGMaterial* curMat = t->getParent();
+        if (names.count(curMat->getMaterialName()) &&
+            ((doAutoDetect == true) || (curMat->getGroupName() == groupName)) && (t->getBuildDestinationTechnique()))
+            techniques.push_back(t);
+    }
+
+    // Build render state for each technique and Acquire the CPU/GPU programs.
+    buildTargetRenderStates(techniques);
+}
+
 //-----------------------------------------------------------------------------
 bool ShaderGenerator::SGScheme::validateIlluminationPasses(const String& materialName, const String& groupName)
 {
@@ -49,7 +49,7 @@ ProgramManager& ProgramManager::getSingleton()
 }
 
 //-----------------------------------------------------------------------------
-ProgramManager::ProgramManager()
+ProgramManager::ProgramManager() : mShaderCacheDirty(false)
 {
     createDefaultProgramProcessors();
 }
@@ -77,6 +77,23 @@ void ProgramManager::releasePrograms(const ProgramSet* programSet)
         GpuProgramManager::getSingleton().remove(prg);
     }
 }
+//-----------------------------------------------------------------------------
+void ProgramManager::releasePrograms(const std::set<GpuProgramPtr>& programs)
+{
+    for(const auto& prg : programs)
+    {
+        // the set holds the reference otherwise held by the ProgramSet
+        if(prg.use_count() > ResourceGroupManager::RESOURCE_SYSTEM_NUM_REFERENCE_COUNTS + 2)
+            continue;
+
+        // only release the programs we created
+        const auto it = std::find(mShaderList.begin(), mShaderList.end(), prg);
+        if(it == mShaderList.end())
+            continue;
+        mShaderList.erase(it);
+        GpuProgramManager::getSingleton().remove(prg);
+    }
+}
 size_t ProgramManager::getShaderCount(GpuProgramType type) const
 {
     size_t count = 0;
@@ -96,6 +113,235 @@ void ProgramManager::flushGpuProgramsCache()
         GpuProgramManager::getSingleton().remove(s);
     }
     mShaderList.clear();
+    mSignatureCache.clear();
+}
+//-----------------------------------------------------------------------------
+namespace
+{
+// The shader cache is a flat file, so it can be used directly from memory:
+// a header, the entries sorted by signature hash and the data they point to.
+const uint32 SHADER_CACHE_MAGIC = 0x43535452; // RTSC
+const uint32 SHADER_CACHE_VERSION = 2;
+// Must be increased whenever FunctionAtom::_appendSignature changes, as cached
+// programs are looked up by signature and an old scheme may map to wrong programs.
+const uint32 SHADER_SIGNATURE_VERSION = 2;
+
+struct ShaderCacheHeader
+{
+    uint32 magic;
+    uint32 version;
+    uint32 signatureVersion;
+    uint32 ogreVersion;
+    uint32 deviceHash;
+    uint32 numEntries;
+};
+
+struct ShaderCacheEntry
+{
+    uint32 hash;
+    uint32 signatureOffset, signatureSize;
+    uint32 nameOffset, nameSize;
+    uint32 sourceOffset, sourceSize;
+    uint32 microcodeId;
+    uint32 microcodeOffset, microcodeSize;
+};
+
+uint32 getDeviceHash()
+{
+    auto rs = Root::getSingleton().getRenderSystem();
+    if (!rs)
+        return 0;
+
+    auto caps = rs->getCapabilities();
+    String desc = rs->getName() + '\0' + caps->getDeviceName() + '\0' +
+                  caps->getDriverVersion().toString() + '\0' +
+                  RenderSystemCapabilities::vendorToString(caps->getVendor()) + '\0' +
+                  StringConverter::toString(rs->getNativeShadingLanguageVersion());
+    for (const auto& profile : caps->getSupportedShaderProfiles())
+        desc += '\0' + profile;
+
+    return FastHash(desc.c_str(), desc.size());
+}
+
+const ShaderCacheEntry* getCacheEntries(const MemoryDataStreamPtr& data)
+{
+    return reinterpret_cast<const ShaderCacheEntry*>(data->getPtr() + sizeof(ShaderCacheHeader));
+}
+
+size_t getNumCacheEntries(const MemoryDataStreamPtr& data)
+{
+    return data ? reinterpret_cast<const ShaderCacheHeader*>(data->getPtr())->numEntries : 0;
+}
+
+const ShaderCacheEntry* findCacheEntry(const MemoryDataStreamPtr& data, const String& signature)
+{
+    size_t numEntries = getNumCacheEntries(data);
+    if (!numEntries)
+        return NULL;
+
+    uint32 hash = FastHash(signature.c_str(), signature.size());
+    auto begin = getCacheEntries(data);
+    auto end = begin + numEntries;
+    auto it = std::lower_bound(begin, end, hash,
+                               [](const ShaderCacheEntry& e, uint32 h) { return e.hash < h; });
+    for (; it != end && it->hash == hash; ++it)
+    {
+        if (it->signatureSize == signature.size() &&
+            memcmp(data->getPtr() + it->signatureOffset, signature.c_str(), signature.size()) == 0)
+            return it;
+    }
+    return NULL;
+}
+
+String getCacheString(const MemoryDataStreamPtr& data, uint32 offset, uint32 size)
+{
+    return String(reinterpret_cast<const char*>(data->getPtr() + offset), size);
+}
+}
+
+bool ProgramManager::loadShaderCache(const DataStreamPtr& stream)
+{
+    mShaderCacheData.reset();
+
+    auto data = std::make_shared<MemoryDataStream>(stream);
+    auto header = reinterpret_cast<const ShaderCacheHeader*>(data->getPtr());
+    if (data->size() < sizeof(ShaderCacheHeader) || header->magic != SHADER_CACHE_MAGIC ||
+        header->version != SHADER_CACHE_VERSION)
+    {
+        LogManager::getSingleton().logWarning("Invalid RTSS shader cache " + stream->getName());
+        return false;
+    }
+
+    if (header->signatureVersion != SHADER_SIGNATURE_VERSION || header->ogreVersion != OGRE_VERSION ||
+        header->deviceHash != getDeviceHash())
+    {
+        LogManager::getSingleton().logMessage("RTSS: ignoring outdated shader cache " + stream->getName());
+        return false;
+    }
+
+    // Validate the entries once, so lookups can use them without checks.
+    size_t size = data->size();
+    bool valid = header->numEntries <= (size - sizeof(ShaderCacheHeader)) / sizeof(ShaderCacheEntry);
+    auto entries = getCacheEntries(data);
+    for (uint32 i = 0; valid && i < header->numEntries; ++i)
+    {
+        const auto& e = entries[i];
+        valid = (i == 0 || entries[i - 1].hash <= e.hash) && e.signatureOffset <= size &&
+                e.signatureSize <= size - e.signatureOffset && e.nameOffset <= size &&
+                e.nameSize <= size - e.nameOffset && e.sourceOffset <= size &&
+                e.sourceSize <= size - e.sourceOffset && e.microcodeOffset <= size &&
+                e.microcodeSize <= size - e.microcodeOffset;
+    }
+
+    if (!valid)
+    {
+        LogManager::getSingleton().logWarning("Invalid RTSS shader cache " + stream->getName());
+        return false;
+    }
+
+    mShaderCacheData = data;
+    mShaderCacheDirty = false;
+    return true;
+}
+//-----------------------------------------------------------------------------
+void ProgramManager::saveShaderCache(const DataStreamPtr& stream) const
+{
+    if (!stream->isWriteable())
+    {
+        OGRE_EXCEPT(Exception::ERR_CANNOT_WRITE_TO_FILE, "Unable to write to stream " + stream->getName());
+    }
+
+    struct Record
+    {
+        ShaderCacheEntry entry;
+        const void* data[4];
+    };
+    std::vector<Record> records;
+
+    auto& gpuProgramMgr = GpuProgramManager::getSingleton();
+    for (const auto& sig : mSignatureCache)
+    {
+        auto prg = gpuProgramMgr.getByName(sig.second, RGN_INTERNAL);
+        if (!prg)
+            continue;
+
+        Record r = {};
+        r.entry.hash = FastHash(sig.first.c_str(), sig.first.size());
+        r.entry.signatureSize = uint32(sig.first.size());
+        r.entry.nameSize = uint32(sig.second.size());
+        r.entry.sourceSize = uint32(prg->getSource().size());
+        r.entry.microcodeId = prg->_getHash();
+        r.data[0] = sig.first.c_str();
+        r.data[1] = sig.second.c_str();
+        r.data[2] = prg->getSource().c_str();
+        if (gpuProgramMgr.isMicrocodeAvailableInCache(r.entry.microcodeId))
+        {
+            const auto& microcode = gpuProgramMgr.getMicrocodeFromCache(r.entry.microcodeId);
+            r.entry.microcodeSize = uint32(microcode->size());
+            r.data[3] = microcode->getPtr();
+        }
+        records.push_back(r);
+    }
+
+    // keep the entries we did not use in this run
+    for (size_t i = 0; i < getNumCacheEntries(mShaderCacheData); ++i)
+    {
+        const auto& e = getCacheEntries(mShaderCacheData)[i];
+        if (mSignatureCache.count(getCacheString(mShaderCacheData, e.signatureOffset, e.signatureSize)))
+            continue;
+
+        Record r = {e};
+        r.data[0] = mShaderCacheData->getPtr() + e.signatureOffset;
+        r.data[1] = mShaderCacheData->getPtr() + e.nameOffset;
+        r.data[2] = mShaderCacheData->getPtr() + e.sourceOffset;
+        r.data[3] = mShaderCacheData->getPtr() + e.microcodeOffset;
+        records.push_back(r);
+    }
+
+    std::sort(records.begin(), records.end(),
+              [](const Record& a, const Record& b) { return a.entry.hash < b.entry.hash; });
+
+    ShaderCacheHeader header = {SHADER_CACHE_MAGIC, SHADER_CACHE_VERSION, SHADER_SIGNATURE_VERSION,
+                                OGRE_VERSION, getDeviceHash(), uint32(records.size())};
+    stream->write(&header, sizeof(header));
+
+    uint32 offset = uint32(sizeof(ShaderCacheHeader) + records.size() * sizeof(ShaderCacheEntry));
+    for (auto& r : records)
+    {
+        r.entry.signatureOffset = offset;
+        offset += r.entry.signatureSize;
+        r.entry.nameOffset = offset;
+        offset += r.entry.nameSize;
+        r.entry.sourceOffset = offset;
+        offset += r.entry.sourceSize;
+        r.entry.microcodeOffset = offset;
+        offset += r.entry.microcodeSize;
+        stream->write(&r.entry, sizeof(ShaderCacheEntry));
+    }
+
+    for (const auto& r : records)
+    {
+        stream->write(r.data[0], r.entry.signatureSize);
+        stream->write(r.data[1], r.entry.nameSize);
+        stream->write(r.data[2], r.entry.sourceSize);
+        stream->write(r.data[3], r.entry.microcodeSize);
+    }
+}
+//-----------------------------------------------------------------------------
+bool ProgramManager::isShaderCacheDirty() const
+{
+    if (mShaderCacheDirty)
+        return true;
+
+    // the microcode of cached programs might have become available
+    auto& gpuProgramMgr = GpuProgramManager::getSingleton();
+    for (const auto& sig : mSignatureCache)
+    {
+        auto e = findCacheEntry(mShaderCacheData, sig.first);
+        if (e && !e->microcodeSize && gpuProgramMgr.isMicrocodeAvailableInCache(e->microcodeId))
+            return true;
+    }
+    return false;
 }
 //-----------------------------------------------------------------------------
 void ProgramManager::createDefaultProgramProcessors()
@@ -114,13 +360,56 @@ void ProgramManager::destroyDefaultProgramProcessors()
 }
 
 //-----------------------------------------------------------------------------
-void ProgramManager::createGpuPrograms(ProgramSet* programSet)
+void ProgramManager::prepareGpuPrograms(ProgramSet* programSet)
 {
     // Before we start we need to make sure that the pixel shader input
     //  parameters are the same as the vertex output, this required by 
     //  shader models 4 and 5.
     matchVStoPSInterface(programSet);
 
+    ProgramProcessor* programProcessor = mDefaultProgramProcessors.front();
+
+    // Call the pre creation of GPU programs method.
+    if (!programProcessor->preCreateGpuPrograms(programSet))
+        OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR, "preCreateGpuPrograms failed");
+
+    const ShaderGenerator& shaderGen = ShaderGenerator::getSingleton();
+    const String& language = shaderGen.getTargetLanguage();
+    auto programWriter = ProgramWriterManager::getSingleton().getProgramWriter(language);
+
+    for(auto type : {GPT_VERTEX_PROGRAM, GPT_FRAGMENT_PROGRAM})
+    {
+        Program* shaderProgram = programSet->getCpuProgram(type);
+
+        if (shaderGen.getTargetLinearColours())
+        {
+            shaderProgram->addPreprocessorDefines("USE_LINEAR_COLOURS,TARGET_CONSUMES_LINEAR");
+            shaderProgram->setUseLinearColours(true);
+        }
+
+        generateSignature(programSet->mSignatures[type], shaderProgram, language,
+                          shaderGen.getShaderProfiles(type));
+    }
+
+    // Writing the source code renames shared parameters, so only do this after computing all signatures.
+    for(auto type : {GPT_VERTEX_PROGRAM, GPT_FRAGMENT_PROGRAM})
+    {
+        // The source code is only needed for programs we did not create yet.
+        const String& signature = programSet->mSignatures[type];
+        if (mSignatureCache.find(signature) == mSignatureCache.end() &&
+            !findCacheEntry(mShaderCacheData, signature))
+            programSet->mSources[type] = generateSourceCode(programSet->getCpuProgram(type), programWriter);
+    }
+
+    programSet->mPrepared = true;
+}
+
+//-----------------------------------------------------------------------------
+void ProgramManager::createGpuPrograms(ProgramSet* programSet)
+{
+    if (!programSet->mPrepared)
+        prepareGpuPrograms(programSet);
+
     // Grab the matching writer.
     const String& language = ShaderGenerator::getSingleton().getTargetLanguage();
 
@@ -128,18 +417,18 @@ void ProgramManager::createGpuPrograms(ProgramSet* programSet)
 
     ProgramProcessor* programProcessor = mDefaultProgramProcessors.front();
     
-    // Call the pre creation of GPU programs method.
-    if (!programProcessor->preCreateGpuPrograms(programSet))
-        OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR, "preCreateGpuPrograms failed");
-    
     // Create the shader programs
     for(auto type : {GPT_VERTEX_PROGRAM, GPT_FRAGMENT_PROGRAM})
     {
-        auto gpuProgram = createGpuProgram(programSet->getCpuProgram(type), programWriter, language,
+        auto gpuProgram = createGpuProgram(programSet, type, programWriter, language,
                                            ShaderGenerator::getSingleton().getShaderProfiles(type),
                                            ShaderGenerator::getSingleton().getShaderCachePath());
         programSet->setGpuProgram(gpuProgram);
+
+        programSet->mSignatures[type].clear();
+        programSet->mSources[type].clear();
     }
+    programSet->mPrepared = false;
 
     // update VS flags
     auto gpuVs = programSet->getGpuProgram(GPT_VERTEX_PROGRAM);
@@ -153,36 +442,65 @@ void ProgramManager::createGpuPrograms(ProgramSet* programSet)
 }
 
 //-----------------------------------------------------------------------------
-GpuProgramPtr ProgramManager::createGpuProgram(Program* shaderProgram, 
+GpuProgramPtr ProgramManager::createGpuProgram(ProgramSet* programSet,
+                                               GpuProgramType type,
                                                ProgramWriter* programWriter,
                                                const String& language,
                                                const String& profiles,
                                                const String& cachePath)
 {
-    std::stringstream sourceCodeStringStream;
-
-    // Generate source code.
-    programWriter->writeSourceCode(sourceCodeStringStream, shaderProgram);
-    String source = sourceCodeStringStream.str();
+    Program* shaderProgram = programSet->getCpuProgram(type);
+    const String& signature = programSet->mSignatures[type];
 
-    if (ShaderGenerator::getSingleton().getTargetLinearColours())
+    // Programs with the same signature were generated from the same source code.
+    auto it = mSignatureCache.find(signature);
+    if (it != mSignatureCache.end())
     {
-        shaderProgram->addPreprocessorDefines("USE_LINEAR_COLOURS,TARGET_CONSUMES_LINEAR");
-        shaderProgram->setUseLinearColours(true);
+        if (auto pGpuProgram = GpuProgramManager::getSingleton().getByName(it->second, RGN_INTERNAL))
+            return pGpuProgram;
     }
 
-    // Generate program name.
-    String programName = generateHash(source, shaderProgram->getPreprocessorDefines());
-
-    if (shaderProgram->getType() == GPT_VERTEX_PROGRAM)
+    String programName;
+    String& source = programSet->mSources[type];
+    auto cacheEntry = findCacheEntry(mShaderCacheData, signature);
+    if (cacheEntry)
     {
-        programName += "_VS";
+        // Take the program from the shader cache, along with its microcode if any.
+        programName = getCacheString(mShaderCacheData, cacheEntry->nameOffset, cacheEntry->nameSize);
+        source = getCacheString(mShaderCacheData, cacheEntry->sourceOffset, cacheEntry->sourceSize);
+
+        auto& gpuProgramMgr = GpuProgramManager::getSingleton();
+        if (cacheEntry->microcodeSize && !gpuProgramMgr.isMicrocodeAvailableInCache(cacheEntry->microcodeId))
+        {
+            auto microcode = GpuProgramManager::createMicrocode(cacheEntry->microcodeSize);
+            memcpy(microcode->getPtr(), mShaderCacheData->getPtr() + cacheEntry->microcodeOffset,
+                   cacheEntry->microcodeSize);
+            gpuProgramMgr.addMicrocodeToCache(cacheEntry->microcodeId, microcode);
+        }
     }
-    else if (shaderProgram->getType() == GPT_FRAGMENT_PROGRAM)
+    else
     {
-        programName += "_FS";
+        // Generate source code, unless done by prepareGpuPrograms.
+        if (source.empty())
+            source = generateSourceCode(shaderProgram, programWriter);
+
+        // Generate program name.
+        programName = generateHash(source, shaderProgram->getPreprocessorDefines());
+
+        if (shaderProgram->getType() == GPT_VERTEX_PROGRAM)
+        {
+            programName += "_VS";
+        }
+        else if (shaderProgram->getType() == GPT_FRAGMENT_PROGRAM)
+        {
+            programName += "_FS";
+        }
+
+        mShaderCacheDirty = true;
     }
 
+    mSignatureCache[signature] = programName;
+
     // Try to get program by name.
     auto pGpuProgram = GpuProgramManager::getSingleton().getByName(programName, RGN_INTERNAL);
 
@@ -196,7 +514,7 @@ GpuProgramPtr ProgramManager::createGpuProgram(Program* shaderProgram,
         GpuProgramManager::getSingleton().createProgram(programName, RGN_INTERNAL, language, shaderProgram->getType());
 
     // Case cache directory specified -> create program from file.
-    if (!cachePath.empty())
+    if (!cachePath.empty() && !cacheEntry)
     {
         const String  programFullName = programName + "." + programWriter->getTargetLanguage();
         const String  programFileName = cachePath + programFullName;
@@ -250,6 +568,97 @@ GpuProgramPtr ProgramManager::createGpuProgram(Program* shaderProgram,
     return pGpuProgram;
 }
 
+//-----------------------------------------------------------------------------
+String ProgramManager::generateSourceCode(Program* shaderProgram, ProgramWriter* programWriter)
+{
+    std::stringstream sourceCodeStringStream;
+    programWriter->writeSourceCode(sourceCodeStringStream, shaderProgram);
+    return sourceCodeStringStream.str();
+}
+
+//-----------------------------------------------------------------------------
+template <typename T> static void appendValue(String& sig, const T& val)
+{
+    sig.append(reinterpret_cast<const char*>(&val), sizeof(T));
+}
+
+static void appendString(String& sig, const String& str)
+{
+    sig += str;
+    sig += '\0';
+}
+
+static void appendParameters(String& sig, const ShaderParameterList& params)
+{
+    appendValue(sig, params.size());
+    for (const auto& p : params)
+    {
+        appendString(sig, p->toString());
+        appendString(sig, p->getStructType());
+        appendValue(sig, p->getType());
+        appendValue(sig, p->getSemantic());
+        appendValue(sig, p->getIndex());
+        appendValue(sig, p->getContent());
+        appendValue(sig, p->getSize());
+        appendValue(sig, p->isHighP());
+    }
+}
+
+void ProgramManager::generateSignature(String& sig, Program* shaderProgram, const String& language,
+                                       const String& profiles)
+{
+    sig.clear();
+    appendValue(sig, shaderProgram->getType());
+    appendString(sig, language);
+    appendString(sig, profiles);
+    appendString(sig, shaderProgram->getPreprocessorDefines());
+    appendValue(sig, shaderProgram->getUseColumnMajorMatrices());
+
+    for (size_t i = 0; i < shaderProgram->getDependencyCount(); ++i)
+        appendString(sig, shaderProgram->getDependency(i));
+    sig += '\0';
+
+    for (const auto& shared : shaderProgram->getSharedParameters())
+    {
+        appendString(sig, shared->getName());
+        for (const auto& e : shared->getConstantDefinitionsSorted())
+        {
+            appendString(sig, e.first);
+            appendValue(sig, e.second.constType);
+            appendValue(sig, e.second.arraySize);
+        }
+        sig += '\0';
+    }
+    sig += '\0';
+
+    // auto constants do not show up in the source code, but they are bound to the shared
+    // default parameters of the GpuProgram, so keep them apart
+    for (const auto& p : shaderProgram->getParameters())
+    {
+        appendString(sig, p->getName());
+        appendValue(sig, p->getType());
+        appendValue(sig, p->getIndex());
+        appendValue(sig, p->getSize());
+        appendValue(sig, p->isHighP());
+        appendValue(sig, p->isAutoConstantParameter());
+        if (!p->isAutoConstantParameter())
+            continue;
+        appendValue(sig, p->getAutoConstantType());
+        if (p->isAutoConstantRealParameter())
+            appendValue(sig, p->getAutoConstantRealData());
+        else
+            appendValue(sig, p->getAutoConstantIntData());
+    }
+    sig += '\0';
+
+    Function* main = shaderProgram->getMain();
+    appendParameters(sig, main->getInputParameters());
+    appendParameters(sig, main->getOutputParameters());
+    appendParameters(sig, main->getLocalParameters());
+
+    for (const auto& atom : main->getAtomInstances())
+        atom->_appendSignature(sig);
+}
 
 //-----------------------------------------------------------------------------
 String ProgramManager::generateHash(const String& programString, const String& defines)
@@ -31,7 +31,7 @@ namespace Ogre {
 namespace RTShader {
 
 //-----------------------------------------------------------------------------
-ProgramSet::ProgramSet() {}
+ProgramSet::ProgramSet() : mPrepared(false) {}
 
 //-----------------------------------------------------------------------------
 ProgramSet::~ProgramSet() {}
@@ -135,7 +135,7 @@ void ProgramWriter::writeParameterSemantic(std::ostream& os, const ParameterPtr&
 }
 
 void ProgramWriter::redirectGlobalWrites(std::ostream& os, FunctionAtom* func, const ShaderParameterList& inputs,
-                                         const UniformParameterList& uniforms)
+                                         const UniformParameterList& uniforms, std::set<String>& localRenames)
 {
     for (auto& operand : func->getOperandList())
     {
@@ -157,7 +157,7 @@ void ProgramWriter::redirectGlobalWrites(std::ostream& os, FunctionAtom* func, c
         }
 
         // now we check if we already declared a redirector var
-        if (doLocalRename && mLocalRenames.find(param->getName()) == mLocalRenames.end())
+        if (doLocalRename && localRenames.find(param->getName()) == localRenames.end())
         {
             // Declare the copy variable and assign the original
             String newVar = "local_" + param->getName();
@@ -166,7 +166,7 @@ void ProgramWriter::redirectGlobalWrites(std::ostream& os, FunctionAtom* func, c
 
             // From now on we replace it automatic
             param->_rename(newVar, true);
-            mLocalRenames.insert(newVar);
+            localRenames.insert(newVar);
         }
     }
 }
@@ -157,9 +157,16 @@ void TargetRenderState::bindUniformParameters(Program* pCpuProgram, const GpuPro
     }
 }
 
-void TargetRenderState::acquirePrograms(Pass* pass)
+void TargetRenderState::preparePrograms()
 {
     createCpuPrograms();
+    ProgramManager::getSingleton().prepareGpuPrograms(mProgramSet.get());
+}
+
+void TargetRenderState::acquirePrograms(Pass* pass)
+{
+    if (!mProgramSet || !mProgramSet->mPrepared)
+        createCpuPrograms();
     ProgramManager::getSingleton().createGpuPrograms(mProgramSet.get());
 
     bool hasError = false;
@@ -286,6 +286,8 @@ namespace Ogre
         static const uint16 TERRAINDERIVEDDATA_CHUNK_VERSION;
         static const uint32 TERRAINGENERALINFO_CHUNK_ID;
         static const uint16 TERRAINGENERALINFO_CHUNK_VERSION;
+        static const uint32 TERRAINPAGE_ID;
+        static const uint16 TERRAINPAGE_VERSION;
 
         static const uint32 LOD_MORPH_CUSTOM_PARAM;
 
@@ -681,6 +683,7 @@ namespace Ogre
             terrain. If the filename includes path specifiers then it is saved
             directly instead (but note that it may not be reloadable via the
             resource system if the location is not on the path). 
+        @see TerrainGlobalOptions::setUseCompactPageFormat
         */
         void save(const String& filename);
         /** Save terrain data in native form to a serializing stream.
@@ -689,6 +692,12 @@ namespace Ogre
             this form.
         */
         void save(StreamSerialiser& stream);
+        /** Save terrain data as a compact page to a stream.
+
+            Terrain::prepare(DataStreamPtr&) reads it back.
+        @see TerrainGlobalOptions::setUseCompactPageFormat
+        */
+        void savePage(const DataStreamPtr& stream);
 
         /** Prepare the terrain from a standalone file.
         @note
@@ -700,7 +709,7 @@ namespace Ogre
         /** Prepare terrain data from saved data.
 
             This is safe to do in a background thread as it creates no GPU resources.
-            It reads data from a native terrain data chunk. 
+            It reads data from a native terrain data chunk or a compact page.
         @return true if the preparation was successful
         */
         bool prepare(DataStreamPtr& stream);
@@ -1609,6 +1618,11 @@ namespace Ogre
         }
         void freeLodData();
 
+        /// Recalculate modified height deltas before they get written out
+        void finaliseHeightDeltasForSave();
+        /// Read the compact page format, see TerrainGlobalOptions::setUseCompactPageFormat
+        bool preparePage(const DataStreamPtr& stream);
+
         void freeCPUResources();
         void freeGPUResources();
         void determineLodLevels();
@@ -1634,6 +1648,8 @@ namespace Ogre
         */
         void getPointAlign(uint32 x, uint32 y, float height, Alignment align, Vector3* outpos) const;
         void calculateCurrentLod(Viewport* vp);
+        /// Lightmap for rect (lightmap space) by sweeping the horizon along the light direction
+        void calculateHorizonLightmap(const Rect& rect, const Vector3& lightVec, uint8* pData);
 
         /// Delete blend maps for all layers >= lowIndex
         void deleteBlendMaps(uint8 lowIndex);
@@ -1855,6 +1871,8 @@ namespace Ogre
         Real mCompositeMapDistance;
         String mResourceGroup;
         bool mUseVertexCompressionWhenAvailable;
+        bool mUseHorizonLightMap;
+        bool mUseCompactPageFormat;
 
     public:
         TerrainGlobalOptions();
@@ -1875,6 +1893,33 @@ namespace Ogre
         const Vector3& getLightMapDirection() const { return mLightMapDir; }
         /** Set the shadow map light direction to use (world space). */
         void setLightMapDirection(const Vector3& v) { mLightMapDir = v; }
+        /// Whether lightmaps are computed by a horizon sweep instead of per texel raycasts
+        bool getUseHorizonLightMap() const { return mUseHorizonLightMap; }
+        /** Set whether lightmaps are computed by a horizon sweep instead of per texel raycasts.
+
+            The sweep walks lines parallel to the light direction and carries the
+            shadow cast by the heights passed so far, which makes it O(1) per texel
+            and lets it run in parallel on the WorkQueue. This makes moving the light
+            interactive on large terrains. Shadows are resolved at lightmap rather
+            than at height data resolution and only cast from direct neighbours.
+            It defaults to false.
+        */
+        void setUseHorizonLightMap(bool enabled) { mUseHorizonLightMap = enabled; }
+        /// Whether Terrain::save(const String&) writes the compact page format
+        bool getUseCompactPageFormat() const { return mUseCompactPageFormat; }
+        /** Set whether Terrain::save(const String&) writes the compact page format.
+
+            A page is a fixed header followed by 16 byte aligned sections holding
+            16 bit quantized heights and deltas and the derived maps in the pixel
+            formats of their textures. Loading it is a single read, or none if the
+            archive is memory mapped, followed by a dequantization of the heights
+            instead of decompressing and parsing chunks, which keeps streaming
+            TerrainGroup pages cheap. Heights lose precision to 1/65535 of the
+            height range of the page and the format is only readable on platforms
+            with the same byte order. Terrain::prepare detects either format.
+            It defaults to false.
+        */
+        void setUseCompactPageFormat(bool enabled) { mUseCompactPageFormat = enabled; }
         /// Get the composite map ambient light to use 
         const ColourValue& getCompositeMapAmbient() const { return mCompositeMapAmbient; }
         /// Set the composite map ambient light to use 
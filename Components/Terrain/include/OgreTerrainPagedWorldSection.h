@@ -172,6 +172,9 @@ namespace Ogre
         unsigned long mNextLoadingTime;
         uint32 mLoadingIntervalMs;
 
+        /// Load priority of a requested page, lower is more urgent
+        Real getPagePriority(PageID pageID);
+
         /// WorkQueue::RequestHandler override
         WorkQueue::Response* handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ);
         /// WorkQueue::ResponseHandler override
@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include "OgreTerrainQuadTreeNode.h"
 #include "OgreStreamSerialiser.h"
 #include "OgreMath.h"
+#include "OgreArrayMath.h"
 #include "OgreCamera.h"
 #include "OgreImage.h"
 #include "OgrePixelFormat.h"
@@ -71,6 +72,8 @@ namespace Ogre
     const uint16 Terrain::TERRAINLAYERINSTANCE_CHUNK_VERSION = 1;
     const uint32 Terrain::TERRAINDERIVEDDATA_CHUNK_ID = StreamSerialiser::makeIdentifier("TDDA");
     const uint16 Terrain::TERRAINDERIVEDDATA_CHUNK_VERSION = 1;
+    const uint32 Terrain::TERRAINPAGE_ID = StreamSerialiser::makeIdentifier("TPAG");
+    const uint16 Terrain::TERRAINPAGE_VERSION = 1;
     // since 129^2 is the greatest power we can address in 16-bit index
     const uint16 Terrain::TERRAIN_MAX_BATCH_SIZE = 129; 
     const uint32 Terrain::LOD_MORPH_CUSTOM_PARAM = 1001;
@@ -111,6 +114,8 @@ namespace Ogre
         , mCompositeMapDistance(4000)
         , mResourceGroup(ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME)
         , mUseVertexCompressionWhenAvailable(true)
+        , mUseHorizonLightMap(false)
+        , mUseCompactPageFormat(false)
     {
     }
     //---------------------------------------------------------------------
@@ -277,17 +282,26 @@ namespace Ogre
             mLodManager->close();
         }
 
+        bool compactPage = TerrainGlobalOptions::getSingleton().getUseCompactPageFormat();
         {
             DataStreamPtr stream = Root::createFileStream(filename, _getDerivedResourceGroup(), true);
-            StreamSerialiser ser(stream);
-            save(ser);
+            if (compactPage)
+            {
+                savePage(stream);
+            }
+            else
+            {
+                StreamSerialiser ser(stream);
+                save(ser);
+            }
         }
 
-        if (mLodManager && wasOpen)
+        // a page holds all LODs in memory, so there is nothing to stream from it
+        if (mLodManager && wasOpen && !compactPage)
             mLodManager->open(filename);
     }
     //---------------------------------------------------------------------
-    void Terrain::save(StreamSerialiser& stream)
+    void Terrain::finaliseHeightDeltasForSave()
     {
         // wait for any queued processes to finish
         waitForDerivedProcesses();
@@ -302,6 +316,11 @@ namespace Ogre
             calculateHeightDeltas(rect);
             finaliseHeightDeltas(rect, false);
         }
+    }
+    //---------------------------------------------------------------------
+    void Terrain::save(StreamSerialiser& stream)
+    {
+        finaliseHeightDeltasForSave();
 
         stream.writeChunkBegin(TERRAIN_CHUNK_ID, TERRAIN_CHUNK_VERSION);
 
@@ -459,6 +478,202 @@ namespace Ogre
 
     }
     //---------------------------------------------------------------------
+    namespace
+    {
+        enum PageSection
+        {
+            PS_HEIGHTS,
+            PS_DELTAS,
+            PS_LAYERS,
+            PS_BLENDMAPS,
+            PS_NORMALMAP,
+            PS_COLOURMAP,
+            PS_LIGHTMAP,
+            PS_COMPOSITEMAP,
+            PS_COUNT
+        };
+
+        const uint16 PAGE_BYTE_ORDER_MARK = 0xFEFF;
+        const size_t PAGE_SECTION_ALIGN = 16;
+
+        /// Fixed size start of a compact terrain page, offsets are relative to it
+        struct TerrainPageHeader
+        {
+            uint32 id;
+            uint16 version;
+            uint16 byteOrderMark;
+            double worldSize;
+            double pos[3];
+            float heightBase;
+            float heightScale;
+            float deltaBase;
+            float deltaScale;
+            uint16 size;
+            uint16 maxBatchSize;
+            uint16 minBatchSize;
+            uint16 layerBlendMapSize;
+            uint16 normalMapSize;
+            uint16 colourMapSize;
+            uint16 lightmapSize;
+            uint16 compositeMapSize;
+            uint8 align;
+            uint8 padding[3];
+            uint32 offsets[PS_COUNT];
+            uint32 sizes[PS_COUNT];
+        };
+
+        void quantizePageData(const float* src, size_t count, uint16* dst, float& base, float& scale)
+        {
+            auto range = std::minmax_element(src, src + count);
+            base = *range.first;
+            scale = (*range.second - base) / 65535.0f;
+            float invScale = scale > 0 ? 1.0f / scale : 0.0f;
+            for (size_t i = 0; i < count; ++i)
+                dst[i] = uint16(std::min((src[i] - base) * invScale + 0.5f, 65535.0f));
+        }
+
+        void dequantizePageData(const uint16* src, size_t count, float base, float scale, float* dst)
+        {
+            for (size_t i = 0; i < count; ++i)
+                dst[i] = base + src[i] * scale;
+        }
+
+        /// Pad the stream to the next section boundary and return the section offset
+        uint32 beginPageSection(const DataStreamPtr& stream, size_t start)
+        {
+            static const uint8 padding[PAGE_SECTION_ALIGN] = {0};
+            size_t offset = stream->tell() - start;
+            size_t aligned = (offset + PAGE_SECTION_ALIGN - 1) & ~(PAGE_SECTION_ALIGN - 1);
+            stream->write(padding, aligned - offset);
+            return uint32(aligned);
+        }
+
+        /// Write a derived map, reading it back from its texture if it only lives on the GPU
+        uint32 writePageMap(const DataStreamPtr& stream, const Image& cpuMap, const TexturePtr& tex,
+                            PixelFormat format, uint16 size)
+        {
+            if (cpuMap.getData())
+            {
+                stream->write(cpuMap.getData(), cpuMap.getSize());
+                return uint32(cpuMap.getSize());
+            }
+            Image tmp(format, size, size);
+            tex->getBuffer()->blitToMemory(tmp.getPixelBox());
+            stream->write(tmp.getData(), tmp.getSize());
+            return uint32(tmp.getSize());
+        }
+
+        void readPageMap(const uchar* page, const TerrainPageHeader& header, PageSection section,
+                         PixelFormat format, uint16 size, Image& dst)
+        {
+            dst.create(format, size, size);
+            if (header.sizes[section] != dst.getSize())
+                OGRE_EXCEPT(Exception::ERR_INVALID_STATE, "corrupt terrain page", "Terrain::prepare");
+            memcpy(dst.getData(), page + header.offsets[section], dst.getSize());
+        }
+    }
+    //---------------------------------------------------------------------
+    void Terrain::savePage(const DataStreamPtr& stream)
+    {
+        finaliseHeightDeltasForSave();
+        checkLayers(false);
+
+        TerrainPageHeader header;
+        memset(&header, 0, sizeof(header));
+        header.id = TERRAINPAGE_ID;
+        header.version = TERRAINPAGE_VERSION;
+        header.byteOrderMark = PAGE_BYTE_ORDER_MARK;
+        header.worldSize = mWorldSize;
+        header.pos[0] = mPos.x;
+        header.pos[1] = mPos.y;
+        header.pos[2] = mPos.z;
+        header.size = mSize;
+        header.maxBatchSize = mMaxBatchSize;
+        header.minBatchSize = mMinBatchSize;
+        header.align = (uint8)mAlign;
+
+        size_t start = stream->tell();
+        stream->write(&header, sizeof(header));
+
+        size_t numVertices = size_t(mSize) * mSize;
+        std::vector<uint16> quantized(numVertices);
+
+        quantizePageData(mHeightData, numVertices, quantized.data(), header.heightBase, header.heightScale);
+        header.offsets[PS_HEIGHTS] = beginPageSection(stream, start);
+        header.sizes[PS_HEIGHTS] = uint32(stream->write(quantized.data(), numVertices * sizeof(uint16)));
+
+        quantizePageData(mDeltaData, numVertices, quantized.data(), header.deltaBase, header.deltaScale);
+        header.offsets[PS_DELTAS] = beginPageSection(stream, start);
+        header.sizes[PS_DELTAS] = uint32(stream->write(quantized.data(), numVertices * sizeof(uint16)));
+
+        // layers and the per node LOD deltas are small, so they keep the chunked form
+        header.offsets[PS_LAYERS] = beginPageSection(stream, start);
+        {
+            StreamSerialiser ser(stream);
+            writeLayerDeclaration(mLayerDecl, ser);
+            writeLayerInstanceList(mLayers, ser);
+            mQuadTree->save(ser);
+        }
+        header.sizes[PS_LAYERS] = uint32(stream->tell() - start - header.offsets[PS_LAYERS]);
+
+        header.offsets[PS_BLENDMAPS] = beginPageSection(stream, start);
+        int numBlendTex = getBlendTextureCount((uint8)mLayers.size());
+        if (!mCpuBlendMapStorage.empty())
+        {
+            header.layerBlendMapSize = mLayerBlendMapSize;
+            for (int i = 0; i < numBlendTex; ++i)
+                header.sizes[PS_BLENDMAPS] += uint32(
+                    stream->write(mCpuBlendMapStorage[i].getData(), mCpuBlendMapStorage[i].getSize()));
+        }
+        else
+        {
+            header.layerBlendMapSize = mLayerBlendMapSizeActual;
+            Image tmp(PF_BYTE_RGBA, mLayerBlendMapSizeActual, mLayerBlendMapSizeActual);
+            for (const auto& tex : mBlendTextureList)
+            {
+                tex->getBuffer()->blitToMemory(tmp.getPixelBox());
+                header.sizes[PS_BLENDMAPS] += uint32(stream->write(tmp.getData(), tmp.getSize()));
+            }
+        }
+
+        if (mNormalMapRequired)
+        {
+            header.normalMapSize = mSize;
+            header.offsets[PS_NORMALMAP] = beginPageSection(stream, start);
+            header.sizes[PS_NORMALMAP] =
+                writePageMap(stream, mCpuTerrainNormalMap, mTerrainNormalMap, PF_BYTE_RGB, mSize);
+        }
+        if (mGlobalColourMapEnabled)
+        {
+            header.colourMapSize = mGlobalColourMapSize;
+            header.offsets[PS_COLOURMAP] = beginPageSection(stream, start);
+            header.sizes[PS_COLOURMAP] =
+                writePageMap(stream, mCpuColourMap, mColourMap, PF_BYTE_RGB, mGlobalColourMapSize);
+        }
+        if (mLightMapRequired)
+        {
+            header.lightmapSize = mLightmapSize;
+            header.offsets[PS_LIGHTMAP] = beginPageSection(stream, start);
+            header.sizes[PS_LIGHTMAP] = writePageMap(stream, mCpuLightmap, mLightmap, PF_L8, mLightmapSize);
+        }
+        if (mCompositeMapRequired)
+        {
+            header.compositeMapSize = mCompositeMapSize;
+            header.offsets[PS_COMPOSITEMAP] = beginPageSection(stream, start);
+            header.sizes[PS_COMPOSITEMAP] =
+                writePageMap(stream, mCpuCompositeMap, mCompositeMap, PF_BYTE_RGBA, mCompositeMapSize);
+        }
+
+        // now that the layout is known, fill in the header
+        size_t end = stream->tell();
+        stream->seek(start);
+        stream->write(&header, sizeof(header));
+        stream->seek(end);
+
+        mModified = false;
+        mHeightDataModified = false;
+    }
+    //---------------------------------------------------------------------
     void Terrain::writeLayerDeclaration(const TerrainLayerDeclaration& decl, StreamSerialiser& stream)
     {
         // Layer declaration
@@ -575,6 +790,17 @@ namespace Ogre
     bool Terrain::prepare(DataStreamPtr& stream)
     {
         freeLodData();
+
+        uint32 id = 0;
+        size_t actuallyRead = stream->read(&id, sizeof(uint32));
+        stream->skip(0 - (long)actuallyRead);
+        if (id == TERRAINPAGE_ID)
+        {
+            // all LODs are in the page, nothing is streamed later
+            mLodManager = OGRE_NEW TerrainLodManager( this );
+            return preparePage(stream);
+        }
+
         mLodManager = OGRE_NEW TerrainLodManager( this, stream );
         StreamSerialiser ser(stream);
         return prepare(ser);
@@ -732,6 +958,127 @@ namespace Ogre
         return true;
     }
     //---------------------------------------------------------------------
+    bool Terrain::preparePage(const DataStreamPtr& stream)
+    {
+        mPrepareInProgress = true;
+
+        freeTemporaryResources();
+        freeCPUResources();
+
+        copyGlobalOptions();
+
+        // the page is read in place, which is free if the archive is memory mapped
+        MemoryDataStreamPtr pageStream = std::dynamic_pointer_cast<MemoryDataStream>(stream);
+        if (!pageStream)
+            pageStream = std::make_shared<MemoryDataStream>(stream);
+        const uchar* page = pageStream->getCurrentPtr();
+        size_t pageSize = pageStream->size() - pageStream->tell();
+
+        TerrainPageHeader header;
+        if (pageSize < sizeof(header))
+            return false;
+        memcpy(&header, page, sizeof(header));
+        if (header.id != TERRAINPAGE_ID || header.version != TERRAINPAGE_VERSION)
+            return false;
+        if (header.byteOrderMark != PAGE_BYTE_ORDER_MARK)
+            OGRE_EXCEPT(Exception::ERR_INVALID_STATE,
+                        "terrain page '" + stream->getName() + "' was written with a different byte order",
+                        "Terrain::prepare");
+        for (int i = 0; i < PS_COUNT; ++i)
+        {
+            if (size_t(header.offsets[i]) + header.sizes[i] > pageSize)
+                OGRE_EXCEPT(Exception::ERR_INVALID_STATE,
+                            "terrain page '" + stream->getName() + "' is truncated", "Terrain::prepare");
+        }
+
+        mAlign = (Alignment)header.align;
+        mSize = header.size;
+        mWorldSize = header.worldSize;
+        mMaxBatchSize = header.maxBatchSize;
+        mMinBatchSize = header.minBatchSize;
+        mPos = Vector3(header.pos[0], header.pos[1], header.pos[2]);
+        mRootNode->setPosition(mPos);
+        updateBaseScale();
+        determineLodLevels();
+
+        size_t numVertices = size_t(mSize) * mSize;
+        if (header.sizes[PS_HEIGHTS] != numVertices * sizeof(uint16) ||
+            header.sizes[PS_DELTAS] != numVertices * sizeof(uint16))
+            OGRE_EXCEPT(Exception::ERR_INVALID_STATE, "corrupt terrain page", "Terrain::prepare");
+
+        mHeightData = OGRE_ALLOC_T(float, numVertices, MEMCATEGORY_GEOMETRY);
+        mDeltaData = OGRE_ALLOC_T(float, numVertices, MEMCATEGORY_GEOMETRY);
+        dequantizePageData(reinterpret_cast<const uint16*>(page + header.offsets[PS_HEIGHTS]), numVertices,
+                           header.heightBase, header.heightScale, mHeightData);
+        dequantizePageData(reinterpret_cast<const uint16*>(page + header.offsets[PS_DELTAS]), numVertices,
+                           header.deltaBase, header.deltaScale, mDeltaData);
+
+        DataStreamPtr layerStream = std::make_shared<MemoryDataStream>(
+            const_cast<uchar*>(page) + header.offsets[PS_LAYERS], header.sizes[PS_LAYERS], false, true);
+        StreamSerialiser ser(layerStream);
+
+        // Layer declaration
+        if (!readLayerDeclaration(ser, mLayerDecl))
+            return false;
+        checkDeclaration();
+
+        // Layers
+        if (!readLayerInstanceList(ser, mLayerDecl.size(), mLayers))
+            return false;
+        deriveUVMultipliers();
+
+        // Packed layer blend data
+        mLayerBlendMapSize = header.layerBlendMapSize;
+        mLayerBlendMapSizeActual = mLayerBlendMapSize; // for now, until we check
+        // blend textures that were never created are not in the page, they start out black
+        size_t blendMapBytes =
+            PixelUtil::getMemorySize(mLayerBlendMapSize, mLayerBlendMapSize, 1, PF_BYTE_RGBA);
+        size_t numBlendTex = blendMapBytes ? header.sizes[PS_BLENDMAPS] / blendMapBytes : 0;
+        numBlendTex = std::min(numBlendTex, (size_t)getBlendTextureCount((uint8)mLayers.size()));
+        const uchar* blendData = page + header.offsets[PS_BLENDMAPS];
+        for (size_t i = 0; i < numBlendTex; ++i)
+        {
+            mCpuBlendMapStorage.emplace_back(PF_BYTE_RGBA, mLayerBlendMapSize, mLayerBlendMapSize);
+            memcpy(mCpuBlendMapStorage.back().getData(), blendData + i * blendMapBytes, blendMapBytes);
+        }
+
+        // derived data
+        if (header.normalMapSize)
+        {
+            mNormalMapRequired = true;
+            readPageMap(page, header, PS_NORMALMAP, PF_BYTE_RGB, header.normalMapSize, mCpuTerrainNormalMap);
+        }
+        if (header.colourMapSize)
+        {
+            mGlobalColourMapEnabled = true;
+            mGlobalColourMapSize = header.colourMapSize;
+            readPageMap(page, header, PS_COLOURMAP, PF_BYTE_RGB, mGlobalColourMapSize, mCpuColourMap);
+        }
+        if (header.lightmapSize)
+        {
+            mLightMapRequired = true;
+            mLightmapSize = header.lightmapSize;
+            readPageMap(page, header, PS_LIGHTMAP, PF_L8, mLightmapSize, mCpuLightmap);
+        }
+        if (header.compositeMapSize)
+        {
+            mCompositeMapRequired = true;
+            mCompositeMapSize = header.compositeMapSize;
+            readPageMap(page, header, PS_COMPOSITEMAP, PF_BYTE_RGBA, mCompositeMapSize, mCpuCompositeMap);
+        }
+
+        // Create & load quadtree
+        mQuadTree = OGRE_NEW TerrainQuadTreeNode(this, 0, 0, 0, mSize, mNumLodLevels - 1, 0);
+        mQuadTree->prepare(ser);
+
+        mModified = false;
+        mHeightDataModified = false;
+
+        mPrepareInProgress = false;
+
+        return true;
+    }
+    //---------------------------------------------------------------------
     bool Terrain::prepare(const ImportData& importData)
     {
         mPrepareInProgress = true;
@@ -2018,6 +2365,10 @@ namespace Ogre
 
         mQuadTree->preDeltaCalculation(clampedRect);
 
+        // leaf nodes of the quadtree cover leafSize + 1 vertices
+        int leafSize = std::min(mMaxBatchSize, mSize) - 1;
+        int numLeaves = (mSize - 1) / leafSize;
+
         /// Iterate over target levels, 
         for (int targetLevel = 1; targetLevel < mNumLodLevels; ++targetLevel)
         {
@@ -2048,113 +2399,152 @@ namespace Ogre
             if (lodRect.bottom % step)
                 lodRect.bottom += step - (lodRect.bottom % step);
 
-            for (int j = lodRect.top; j < lodRect.bottom - step; j += step )
+            // Rows of quads are processed in parallel. They write disjoint vertices of
+            // mDeltaData, but notifying the quadtree per vertex would race, so each
+            // task keeps the max delta per leaf node and these are merged afterwards
+            int numQuadRows = std::max(0, (lodRect.bottom - lodRect.top) / step - 1);
+            std::vector<Real> leafMaxDelta(numLeaves * numLeaves, -std::numeric_limits<Real>::infinity());
+            std::mutex leafMutex;
+            auto calculateQuadRows = [&](size_t rowBegin, size_t rowEnd)
             {
-                for (int i = lodRect.left; i < lodRect.right - step; i += step )
+                std::vector<Real> localMaxDelta(leafMaxDelta.size(), -std::numeric_limits<Real>::infinity());
+                for (int j = lodRect.top + int(rowBegin) * step; j < lodRect.top + int(rowEnd) * step; j += step )
                 {
-                    // Form planes relating to the lower detail tris to be produced
-                    // For even tri strip rows, they are this shape:
-                    // 2---3
-                    // | / |
-                    // 0---1
-                    // For odd tri strip rows, they are this shape:
-                    // 2---3
-                    // | \ |
-                    // 0---1
-
-                    Vector3 v0, v1, v2, v3;
-                    getPointAlign(i, j, ALIGN_X_Y, &v0);
-                    getPointAlign(i + step, j, ALIGN_X_Y, &v1);
-                    getPointAlign(i, j + step, ALIGN_X_Y, &v2);
-                    getPointAlign(i + step, j + step, ALIGN_X_Y, &v3);
-
-                    Vector4 t1, t2;
-                    bool backwardTri = false;
-                    // Odd or even in terms of target level
-                    if ((j / step) % 2 == 0)
-                    {
-                        t1 = Math::calculateFaceNormalWithoutNormalize(v0, v1, v3);
-                        t2 = Math::calculateFaceNormalWithoutNormalize(v0, v3, v2);
-                    }
-                    else
-                    {
-                        t1 = Math::calculateFaceNormalWithoutNormalize(v1, v3, v2);
-                        t2 = Math::calculateFaceNormalWithoutNormalize(v0, v1, v2);
-                        backwardTri = true;
-                    }
-
-                    // include the bottommost row of vertices if this is the last row
-                    int yubound = (j == (mSize - step)? step : step - 1);
-                    for ( int y = 0; y <= yubound; y++ )
+                    for (int i = lodRect.left; i < lodRect.right - step; i += step )
                     {
-                        // include the rightmost col of vertices if this is the last col
-                        int xubound = (i == (mSize - step)? step : step - 1);
-                        for ( int x = 0; x <= xubound; x++ )
+                        // Form planes relating to the lower detail tris to be produced
+                        // For even tri strip rows, they are this shape:
+                        // 2---3
+                        // | / |
+                        // 0---1
+                        // For odd tri strip rows, they are this shape:
+                        // 2---3
+                        // | \ |
+                        // 0---1
+
+                        Vector3 v0, v1, v2, v3;
+                        getPointAlign(i, j, ALIGN_X_Y, &v0);
+                        getPointAlign(i + step, j, ALIGN_X_Y, &v1);
+                        getPointAlign(i, j + step, ALIGN_X_Y, &v2);
+                        getPointAlign(i + step, j + step, ALIGN_X_Y, &v3);
+
+                        Vector4 t1, t2;
+                        bool backwardTri = false;
+                        // Odd or even in terms of target level
+                        if ((j / step) % 2 == 0)
                         {
-                            int fulldetailx = static_cast<int>(i + x);
-                            int fulldetaily = static_cast<int>(j + y);
-                            if ( fulldetailx % step == 0 && 
-                                fulldetaily % step == 0 )
-                            {
-                                // Skip, this one is a vertex at this level
-                                continue;
-                            }
-
-                            Real ypct = (Real)y / (Real)step;
-                            Real xpct = (Real)x / (Real)step;
+                            t1 = Math::calculateFaceNormalWithoutNormalize(v0, v1, v3);
+                            t2 = Math::calculateFaceNormalWithoutNormalize(v0, v3, v2);
+                        }
+                        else
+                        {
+                            t1 = Math::calculateFaceNormalWithoutNormalize(v1, v3, v2);
+                            t2 = Math::calculateFaceNormalWithoutNormalize(v0, v1, v2);
+                            backwardTri = true;
+                        }
 
-                            //interpolated height
-                            Vector3 actualPos;
-                            getPointAlign(fulldetailx, fulldetaily, ALIGN_X_Y, &actualPos);
-                            Real interp_h;
-                            // Determine which tri we're on 
-                            if ((xpct > ypct && !backwardTri) ||
-                                (xpct > (1-ypct) && backwardTri))
-                            {
-                                // Solve for x/z
-                                interp_h = 
-                                    (-t1.x * actualPos.x
-                                    - t1.y * actualPos.y
-                                    - t1.w) / t1.z;
-                            }
-                            else
+                        // include the bottommost row of vertices if this is the last row
+                        int yubound = (j == (mSize - step)? step : step - 1);
+                        for ( int y = 0; y <= yubound; y++ )
+                        {
+                            // include the rightmost col of vertices if this is the last col
+                            int xubound = (i == (mSize - step)? step : step - 1);
+                            for ( int x = 0; x <= xubound; x++ )
                             {
-                                // Second tri
-                                interp_h = 
-                                    (-t2.x * actualPos.x
-                                    - t2.y * actualPos.y
-                                    - t2.w) / t2.z;
-                            }
-
-                            Real actual_h = actualPos.z;
-                            Real delta = interp_h - actual_h;
-
-                            // max(delta) is the worst case scenario at this LOD
-                            // compared to the original heightmap
+                                int fulldetailx = static_cast<int>(i + x);
+                                int fulldetaily = static_cast<int>(j + y);
+                                if ( fulldetailx % step == 0 && 
+                                    fulldetaily % step == 0 )
+                                {
+                                    // Skip, this one is a vertex at this level
+                                    continue;
+                                }
+
+                                Real ypct = (Real)y / (Real)step;
+                                Real xpct = (Real)x / (Real)step;
+
+                                //interpolated height
+                                Vector3 actualPos;
+                                getPointAlign(fulldetailx, fulldetaily, ALIGN_X_Y, &actualPos);
+                                Real interp_h;
+                                // Determine which tri we're on 
+                                if ((xpct > ypct && !backwardTri) ||
+                                    (xpct > (1-ypct) && backwardTri))
+                                {
+                                    // Solve for x/z
+                                    interp_h = 
+                                        (-t1.x * actualPos.x
+                                        - t1.y * actualPos.y
+                                        - t1.w) / t1.z;
+                                }
+                                else
+                                {
+                                    // Second tri
+                                    interp_h = 
+                                        (-t2.x * actualPos.x
+                                        - t2.y * actualPos.y
+                                        - t2.w) / t2.z;
+                                }
+
+                                Real actual_h = actualPos.z;
+                                Real delta = interp_h - actual_h;
+
+                                // max(delta) is the worst case scenario at this LOD
+                                // compared to the original heightmap
+
+                                // tell the leaves containing this vertex, vertices on a
+                                // boundary are shared by the adjacent leaves
+                                int leafX = fulldetailx / leafSize, leafY = fulldetaily / leafSize;
+                                for (int ly = leafY - (leafY && fulldetaily % leafSize == 0); ly <= leafY; ++ly)
+                                {
+                                    for (int lx = leafX - (leafX && fulldetailx % leafSize == 0); lx <= leafX; ++lx)
+                                    {
+                                        if (lx < numLeaves && ly < numLeaves)
+                                        {
+                                            Real& maxDelta = localMaxDelta[ly * numLeaves + lx];
+                                            maxDelta = std::max(maxDelta, delta);
+                                        }
+                                    }
+                                }
+
+
+                                // If this vertex is being removed at this LOD, 
+                                // then save the height difference since that's the move
+                                // it will need to make. Vertices to be removed at this LOD
+                                // are halfway between the steps, but exclude those that
+                                // would have been eliminated at earlier levels
+                                int halfStep = step / 2;
+                                if (
+                                 ((fulldetailx % step) == halfStep && (fulldetaily % halfStep) == 0) ||
+                                 ((fulldetaily % step) == halfStep && (fulldetailx % halfStep) == 0))
+                                {
+                                    // Save height difference 
+                                    mDeltaData[fulldetailx + (fulldetaily * mSize)] = delta;
+                                }
 
-                            // tell the quadtree about this 
-                            mQuadTree->notifyDelta(fulldetailx, fulldetaily, sourceLevel, delta);
-
-
-                            // If this vertex is being removed at this LOD, 
-                            // then save the height difference since that's the move
-                            // it will need to make. Vertices to be removed at this LOD
-                            // are halfway between the steps, but exclude those that
-                            // would have been eliminated at earlier levels
-                            int halfStep = step / 2;
-                            if (
-                             ((fulldetailx % step) == halfStep && (fulldetaily % halfStep) == 0) ||
-                             ((fulldetaily % step) == halfStep && (fulldetailx % halfStep) == 0))
-                            {
-                                // Save height difference 
-                                mDeltaData[fulldetailx + (fulldetaily * mSize)] = delta;
                             }
 
                         }
+                    } // i
+                } // j
 
-                    }
-                } // i
-            } // j
+                std::lock_guard<std::mutex> lock(leafMutex);
+                for (size_t l = 0; l < leafMaxDelta.size(); ++l)
+                    leafMaxDelta[l] = std::max(leafMaxDelta[l], localMaxDelta[l]);
+            };
+            Root::getSingleton().getWorkQueue()->parallelFor(0, numQuadRows, std::max(1, 64 / step),
+                                                             calculateQuadRows);
+
+            // tell the quadtree, via a vertex inside each leaf so only its ancestors are affected
+            for (int ly = 0; ly < numLeaves; ++ly)
+            {
+                for (int lx = 0; lx < numLeaves; ++lx)
+                {
+                    Real maxDelta = leafMaxDelta[ly * numLeaves + lx];
+                    if (maxDelta != -std::numeric_limits<Real>::infinity())
+                        mQuadTree->notifyDelta(lx * leafSize + 1, ly * leafSize + 1, sourceLevel, maxDelta);
+                }
+            }
 
         } // targetLevel
 
@@ -2996,19 +3386,24 @@ namespace Ogre
         DerivedDataResponse ddres;
         ddres.remainingTypeMask = ddr.typeMask & DERIVED_DATA_ALL;
 
-        // Do only ONE type of task per background iteration, in order of priority
+        // Do only one stage per background iteration, in order of priority
         // this means we return faster, can abort faster and we repeat less redundant calcs
         // we don't do this as separate requests, because we only want one background
-        // task per Terrain instance in flight at once
-        if (ddr.typeMask & DERIVED_DATA_DELTAS)
+        // task per Terrain instance in flight at once.
+        // Deltas and normals only read the heights, so they form one stage; each of
+        // them is split into rows processed in parallel on the WorkQueue
+        if (ddr.typeMask & (DERIVED_DATA_DELTAS | DERIVED_DATA_NORMALS))
         {
-            ddres.deltaUpdateRect = calculateHeightDeltas(ddr.dirtyRect);
-            ddres.remainingTypeMask &= ~ DERIVED_DATA_DELTAS;
-        }
-        else if (ddr.typeMask & DERIVED_DATA_NORMALS)
-        {
-            ddres.normalMapBox = calculateNormals(ddr.dirtyRect, ddres.normalUpdateRect);
-            ddres.remainingTypeMask &= ~ DERIVED_DATA_NORMALS;
+            if (ddr.typeMask & DERIVED_DATA_DELTAS)
+            {
+                ddres.deltaUpdateRect = calculateHeightDeltas(ddr.dirtyRect);
+                ddres.remainingTypeMask &= ~ DERIVED_DATA_DELTAS;
+            }
+            if (ddr.typeMask & DERIVED_DATA_NORMALS)
+            {
+                ddres.normalMapBox = calculateNormals(ddr.dirtyRect, ddres.normalUpdateRect);
+                ddres.remainingTypeMask &= ~ DERIVED_DATA_NORMALS;
+            }
         }
         else if (ddr.typeMask & DERIVED_DATA_LIGHTMAP)
         {
@@ -3145,46 +3540,82 @@ namespace Ogre
         //  | / | \ |
         //  5---6---7
 
-        for (int y = widenedRect.top; y < widenedRect.bottom; ++y)
-        {
-            for (int x = widenedRect.left; x < widenedRect.right; ++x)
+        // Rows are independent, so they are processed in parallel. Within a row the
+        // points are fetched once into a sliding window of three rows and the
+        // normals are evaluated ARRAY_PACKED_REALS at a time.
+        long width = widenedRect.width();
+        auto calculateRows = [&](size_t rowBegin, size_t rowEnd)
+        {
+            // points of the rows y-1, y and y+1, including one column either side
+            std::vector<Vector3> rowPoints[3];
+            std::vector<Vector3>* below = &rowPoints[0];
+            std::vector<Vector3>* centre = &rowPoints[1];
+            std::vector<Vector3>* above = &rowPoints[2];
+            auto fetchRow = [&](std::vector<Vector3>& row, int y)
             {
-                Vector3 cumulativeNormal = Vector3::ZERO;
-
-                // Build points to sample
-                Vector3 centrePoint;
-                Vector3 adjacentPoints[8];
-                getPointFromSelfOrNeighbour(x  , y,   &centrePoint);
-                getPointFromSelfOrNeighbour(x+1, y,   &adjacentPoints[0]);
-                getPointFromSelfOrNeighbour(x+1, y+1, &adjacentPoints[1]);
-                getPointFromSelfOrNeighbour(x,   y+1, &adjacentPoints[2]);
-                getPointFromSelfOrNeighbour(x-1, y+1, &adjacentPoints[3]);
-                getPointFromSelfOrNeighbour(x-1, y,   &adjacentPoints[4]);
-                getPointFromSelfOrNeighbour(x-1, y-1, &adjacentPoints[5]);
-                getPointFromSelfOrNeighbour(x,   y-1, &adjacentPoints[6]);
-                getPointFromSelfOrNeighbour(x+1, y-1, &adjacentPoints[7]);
-
-                for (int i = 0; i < 8; ++i)
-                {
-                    cumulativeNormal += Math::calculateBasicFaceNormal(centrePoint, adjacentPoints[i], adjacentPoints[(i+1)%8]);
-                }
+                row.resize(width + 2);
+                for (long i = 0; i < width + 2; ++i)
+                    getPointFromSelfOrNeighbour(widenedRect.left + i - 1, y, &row[i]);
+            };
+            fetchRow(*below, int(rowBegin) - 1);
+            fetchRow(*centre, int(rowBegin));
 
-                // normalise & store normal
-                cumulativeNormal.normalise();
+            for (int y = int(rowBegin); y < int(rowEnd); ++y)
+            {
+                fetchRow(*above, y + 1);
 
-                // encode as RGB, object space
                 // invert the Y to deal with image space
-                long storeX = x - widenedRect.left;
                 long storeY = widenedRect.bottom - y - 1;
+                uint8* pStoreRow = pData + storeY * width * 3;
 
-                uint8* pStore = pData + ((storeY * widenedRect.width()) + storeX) * 3;
-                *pStore++ = static_cast<uint8>((cumulativeNormal.x + 1.0f) * 0.5f * 255.0f);
-                *pStore++ = static_cast<uint8>((cumulativeNormal.y + 1.0f) * 0.5f * 255.0f);
-                *pStore++ = static_cast<uint8>((cumulativeNormal.z + 1.0f) * 0.5f * 255.0f);
+                for (long i = 0; i < width; i += ARRAY_PACKED_REALS)
+                {
+                    size_t count = std::min<size_t>(ARRAY_PACKED_REALS, width - i);
+                    ArrayVector3 centrePoint, adjacentPoints[8];
+                    centrePoint.loadPacked(&(*centre)[i + 1], count);
+                    adjacentPoints[0].loadPacked(&(*centre)[i + 2], count);
+                    adjacentPoints[1].loadPacked(&(*above)[i + 2], count);
+                    adjacentPoints[2].loadPacked(&(*above)[i + 1], count);
+                    adjacentPoints[3].loadPacked(&(*above)[i], count);
+                    adjacentPoints[4].loadPacked(&(*centre)[i], count);
+                    adjacentPoints[5].loadPacked(&(*below)[i], count);
+                    adjacentPoints[6].loadPacked(&(*below)[i + 1], count);
+                    adjacentPoints[7].loadPacked(&(*below)[i + 2], count);
+
+                    ArrayVector3 edges[8];
+                    for (int j = 0; j < 8; ++j)
+                        edges[j] = adjacentPoints[j] - centrePoint;
+
+                    ArrayVector3 cumulativeNormal(Vector3::ZERO);
+                    for (int j = 0; j < 8; ++j)
+                    {
+                        ArrayVector3 faceNormal = edges[j].crossProduct(edges[(j + 1) % 8]);
+                        faceNormal.normalise();
+                        cumulativeNormal = cumulativeNormal + faceNormal;
+                    }
+
+                    // normalise & store normal
+                    cumulativeNormal.normalise();
+                    Vector3 normals[ARRAY_PACKED_REALS];
+                    cumulativeNormal.storePacked(normals, count);
 
+                    // encode as RGB, object space
+                    uint8* pStore = pStoreRow + i * 3;
+                    for (size_t j = 0; j < count; ++j)
+                    {
+                        *pStore++ = static_cast<uint8>((normals[j].x + 1.0f) * 0.5f * 255.0f);
+                        *pStore++ = static_cast<uint8>((normals[j].y + 1.0f) * 0.5f * 255.0f);
+                        *pStore++ = static_cast<uint8>((normals[j].z + 1.0f) * 0.5f * 255.0f);
+                    }
+                }
 
+                // slide the window up one row
+                std::swap(below, centre);
+                std::swap(centre, above);
             }
-        }
+        };
+        Root::getSingleton().getWorkQueue()->parallelFor(widenedRect.top, widenedRect.bottom, 32,
+                                                         calculateRows);
 
         finalRect = widenedRect;
 
@@ -3317,47 +3748,166 @@ namespace Ogre
         PixelBox* pixbox = OGRE_NEW PixelBox(static_cast<uint32>(widenedRect.width()),
                                              static_cast<uint32>(widenedRect.height()), 1, PF_L8, pData);
 
+        if (TerrainGlobalOptions::getSingleton().getUseHorizonLightMap())
+        {
+            calculateHorizonLightmap(widenedRect, lightVec, pData);
+            return pixbox;
+        }
+
         Real heightPad = (getMaxHeight() - getMinHeight()) * 1.0e-3f;
 
-        for (long y = widenedRect.top; y < widenedRect.bottom; ++y)
+        // every texel casts its own ray, so rows are processed in parallel
+        auto calculateRows = [&](size_t rowBegin, size_t rowEnd)
         {
-            for (long x = widenedRect.left; x < widenedRect.right; ++x)
+            for (long y = long(rowBegin); y < long(rowEnd); ++y)
             {
-                float litVal = 1.0f;
+                for (long x = widenedRect.left; x < widenedRect.right; ++x)
+                {
+                    float litVal = 1.0f;
 
-                // convert to terrain space (not points, allow this to go between points)
-                float Tx = (float)x / (float)(mLightmapSizeActual-1);
-                float Ty = (float)y / (float)(mLightmapSizeActual-1);
+                    // convert to terrain space (not points, allow this to go between points)
+                    float Tx = (float)x / (float)(mLightmapSizeActual-1);
+                    float Ty = (float)y / (float)(mLightmapSizeActual-1);
 
-                // get world space point
-                // add a little height padding to stop shadowing self
-                Vector3 wpos = Vector3::ZERO;
-                getPosition(Tx, Ty, getHeightAtTerrainPosition(Tx, Ty) + heightPad, &wpos);
-                wpos += getPosition();
-                // build ray, cast backwards along light direction
-                Ray ray(wpos, -lightVec);
+                    // get world space point
+                    // add a little height padding to stop shadowing self
+                    Vector3 wpos = Vector3::ZERO;
+                    getPosition(Tx, Ty, getHeightAtTerrainPosition(Tx, Ty) + heightPad, &wpos);
+                    wpos += getPosition();
+                    // build ray, cast backwards along light direction
+                    Ray ray(wpos, -lightVec);
 
-                // Cascade into neighbours when casting, but don't travel further
-                // than world size
-                std::pair<bool, Vector3> rayHit = rayIntersects(ray, true, mWorldSize);
+                    // Cascade into neighbours when casting, but don't travel further
+                    // than world size
+                    std::pair<bool, Vector3> rayHit = rayIntersects(ray, true, mWorldSize);
 
-                if (rayHit.first)
-                    litVal = 0.0f;
+                    if (rayHit.first)
+                        litVal = 0.0f;
 
-                // encode as L8
-                // invert the Y to deal with image space
-                long storeX = x - widenedRect.left;
-                long storeY = widenedRect.bottom - y - 1;
+                    // encode as L8
+                    // invert the Y to deal with image space
+                    long storeX = x - widenedRect.left;
+                    long storeY = widenedRect.bottom - y - 1;
 
-                uint8* pStore = pData + ((storeY * widenedRect.width()) + storeX);
-                *pStore = (unsigned char)(litVal * 255.0);
+                    uint8* pStore = pData + ((storeY * widenedRect.width()) + storeX);
+                    *pStore = (unsigned char)(litVal * 255.0);
 
+                }
             }
-        }
+        };
+        Root::getSingleton().getWorkQueue()->parallelFor(widenedRect.top, widenedRect.bottom, 8, calculateRows);
 
         return pixbox;
 
 
+    }
+    //---------------------------------------------------------------------
+    void Terrain::calculateHorizonLightmap(const Rect& rect, const Vector3& lightVec, uint8* pData)
+    {
+        // Rather than casting a ray per texel, walk lines parallel to the light
+        // direction starting on the lit side. Along a line we carry the highest
+        // shadow cast by the heights passed so far, which drops by the light slope
+        // with every step; a texel below it is in shadow. Lines are independent.
+        long lmSize = mLightmapSizeActual;
+        Real texelWorldSize = mWorldSize / (lmSize - 1);
+        Real heightPad = (getMaxHeight() - getMinHeight()) * 1.0e-3f;
+
+        // direction towards the light in terrain axes (x/y along the terrain, z up)
+        Vector3 toLight = convertWorldToTerrainAxes(-lightVec);
+        Real majorDir = std::max(std::abs(toLight.x), std::abs(toLight.y));
+        if (majorDir < 1e-6f)
+        {
+            // light straight above or below
+            memset(pData, toLight.z > 0 ? 255 : 0, rect.width() * rect.height());
+            return;
+        }
+
+        bool alongX = std::abs(toLight.x) >= std::abs(toLight.y);
+        // offset along the minor axis per major axis texel
+        Real minorSlope = alongX ? toLight.y / toLight.x : toLight.x / toLight.y;
+        // drop of the carried shadow per major axis texel
+        Real shadowDrop = toLight.z * texelWorldSize / majorDir;
+        // walk away from the light
+        long step = (alongX ? toLight.x : toLight.y) > 0 ? -1 : 1;
+
+        long majorBegin = alongX ? rect.left : rect.top;
+        long majorEnd = alongX ? rect.right : rect.bottom;
+        long minorBegin = alongX ? rect.top : rect.left;
+        long minorEnd = alongX ? rect.bottom : rect.right;
+
+        OGRE_LOCK_RW_MUTEX_READ(mNeighbourMutex);
+
+        // start in the neighbour on the lit side, if any, so it can cast shadows onto us
+        Terrain* neighbours[3][3];
+        bool cascade = false;
+        for (long oy = -1; oy <= 1; ++oy)
+        {
+            for (long ox = -1; ox <= 1; ++ox)
+            {
+                neighbours[oy + 1][ox + 1] = (ox || oy) ? getNeighbour(getNeighbourIndex(ox, oy)) : this;
+                cascade |= (ox || oy) && neighbours[oy + 1][ox + 1];
+            }
+        }
+        long extent = cascade ? lmSize - 1 : 0;
+        long first = step > 0 ? -extent : lmSize - 1 + extent;
+        long last = step > 0 ? majorEnd - 1 : majorBegin;
+
+        // lines are identified by their minor axis offset at major coordinate 0; a
+        // line rounds to exactly one texel per major coordinate, so every texel in
+        // rect is written once
+        Real minOffset = std::min(majorBegin * minorSlope, (majorEnd - 1) * minorSlope);
+        Real maxOffset = std::max(majorBegin * minorSlope, (majorEnd - 1) * minorSlope);
+        long firstLine = static_cast<long>(std::floor(minorBegin - maxOffset)) - 1;
+        long lastLine = static_cast<long>(std::ceil(minorEnd - minOffset)) + 1;
+
+        Real invLmSize = 1.0f / (lmSize - 1);
+        auto sweepLines = [&](size_t lineBegin, size_t lineEnd)
+        {
+            for (size_t line = lineBegin; line < lineEnd; ++line)
+            {
+                Real offset = Real(firstLine + long(line));
+                Real shadow = -std::numeric_limits<Real>::infinity();
+                for (long u = first;; u += step)
+                {
+                    Real v = offset + u * minorSlope;
+                    Real tx = (alongX ? u : v) * invLmSize;
+                    Real ty = (alongX ? v : u) * invLmSize;
+
+                    // height in this terrain or the neighbour covering the position
+                    long ox = tx < 0 ? -1 : (tx > 1 ? 1 : 0);
+                    long oy = ty < 0 ? -1 : (ty > 1 ? 1 : 0);
+                    const Terrain* terrain = neighbours[oy + 1][ox + 1];
+                    Real height = -std::numeric_limits<Real>::infinity();
+                    if (terrain && tx - ox >= 0 && tx - ox <= 1 && ty - oy >= 0 && ty - oy <= 1)
+                        height = terrain->getHeightAtTerrainPosition(tx - ox, ty - oy);
+                    else if (tx > -invLmSize && tx < 1 + invLmSize && ty > -invLmSize && ty < 1 + invLmSize)
+                        // rounded onto an edge texel
+                        height = getHeightAtTerrainPosition(Math::Clamp<Real>(tx, 0, 1), Math::Clamp<Real>(ty, 0, 1));
+
+                    shadow -= shadowDrop;
+                    if (u >= majorBegin && u < majorEnd)
+                    {
+                        long minor = static_cast<long>(std::floor(v + 0.5f));
+                        if (minor >= minorBegin && minor < minorEnd)
+                        {
+                            long x = alongX ? u : minor;
+                            long y = alongX ? minor : u;
+                            // encode as L8, invert the Y to deal with image space
+                            long storeX = x - rect.left;
+                            long storeY = rect.bottom - y - 1;
+                            // test the texel itself, the line passes up to half a texel beside it
+                            Real texelHeight = getHeightAtTerrainPosition(x * invLmSize, y * invLmSize);
+                            pData[storeY * rect.width() + storeX] = shadow > texelHeight + heightPad ? 0 : 255;
+                        }
+                    }
+                    shadow = std::max(shadow, height);
+
+                    if (u == last)
+                        break;
+                }
+            }
+        };
+        Root::getSingleton().getWorkQueue()->parallelFor(0, lastLine - firstLine + 1, 16, sweepLines);
     }
     //---------------------------------------------------------------------
     void Terrain::finaliseLightmap(const Rect& rect, PixelBox* lightmapBox)
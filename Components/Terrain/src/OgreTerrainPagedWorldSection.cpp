@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "OgreTerrainGroup.h"
 #include "OgreGrid2DPageStrategy.h"
 #include "OgrePagedWorld.h"
+#include "OgrePage.h"
 #include "OgrePageManager.h"
 #include "OgreRoot.h"
 #include "OgreTimer.h"
@@ -275,6 +276,12 @@ namespace Ogre
         }
     }
     //---------------------------------------------------------------------
+    Real TerrainPagedWorldSection::getPagePriority(PageID pageID)
+    {
+        Page* page = getPage(pageID);
+        return page ? page->getLoadPriority() : std::numeric_limits<Real>::max();
+    }
+    //---------------------------------------------------------------------
     WorkQueue::Response* TerrainPagedWorldSection::handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
     {
         if(mPagesInLoading.empty())
@@ -318,6 +325,9 @@ namespace Ogre
             mTerrainGroup->loadTerrain(x, y, false);
             mPagesInLoading.pop_front();
 
+            // load the most urgent pages first; pages unknown to the section go last
+            mPagesInLoading.sort([this](PageID a, PageID b) { return getPagePriority(a) < getPagePriority(b); });
+
             unsigned long currentTime = Root::getSingletonPtr()->getTimer()->getMilliseconds();
             mNextLoadingTime = currentTime + mLoadingIntervalMs;
 
@@ -71,6 +71,14 @@ namespace Volume {
         /** Overridden from Source.
         */
         Real getValue(const Vector3 &position) const override;
+
+        /** Overridden from Source.
+        */
+        void getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const override;
+
+        /** Overridden from Source.
+        */
+        void getValues(const Vector3 *positions, Real *values, size_t count) const override;
     };
 
     /** A plane.
@@ -102,6 +110,14 @@ namespace Volume {
         /** Overridden from Source.
         */
         Real getValue(const Vector3 &position) const override;
+
+        /** Overridden from Source.
+        */
+        void getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const override;
+
+        /** Overridden from Source.
+        */
+        void getValues(const Vector3 *positions, Real *values, size_t count) const override;
     };
 
     /** A not rotated cube.
@@ -166,6 +182,14 @@ namespace Volume {
         /** Overridden from Source.
         */
         Real getValue(const Vector3 &position) const override;
+
+        /** Overridden from Source.
+        */
+        void getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const override;
+
+        /** Overridden from Source.
+        */
+        void getValues(const Vector3 *positions, Real *values, size_t count) const override;
     };
 
     /** Abstract operation volume source holding two sources as operants.
@@ -244,6 +268,14 @@ namespace Volume {
         /** Overridden from Source.
         */
         Real getValue(const Vector3 &position) const override;
+
+        /** Overridden from Source.
+        */
+        void getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const override;
+
+        /** Overridden from Source.
+        */
+        void getValues(const Vector3 *positions, Real *values, size_t count) const override;
     };
 
     /** Builds the union between two sources.
@@ -271,6 +303,14 @@ namespace Volume {
         /** Overridden from Source.
         */
         Real getValue(const Vector3 &position) const override;
+
+        /** Overridden from Source.
+        */
+        void getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const override;
+
+        /** Overridden from Source.
+        */
+        void getValues(const Vector3 *positions, Real *values, size_t count) const override;
     };
 
     /** Builds the difference between two sources.
@@ -299,6 +339,14 @@ namespace Volume {
         /** Overridden from Source.
         */
         Real getValue(const Vector3 &position) const override;
+
+        /** Overridden from Source.
+        */
+        void getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const override;
+
+        /** Overridden from Source.
+        */
+        void getValues(const Vector3 *positions, Real *values, size_t count) const override;
     };
 
     /** Source which does a unary operation to another one.
@@ -359,6 +407,14 @@ namespace Volume {
         /** Overridden from Source.
         */
         Real getValue(const Vector3 &position) const override;
+
+        /** Overridden from Source.
+        */
+        void getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const override;
+
+        /** Overridden from Source.
+        */
+        void getValues(const Vector3 *positions, Real *values, size_t count) const override;
     };
 
     /** Scales the given volume source.
@@ -386,6 +442,14 @@ namespace Volume {
         /** Overridden from Source.
         */
         Real getValue(const Vector3 &position) const override;
+
+        /** Overridden from Source.
+        */
+        void getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const override;
+
+        /** Overridden from Source.
+        */
+        void getValues(const Vector3 *positions, Real *values, size_t count) const override;
     };
 
     class _OgreVolumeExport CSGNoiseSource: public CSGUnarySource
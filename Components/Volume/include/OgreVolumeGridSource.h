@@ -158,6 +158,14 @@ namespace Volume {
         */
         Real getValue(const Vector3 &position) const override;
 
+        /** Overridden from VolumeSource. Interpolates four positions at once.
+        */
+        void getValues(const Vector3 *positions, Real *values, size_t count) const override;
+
+        /** Overridden from VolumeSource. Interpolates the gradients of four positions at once.
+        */
+        void getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const override;
+
         /** Gets the width of the texture.
         @return
             The width of the texture.
@@ -177,7 +185,9 @@ namespace Volume {
         size_t getDepth(void) const;
 
         /** Updates this grid with another source in a certain area. Use
-        it for example to add spheres as a brush.
+        it for example to add spheres as a brush. The area is evaluated in rows
+        of cells, distributed over the threads of the WorkQueue, so the sources
+        must support concurrent reads like they do for the chunk loading.
         @param operation
             The operation to use, will use this source and the other given one as operands. Beware that
             this function overrides the maybe existing sources in the operation.
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #define __Ogre_Volume_MeshBuilder_H__
 
 #include <vector>
+#include <unordered_map>
 #include "OgreManualObject.h"
 #include "OgreVector.h"
 #include "OgreAxisAlignedBox.h"
@@ -98,6 +99,15 @@ namespace Volume {
     */
     bool _OgreVolumeExport operator<(const Vertex& a, const Vertex& b);
 
+    /** A hash function for vertices, consistent with the == operator.
+    @note
+        This is needed so that Vertex can serve as the key in an unordered_map structure.
+    */
+    struct _OgreVolumeExport VertexHash
+    {
+        size_t operator()(const Vertex& v) const;
+    };
+
     /** To hold vertices.
     */
     typedef std::vector<Vertex> VecVertex;
@@ -139,7 +149,7 @@ namespace Volume {
         static const unsigned short MAIN_BINDING;
 
         /// Map to get a vertex index.
-        typedef std::map<Vertex, uint32> UMapVertexIndex;
+        typedef std::unordered_map<Vertex, uint32, VertexHash> UMapVertexIndex;
         UMapVertexIndex mIndexMap;
 
          /// Holds the vertices of the mesh.
@@ -160,21 +170,15 @@ namespace Volume {
         */
         inline void addVertex(const Vertex &v)
         {
-            uint32 i = 0;
-            if (mIndexMap.find(v) == mIndexMap.end())
+            std::pair<UMapVertexIndex::iterator, bool> ret = mIndexMap.emplace(v, (uint32)mVertices.size());
+            if (ret.second)
             {
-                i = mVertices.size();
-                mIndexMap[v] = i;
                 mVertices.push_back(v);
 
                 // Update bounding box
                 mBox.merge(Vector3(v.x, v.y, v.z));
             }
-            else
-            {
-                i = mIndexMap[v];
-            }
-            mIndices.push_back(i);
+            mIndices.push_back(ret.first->second);
         }
 
     public:
@@ -101,6 +101,33 @@ namespace Volume {
         */
         virtual Real getValue(const Vector3 &position) const = 0;
 
+        /** Gets the density values and gradients at many positions at once.
+
+            This is what the octree and the iso surface use to sample the volume. The default
+            implementation calls getValueAndGradient for each position, sources that can evaluate
+            several positions at once more efficiently, e.g. with SIMD, override it. The results
+            must be the same as those of getValueAndGradient.
+        @param positions
+            The positions.
+        @param values
+            Receives a vector per position with x, y, z containing the gradient and w containing the density.
+        @param count
+            The amount of positions.
+        */
+        virtual void getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const;
+
+        /** Gets the density values at many positions at once.
+
+            Like getValuesAndGradients, this calls getValue for each position by default.
+        @param positions
+            The positions.
+        @param values
+            Receives the density per position.
+        @param count
+            The amount of positions.
+        */
+        virtual void getValues(const Vector3 *positions, Real *values, size_t count) const;
+
         /** Serializes a volume source to a discrete grid file with deflated
         compression. To achieve better compression, all density values are clamped
         within a maximum absolute value of (to - from).length() / 16.0. The values
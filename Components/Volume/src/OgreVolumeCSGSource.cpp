@@ -25,11 +25,88 @@ THE SOFTWARE.
 -----------------------------------------------------------------------------
 */
 #include "OgreVolumeCSGSource.h"
+#include "OgreArrayMath.h"
 #include <algorithm>
 
 namespace Ogre {
 namespace Volume {
 
+namespace {
+    /// The amount of positions the operations evaluate their operands for at once
+    const size_t BATCH_SIZE = 64;
+
+    /// Calls func(positions, first, num) for the positions in packs of ARRAY_PACKED_REALS.
+    template <typename Func> void forEachPack(const Vector3 *positions, size_t count, Func func)
+    {
+        for (size_t i = 0; i < count; i += ARRAY_PACKED_REALS)
+        {
+            size_t num = std::min(ARRAY_PACKED_REALS, count - i);
+            ArrayVector3 p;
+            p.loadPacked(positions + i, num);
+            func(p, i, num);
+        }
+    }
+
+    void storeValues(Real *values, ArrayReal v, size_t num)
+    {
+        Real tmp[ARRAY_PACKED_REALS];
+        ArrayMath::store(tmp, v);
+        std::copy(tmp, tmp + num, values);
+    }
+
+    void storeValuesAndGradients(Vector4 *values, const ArrayVector3 &gradient, ArrayReal v, size_t num)
+    {
+        Vector3 g[ARRAY_PACKED_REALS];
+        gradient.storePacked(g, num);
+        Real tmp[ARRAY_PACKED_REALS];
+        ArrayMath::store(tmp, v);
+        for (size_t i = 0; i < num; ++i)
+        {
+            values[i] = Vector4(g[i].x, g[i].y, g[i].z, tmp[i]);
+        }
+    }
+
+    /// The same as CSGCubeSource::distanceTo
+    ArrayReal cubeDistanceTo(const ArrayVector3 &position, const ArrayVector3 &boxMin, const ArrayVector3 &boxMax)
+    {
+        using namespace ArrayMath;
+        const ArrayVector3 dMin = position - boxMin;
+        const ArrayVector3 dMax = boxMax - position;
+        const ArrayReal zero = set1(0);
+
+        // Inside of the box, all of them are positive and the nearest side is the distance
+        ArrayReal inside = min(min(min(dMin.x, dMin.y), min(dMin.z, dMax.x)), min(dMax.y, dMax.z));
+        ArrayVector3 outside(max(max(neg(dMin.x), neg(dMax.x)), zero), max(max(neg(dMin.y), neg(dMax.y)), zero),
+                             max(max(neg(dMin.z), neg(dMax.z)), zero));
+        return select(cmpLess(inside, zero), neg(outside.length()), inside);
+    }
+
+    void getOperandValues(const Source *src, const Vector3 *positions, Real *values, size_t count)
+    {
+        src->getValues(positions, values, count);
+    }
+
+    void getOperandValues(const Source *src, const Vector3 *positions, Vector4 *values, size_t count)
+    {
+        src->getValuesAndGradients(positions, values, count);
+    }
+
+    /// Calls func(values, operandValues, num) with the values of the operand in batches.
+    template <typename T, typename Func>
+    void forEachBatch(const Source *src, const Vector3 *positions, T *values, size_t count, Func func)
+    {
+        T operandValues[BATCH_SIZE];
+        for (size_t i = 0; i < count; i += BATCH_SIZE)
+        {
+            size_t num = std::min(BATCH_SIZE, count - i);
+            getOperandValues(src, positions + i, operandValues, num);
+            func(values + i, operandValues, num);
+        }
+    }
+}
+
+    //-----------------------------------------------------------------------
+
     Vector3 CSGCubeSource::mBoxNormals[6] = {
         Vector3::UNIT_X,
         Vector3::UNIT_Y,
@@ -66,6 +143,30 @@ namespace Volume {
         Vector3 pMinCenter = position - mCenter;
         return mR - pMinCenter.length();
     }
+
+    //-----------------------------------------------------------------------
+
+    void CSGSphereSource::getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const
+    {
+        const ArrayVector3 center(mCenter);
+        const ArrayReal r = ArrayMath::set1(mR);
+        forEachPack(positions, count, [&](const ArrayVector3 &p, size_t i, size_t num) {
+            ArrayVector3 gradient = p - center;
+            ArrayReal length = gradient.normalise();
+            storeValuesAndGradients(values + i, gradient, ArrayMath::sub(r, length), num);
+        });
+    }
+
+    //-----------------------------------------------------------------------
+
+    void CSGSphereSource::getValues(const Vector3 *positions, Real *values, size_t count) const
+    {
+        const ArrayVector3 center(mCenter);
+        const ArrayReal r = ArrayMath::set1(mR);
+        forEachPack(positions, count, [&](const ArrayVector3 &p, size_t i, size_t num) {
+            storeValues(values + i, ArrayMath::sub(r, (p - center).length()), num);
+        });
+    }
     
     //-----------------------------------------------------------------------
 
@@ -93,6 +194,28 @@ namespace Volume {
         // Lineare Algebra: Ein geometrischer Zugang, S.180-181
         return mD - mNormal.dotProduct(position);
     }
+
+    //-----------------------------------------------------------------------
+
+    void CSGPlaneSource::getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const
+    {
+        const ArrayVector3 normal(mNormal);
+        const ArrayReal d = ArrayMath::set1(mD);
+        forEachPack(positions, count, [&](const ArrayVector3 &p, size_t i, size_t num) {
+            storeValuesAndGradients(values + i, normal, ArrayMath::sub(d, normal.dotProduct(p)), num);
+        });
+    }
+
+    //-----------------------------------------------------------------------
+
+    void CSGPlaneSource::getValues(const Vector3 *positions, Real *values, size_t count) const
+    {
+        const ArrayVector3 normal(mNormal);
+        const ArrayReal d = ArrayMath::set1(mD);
+        forEachPack(positions, count, [&](const ArrayVector3 &p, size_t i, size_t num) {
+            storeValues(values + i, ArrayMath::sub(d, normal.dotProduct(p)), num);
+        });
+    }
     
     //-----------------------------------------------------------------------
 
@@ -124,6 +247,39 @@ namespace Volume {
     {
         return distanceTo(position);
     }
+
+    //-----------------------------------------------------------------------
+
+    void CSGCubeSource::getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const
+    {
+        using namespace ArrayMath;
+        const ArrayVector3 boxMin(mBox.getMinimum());
+        const ArrayVector3 boxMax(mBox.getMaximum());
+        const ArrayReal one = set1(1);
+        forEachPack(positions, count, [&](const ArrayVector3 &p, size_t i, size_t num) {
+            // The same Prewitt approximation as getValueAndGradient
+            ArrayVector3 gradient(
+                sub(cubeDistanceTo(ArrayVector3(add(p.x, one), p.y, p.z), boxMin, boxMax),
+                    cubeDistanceTo(ArrayVector3(sub(p.x, one), p.y, p.z), boxMin, boxMax)),
+                sub(cubeDistanceTo(ArrayVector3(p.x, add(p.y, one), p.z), boxMin, boxMax),
+                    cubeDistanceTo(ArrayVector3(p.x, sub(p.y, one), p.z), boxMin, boxMax)),
+                sub(cubeDistanceTo(ArrayVector3(p.x, p.y, add(p.z, one)), boxMin, boxMax),
+                    cubeDistanceTo(ArrayVector3(p.x, p.y, sub(p.z, one)), boxMin, boxMax)));
+            gradient.normalise();
+            storeValuesAndGradients(values + i, -gradient, cubeDistanceTo(p, boxMin, boxMax), num);
+        });
+    }
+
+    //-----------------------------------------------------------------------
+
+    void CSGCubeSource::getValues(const Vector3 *positions, Real *values, size_t count) const
+    {
+        const ArrayVector3 boxMin(mBox.getMinimum());
+        const ArrayVector3 boxMax(mBox.getMaximum());
+        forEachPack(positions, count, [&](const ArrayVector3 &p, size_t i, size_t num) {
+            storeValues(values + i, cubeDistanceTo(p, boxMin, boxMax), num);
+        });
+    }
     
     //-----------------------------------------------------------------------
 
@@ -202,6 +358,32 @@ namespace Volume {
         }
         return valueB;
     }
+
+    //-----------------------------------------------------------------------
+
+    void CSGIntersectionSource::getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const
+    {
+        mA->getValuesAndGradients(positions, values, count);
+        forEachBatch(mB, positions, values, count, [](Vector4 *values, const Vector4 *valuesB, size_t num) {
+            for (size_t i = 0; i < num; ++i)
+            {
+                values[i] = values[i].w < valuesB[i].w ? values[i] : valuesB[i];
+            }
+        });
+    }
+
+    //-----------------------------------------------------------------------
+
+    void CSGIntersectionSource::getValues(const Vector3 *positions, Real *values, size_t count) const
+    {
+        mA->getValues(positions, values, count);
+        forEachBatch(mB, positions, values, count, [](Real *values, const Real *valuesB, size_t num) {
+            for (size_t i = 0; i < num; ++i)
+            {
+                values[i] = values[i] < valuesB[i] ? values[i] : valuesB[i];
+            }
+        });
+    }
     
     //-----------------------------------------------------------------------
 
@@ -240,6 +422,32 @@ namespace Volume {
         }
         return valueB;
     }
+
+    //-----------------------------------------------------------------------
+
+    void CSGUnionSource::getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const
+    {
+        mA->getValuesAndGradients(positions, values, count);
+        forEachBatch(mB, positions, values, count, [](Vector4 *values, const Vector4 *valuesB, size_t num) {
+            for (size_t i = 0; i < num; ++i)
+            {
+                values[i] = values[i].w > valuesB[i].w ? values[i] : valuesB[i];
+            }
+        });
+    }
+
+    //-----------------------------------------------------------------------
+
+    void CSGUnionSource::getValues(const Vector3 *positions, Real *values, size_t count) const
+    {
+        mA->getValues(positions, values, count);
+        forEachBatch(mB, positions, values, count, [](Real *values, const Real *valuesB, size_t num) {
+            for (size_t i = 0; i < num; ++i)
+            {
+                values[i] = values[i] > valuesB[i] ? values[i] : valuesB[i];
+            }
+        });
+    }
     
     //-----------------------------------------------------------------------
 
@@ -278,6 +486,34 @@ namespace Volume {
         }
         return valueB;
     }
+
+    //-----------------------------------------------------------------------
+
+    void CSGDifferenceSource::getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const
+    {
+        mA->getValuesAndGradients(positions, values, count);
+        forEachBatch(mB, positions, values, count, [](Vector4 *values, const Vector4 *valuesB, size_t num) {
+            for (size_t i = 0; i < num; ++i)
+            {
+                Vector4 valueB = (Real)-1.0 * valuesB[i];
+                values[i] = values[i].w < valueB.w ? values[i] : valueB;
+            }
+        });
+    }
+
+    //-----------------------------------------------------------------------
+
+    void CSGDifferenceSource::getValues(const Vector3 *positions, Real *values, size_t count) const
+    {
+        mA->getValues(positions, values, count);
+        forEachBatch(mB, positions, values, count, [](Real *values, const Real *valuesB, size_t num) {
+            for (size_t i = 0; i < num; ++i)
+            {
+                Real valueB = (Real)-1.0 * valuesB[i];
+                values[i] = values[i] < valueB ? values[i] : valueB;
+            }
+        });
+    }
     
     //-----------------------------------------------------------------------
 
@@ -330,6 +566,28 @@ namespace Volume {
     {
         return (Real)-1.0 * mSrc->getValue(position);
     }
+
+    //-----------------------------------------------------------------------
+
+    void CSGNegateSource::getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const
+    {
+        mSrc->getValuesAndGradients(positions, values, count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] = (Real)-1.0 * values[i];
+        }
+    }
+
+    //-----------------------------------------------------------------------
+
+    void CSGNegateSource::getValues(const Vector3 *positions, Real *values, size_t count) const
+    {
+        mSrc->getValues(positions, values, count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] = (Real)-1.0 * values[i];
+        }
+    }
     
     //-----------------------------------------------------------------------
 
@@ -350,6 +608,46 @@ namespace Volume {
     {
         return mSrc->getValue(position / mScale) * mScale;
     }
+
+    //-----------------------------------------------------------------------
+
+    void CSGScaleSource::getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const
+    {
+        Vector3 scaledPositions[BATCH_SIZE];
+        for (size_t i = 0; i < count; i += BATCH_SIZE)
+        {
+            size_t num = std::min(BATCH_SIZE, count - i);
+            for (size_t j = 0; j < num; ++j)
+            {
+                scaledPositions[j] = positions[i + j] / mScale;
+            }
+            mSrc->getValuesAndGradients(scaledPositions, values + i, num);
+            for (size_t j = 0; j < num; ++j)
+            {
+                values[i + j] = values[i + j] * mScale;
+            }
+        }
+    }
+
+    //-----------------------------------------------------------------------
+
+    void CSGScaleSource::getValues(const Vector3 *positions, Real *values, size_t count) const
+    {
+        Vector3 scaledPositions[BATCH_SIZE];
+        for (size_t i = 0; i < count; i += BATCH_SIZE)
+        {
+            size_t num = std::min(BATCH_SIZE, count - i);
+            for (size_t j = 0; j < num; ++j)
+            {
+                scaledPositions[j] = positions[i + j] / mScale;
+            }
+            mSrc->getValues(scaledPositions, values + i, num);
+            for (size_t j = 0; j < num; ++j)
+            {
+                values[i + j] = values[i + j] * mScale;
+            }
+        }
+    }
     
     //-----------------------------------------------------------------------
 
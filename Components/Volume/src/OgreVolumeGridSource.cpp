@@ -29,6 +29,9 @@ THE SOFTWARE.
 #include "OgreLogManager.h"
 #include "OgreRay.h"
 #include "OgreVolumeCSGSource.h"
+#include "OgreArrayMath.h"
+#include "OgreRoot.h"
+#include "OgreWorkQueue.h"
 
 namespace Ogre {
 namespace Volume {
@@ -196,6 +199,157 @@ namespace Volume {
         return value;
     }
     
+    //-----------------------------------------------------------------------
+
+    namespace
+    {
+        using namespace ArrayMath;
+
+        /// The grid cells of up to ARRAY_PACKED_REALS positions, the unused lanes repeat the last one
+        struct PackedCells
+        {
+            size_t num;
+            size_t lo[3][ARRAY_PACKED_REALS];
+            size_t hi[3][ARRAY_PACKED_REALS];
+            ArrayReal dX, dY, dZ;
+
+            PackedCells(const Vector3 *positions, size_t count, const ArrayVector3 &scale) : num(count)
+            {
+                ArrayVector3 scaledPosition;
+                scaledPosition.loadPacked(positions, num);
+                scaledPosition = scaledPosition * scale;
+
+                Real s[3][ARRAY_PACKED_REALS];
+                store(s[0], scaledPosition.x);
+                store(s[1], scaledPosition.y);
+                store(s[2], scaledPosition.z);
+
+                Real c0[3][ARRAY_PACKED_REALS];
+                for (size_t j = 0; j < ARRAY_PACKED_REALS; ++j)
+                {
+                    size_t k = std::min(j, num - 1);
+                    for (size_t c = 0; c < 3; ++c)
+                    {
+                        lo[c][j] = (size_t)s[c][k];
+                        hi[c][j] = (size_t)ceil(s[c][k]);
+                        c0[c][j] = (Real)lo[c][j];
+                    }
+                }
+                dX = sub(scaledPosition.x, load(c0[0]));
+                dY = sub(scaledPosition.y, load(c0[1]));
+                dZ = sub(scaledPosition.z, load(c0[2]));
+            }
+
+            /// Calls fetch(lane, corner, x, y, z) for the eight corners of each used lane
+            template <typename F> void forEachCorner(F fetch) const
+            {
+                for (size_t j = 0; j < num; ++j)
+                {
+                    fetch(j, 0, lo[0][j], lo[1][j], lo[2][j]);
+                    fetch(j, 1, hi[0][j], lo[1][j], lo[2][j]);
+                    fetch(j, 2, lo[0][j], hi[1][j], lo[2][j]);
+                    fetch(j, 3, lo[0][j], lo[1][j], hi[2][j]);
+                    fetch(j, 4, hi[0][j], lo[1][j], hi[2][j]);
+                    fetch(j, 5, lo[0][j], hi[1][j], hi[2][j]);
+                    fetch(j, 6, hi[0][j], hi[1][j], lo[2][j]);
+                    fetch(j, 7, hi[0][j], hi[1][j], hi[2][j]);
+                }
+            }
+
+            /// The same trilinear interpolation as getValue, of the corner values f[corner][lane]
+            ArrayReal interpolate(Real f[8][ARRAY_PACKED_REALS]) const
+            {
+                for (size_t j = num; j < ARRAY_PACKED_REALS; ++j)
+                    for (size_t c = 0; c < 8; ++c)
+                        f[c][j] = f[c][num - 1];
+
+                const ArrayReal one = set1(1);
+                ArrayReal oneMinX = sub(one, dX);
+                ArrayReal oneMinY = sub(one, dY);
+                ArrayReal oneMinZ = sub(one, dZ);
+                ArrayReal oneMinXoneMinY = mul(oneMinX, oneMinY);
+                ArrayReal dXOneMinY = mul(dX, oneMinY);
+
+                ArrayReal front = add(add(mul(load(f[0]), oneMinXoneMinY), mul(load(f[1]), dXOneMinY)),
+                                      mul(mul(load(f[2]), oneMinX), dY));
+                ArrayReal back = add(add(mul(load(f[3]), oneMinXoneMinY), mul(load(f[4]), dXOneMinY)),
+                                     mul(mul(load(f[5]), oneMinX), dY));
+                ArrayReal top = add(mul(load(f[6]), oneMinZ), mul(load(f[7]), dZ));
+                return add(add(mul(oneMinZ, front), mul(dZ, back)), mul(mul(dX, dY), top));
+            }
+        };
+    }
+
+    //-----------------------------------------------------------------------
+
+    void GridSource::getValues(const Vector3 *positions, Real *values, size_t count) const
+    {
+        if (!mTrilinearValue)
+        {
+            // Nearest neighbour is a plain lookup
+            Source::getValues(positions, values, count);
+            return;
+        }
+
+        const ArrayVector3 scale(Vector3(mPosXScale, mPosYScale, mPosZScale));
+        for (size_t i = 0; i < count; i += ARRAY_PACKED_REALS)
+        {
+            PackedCells cells(positions + i, std::min(ARRAY_PACKED_REALS, count - i), scale);
+
+            Real f[8][ARRAY_PACKED_REALS];
+            cells.forEachCorner([this, &f](size_t j, size_t c, size_t x, size_t y, size_t z) {
+                f[c][j] = getVolumeGridValue(x, y, z);
+            });
+
+            Real tmp[ARRAY_PACKED_REALS];
+            store(tmp, cells.interpolate(f));
+            std::copy(tmp, tmp + cells.num, values + i);
+        }
+    }
+
+    //-----------------------------------------------------------------------
+
+    void GridSource::getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const
+    {
+        const ArrayVector3 scale(Vector3(mPosXScale, mPosYScale, mPosZScale));
+        for (size_t i = 0; i < count; i += ARRAY_PACKED_REALS)
+        {
+            size_t num = std::min(ARRAY_PACKED_REALS, count - i);
+            Real densities[ARRAY_PACKED_REALS];
+            getValues(positions + i, densities, num);
+
+            if (!mTrilinearGradient)
+            {
+                for (size_t j = 0; j < num; ++j)
+                {
+                    Vector3 scaledPosition(positions[i + j].x * mPosXScale, positions[i + j].y * mPosYScale,
+                                           positions[i + j].z * mPosZScale);
+                    Vector3 gradient = getGradient((size_t)(scaledPosition.x + (Real)0.5),
+                                                   (size_t)(scaledPosition.y + (Real)0.5),
+                                                   (size_t)(scaledPosition.z + (Real)0.5)) * (Real)-1.0;
+                    values[i + j] = Vector4(gradient.x, gradient.y, gradient.z, densities[j]);
+                }
+                continue;
+            }
+
+            // The gradient of each corner, interpolated per component
+            PackedCells cells(positions + i, num, scale);
+            Real g[3][8][ARRAY_PACKED_REALS];
+            cells.forEachCorner([this, &g](size_t j, size_t c, size_t x, size_t y, size_t z) {
+                Vector3 gradient = getGradient(x, y, z);
+                g[0][c][j] = gradient.x;
+                g[1][c][j] = gradient.y;
+                g[2][c][j] = gradient.z;
+            });
+
+            Real gradients[3][ARRAY_PACKED_REALS];
+            for (size_t c = 0; c < 3; ++c)
+                store(gradients[c], neg(cells.interpolate(g[c])));
+            for (size_t j = 0; j < num; ++j)
+                values[i + j] = Vector4(gradients[0][j], gradients[1][j], gradients[2][j], densities[j]);
+        }
+    }
+
     //-----------------------------------------------------------------------
     
     size_t GridSource::getWidth(void) const
@@ -231,8 +385,6 @@ namespace Volume {
         // cells anyway.
         bool oldTrilinearValue = mTrilinearValue;
         mTrilinearValue = false;
-        float value;
-        int x, y;
         Vector3 scaledCenter(center.x * mPosXScale, center.y * mPosYScale, center.z * mPosZScale);
         int xStart = Math::Clamp(static_cast<int>(scaledCenter.x - radius * mPosXScale), 0, static_cast<int>(mWidth));
         int xEnd = Math::Clamp(static_cast<int>(scaledCenter.x + radius * mPosXScale), 0, static_cast<int>(mWidth));
@@ -240,20 +392,28 @@ namespace Volume {
         int yEnd = Math::Clamp(static_cast<int>(scaledCenter.y + radius * mPosYScale), 0, static_cast<int>(mHeight));
         int zStart = Math::Clamp(static_cast<int>(scaledCenter.z - radius * mPosZScale), 0, static_cast<int>(mDepth));
         int zEnd = Math::Clamp(static_cast<int>(scaledCenter.z + radius * mPosZScale), 0, static_cast<int>(mDepth));
-        Vector3 pos;
-        for (int z = zStart; z < zEnd; ++z)
+        if (xStart < xEnd)
         {
-            for (y = yStart; y < yEnd; ++y)
-            {
-                for (x = xStart; x < xEnd; ++x)
+            // Every cell only reads its own value of this grid, so the slices are independent
+            Root::getSingleton().getWorkQueue()->parallelFor(zStart, zEnd, 1, [&](size_t first, size_t last) {
+                std::vector<Vector3> positions(xEnd - xStart);
+                std::vector<Real> values(xEnd - xStart);
+                for (int z = (int)first; z < (int)last; ++z)
                 {
-                    pos.x = x * worldWidthScale;
-                    pos.y = y * worldHeightScale;
-                    pos.z = z * worldDepthScale;
-                    value = operation->getValue(pos);
-                    setVolumeGridValue(x, y, z, value);
+                    for (int y = yStart; y < yEnd; ++y)
+                    {
+                        for (int x = xStart; x < xEnd; ++x)
+                        {
+                            positions[x - xStart] = Vector3(x * worldWidthScale, y * worldHeightScale, z * worldDepthScale);
+                        }
+                        operation->getValues(positions.data(), values.data(), positions.size());
+                        for (int x = xStart; x < xEnd; ++x)
+                        {
+                            setVolumeGridValue(x, y, z, (float)values[x - xStart]);
+                        }
+                    }
                 }
-            }
+            });
         }
 
         mTrilinearValue = oldTrilinearValue;
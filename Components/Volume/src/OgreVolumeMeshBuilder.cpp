@@ -56,6 +56,16 @@ namespace Volume {
 
     //-----------------------------------------------------------------------
 
+    size_t VertexHash::operator()(const Vertex& v) const
+    {
+        // Adding zero turns -0 into 0, they are equal for the == operator
+        const Real components[6] = {v.x + (Real)0.0, v.y + (Real)0.0, v.z + (Real)0.0,
+            v.nX + (Real)0.0, v.nY + (Real)0.0, v.nZ + (Real)0.0};
+        return FastHash(reinterpret_cast<const char*>(components), sizeof(components));
+    }
+
+    //-----------------------------------------------------------------------
+
     const unsigned short MeshBuilder::MAIN_BINDING = 0;
 
     //-----------------------------------------------------------------------
@@ -60,50 +60,74 @@ namespace Volume {
         }
 
         // Error metric of http://www.andrew.cmu.edu/user/jessicaz/publication/meshing/
-        Real f000 = mSrc->getValue(from);
-        Real f001 = mSrc->getValue(node->getCorner3());
-        Real f010 = mSrc->getValue(node->getCorner4());
-        Real f011 = mSrc->getValue(node->getCorner7());
-        Real f100 = mSrc->getValue(node->getCorner1());
-        Real f101 = mSrc->getValue(node->getCorner2());
-        Real f110 = mSrc->getValue(node->getCorner5());
-        Real f111 = mSrc->getValue(to);
+        const Vector3 corners[8] = {from, node->getCorner3(), node->getCorner4(), node->getCorner7(),
+            node->getCorner1(), node->getCorner2(), node->getCorner5(), to};
+        Real f[8];
+        mSrc->getValues(corners, f, 8);
 
-        Vector3 positions[19][2] = {
-            {node->getCenterBackBottom(), Vector3((Real)0.5, (Real)0.0, (Real)0.0)},
-            {node->getCenterLeftBottom(), Vector3((Real)0.0, (Real)0.0, (Real)0.5)},
-            {node->getCenterBottom(), Vector3((Real)0.5, (Real)0.0, (Real)0.5)},
-            {node->getCenterRightBottom(), Vector3((Real)1.0, (Real)0.0, (Real)0.5)},
-            {node->getCenterFrontBottom(), Vector3((Real)0.5, (Real)0.0, (Real)1.0)},
+        const Vector3 positions[19] = {
+            node->getCenterBackBottom(),
+            node->getCenterLeftBottom(),
+            node->getCenterBottom(),
+            node->getCenterRightBottom(),
+            node->getCenterFrontBottom(),
 
-            {node->getCenterBackLeft(), Vector3((Real)0.0, (Real)0.5, (Real)0.0)},
-            {node->getCenterBack(), Vector3((Real)0.5, (Real)0.5, (Real)0.0)},
-            {node->getCenterBackRight(), Vector3((Real)1.0, (Real)0.5, (Real)0.0)},
-            {node->getCenterLeft(), Vector3((Real)0.0, (Real)0.5, (Real)0.5)},
-            {node->getCenter(), Vector3((Real)0.5, (Real)0.5, (Real)0.5)},
-            {node->getCenterRight(), Vector3((Real)1.0, (Real)0.5, (Real)0.5)},
-            {node->getCenterFrontLeft(), Vector3((Real)0.0, (Real)0.5, (Real)1.0)},
-            {node->getCenterFront(), Vector3((Real)0.5, (Real)0.5, (Real)1.0)},
-            {node->getCenterFrontRight(), Vector3((Real)1.0, (Real)0.5, (Real)1.0)},
+            node->getCenterBackLeft(),
+            node->getCenterBack(),
+            node->getCenterBackRight(),
+            node->getCenterLeft(),
+            node->getCenter(),
+            node->getCenterRight(),
+            node->getCenterFrontLeft(),
+            node->getCenterFront(),
+            node->getCenterFrontRight(),
         
-            {node->getCenterBackTop(), Vector3((Real)0.5, (Real)1.0, (Real)0.0)},
-            {node->getCenterLeftTop(), Vector3((Real)0.0, (Real)1.0, (Real)0.5)},
-            {node->getCenterTop(), Vector3((Real)0.5, (Real)1.0, (Real)0.5)},
-            {node->getCenterRightTop(), Vector3((Real)1.0, (Real)1.0, (Real)0.5)},
-            {node->getCenterFrontTop(), Vector3((Real)0.5, (Real)1.0, (Real)1.0)}
+            node->getCenterBackTop(),
+            node->getCenterLeftTop(),
+            node->getCenterTop(),
+            node->getCenterRightTop(),
+            node->getCenterFrontTop()
         };
+        static const Vector3 factors[19] = {
+            Vector3((Real)0.5, (Real)0.0, (Real)0.0),
+            Vector3((Real)0.0, (Real)0.0, (Real)0.5),
+            Vector3((Real)0.5, (Real)0.0, (Real)0.5),
+            Vector3((Real)1.0, (Real)0.0, (Real)0.5),
+            Vector3((Real)0.5, (Real)0.0, (Real)1.0),
 
+            Vector3((Real)0.0, (Real)0.5, (Real)0.0),
+            Vector3((Real)0.5, (Real)0.5, (Real)0.0),
+            Vector3((Real)1.0, (Real)0.5, (Real)0.0),
+            Vector3((Real)0.0, (Real)0.5, (Real)0.5),
+            Vector3((Real)0.5, (Real)0.5, (Real)0.5),
+            Vector3((Real)1.0, (Real)0.5, (Real)0.5),
+            Vector3((Real)0.0, (Real)0.5, (Real)1.0),
+            Vector3((Real)0.5, (Real)0.5, (Real)1.0),
+            Vector3((Real)1.0, (Real)0.5, (Real)1.0),
+
+            Vector3((Real)0.5, (Real)1.0, (Real)0.0),
+            Vector3((Real)0.0, (Real)1.0, (Real)0.5),
+            Vector3((Real)0.5, (Real)1.0, (Real)0.5),
+            Vector3((Real)1.0, (Real)1.0, (Real)0.5),
+            Vector3((Real)0.5, (Real)1.0, (Real)1.0)
+        };
+        // Sample in small batches, most nodes near the surface exceed the error early
+        const size_t batchSize = 4;
+        Vector4 values[19];
     
         Real error = (Real)0.0;
-        Vector4 value;
         Vector3 gradient;
-        for (auto & position : positions)
+        for (size_t i = 0; i < 19; ++i)
         {
-            value = mSrc->getValueAndGradient(position[0]);
+            if (i % batchSize == 0)
+            {
+                mSrc->getValuesAndGradients(positions + i, values + i, std::min(batchSize, (size_t)19 - i));
+            }
+            const Vector4 &value = values[i];
             gradient.x = value.x;
             gradient.y = value.y;
             gradient.z = value.z;
-            Real interpolated = interpolate(f000, f001, f010, f011, f100, f101, f110, f111, position[1]);
+            Real interpolated = interpolate(f[0], f[1], f[2], f[3], f[4], f[5], f[6], f[7], factors[i]);
             Real gradientMagnitude = gradient.length();
             if (gradientMagnitude < FLT_EPSILON)
             {
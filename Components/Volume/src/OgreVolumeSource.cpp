@@ -61,6 +61,26 @@ namespace Volume {
 
     //-----------------------------------------------------------------------
 
+    void Source::getValuesAndGradients(const Vector3 *positions, Vector4 *values, size_t count) const
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] = getValueAndGradient(positions[i]);
+        }
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Source::getValues(const Vector3 *positions, Real *values, size_t count) const
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] = getValue(positions[i]);
+        }
+    }
+
+    //-----------------------------------------------------------------------
+
     void Source::serialize(const Vector3 &from, const Vector3 &to, float voxelWidth, const String &file)
     {
         Real maxClampedAbsoluteDensity = (from - to).length() / (Real)16.0;
@@ -281,6 +281,21 @@ namespace Ogre {
         void apply(Skeleton* skeleton, Real timePos, float weight,
           const AnimationState::BoneBlendMask* blendMask, Real scale);
 
+        /** Applies all node tracks given a specific time index and weight to a given skeleton.
+
+            With linear interpolation, the tracks are evaluated ARRAY_PACKED_REALS at a time using
+            SIMD, unless they have a Listener.
+        @param skeleton
+        @param timeIndex The time index in the animation to apply, see _getTimeIndex
+        @param weight The influence to give to this track, 1.0 for full influence, less to blend with
+            other animations.
+        @param blendMask The influence array defining additional per bone weights, may be NULL
+        @param scale The scale to apply to translations and scalings, useful for
+            adapting an animation to a different size target.
+        */
+        void apply(Skeleton* skeleton, const TimeIndex& timeIndex, float weight,
+          const AnimationState::BoneBlendMask* blendMask, Real scale);
+
         /** Applies all vertex tracks given a specific time point and weight to a given entity.
         @param entity The Entity to which this animation should be applied
         @param timePos The time position in the animation to apply.
@@ -464,6 +479,20 @@ namespace Ogre {
             global keyframe time list.
         */
         TimeIndex _getTimeIndex(Real timePos) const;
+
+        /** @copydoc _getTimeIndex(Real) const
+        @param keyIndexHint The key index of a previous time index, which is checked before
+            searching the keyframe times and updated to the new key index. As time usually
+            advances by less than a keyframe, this mostly avoids the search.
+        */
+        TimeIndex _getTimeIndex(Real timePos, uint& keyIndexHint) const;
+
+        /** Internal method building the data that is otherwise built on demand by apply().
+
+            Afterwards applying the animation does not modify it, so it can be applied to
+            several targets concurrently as long as it is not altered.
+        */
+        void _prepareForApply();
         
         /** Sets a base keyframe which for the skeletal / pose keyframes 
             in this animation. 
@@ -540,6 +569,10 @@ namespace Ogre {
 
         /// Internal method to build global keyframe time list
         void buildKeyFrameTimeList(void) const;
+
+        /// Applies up to ARRAY_PACKED_REALS linearly interpolated node tracks to the bones at once
+        void applyToBones(NodeAnimationTrack* const* tracks, Bone* const* bones, const Real* weights,
+                          size_t count, const TimeIndex& timeIndex, Real scale, bool shortestPath) const;
     };
 
     /** @} */
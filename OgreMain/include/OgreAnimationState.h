@@ -165,6 +165,13 @@ namespace Ogre {
           assert(mBlendMask.size() > boneHandle);
           return mBlendMask[boneHandle];
       }
+
+      /** Key index of the last time index of this state, see Animation::_getTimeIndex
+
+          Internal use only. Updated whenever the state is applied, so a state must not be
+          applied by several threads at once.
+      */
+      uint& _getKeyIndexHint() { return mKeyIndexHint; }
     private:
         /** @brief Set the blend mask data (might be dangerous)
          *
@@ -184,6 +191,7 @@ namespace Ogre {
         Real mWeight;
         bool mEnabled;
         bool mLoop;
+        uint mKeyIndexHint;
 
     };
 
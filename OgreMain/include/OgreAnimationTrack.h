@@ -313,6 +313,7 @@ namespace Ogre
     */
     class _OgreExport NodeAnimationTrack : public AnimationTrack
     {
+        friend class Animation;
     public:
         /// Constructor
         NodeAnimationTrack(Animation* parent, unsigned short handle);
@@ -0,0 +1,502 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+#ifndef __ArrayMath_H__
+#define __ArrayMath_H__
+
+#include "OgrePrerequisites.h"
+#include "OgrePlatformInformation.h"
+#include "OgreMatrix4.h"
+#include "OgreQuaternion.h"
+#include "OgreVector.h"
+
+#if __OGRE_HAVE_SSE && (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+#   define OGRE_ARRAY_MATH_SSE 1
+#   include <xmmintrin.h>
+#else
+#   define OGRE_ARRAY_MATH_SSE 0
+#endif
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Math
+    *  @{
+    */
+
+    /// Number of values processed at once by the ArrayVector3, ArrayQuaternion and ArrayAffine3 types
+    static const size_t ARRAY_PACKED_REALS = 4;
+
+#if OGRE_ARRAY_MATH_SSE
+    typedef __m128 ArrayReal;
+#else
+    struct ArrayReal
+    {
+        Real v[ARRAY_PACKED_REALS];
+    };
+#endif
+
+    /** Operations on ArrayReal, i.e. on ARRAY_PACKED_REALS values at once.
+
+        Comparisons return a mask, that can be passed to select.
+    */
+    namespace ArrayMath
+    {
+#if OGRE_ARRAY_MATH_SSE
+        inline ArrayReal set1(Real a) { return _mm_set1_ps(a); }
+        /// lane i is set to the i-th argument
+        inline ArrayReal set(Real a, Real b, Real c, Real d) { return _mm_setr_ps(a, b, c, d); }
+        inline ArrayReal load(const Real* src) { return _mm_loadu_ps(src); }
+        inline void store(Real* dst, ArrayReal a) { _mm_storeu_ps(dst, a); }
+
+        inline ArrayReal add(ArrayReal a, ArrayReal b) { return _mm_add_ps(a, b); }
+        inline ArrayReal sub(ArrayReal a, ArrayReal b) { return _mm_sub_ps(a, b); }
+        inline ArrayReal mul(ArrayReal a, ArrayReal b) { return _mm_mul_ps(a, b); }
+        inline ArrayReal div(ArrayReal a, ArrayReal b) { return _mm_div_ps(a, b); }
+        inline ArrayReal neg(ArrayReal a) { return _mm_xor_ps(a, _mm_set1_ps(-0.0f)); }
+        inline ArrayReal abs(ArrayReal a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+        inline ArrayReal sqrt(ArrayReal a) { return _mm_sqrt_ps(a); }
+        inline ArrayReal min(ArrayReal a, ArrayReal b) { return _mm_min_ps(a, b); }
+        inline ArrayReal max(ArrayReal a, ArrayReal b) { return _mm_max_ps(a, b); }
+
+        inline ArrayReal cmpLess(ArrayReal a, ArrayReal b) { return _mm_cmplt_ps(a, b); }
+        inline ArrayReal cmpGreater(ArrayReal a, ArrayReal b) { return _mm_cmpgt_ps(a, b); }
+        /// returns a where the mask is set and b otherwise
+        inline ArrayReal select(ArrayReal mask, ArrayReal a, ArrayReal b)
+        {
+            return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+        }
+        /// whether the mask is set in any lane
+        inline bool any(ArrayReal mask) { return _mm_movemask_ps(mask) != 0; }
+#else
+#define OGRE_ARRAY_MATH_OP(expr)                                                                             \
+        ArrayReal r;                                                                                         \
+        for (size_t i = 0; i < ARRAY_PACKED_REALS; ++i)                                                      \
+            r.v[i] = expr;                                                                                   \
+        return r
+        inline ArrayReal set1(Real a) { OGRE_ARRAY_MATH_OP(a); }
+        /// lane i is set to the i-th argument
+        inline ArrayReal set(Real a, Real b, Real c, Real d)
+        {
+            ArrayReal r = {{a, b, c, d}};
+            return r;
+        }
+        inline ArrayReal load(const Real* src) { OGRE_ARRAY_MATH_OP(src[i]); }
+        inline void store(Real* dst, ArrayReal a)
+        {
+            for (size_t i = 0; i < ARRAY_PACKED_REALS; ++i)
+                dst[i] = a.v[i];
+        }
+
+        inline ArrayReal add(ArrayReal a, ArrayReal b) { OGRE_ARRAY_MATH_OP(a.v[i] + b.v[i]); }
+        inline ArrayReal sub(ArrayReal a, ArrayReal b) { OGRE_ARRAY_MATH_OP(a.v[i] - b.v[i]); }
+        inline ArrayReal mul(ArrayReal a, ArrayReal b) { OGRE_ARRAY_MATH_OP(a.v[i] * b.v[i]); }
+        inline ArrayReal div(ArrayReal a, ArrayReal b) { OGRE_ARRAY_MATH_OP(a.v[i] / b.v[i]); }
+        inline ArrayReal neg(ArrayReal a) { OGRE_ARRAY_MATH_OP(-a.v[i]); }
+        inline ArrayReal abs(ArrayReal a) { OGRE_ARRAY_MATH_OP(std::abs(a.v[i])); }
+        inline ArrayReal sqrt(ArrayReal a) { OGRE_ARRAY_MATH_OP(std::sqrt(a.v[i])); }
+        inline ArrayReal min(ArrayReal a, ArrayReal b) { OGRE_ARRAY_MATH_OP(std::min(a.v[i], b.v[i])); }
+        inline ArrayReal max(ArrayReal a, ArrayReal b) { OGRE_ARRAY_MATH_OP(std::max(a.v[i], b.v[i])); }
+
+        // masks are 1 where set and 0 otherwise
+        inline ArrayReal cmpLess(ArrayReal a, ArrayReal b) { OGRE_ARRAY_MATH_OP(Real(a.v[i] < b.v[i])); }
+        inline ArrayReal cmpGreater(ArrayReal a, ArrayReal b) { OGRE_ARRAY_MATH_OP(Real(a.v[i] > b.v[i])); }
+        /// returns a where the mask is set and b otherwise
+        inline ArrayReal select(ArrayReal mask, ArrayReal a, ArrayReal b)
+        {
+            OGRE_ARRAY_MATH_OP(mask.v[i] != 0 ? a.v[i] : b.v[i]);
+        }
+        /// whether the mask is set in any lane
+        inline bool any(ArrayReal mask)
+        {
+            for (size_t i = 0; i < ARRAY_PACKED_REALS; ++i)
+                if (mask.v[i] != 0)
+                    return true;
+            return false;
+        }
+#undef OGRE_ARRAY_MATH_OP
+#endif
+        /// a * b + c
+        inline ArrayReal madd(ArrayReal a, ArrayReal b, ArrayReal c) { return add(mul(a, b), c); }
+    }
+
+    /** ARRAY_PACKED_REALS Vector3s stored as structure of arrays.
+
+        The Array types are meant for processing many transforms at once, e.g. all bones of a
+        Skeleton. Data is converted from and to the regular types with load and store, which take
+        either pointers to the individual elements or a packed array of them.
+        @note
+            load and store accept a count smaller than ARRAY_PACKED_REALS, the unused lanes are
+            filled with the last element, so they compute valid values.
+    */
+    class _OgreExport ArrayVector3
+    {
+    public:
+        ArrayReal x, y, z;
+
+        /// Do <b>NOT</b> initialize the vectors for efficiency
+        ArrayVector3() {}
+        ArrayVector3(ArrayReal _x, ArrayReal _y, ArrayReal _z) : x(_x), y(_y), z(_z) {}
+        /// sets all lanes to v
+        explicit ArrayVector3(const Vector3& v)
+            : x(ArrayMath::set1(v.x)), y(ArrayMath::set1(v.y)), z(ArrayMath::set1(v.z))
+        {
+        }
+
+        void load(const Vector3* const src[ARRAY_PACKED_REALS], size_t count = ARRAY_PACKED_REALS)
+        {
+            Real v[3][ARRAY_PACKED_REALS];
+            for (size_t i = 0; i < ARRAY_PACKED_REALS; ++i)
+            {
+                const Vector3& s = *src[std::min(i, count - 1)];
+                v[0][i] = s.x;
+                v[1][i] = s.y;
+                v[2][i] = s.z;
+            }
+            x = ArrayMath::load(v[0]);
+            y = ArrayMath::load(v[1]);
+            z = ArrayMath::load(v[2]);
+        }
+        void loadPacked(const Vector3* src, size_t count = ARRAY_PACKED_REALS)
+        {
+            const Vector3* ptrs[ARRAY_PACKED_REALS];
+            for (size_t i = 0; i < ARRAY_PACKED_REALS; ++i)
+                ptrs[i] = src + std::min(i, count - 1);
+            load(ptrs, count);
+        }
+
+        void store(Vector3* const dst[ARRAY_PACKED_REALS], size_t count = ARRAY_PACKED_REALS) const
+        {
+            Real v[3][ARRAY_PACKED_REALS];
+            ArrayMath::store(v[0], x);
+            ArrayMath::store(v[1], y);
+            ArrayMath::store(v[2], z);
+            for (size_t i = 0; i < count; ++i)
+                *dst[i] = Vector3(v[0][i], v[1][i], v[2][i]);
+        }
+        void storePacked(Vector3* dst, size_t count = ARRAY_PACKED_REALS) const
+        {
+            Vector3* ptrs[ARRAY_PACKED_REALS];
+            for (size_t i = 0; i < count; ++i)
+                ptrs[i] = dst + i;
+            store(ptrs, count);
+        }
+
+        ArrayVector3 operator+(const ArrayVector3& b) const
+        {
+            return ArrayVector3(ArrayMath::add(x, b.x), ArrayMath::add(y, b.y), ArrayMath::add(z, b.z));
+        }
+        ArrayVector3 operator-(const ArrayVector3& b) const
+        {
+            return ArrayVector3(ArrayMath::sub(x, b.x), ArrayMath::sub(y, b.y), ArrayMath::sub(z, b.z));
+        }
+        /// component wise multiplication
+        ArrayVector3 operator*(const ArrayVector3& b) const
+        {
+            return ArrayVector3(ArrayMath::mul(x, b.x), ArrayMath::mul(y, b.y), ArrayMath::mul(z, b.z));
+        }
+        ArrayVector3 operator*(ArrayReal s) const
+        {
+            return ArrayVector3(ArrayMath::mul(x, s), ArrayMath::mul(y, s), ArrayMath::mul(z, s));
+        }
+        ArrayVector3 operator-() const
+        {
+            return ArrayVector3(ArrayMath::neg(x), ArrayMath::neg(y), ArrayMath::neg(z));
+        }
+
+        ArrayReal dotProduct(const ArrayVector3& b) const
+        {
+            using namespace ArrayMath;
+            return add(add(mul(x, b.x), mul(y, b.y)), mul(z, b.z));
+        }
+        ArrayVector3 crossProduct(const ArrayVector3& b) const
+        {
+            using namespace ArrayMath;
+            return ArrayVector3(sub(mul(y, b.z), mul(z, b.y)), sub(mul(z, b.x), mul(x, b.z)),
+                                sub(mul(x, b.y), mul(y, b.x)));
+        }
+        ArrayReal squaredLength() const { return dotProduct(*this); }
+        ArrayReal length() const { return ArrayMath::sqrt(squaredLength()); }
+
+        /** Normalises the vectors, returns the previous lengths.
+
+            Like Vector3::normalise, vectors of zero length are left unchanged.
+        */
+        ArrayReal normalise()
+        {
+            using namespace ArrayMath;
+            ArrayReal len = length();
+            ArrayReal invLen = select(cmpGreater(len, set1(0)), div(set1(1), len), set1(1));
+            *this = *this * invLen;
+            return len;
+        }
+    };
+
+    /** ARRAY_PACKED_REALS Quaternions stored as structure of arrays.
+
+        See ArrayVector3 for the conventions.
+    */
+    class _OgreExport ArrayQuaternion
+    {
+    public:
+        ArrayReal w, x, y, z;
+
+        /// Do <b>NOT</b> initialize the quaternions for efficiency
+        ArrayQuaternion() {}
+        ArrayQuaternion(ArrayReal _w, ArrayReal _x, ArrayReal _y, ArrayReal _z) : w(_w), x(_x), y(_y), z(_z) {}
+        /// sets all lanes to q
+        explicit ArrayQuaternion(const Quaternion& q)
+            : w(ArrayMath::set1(q.w)), x(ArrayMath::set1(q.x)), y(ArrayMath::set1(q.y)),
+              z(ArrayMath::set1(q.z))
+        {
+        }
+
+        void load(const Quaternion* const src[ARRAY_PACKED_REALS], size_t count = ARRAY_PACKED_REALS)
+        {
+            Real v[4][ARRAY_PACKED_REALS];
+            for (size_t i = 0; i < ARRAY_PACKED_REALS; ++i)
+            {
+                const Quaternion& s = *src[std::min(i, count - 1)];
+                v[0][i] = s.w;
+                v[1][i] = s.x;
+                v[2][i] = s.y;
+                v[3][i] = s.z;
+            }
+            w = ArrayMath::load(v[0]);
+            x = ArrayMath::load(v[1]);
+            y = ArrayMath::load(v[2]);
+            z = ArrayMath::load(v[3]);
+        }
+        void loadPacked(const Quaternion* src, size_t count = ARRAY_PACKED_REALS)
+        {
+            const Quaternion* ptrs[ARRAY_PACKED_REALS];
+            for (size_t i = 0; i < ARRAY_PACKED_REALS; ++i)
+                ptrs[i] = src + std::min(i, count - 1);
+            load(ptrs, count);
+        }
+
+        void store(Quaternion* const dst[ARRAY_PACKED_REALS], size_t count = ARRAY_PACKED_REALS) const
+        {
+            Real v[4][ARRAY_PACKED_REALS];
+            ArrayMath::store(v[0], w);
+            ArrayMath::store(v[1], x);
+            ArrayMath::store(v[2], y);
+            ArrayMath::store(v[3], z);
+            for (size_t i = 0; i < count; ++i)
+                *dst[i] = Quaternion(v[0][i], v[1][i], v[2][i], v[3][i]);
+        }
+        void storePacked(Quaternion* dst, size_t count = ARRAY_PACKED_REALS) const
+        {
+            Quaternion* ptrs[ARRAY_PACKED_REALS];
+            for (size_t i = 0; i < count; ++i)
+                ptrs[i] = dst + i;
+            store(ptrs, count);
+        }
+
+        ArrayQuaternion operator+(const ArrayQuaternion& b) const
+        {
+            using namespace ArrayMath;
+            return ArrayQuaternion(add(w, b.w), add(x, b.x), add(y, b.y), add(z, b.z));
+        }
+        ArrayQuaternion operator-(const ArrayQuaternion& b) const
+        {
+            using namespace ArrayMath;
+            return ArrayQuaternion(sub(w, b.w), sub(x, b.x), sub(y, b.y), sub(z, b.z));
+        }
+        ArrayQuaternion operator*(ArrayReal s) const
+        {
+            using namespace ArrayMath;
+            return ArrayQuaternion(mul(w, s), mul(x, s), mul(y, s), mul(z, s));
+        }
+        ArrayQuaternion operator-() const
+        {
+            using namespace ArrayMath;
+            return ArrayQuaternion(neg(w), neg(x), neg(y), neg(z));
+        }
+
+        /// @copydoc Quaternion::operator*(const Quaternion&) const
+        ArrayQuaternion operator*(const ArrayQuaternion& q) const
+        {
+            using namespace ArrayMath;
+            return ArrayQuaternion(sub(sub(sub(mul(w, q.w), mul(x, q.x)), mul(y, q.y)), mul(z, q.z)),
+                                   sub(add(add(mul(w, q.x), mul(x, q.w)), mul(y, q.z)), mul(z, q.y)),
+                                   sub(add(add(mul(w, q.y), mul(y, q.w)), mul(z, q.x)), mul(x, q.z)),
+                                   sub(add(add(mul(w, q.z), mul(z, q.w)), mul(x, q.y)), mul(y, q.x)));
+        }
+
+        /// Rotation of the vectors
+        ArrayVector3 operator*(const ArrayVector3& v) const
+        {
+            // nVidia SDK implementation, as in Quaternion
+            ArrayVector3 qvec(x, y, z);
+            ArrayVector3 uv = qvec.crossProduct(v);
+            ArrayVector3 uuv = qvec.crossProduct(uv);
+            uv = uv * ArrayMath::mul(ArrayMath::set1(2), w);
+            uuv = uuv * ArrayMath::set1(2);
+            return v + uv + uuv;
+        }
+
+        ArrayReal Dot(const ArrayQuaternion& q) const
+        {
+            using namespace ArrayMath;
+            return add(add(add(mul(w, q.w), mul(x, q.x)), mul(y, q.y)), mul(z, q.z));
+        }
+        ArrayReal Norm() const { return ArrayMath::sqrt(Dot(*this)); }
+
+        /// Normalises the quaternions, returns the previous lengths
+        ArrayReal normalise()
+        {
+            ArrayReal len = Norm();
+            *this = *this * ArrayMath::div(ArrayMath::set1(1), len);
+            return len;
+        }
+
+        /// @copydoc Quaternion::nlerp
+        static ArrayQuaternion nlerp(ArrayReal fT, const ArrayQuaternion& rkP, const ArrayQuaternion& rkQ,
+                                     bool shortestPath = false)
+        {
+            ArrayQuaternion q = rkQ;
+            if (shortestPath)
+                q = rkQ.flipTo(rkP);
+            ArrayQuaternion result = rkP + (q - rkP) * fT;
+            result.normalise();
+            return result;
+        }
+
+        /** Spherical linear interpolation, see Quaternion::Slerp
+
+            The interpolation factor can differ per lane.
+        */
+        static ArrayQuaternion Slerp(ArrayReal fT, const ArrayQuaternion& rkP, const ArrayQuaternion& rkQ,
+                                     bool shortestPath = false);
+
+    private:
+        /// negates the lanes, which point away from q
+        ArrayQuaternion flipTo(const ArrayQuaternion& q) const
+        {
+            using namespace ArrayMath;
+            ArrayReal flip = cmpLess(Dot(q), set1(0));
+            return ArrayQuaternion(select(flip, neg(w), w), select(flip, neg(x), x), select(flip, neg(y), y),
+                                   select(flip, neg(z), z));
+        }
+    };
+
+    /** ARRAY_PACKED_REALS Affine3 matrices stored as structure of arrays.
+
+        See ArrayVector3 for the conventions. Only the upper 3x4 part is stored.
+    */
+    class _OgreExport ArrayAffine3
+    {
+    public:
+        ArrayReal m[3][4];
+
+        /// Do <b>NOT</b> initialize the matrices for efficiency
+        ArrayAffine3() {}
+
+        void load(const Affine3* const src[ARRAY_PACKED_REALS], size_t count = ARRAY_PACKED_REALS)
+        {
+            Real v[12][ARRAY_PACKED_REALS];
+            for (size_t i = 0; i < ARRAY_PACKED_REALS; ++i)
+            {
+                const Affine3& s = *src[std::min(i, count - 1)];
+                for (int j = 0; j < 12; ++j)
+                    v[j][i] = s[j / 4][j % 4];
+            }
+            for (int j = 0; j < 12; ++j)
+                m[j / 4][j % 4] = ArrayMath::load(v[j]);
+        }
+        void loadPacked(const Affine3* src, size_t count = ARRAY_PACKED_REALS)
+        {
+            const Affine3* ptrs[ARRAY_PACKED_REALS];
+            for (size_t i = 0; i < ARRAY_PACKED_REALS; ++i)
+                ptrs[i] = src + std::min(i, count - 1);
+            load(ptrs, count);
+        }
+
+        void store(Affine3* const dst[ARRAY_PACKED_REALS], size_t count = ARRAY_PACKED_REALS) const
+        {
+            Real v[12][ARRAY_PACKED_REALS];
+            for (int j = 0; j < 12; ++j)
+                ArrayMath::store(v[j], m[j / 4][j % 4]);
+            for (size_t i = 0; i < count; ++i)
+            {
+                Affine3& d = *dst[i];
+                for (int j = 0; j < 12; ++j)
+                    d[j / 4][j % 4] = v[j][i];
+                d[3][0] = 0, d[3][1] = 0, d[3][2] = 0, d[3][3] = 1;
+            }
+        }
+        void storePacked(Affine3* dst, size_t count = ARRAY_PACKED_REALS) const
+        {
+            Affine3* ptrs[ARRAY_PACKED_REALS];
+            for (size_t i = 0; i < count; ++i)
+                ptrs[i] = dst + i;
+            store(ptrs, count);
+        }
+
+        /// @copydoc TransformBaseReal::makeTransform
+        void makeTransform(const ArrayVector3& position, const ArrayVector3& scale,
+                           const ArrayQuaternion& orientation)
+        {
+            using namespace ArrayMath;
+            // same as Quaternion::ToRotationMatrix
+            ArrayReal fTx = add(orientation.x, orientation.x);
+            ArrayReal fTy = add(orientation.y, orientation.y);
+            ArrayReal fTz = add(orientation.z, orientation.z);
+            ArrayReal fTwx = mul(fTx, orientation.w);
+            ArrayReal fTwy = mul(fTy, orientation.w);
+            ArrayReal fTwz = mul(fTz, orientation.w);
+            ArrayReal fTxx = mul(fTx, orientation.x);
+            ArrayReal fTxy = mul(fTy, orientation.x);
+            ArrayReal fTxz = mul(fTz, orientation.x);
+            ArrayReal fTyy = mul(fTy, orientation.y);
+            ArrayReal fTyz = mul(fTz, orientation.y);
+            ArrayReal fTzz = mul(fTz, orientation.z);
+            ArrayReal one = set1(1);
+
+            m[0][0] = mul(scale.x, sub(one, add(fTyy, fTzz)));
+            m[0][1] = mul(scale.y, sub(fTxy, fTwz));
+            m[0][2] = mul(scale.z, add(fTxz, fTwy));
+            m[0][3] = position.x;
+            m[1][0] = mul(scale.x, add(fTxy, fTwz));
+            m[1][1] = mul(scale.y, sub(one, add(fTxx, fTzz)));
+            m[1][2] = mul(scale.z, sub(fTyz, fTwx));
+            m[1][3] = position.y;
+            m[2][0] = mul(scale.x, sub(fTxz, fTwy));
+            m[2][1] = mul(scale.y, add(fTyz, fTwx));
+            m[2][2] = mul(scale.z, sub(one, add(fTxx, fTyy)));
+            m[2][3] = position.z;
+        }
+
+        /// Concatenation, as Affine3::operator*
+        ArrayAffine3 operator*(const ArrayAffine3& b) const
+        {
+            using namespace ArrayMath;
+            ArrayAffine3 r;
+            for (int i = 0; i < 3; ++i)
+            {
+                for (int j = 0; j < 4; ++j)
+                    r.m[i][j] = add(add(mul(m[i][0], b.m[0][j]), mul(m[i][1], b.m[1][j])), mul(m[i][2], b.m[2][j]));
+                r.m[i][3] = add(r.m[i][3], m[i][3]);
+            }
+            return r;
+        }
+
+        /// Transforms the points
+        ArrayVector3 operator*(const ArrayVector3& v) const
+        {
+            using namespace ArrayMath;
+            ArrayReal r[3];
+            for (int i = 0; i < 3; ++i)
+                r[i] = add(add(add(mul(m[i][0], v.x), mul(m[i][1], v.y)), mul(m[i][2], v.z)), m[i][3]);
+            return ArrayVector3(r[0], r[1], r[2]);
+        }
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#endif
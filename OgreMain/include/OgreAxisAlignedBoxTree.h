@@ -0,0 +1,167 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+#ifndef __AxisAlignedBoxTree_H__
+#define __AxisAlignedBoxTree_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreAxisAlignedBox.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre
+{
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Math
+    *  @{
+    */
+    /** Dynamic bounding volume hierarchy of axis aligned boxes
+
+        Each proxy is stored with a box enlarged by a margin relative to its size, so moving it
+        slightly only needs a containment test instead of restructuring the tree. Proxies are
+        inserted next to the sibling with the lowest surface area cost and the tree is kept
+        balanced by rotations, while rebuild() recreates it top down using the surface area
+        heuristic (SAH), which is preferable after changing many proxies at once.
+    */
+    class _OgreExport AxisAlignedBoxTree
+    {
+    public:
+        AxisAlignedBoxTree();
+
+        /// Sets the enlargement of the proxy boxes on each side, relative to their size
+        void setMargin(Real margin) { mMargin = margin; }
+        Real getMargin() const { return mMargin; }
+
+        /** Adds a proxy for a finite box
+        @return the id of the proxy
+        */
+        int createProxy(const AxisAlignedBox& box, void* userData);
+        void destroyProxy(int proxyId);
+        /** Updates the box of a proxy
+        @return true if the proxy was reinserted, as the enlarged box did not fit anymore
+        */
+        bool moveProxy(int proxyId, const AxisAlignedBox& box);
+
+        void* getUserData(int proxyId) const { return mNodes[proxyId].userData; }
+        /// Gets the enlarged box stored for the proxy
+        const AxisAlignedBox& getFatBox(int proxyId) const { return mNodes[proxyId].box; }
+
+        /// Recreates the tree of the current proxies using the surface area heuristic
+        void rebuild();
+        /// Removes all proxies
+        void clear();
+
+        size_t getNumProxies() const { return mNumProxies; }
+        /// Gets the number of levels below the root, 0 for a single proxy
+        int getHeight() const { return mRoot == NULL_NODE ? 0 : mNodes[mRoot].height; }
+
+        /** Calls func(userData) for each proxy, whose enlarged box passes test
+
+            @param test called as test(box) on the boxes of the tree nodes and must return true
+            if anything inside the box could match, e.g. a Ray or Sphere intersection test
+            @param func called as func(userData) for each matching proxy
+        */
+        template <class Test, class Func> void query(const Test& test, const Func& func) const
+        {
+            if (mRoot != NULL_NODE)
+                query(mRoot, test, func);
+        }
+
+        /** Calls func(userDataA, userDataB) once for each pair of proxies with overlapping
+            enlarged boxes, found by traversing the tree against itself
+        */
+        template <class Func> void queryPairs(const Func& func) const
+        {
+            if (mRoot != NULL_NODE)
+                queryPairs(mRoot, func);
+        }
+
+    private:
+        static const int NULL_NODE = -1;
+
+        struct Node
+        {
+            AxisAlignedBox box;
+            void* userData;
+            /// parent node or next node of the free list
+            int parent;
+            int child1;
+            int child2;
+            /// 0 for leaves, -1 for free nodes
+            int height;
+
+            bool isLeaf() const { return child1 == NULL_NODE; }
+        };
+
+        std::vector<Node> mNodes;
+        int mRoot;
+        int mFreeList;
+        size_t mNumProxies;
+        Real mMargin;
+
+        int allocateNode();
+        void freeNode(int node);
+        AxisAlignedBox enlarge(const AxisAlignedBox& box) const;
+        void insertLeaf(int leaf);
+        void removeLeaf(int leaf);
+        /// Recomputes the boxes and heights from node to the root, rotating unbalanced nodes
+        void refit(int node);
+        int balance(int node);
+        int build(int* leaves, size_t count);
+
+        template <class Test, class Func> void query(int index, const Test& test, const Func& func) const
+        {
+            const Node& node = mNodes[index];
+            if (!test(node.box))
+                return;
+            if (node.isLeaf())
+            {
+                func(node.userData);
+                return;
+            }
+            query(node.child1, test, func);
+            query(node.child2, test, func);
+        }
+
+        template <class Func> void queryPairs(int index, const Func& func) const
+        {
+            const Node& node = mNodes[index];
+            if (node.isLeaf())
+                return;
+            queryPairs(node.child1, func);
+            queryPairs(node.child2, func);
+            queryPairs(node.child1, node.child2, func);
+        }
+
+        template <class Func> void queryPairs(int a, int b, const Func& func) const
+        {
+            const Node& nodeA = mNodes[a];
+            const Node& nodeB = mNodes[b];
+            if (!nodeA.box.intersects(nodeB.box))
+                return;
+
+            if (nodeA.isLeaf() && nodeB.isLeaf())
+            {
+                func(nodeA.userData, nodeB.userData);
+            }
+            else if (nodeB.isLeaf() || (!nodeA.isLeaf() && nodeA.height >= nodeB.height))
+            {
+                // descend into the larger subtree
+                queryPairs(nodeA.child1, b, func);
+                queryPairs(nodeA.child2, b, func);
+            }
+            else
+            {
+                queryPairs(a, nodeB.child1, func);
+                queryPairs(a, nodeB.child2, func);
+            }
+        }
+    };
+    /** @} */
+    /** @} */
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
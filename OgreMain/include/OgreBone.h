@@ -116,6 +116,19 @@ namespace Ogre
         */
         void _getOffsetTransform(Affine3& m) const;
 
+        /** Gets the offset transforms of several bones at once, processing them as SoA batches.
+
+            Internal use only.
+        */
+        static void _getOffsetTransforms(Bone* const* bones, size_t numBones, Affine3* pMatrices);
+
+        /** Translates in parent space, rotates in local space and scales the bone, as an animation
+            track does, but notifies the update only once.
+
+            Internal use only.
+        */
+        void _applyAnimation(const Vector3& translation, const Quaternion& rotation, const Vector3& scaling);
+
         /** Gets the inverted binding pose scale. */
         const Vector3& _getBindingPoseInverseScale(void) const { return mBindDerivedInverseScale; }
         /** Gets the inverted binding pose position. */
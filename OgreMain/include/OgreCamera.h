@@ -584,6 +584,9 @@ namespace Ogre {
         bool isVisible(const Sphere& bound, FrustumPlane* culledBy = 0) const override;
         /// @copydoc Frustum::isVisible(const Vector3&, FrustumPlane*) const
         bool isVisible(const Vector3& vert, FrustumPlane* culledBy = 0) const override;
+        /// @copydoc Frustum::isVisible(const float* const[3], const float* const[3], size_t, uint32*) const
+        void isVisible(const float* const minimum[3], const float* const maximum[3], size_t numBoxes,
+                       uint32* visibleMask) const override;
         /// @copydoc Frustum::getWorldSpaceCorners
         const Corners& getWorldSpaceCorners(void) const override;
         /// @copydoc Frustum::getFrustumPlane
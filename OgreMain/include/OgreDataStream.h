@@ -356,6 +356,10 @@ namespace Ogre {
         */
         void close(void) override;
 
+        /** @copydoc DataStream::getAsString
+        */
+        String getAsString(void) override;
+
         /** Sets whether or not to free the encapsulated memory on close. */
         void setFreeOnClose(bool free) { mFreeOnClose = free; }
     };
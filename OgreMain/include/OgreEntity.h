@@ -40,6 +40,8 @@ THE SOFTWARE.
 #include "OgreHeaderPrefix.h"
 
 namespace Ogre {
+    class SoftwareVertexBlendBatch;
+
     /** \addtogroup Core
     *  @{
     */
@@ -81,6 +83,8 @@ namespace Ogre {
         // Allow EntityFactory full access
         friend class EntityFactory;
         friend class SubEntity;
+        // Allow batched animation updates
+        friend class SceneManager;
     public:
         
         typedef std::set<Entity*> EntitySet;
@@ -224,8 +228,11 @@ namespace Ogre {
         /// Records the last frame in which animation was updated.
         unsigned long mFrameAnimationLastUpdated;
 
-        /// Perform all the updates required for an animated entity.
-        void updateAnimation(void);
+        /** Perform all the updates required for an animated entity.
+        @param blendBatch If given, the software skinning is added to it instead of performed
+            right away.
+        */
+        void updateAnimation(SoftwareVertexBlendBatch* blendBatch = NULL);
 
         /// Records the last frame in which the bones was updated.
         /// It's a pointer because it can be shared between different entities with
@@ -389,6 +396,20 @@ namespace Ogre {
             return mSubEntityList;
         }
 
+        /** Finds the closest intersection of a ray with the triangles of the visible SubEntities
+
+            Unlike RaySceneQuery, which only tests the bounding volumes, this tests the actual
+            geometry using a TriangleTree, which is built on first use and cached per SubMesh.
+            Software animated entities are tested using their current positions, while hardware
+            skinned ones are tested in their bind pose, unless software animation was requested
+            via addSoftwareAnimationRequest.
+        @param ray the ray in world space
+        @param subEntity if not NULL, receives the index of the hit SubEntity
+        @param triangle if not NULL, receives the index of the hit triangle of the SubMesh
+        @return whether the ray hit and the distance in units of the ray direction
+        */
+        RayTestResult raycast(const Ray& ray, size_t* subEntity = NULL, size_t* triangle = NULL);
+
         /** Clones this entity and returns a pointer to the clone.
 
             Useful method for duplicating an entity. The new entity must be
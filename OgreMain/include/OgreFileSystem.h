@@ -70,6 +70,16 @@ namespace Ogre {
 
         /// Get whether hidden files are ignored during filesystem enumeration.
         static bool getIgnoreHidden();
+
+        /** Set whether files opened read-only are memory mapped, where supported.
+
+        The returned streams are then MemoryDataStream instances on the mapped file, which
+        loaders can parse in place instead of copying the file contents. The default is false.
+        */
+        static void setUseMemoryMapping(bool map);
+
+        /// Get whether files opened read-only are memory mapped.
+        static bool getUseMemoryMapping();
     };
 
     class APKFileSystemArchiveFactory : public ArchiveFactory
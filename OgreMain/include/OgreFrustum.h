@@ -420,6 +420,24 @@ namespace Ogre
         */
         virtual bool isVisible(const Vector3& vert, FrustumPlane* culledBy = 0) const;
 
+        /** Tests whether the given containers are visible in the Frustum.
+
+            Same as isVisible(const AxisAlignedBox&, FrustumPlane*) for each box, but
+            tests several boxes at once using SIMD where available.
+        @param minimum
+            Pointers to the x, y and z arrays of the box minimums (world space).
+        @param maximum
+            Pointers to the x, y and z arrays of the box maximums (world space).
+        @param numBoxes
+            Number of boxes to test. All of them must be finite, null and infinite
+            boxes have to be handled by the caller.
+        @param visibleMask
+            Receives the results, bit (i % 32) of element (i / 32) is set if box i is visible.
+            Must hold at least (numBoxes + 31) / 32 elements.
+        */
+        virtual void isVisible(const float* const minimum[3], const float* const maximum[3], size_t numBoxes,
+                               uint32* visibleMask) const;
+
         uint32 getTypeFlags(void) const override;
         const AxisAlignedBox& getBoundingBox(void) const override;
         Real getBoundingRadius(void) const override;
@@ -321,6 +321,26 @@ namespace Ogre {
 
         GpuNamedConstants();
         ~GpuNamedConstants();
+        GpuNamedConstants(const GpuNamedConstants& oth);
+        GpuNamedConstants& operator=(const GpuNamedConstants& oth);
+
+        /** Build the hashed name index used by find
+
+            If the index was generated, this must be called again after modifying map.
+            GpuProgram generates it once the definitions are complete, as they are
+            shared between threads afterwards and must not be modified anymore.
+        */
+        void generateHashIndex();
+        /// Whether generateHashIndex was called
+        bool hasHashIndex() const { return !mHashIndex.empty(); }
+        /** Find a constant definition by name
+
+            Uses the hashed name index if it was generated and the map otherwise.
+            @param name the name, without any array suffix
+            @param len length of name
+            @return the definition or NULL if not found
+        */
+        const GpuConstantDefinition* find(const char* name, size_t len) const;
 
         /** Saves constant definitions to a file
          * compatible with @ref GpuProgram::setManualNamedConstantsFile.
@@ -332,6 +352,36 @@ namespace Ogre {
         void load(DataStreamPtr& stream);
 
         size_t calculateSize(void) const;
+    private:
+        /// open addressing table of (name hash, entry), the size is a power of two
+        std::vector<std::pair<uint32, const GpuConstantDefinitionMap::value_type*>> mHashIndex;
+    };
+
+    /** A named constant resolved by GpuProgramParameters::getNamedConstantHandle
+
+        Setting a constant by its handle skips the name lookup. The handle is valid for
+        all GpuProgramParameters created from the same program, as long as the program
+        is not recompiled.
+    */
+    struct GpuConstantHandle
+    {
+        /// Physical buffer index, including any array offset
+        size_t physicalIndex;
+        /// Number of typed slots available from physicalIndex
+        uint32 size;
+        /// Number of typed slots per element
+        uint32 elementSize;
+        /// Data type
+        GpuConstantType constType;
+
+        GpuConstantHandle()
+            : physicalIndex((std::numeric_limits<size_t>::max)()), size(0), elementSize(0),
+              constType(GCT_UNKNOWN)
+        {
+        }
+
+        /// Whether the constant exists
+        bool isValid() const { return physicalIndex != (std::numeric_limits<size_t>::max)(); }
     };
 
     /// Simple class for loading / saving GpuNamedConstants
@@ -1259,6 +1309,28 @@ namespace Ogre {
 
         bool mUseLinearColours;
 
+        /// Compiled form of an AutoConstantEntry, see compileAutoConstants
+        struct AutoConstantOp
+        {
+            /// direct source for 4x4 matrix autos, NULL to take the generic path
+            const TransformBaseReal& (*matrix)(const AutoParamDataSource*);
+            /// index into mAutoConstants
+            uint32 entry;
+        };
+        /// mAutoConstants sorted by variability
+        std::vector<AutoConstantOp> mAutoConstantOps;
+        /// (variability, end index into mAutoConstantOps) of each variability group
+        std::vector<std::pair<uint16, uint32>> mAutoConstantGroups;
+        /// whether mAutoConstants changed since the last compileAutoConstants
+        bool mAutoConstantOpsDirty;
+
+        /// Rebuild mAutoConstantOps from mAutoConstants
+        void compileAutoConstants();
+        /// Update a single auto constant from the source
+        void updateAutoConstant(const AutoConstantEntry& ac, const AutoParamDataSource* source);
+        /// Write a 4x4 matrix as 16 floats, transposing if needed
+        void writeRawMatrix(size_t physicalIndex, const TransformBaseReal& m);
+
         /// Return the variability for an auto constant
         static uint16 deriveVariability(AutoConstantType act);
 
@@ -1266,7 +1338,7 @@ namespace Ogre {
 
         GpuSharedParamUsageList mSharedParamSets;
 
-        template <typename T> void _setNamedConstant(const String& name, const T* val, size_t count);
+        template <typename T> void _setNamedConstant(const GpuConstantHandle& handle, const T* val, size_t count);
 
     public:
         GpuProgramParameters();
@@ -1725,6 +1797,51 @@ namespace Ogre {
         void setNamedConstant(const String& name, const uint *val, size_t count,
                               size_t multiple = 4);
         /// @}
+
+        /** @name Set constant by handle
+            Use these for constants that are set often, e.g. per object. They skip
+            the name lookup done by the string overloads above.
+        */
+        /// @{
+        /** Resolve a named constant to a handle
+
+            Array elements can be resolved directly, e.g. "lights[2]".
+            @param name The name of the parameter
+            @return the handle, which is invalid if the parameter does not exist and
+            missing parameters are ignored. Setting an invalid handle does nothing.
+        */
+        GpuConstantHandle getNamedConstantHandle(const String& name) const;
+        /// @copydoc setNamedConstant(const String&, float)
+        void setNamedConstant(const GpuConstantHandle& handle, float val);
+        /// @overload
+        void setNamedConstant(const GpuConstantHandle& handle, int val);
+        /// @overload
+        void setNamedConstant(const GpuConstantHandle& handle, uint val);
+        /// @overload
+        void setNamedConstant(const GpuConstantHandle& handle, const Vector4& val);
+        /// @overload
+        void setNamedConstant(const GpuConstantHandle& handle, const Vector3& val);
+        /// @overload
+        void setNamedConstant(const GpuConstantHandle& handle, const Vector2& val);
+        /// @overload
+        void setNamedConstant(const GpuConstantHandle& handle, const Matrix4& val);
+        /// @overload
+        void setNamedConstant(const GpuConstantHandle& handle, const ColourValue& colour);
+        /// @overload
+        void setNamedConstant(const GpuConstantHandle& handle, const Matrix4* m, size_t numEntries);
+        /// @overload
+        void setNamedConstant(const GpuConstantHandle& handle, const float *val, size_t count,
+                              size_t multiple = 4);
+        /// @overload
+        void setNamedConstant(const GpuConstantHandle& handle, const double *val, size_t count,
+                              size_t multiple = 4);
+        /// @overload
+        void setNamedConstant(const GpuConstantHandle& handle, const int *val, size_t count,
+                              size_t multiple = 4);
+        /// @overload
+        void setNamedConstant(const GpuConstantHandle& handle, const uint *val, size_t count,
+                              size_t multiple = 4);
+        /// @}
         /** Find a constant definition for a named parameter.
 
             This method returns null if the named parameter did not exist, unlike
@@ -517,6 +517,17 @@ namespace Ogre
 
         size_t getNumSections(void) const { return mSectionList.size(); }
 
+        /** Finds the closest intersection of a ray with the triangles of all sections
+
+            The TriangleTree of each section is built on first use and rebuilt after the section
+            is updated.
+        @param ray the ray in world space
+        @param section if not NULL, receives the index of the hit section
+        @param triangle if not NULL, receives the index of the hit triangle of the section
+        @return whether the ray hit and the distance in units of the ray direction
+        */
+        RayTestResult raycast(const Ray& ray, size_t* section = NULL, size_t* triangle = NULL);
+
 
         /** Sets whether or not to keep the original declaration order when 
             queuing the renderables.
@@ -559,7 +570,7 @@ namespace Ogre
             mutable MaterialPtr mMaterial;
             RenderOperation mRenderOperation;
             bool m32BitIndices;
-
+            std::unique_ptr<TriangleTree> mTriangleTree;
 
         public:
             ManualObjectSection(ManualObject* parent, const String& materialName,
@@ -602,6 +613,11 @@ namespace Ogre
 
             /// convert this section to a SubMesh
             void convertToSubMesh(SubMesh* sm) const;
+
+            /// Gets the TriangleTree of the geometry, which is built on first use
+            const TriangleTree& _getTriangleTree();
+            /// Discards the TriangleTree after the geometry was changed
+            void _invalidateTriangleTree();
                     
         };
 
@@ -964,6 +964,61 @@ namespace Ogre {
         const UserObjectBindings& getUserObjectBindings() const { return mUserObjectBindings; }
     };
 
+    /** Collects software vertex blends to perform them concurrently.
+
+        The buffers are locked when a blend is added and stay locked until run() is called,
+        which blends the vertices on the WorkQueue workers and unlocks the buffers on the
+        calling thread again. A buffer used by several blends, like the source data of a
+        Mesh shared by many entities, is locked only once.
+    */
+    class _OgreExport SoftwareVertexBlendBatch
+    {
+    public:
+        /// Arguments of OptimisedUtil::softwareVertexSkinning for one blend
+        struct Blend
+        {
+            const float* srcPos;
+            float* destPos;
+            const float* srcNorm;
+            float* destNorm;
+            const float* blendWeight;
+            const unsigned char* blendIndex;
+            size_t srcPosStride, destPosStride;
+            size_t srcNormStride, destNormStride;
+            size_t blendWeightStride, blendIndexStride;
+            size_t numWeightsPerVertex;
+            size_t numVertices;
+            /// first entry of this blend in the matrix list
+            size_t firstMatrix;
+        };
+
+        SoftwareVertexBlendBatch();
+        /// Runs any pending blends
+        ~SoftwareVertexBlendBatch();
+
+        /// Same as Mesh::softwareVertexBlend, but deferred until run() is called
+        void add(const VertexData* sourceVertexData, const VertexData* targetVertexData,
+                 const Affine3* const* blendMatrices, size_t numMatrices, bool blendNormals);
+
+        /// Whether any buffer bound to the vertex data is locked by a pending blend
+        bool isLocked(const VertexData* vertexData) const;
+
+        /// Whether there are no pending blends
+        bool empty() const { return mBlends.empty(); }
+
+        /// Performs the pending blends and unlocks the buffers
+        void run();
+
+        /// number of vertices a single task blends at most
+        size_t mVerticesPerTask;
+    private:
+        std::vector<Blend> mBlends;
+        std::vector<const Affine3*> mMatrices;
+        std::map<HardwareBuffer*, void*> mLockedBuffers;
+        /// blend index and first vertex per task
+        std::vector<std::pair<size_t, size_t>> mTasks;
+    };
+
     /** @} */
     /** @} */
 
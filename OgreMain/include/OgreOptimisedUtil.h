@@ -204,6 +204,29 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices) = 0;
+
+        /** Test axis aligned boxes against a set of planes.
+
+            A box is rejected if it lies completely on the negative side of any of
+            the planes, as determined by Plane::getSide(const Vector3&, const Vector3&).
+        @param planes An array of planes to test against.
+        @param numPlanes Number of planes in the array.
+        @param minimum Pointers to the x, y and z components of the box minimums,
+            stored as separate arrays. No alignment requirements.
+        @param maximum Pointers to the x, y and z components of the box maximums,
+            stored as separate arrays. No alignment requirements.
+        @param visibleMask Array used to store the results, bit (i % 32) of element
+            (i / 32) is set if box i is not rejected by any of the planes. Must
+            hold at least (numBoxes + 31) / 32 elements.
+        @param numBoxes Number of boxes to test, all of them must be finite.
+        */
+        virtual void cullAxisAlignedBoxes(
+            const Plane* planes,
+            size_t numPlanes,
+            const float* const minimum[3],
+            const float* const maximum[3],
+            uint32* visibleMask,
+            size_t numBoxes) = 0;
     };
 
     /** Returns raw offsetted of the given pointer.
@@ -40,6 +40,14 @@ namespace Ogre {
 #   define __OGRE_HAVE_SSE  1
 #endif
 
+/* Define whether or not Ogre compiled with AVX2 support. Unlike SSE, this does not need any
+   compiler flags, the AVX2 code paths are enabled per function and selected at runtime.
+*/
+#if __OGRE_HAVE_SSE && (OGRE_COMPILER != OGRE_COMPILER_MSVC || OGRE_COMP_VER >= 1800) && \
+    OGRE_PLATFORM != OGRE_PLATFORM_EMSCRIPTEN
+#   define __OGRE_HAVE_AVX2  1
+#endif
+
 /* Define whether or not Ogre compiled with VFP support.
  */
 #if OGRE_DOUBLE_PRECISION == 0 && OGRE_CPU == OGRE_CPU_ARM && (OGRE_COMPILER == OGRE_COMPILER_GNUC || OGRE_COMPILER == OGRE_COMPILER_CLANG) && defined(__VFP_FP__)
@@ -62,6 +70,10 @@ namespace Ogre {
 #   define __OGRE_HAVE_SSE  0
 #endif
 
+#ifndef __OGRE_HAVE_AVX2
+#   define __OGRE_HAVE_AVX2  0
+#endif
+
 #ifndef __OGRE_HAVE_VFP
 #   define __OGRE_HAVE_VFP  0
 #endif
@@ -118,6 +130,10 @@ namespace Ogre {
             CPU_FEATURE_FPU             = 1 << 12,
             CPU_FEATURE_PRO             = 1 << 13,
             CPU_FEATURE_HTT             = 1 << 14,
+            CPU_FEATURE_AVX             = 1 << 18,
+            CPU_FEATURE_AVX2            = 1 << 19,
+            CPU_FEATURE_FMA             = 1 << 20,
+            CPU_FEATURE_AVX512F         = 1 << 21,
 #elif OGRE_CPU == OGRE_CPU_ARM          
             CPU_FEATURE_VFP             = 1 << 15,
             CPU_FEATURE_NEON            = 1 << 16,
@@ -257,6 +257,7 @@ OGRE_DEBUG_NS_END
     class TextureManager;
     class TransformKeyFrame;
     class Timer;
+    class TriangleTree;
     class UserObjectBindings;
     template <int dims, typename T> class _OgreMaybeExport Vector;
     typedef Vector<2, Real> Vector2;
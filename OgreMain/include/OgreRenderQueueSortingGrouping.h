@@ -155,6 +155,11 @@ namespace Ogre {
         PassGroupRenderableMap mGrouped;
         /// Sorted descending (can iterate backwards to get ascending)
         RenderablePassList mSortedDescending;
+        /// Whether pass groups may be reordered by the geometry they bind
+        bool mStateSortEnabled;
+        struct StateSortScratch;
+        /// Scratch space of the pass group state sort, allocated on first use
+        std::unique_ptr<StateSortScratch> mStateSortScratch;
 
         /// Internal visitor implementation
         void acceptVisitorGrouped(QueuedRenderableVisitor* visitor) const;
@@ -165,6 +170,7 @@ namespace Ogre {
 
     public:
         QueuedRenderableCollection();
+        ~QueuedRenderableCollection();
 
         /// Empty the collection
         void clear(void);
@@ -196,6 +202,13 @@ namespace Ogre {
             mOrganisationMode |= uint8(om);
         }
 
+        /** Set whether the renderables of a pass group may be reordered to bind the same
+            geometry back to back. Disable it where the submission order matters, like for
+            blended renderables that are not depth sorted.
+        */
+        void setStateSortEnabled(bool enabled) { mStateSortEnabled = enabled; }
+        bool getStateSortEnabled() const { return mStateSortEnabled; }
+
         /// Add a renderable to the collection using a given pass
         void addRenderable(Pass* pass, Renderable* rend);
         
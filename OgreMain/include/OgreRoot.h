@@ -873,6 +873,9 @@ namespace Ogre
             process your custom background tasks using the shared thread pool.
             However, you must remember to assign yourself a new channel through
             which to process your tasks.
+
+            This is a DefaultWorkQueue, unless the environment variable @c OGRE_WORK_QUEUE
+            was set to @c workstealing when Root was created, which selects WorkStealingWorkQueue.
         */
         WorkQueue* getWorkQueue() const { return mWorkQueue.get(); }
 
@@ -45,10 +45,12 @@ Torus Knot Software Ltd.
 #include "OgreResourceGroupManager.h"
 #include "OgreInstanceManager.h"
 #include "OgreManualObject.h"
+#include "OgreMesh.h"
 #include "OgreRenderSystem.h"
 #include "OgreLodListener.h"
 #include "OgreHeaderPrefix.h"
 #include "OgreNameGenerator.h"
+#include "OgreAxisAlignedBoxTree.h"
 
 namespace Ogre {
     /** \addtogroup Core
@@ -408,6 +410,12 @@ namespace Ogre {
         };
         /// Allow visitor helper to access protected methods
         friend class SceneMgrQueuedRenderableVisitor;
+        /// Allow the default queries to use mSceneQueryTree
+        friend class DefaultIntersectionSceneQuery;
+        friend class DefaultAxisAlignedBoxSceneQuery;
+        friend class DefaultRaySceneQuery;
+        friend class DefaultSphereSceneQuery;
+        friend class DefaultPlaneBoundedVolumeListSceneQuery;
 
         typedef std::map<String, Camera* > CameraList;
         typedef std::map<String, MovableObject*> MovableObjectMap;
@@ -675,6 +683,28 @@ namespace Ogre {
         /// Internal method for firing the queue end event, returns true if queue is to be repeated
         virtual bool fireRenderQueueEnded(uint8 id, const String& cameraName);
 
+        /** Updates the animation of the entities found visible in one go
+
+            The bone matrices of the entities are computed by the WorkQueue workers, as is the
+            software skinning, while the remaining per Entity work stays on the calling thread.
+        */
+        struct _OgreExport AnimationUpdater
+        {
+            /// entities queued by Entity::_updateRenderQueue
+            std::vector<Entity*> mEntities;
+            /// entities owning a skeleton instance whose bone matrices are out of date
+            std::vector<Entity*> mSkeletonOwners;
+            SoftwareVertexBlendBatch mBlendBatch;
+            bool mEnabled;
+            /// whether entities are currently queued instead of updated right away
+            bool mCollecting;
+
+            AnimationUpdater();
+
+            /// Update the animation of the queued entities and stop collecting them
+            void update();
+        } mAnimationUpdater;
+
     private:
         /** Internal method for creating the AutoParamDataSource instance. */
         AutoParamDataSource* createAutoParamDataSource(void) const
@@ -991,6 +1021,153 @@ namespace Ogre {
         uint32 mVisibilityMask;
         bool mFindVisibleObjects;
 
+        /** Depth ordered, flattened view of the part of the scene graph touched by an update
+
+            Allows updating the transforms of one tree level and the bounds of the
+            previous one across the WorkQueue workers instead of a recursive walk.
+        */
+        struct _OgreExport SceneGraphUpdater
+        {
+            struct Level
+            {
+                std::vector<SceneNode*> nodes;
+                /// whether the derived transform of the node must be recomputed
+                std::vector<uchar> transformDirty;
+            };
+            /// one entry per tree depth; kept across frames to avoid reallocations
+            std::vector<Level> mLevels;
+            /// number of used entries in mLevels
+            size_t mNumLevels;
+            /// minimal number of nodes a single task processes
+            size_t mNodesPerTask;
+            bool mEnabled;
+
+            SceneGraphUpdater();
+
+            /// Equivalent to root->_update(true, false)
+            void update(SceneNode* root);
+        private:
+            void collect(SceneNode* node, bool parentHasChanged, size_t depth);
+        } mSceneGraphUpdater;
+
+        /** Splits the scene graph in subtrees that are frustum culled by the WorkQueue workers
+
+            The nodes above the subtrees are culled on the calling thread, which also
+            processes the visible objects afterwards in the depth first order of the
+            serial traversal.
+        */
+        struct _OgreExport SceneGraphCuller
+        {
+            /// a visible node above the subtrees or, if NULL, the subtree to process
+            struct Entry
+            {
+                SceneNode* node;
+                size_t subtree;
+            };
+            std::vector<Entry> mSequence;
+            std::vector<SceneNode*> mSubtrees;
+            /// visible nodes per subtree; kept across frames to avoid reallocations
+            std::vector<std::vector<SceneNode*>> mVisible;
+            /// scratch space for choosing the split depth
+            std::vector<SceneNode*> mLevel, mNextLevel;
+            /// visible nodes whose scene node debug drawing is pending
+            std::vector<SceneNode*> mDrawStack;
+            /// split the tree at the first depth having at least this many nodes
+            size_t mMinSubtrees;
+            /// minimal number of subtrees a single task processes
+            size_t mSubtreesPerTask;
+            bool mEnabled;
+
+            SceneGraphCuller();
+
+            /// Equivalent to root->_findVisibleObjects(cam, queue, visibleBounds, true, false, onlyShadowCasters)
+            void findVisibleObjects(SceneNode* root, Camera* cam, RenderQueue* queue,
+                                    VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters);
+        private:
+            void collect(SceneNode* node, const Frustum& frustum, size_t depth, size_t splitDepth);
+            void processVisibleNode(SceneNode* node, Camera* cam, RenderQueue* queue,
+                                    VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters,
+                                    DebugDrawer* debugDrawer);
+        } mSceneGraphCuller;
+
+        /** Bounding volume hierarchies of the movable objects, which the default scene queries
+            use instead of testing every object
+
+            The trees mirror the cached world bounds the queries test against. Objects report
+            when deriving changes these, so the next query using a tree only needs to update
+            their leaves, while creating or destroying objects synchronises all of them.
+        */
+        struct _OgreExport SceneQueryTree
+        {
+            enum BoundsType
+            {
+                BT_BOX,
+                BT_SPHERE
+            };
+            struct Proxy
+            {
+                MovableObject* object;
+                /// position of the object when iterating all types and names, which gives the
+                /// order results are reported in
+                uint32 rank;
+                /// value of mSyncCount when the object was last seen
+                uint32 syncCount;
+                /// ids in the trees per BoundsType, -1 for infinite bounds, -2 if not inserted
+                int id[2];
+            };
+            struct Bounds
+            {
+                AxisAlignedBoxTree tree;
+                /// proxies with infinite bounds, which are tested by all queries
+                std::vector<Proxy*> infinite;
+                /// objects whose bounds changed since the last synchronisation
+                std::vector<const MovableObject*> changed;
+                /// whether all objects must be synchronised, e.g. as objects were created
+                std::atomic<bool> syncAll;
+            };
+            Bounds mBounds[2];
+            std::unordered_map<MovableObject*, Proxy> mProxies;
+            uint32 mSyncCount;
+            /// number of changed objects, above which synchronising all is cheaper
+            size_t mChangedLimit;
+            OGRE_MUTEX(mMutex);
+            OGRE_MUTEX(mChangedMutex);
+
+            SceneQueryTree();
+
+            /// Synchronise all objects before the next query
+            void markDirty()
+            {
+                for (auto& b : mBounds)
+                {
+                    if (!b.syncAll.load(std::memory_order_relaxed))
+                        b.syncAll.store(true, std::memory_order_relaxed);
+                }
+            }
+            /// Update the leaf of obj before the next query using the given bounds
+            void markChanged(const MovableObject* obj, BoundsType type);
+            /// Synchronises the tree of the given bounds with the movable objects of sm
+            void update(SceneManager* sm, BoundsType type);
+
+            /** Collects the proxies whose bounds of the given type pass test(box) sorted by rank
+            @note the exact test with the world bounds of the objects is left to the caller
+            */
+            template <class Test>
+            void findCandidates(BoundsType type, const Test& test, std::vector<Proxy*>& candidates) const
+            {
+                candidates = mBounds[type].infinite;
+                mBounds[type].tree.query(test, [&candidates](void* p) { candidates.push_back(static_cast<Proxy*>(p)); });
+                std::sort(candidates.begin(), candidates.end(),
+                          [](const Proxy* a, const Proxy* b) { return a->rank < b->rank; });
+            }
+            typedef std::vector<std::pair<Proxy*, Proxy*>> ProxyPairList;
+            /// Collects the pairs of proxies with overlapping boxes, each ordered and sorted by rank
+            void findPairs(ProxyPairList& pairs);
+        private:
+            /// Updates the leaf of the proxy, returns true if it was (re)inserted
+            bool updateProxy(Proxy& proxy, BoundsType type);
+        } mSceneQueryTree;
+
         /// The active renderable visitor class - subclasses could override this
         SceneMgrQueuedRenderableVisitor* mActiveQueuedRenderableVisitor;
         /// Storage for default renderable visitor
@@ -3248,6 +3425,76 @@ namespace Ogre {
         */
         bool getFindVisibleObjects(void) { return mFindVisibleObjects; }
 
+        /** Sets whether the scene graph is updated in parallel using the WorkQueue workers.
+
+            Instead of recursively walking the tree, the nodes that need updating are
+            flattened into per-depth arrays. Derived transforms are then computed level
+            by level from the root and world bounds are merged bottom-up, with each
+            level being split across the worker threads. The results are identical to
+            the default update.
+
+            This pays off for large scene graphs only. As Node::Listener and
+            MovableObject::_notifyMoved are called from the worker threads, they must be
+            thread safe when this is enabled.
+        @note SceneManagers whose SceneNode types need to do more during the update
+            (e.g. maintaining an octree) ignore this option.
+        */
+        virtual void setParallelSceneGraphUpdate(bool enabled) { mSceneGraphUpdater.mEnabled = enabled; }
+
+        /// Gets whether the scene graph is updated in parallel
+        bool getParallelSceneGraphUpdate() const { return mSceneGraphUpdater.mEnabled; }
+
+        /** Sets whether visible objects are searched in parallel using the WorkQueue workers.
+
+            The scene graph is split into subtrees, which are frustum culled concurrently.
+            The visible objects are then added to the RenderQueue on the calling thread in
+            the same order as the default search does.
+
+            This pays off for large scene graphs only.
+        @note Only affects the default implementation of _findVisibleObjects, SceneManagers
+            using their own spatial structures ignore this option.
+        */
+        void setParallelFindVisibleObjects(bool enabled) { mSceneGraphCuller.mEnabled = enabled; }
+
+        /// Gets whether visible objects are searched in parallel
+        bool getParallelFindVisibleObjects() const { return mSceneGraphCuller.mEnabled; }
+
+        /** Sets whether the animation of visible entities is updated in parallel using the
+            WorkQueue workers.
+
+            Instead of updating each Entity while searching the visible objects, the entities
+            are collected and the bone matrices as well as any software skinning are then
+            computed concurrently before rendering. This pays off when many entities use
+            software animation, e.g. for stencil shadows or without shader support.
+        @note Morph and pose animation is still applied on the calling thread. Entities with
+            objects attached to their bones are updated right away as before.
+        */
+        void setParallelAnimationUpdate(bool enabled) { mAnimationUpdater.mEnabled = enabled; }
+
+        /// Gets whether the animation of visible entities is updated in parallel
+        bool getParallelAnimationUpdate() const { return mAnimationUpdater.mEnabled; }
+
+        /** Notifies that deriving changed the world bounds of a movable object
+
+            Makes the default scene queries update the object before the next search.
+        @param sphere whether the bounding sphere changed instead of the bounding box
+        */
+        void _notifyWorldBoundsChanged(const MovableObject* obj, bool sphere = false)
+        {
+            mSceneQueryTree.markChanged(obj, sphere ? SceneQueryTree::BT_SPHERE : SceneQueryTree::BT_BOX);
+        }
+
+        /** Queue the animation update of an Entity found visible.
+        @return false if the entity must be updated right away
+        */
+        bool _queueAnimationUpdate(Entity* ent)
+        {
+            if (!mAnimationUpdater.mCollecting)
+                return false;
+            mAnimationUpdater.mEntities.push_back(ent);
+            return true;
+        }
+
         /** Set whether to automatically flip the culling mode on objects whenever they
             are negatively scaled.
 
@@ -186,6 +186,8 @@ namespace Ogre {
             IndexData* mIndexData;
             /// Maximum vertex indexable
             size_t mMaxVertexIndex;
+            /// Built on first use by _getTriangleTree
+            std::unique_ptr<TriangleTree> mTriangleTree;
         public:
             GeometryBucket(MaterialBucket* parent, const VertexData* vData, const IndexData* iData);
             virtual ~GeometryBucket();
@@ -209,6 +211,8 @@ namespace Ogre {
             bool assign(QueuedGeometry* qsm);
             /// Build
             void build(bool stencilShadows);
+            /// Gets the TriangleTree of the built geometry, which is built on first use
+            const TriangleTree& _getTriangleTree();
             /// Dump contents for diagnostics
             _OgreExport friend std::ostream& operator<<(std::ostream& o, const GeometryBucket& b);
         };
@@ -394,6 +398,11 @@ namespace Ogre {
             OGRE_DEPRECATED LODIterator getLODIterator(void);
             /// Get an list of the LODs in this region
             const LODBucketList& getLODBuckets() const { return mLodBucketList; }
+            /** Finds the closest intersection of a ray with the triangles of the highest LOD
+            @param ray the ray in world space
+            @return whether the ray hit and the distance in units of the ray direction
+            */
+            RayTestResult raycast(const Ray& ray);
             const ShadowRenderableList&
             getShadowVolumeRenderableList(const Light* light, const HardwareIndexBufferPtr& indexBuffer,
                                           size_t& indexBufferUsedSize, float extrusionDistance,
@@ -706,6 +715,14 @@ namespace Ogre {
         typedef MapIterator<RegionMap> RegionIterator;
         /// Get an list of the regions in this geometry
         const RegionMap& getRegions() const { return mRegionMap; }
+        /** Finds the closest intersection of a ray with the triangles of the built geometry
+
+            Only regions whose bounds are hit are tested, see Region::raycast.
+        @param ray the ray in world space
+        @param region if not NULL, receives the hit Region
+        @return whether the ray hit and the distance in units of the ray direction
+        */
+        RayTestResult raycast(const Ray& ray, Region** region = NULL);
         /// @deprecated use getRegions()
         OGRE_DEPRECATED RegionIterator getRegionIterator(void);
 
@@ -115,10 +115,17 @@ namespace Ogre {
         bool mVertexAnimationAppliedThisFrame;
         /// The camera for which the cached distance is valid
         mutable const Camera *mCachedCamera;
+        /// Tree of the software animated positions
+        std::unique_ptr<TriangleTree> mAnimatedTriangleTree;
+        /// The frame in which mAnimatedTriangleTree was built
+        unsigned long mAnimatedTriangleTreeFrame;
 
         /** Internal method for preparing this Entity for use in animation. */
         void prepareTempBlendBuffers(void);
 
+        /// Gets the tree of the current positions, see Entity::raycast
+        const TriangleTree& getTriangleTree(void);
+
     public:
         /** Gets the name of the Material in use by this instance.
         */
@@ -208,6 +215,14 @@ namespace Ogre {
         */
         void resetIndexDataStartEndIndex();
 
+        /** Finds the closest intersection of a ray with the triangles of this SubEntity
+
+            See Entity::raycast for details.
+        @param ray the ray in world space
+        @param triangle if not NULL, receives the index of the hit triangle
+        */
+        RayTestResult raycast(const Ray& ray, size_t* triangle = NULL);
+
         void getWorldTransforms(Matrix4* xform) const override;
         unsigned short getNumWorldTransforms(void) const override;
         Real getSquaredViewDepth(const Camera* cam) const override;
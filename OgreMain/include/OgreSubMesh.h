@@ -223,6 +223,13 @@ namespace Ogre {
          */
         SubMesh * clone(const String& newName, Mesh *parentMesh = 0);
 
+        /** Gets the TriangleTree of the geometry used for ray casts
+
+            The tree is built on first use and discarded together with the SubMesh, i.e. when the
+            Mesh is reloaded.
+        */
+        const TriangleTree& _getTriangleTree();
+
     private:
 
         /// Flag indicating that bone assignments need to be recompiled
@@ -242,6 +249,8 @@ namespace Ogre {
 
         VertexBoneAssignmentList mBoneAssignments;
 
+        std::unique_ptr<TriangleTree> mTriangleTree;
+
         /// Internal method for removing LOD data
         void removeLodLevels(void);
 
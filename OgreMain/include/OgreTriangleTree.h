@@ -0,0 +1,105 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+#ifndef __TriangleTree_H__
+#define __TriangleTree_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreMath.h"
+#include "OgreArrayMath.h"
+#include "OgreRenderOperation.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre
+{
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Math
+    *  @{
+    */
+    /** Static bounding volume hierarchy over the triangles of a mesh for ray casts
+
+        The tree is built top down using the binned surface area heuristic (SAH) and stored
+        depth first in a flat array, so the first child of a node directly follows it. The
+        triangles of the leaves are stored in batches of ARRAY_PACKED_REALS, which are tested
+        against a ray at once using ArrayMath.
+
+        Triangles are two sided and degenerate triangles are never hit.
+    */
+    class _OgreExport TriangleTree
+    {
+    public:
+        TriangleTree();
+
+        /** Builds the tree from the positions of the vertex data
+        @param vertexData the vertex data, the positions must be of type VET_FLOAT3
+        @param indexData the index data or NULL for non indexed geometry
+        @param opType only triangle lists, strips and fans are used, other types result in an
+            empty tree
+        */
+        void build(const VertexData* vertexData, const IndexData* indexData,
+                   RenderOperation::OperationType opType = RenderOperation::OT_TRIANGLE_LIST);
+        /// Builds the tree from a triangle list
+        void build(const std::vector<Vector3>& positions, const std::vector<uint32>& indices);
+        /// Removes all triangles
+        void clear();
+
+        bool empty() const { return mNodes.empty(); }
+        size_t getNumTriangles() const { return mNumTriangles; }
+
+        /** Finds the closest intersection of the ray with the triangles
+        @param ray the ray, the distance is returned in units of its direction
+        @param triangle if not NULL, receives the index of the hit triangle in the order it was
+            specified in the source data
+        */
+        RayTestResult intersects(const Ray& ray, size_t* triangle = NULL) const;
+
+        /** Finds the closest intersections of many rays
+
+            The rays are traversed in packets of ARRAY_PACKED_REALS, which is efficient for
+            coherent rays, i.e. rays with a similar origin and direction.
+        */
+        void intersects(const Ray* rays, size_t count, RayTestResult* results) const;
+
+    private:
+        struct Node
+        {
+            float min[3];
+            /// index of the second child or of the first batch for leaves
+            uint32 offset;
+            float max[3];
+            /// number of batches, 0 for inner nodes
+            uint16 numBatches;
+            /// split axis of inner nodes
+            uint16 axis;
+        };
+
+        /// ARRAY_PACKED_REALS triangles, stored as a vertex and the edges to the other vertices
+        struct TriangleBatch
+        {
+            Real v0[3][ARRAY_PACKED_REALS];
+            Real e1[3][ARRAY_PACKED_REALS];
+            Real e2[3][ARRAY_PACKED_REALS];
+            uint32 index[ARRAY_PACKED_REALS];
+        };
+
+        struct BuildTriangle;
+
+        std::vector<Node> mNodes;
+        std::vector<TriangleBatch> mBatches;
+        size_t mNumTriangles;
+
+        void build(std::vector<BuildTriangle>& triangles);
+        void buildNode(BuildTriangle* triangles, size_t count, size_t depth);
+        /// updates hit and triangle, if one of the batch's triangles is hit closer than hit.second
+        void intersects(const TriangleBatch& batch, const Ray& ray, RayTestResult& hit,
+                        size_t& triangle) const;
+    };
+    /** @} */
+    /** @} */
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
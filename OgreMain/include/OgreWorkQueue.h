@@ -168,6 +168,15 @@ namespace Ogre
 
         /** Add a new task to the queue */
         virtual void addTask(std::function<void()> task) = 0;
+
+        /** Call func for consecutive sub ranges of [begin, end), each at most grain elements long.
+
+            The sub ranges are processed by the worker threads and the calling thread. Returns once
+            all of them are done. Without thread support, or if the queue is not running, func is
+            called for all sub ranges on the calling thread.
+        */
+        virtual void parallelFor(size_t begin, size_t end, size_t grain,
+                                 const std::function<void(size_t, size_t)>& func);
         
         /** Set whether to pause further processing of any requests. 
         If true, any further requests will simply be queued and not processed until
@@ -299,6 +308,8 @@ namespace Ogre
         void setWorkerThreadCount(size_t c) override { mWorkerThreadCount = c; }
         void addMainThreadTask(std::function<void()> task) override;
         void addTask(std::function<void()> task) override;
+        void parallelFor(size_t begin, size_t end, size_t grain,
+                         const std::function<void(size_t, size_t)>& func) override;
     protected:
         String mName;
         size_t mWorkerThreadCount;
@@ -320,6 +331,46 @@ namespace Ogre
         virtual void notifyWorkers() = 0;
     };
 
+    /** A set of tasks with dependencies between them.
+
+        A task only starts once all the tasks it depends on are finished. The tasks are
+        processed by the worker threads of a WorkQueue and the calling thread of run().
+        Without thread support, or without a WorkQueue, they run serially in dependency order.
+    */
+    class _OgreExport TaskGraph : public UtilityAlloc
+    {
+    public:
+        typedef size_t TaskID;
+
+        /// Add a task to the graph
+        TaskID addTask(std::function<void()> task);
+
+        /// Make task wait until dependency is finished
+        void addDependency(TaskID task, TaskID dependency);
+
+        /** Run all tasks and return once they are finished.
+
+            The graph is not modified, so it can be run again.
+        @param queue The queue providing the worker threads, can be NULL
+        */
+        void run(WorkQueue* queue);
+
+        /// Remove all tasks
+        void clear() { mTasks.clear(); }
+
+        /// Number of tasks in the graph
+        size_t size() const { return mTasks.size(); }
+
+    private:
+        struct Task
+        {
+            std::function<void()> func;
+            std::vector<TaskID> successors;
+            size_t numDependencies;
+        };
+        std::vector<Task> mTasks;
+    };
+
 
 
 
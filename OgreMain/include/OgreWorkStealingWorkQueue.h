@@ -0,0 +1,135 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+#ifndef __OgreWorkStealingWorkQueue_H__
+#define __OgreWorkStealingWorkQueue_H__
+
+#include "OgreWorkQueue.h"
+#include "OgreHeaderPrefix.h"
+
+#include <atomic>
+
+namespace Ogre
+{
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup General
+    *  @{
+    */
+
+    /** Work queue using per-thread work-stealing task deques.
+
+        Tasks added by one of the worker threads or by the thread that called startup() are
+        pushed to a deque owned by that thread, without taking a lock. Idle workers steal from
+        the other deques, so many small tasks can be submitted without serialising on a single
+        queue. Tasks added by any other thread go through a shared, mutex protected queue.
+
+        Use TaskGroup to wait for a set of tasks or to schedule a continuation. A waiting
+        thread processes pending tasks instead of blocking, so waiting also works if the
+        queue was not started.
+
+        Root uses this instead of DefaultWorkQueue if the environment variable
+        @c OGRE_WORK_QUEUE is set to @c workstealing when it is created. Alternatively pass an
+        instance to Root::setWorkQueue.
+    */
+    class _OgreExport WorkStealingWorkQueue : public DefaultWorkQueueBase
+    {
+    public:
+        /** A set of tasks that can be waited for as a whole.
+        */
+        class _OgreExport TaskGroup
+        {
+        public:
+            TaskGroup(WorkStealingWorkQueue* queue);
+            /// Waits for all tasks of the group
+            ~TaskGroup();
+
+            /// Add a task to the group, must not be called after then()
+            void run(std::function<void()> task);
+
+            /** Wait until all tasks of the group are finished.
+
+                The calling thread processes pending tasks of the queue meanwhile.
+            */
+            void wait();
+
+            /** Add a task to the queue once all tasks of the group are finished.
+
+                This closes the group, no further tasks can be added afterwards.
+            */
+            void then(std::function<void()> continuation);
+
+        private:
+            struct State;
+            WorkStealingWorkQueue* mQueue;
+            std::shared_ptr<State> mState;
+            bool mOpen;
+        };
+
+        WorkStealingWorkQueue(const String& name = BLANKSTRING);
+        virtual ~WorkStealingWorkQueue();
+
+        /// Main function for each thread spawned.
+        void _threadMain() override;
+
+        /// @copydoc WorkQueue::shutdown
+        void shutdown() override;
+
+        /// @copydoc WorkQueue::startup
+        void startup(bool forceRestart = true) override;
+
+        /// @copydoc WorkQueue::addTask
+        void addTask(std::function<void()> task) override;
+
+        /// Process one pending task, if any
+        void _processNextRequest() override;
+
+        /** Process one pending task on the calling thread.
+        @return false if no task was pending
+        */
+        bool _processPendingTask();
+
+        /// @copydoc WorkQueue::parallelFor
+        void parallelFor(size_t begin, size_t end, size_t grain,
+                         const std::function<void(size_t, size_t)>& func) override;
+
+    protected:
+        class TaskDeque;
+
+        void notifyWorkers() override;
+
+        /// Returns the deque owned by the calling thread, or NULL
+        TaskDeque* getThreadDeque() const;
+
+        /// Notify that a thread has registered itself with the render system
+        void notifyThreadRegistered();
+
+        std::vector<TaskDeque*> mDeques;
+        /// Number of tasks which were added, but not yet taken for processing
+        std::atomic<size_t> mNumPending;
+        /// Number of workers waiting for new tasks
+        std::atomic<size_t> mNumSleeping;
+        /// Distinguishes the deques of one startup() from any other
+        uint32 mGeneration;
+
+        size_t mNumThreadsRegisteredWithRS;
+        /// Init notification mutex (must lock before waiting on initCondition)
+        OGRE_WQ_MUTEX(mInitMutex);
+        /// Synchroniser token to wait / notify on thread init
+        OGRE_WQ_THREAD_SYNCHRONISER(mInitSync);
+
+        OGRE_WQ_MUTEX(mSleepMutex);
+        OGRE_WQ_THREAD_SYNCHRONISER(mWakeCondition);
+#if OGRE_THREAD_SUPPORT
+        typedef std::vector<OGRE_THREAD_TYPE*> WorkerThreadList;
+        WorkerThreadList mWorkers;
+#endif
+    };
+    /** @} */
+    /** @} */
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -65,6 +65,18 @@ namespace Ogre {
         //! @endcond
 
         Archive *createInstance( const String& name, bool readOnly ) override;
+
+        /** Set whether deflated entries are inflated while the returned stream is read.
+
+        By default entries are inflated completely when opened. Streaming avoids holding the
+        whole entry in memory, but the stream is slower to seek backwards.
+        Entries stored without compression are always returned as MemoryDataStream on the
+        archive data, without copying them.
+        */
+        static void setStreamCompressedEntries(bool stream);
+
+        /// Get whether deflated entries are inflated while the returned stream is read.
+        static bool getStreamCompressedEntries();
     };
 
     /** Specialisation of ZipArchiveFactory for embedded Zip files. */
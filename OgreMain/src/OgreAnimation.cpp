@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "OgreStableHeaders.h"
 #include "OgreAnimation.h"
 #include "OgreKeyFrame.h"
+#include "OgreArrayMath.h"
 
 namespace Ogre {
 
@@ -326,36 +327,154 @@ namespace Ogre {
     void Animation::apply(Skeleton* skel, Real timePos, Real weight,
         Real scale)
     {
-        _applyBaseKeyFrame();
-
         // Calculate time index for fast keyframe search
-        TimeIndex timeIndex = _getTimeIndex(timePos);
-
-        for (auto& t : mNodeTrackList)
-        {
-            // get bone to apply to
-            Bone* b = skel->getBone(t.first);
-            t.second->applyToNode(b, timeIndex, weight, scale);
-        }
-
-
+        apply(skel, _getTimeIndex(timePos), weight, NULL, scale);
     }
     //---------------------------------------------------------------------
     void Animation::apply(Skeleton* skel, Real timePos, float weight,
       const AnimationState::BoneBlendMask* blendMask, Real scale)
+    {
+        // Calculate time index for fast keyframe search
+        apply(skel, _getTimeIndex(timePos), weight, blendMask, scale);
+    }
+    //---------------------------------------------------------------------
+    void Animation::apply(Skeleton* skel, const TimeIndex& timeIndex, float weight,
+      const AnimationState::BoneBlendMask* blendMask, Real scale)
     {
         _applyBaseKeyFrame();
 
-        // Calculate time index for fast keyframe search
-        TimeIndex timeIndex = _getTimeIndex(timePos);
+        if (mInterpolationMode != IM_LINEAR)
+        {
+            for (auto& t : mNodeTrackList)
+            {
+                Bone* b = skel->getBone(t.first);
+                t.second->applyToNode(b, timeIndex, blendMask ? (*blendMask)[b->getHandle()] * weight : weight,
+                                      scale);
+            }
+            return;
+        }
+
+        // batches of tracks, separated by whether they use the shortest rotation path
+        NodeAnimationTrack* tracks[2][ARRAY_PACKED_REALS];
+        Bone* bones[2][ARRAY_PACKED_REALS];
+        Real weights[2][ARRAY_PACKED_REALS];
+        size_t counts[2] = {0, 0};
 
         for (auto& t : mNodeTrackList)
         {
+            NodeAnimationTrack* track = t.second;
             Bone* b = skel->getBone(t.first);
-            t.second->applyToNode(b, timeIndex, (*blendMask)[b->getHandle()] * weight, scale);
+            Real w = blendMask ? (*blendMask)[b->getHandle()] * weight : weight;
+
+            // Nothing to do if no keyframes or zero weight, same as applyToNode
+            if (track->mKeyFrames.empty() || !w)
+                continue;
+
+            if (track->mListener)
+            {
+                track->applyToNode(b, timeIndex, w, scale);
+                continue;
+            }
+
+            int batch = track->mUseShortestRotationPath;
+            size_t& count = counts[batch];
+            tracks[batch][count] = track;
+            bones[batch][count] = b;
+            weights[batch][count] = w;
+            if (++count == ARRAY_PACKED_REALS)
+            {
+                applyToBones(tracks[batch], bones[batch], weights[batch], count, timeIndex, scale, batch);
+                count = 0;
+            }
+        }
+
+        for (int batch = 0; batch < 2; ++batch)
+        {
+            if (counts[batch])
+                applyToBones(tracks[batch], bones[batch], weights[batch], counts[batch], timeIndex, scale, batch);
         }
     }
     //---------------------------------------------------------------------
+    void Animation::applyToBones(NodeAnimationTrack* const* tracks, Bone* const* bones, const Real* weights,
+                                 size_t count, const TimeIndex& timeIndex, Real scale, bool shortestPath) const
+    {
+        using namespace ArrayMath;
+
+        // Same as NodeAnimationTrack::getInterpolatedKeyFrame and applyToNode, for several tracks
+        const Quaternion* rotations[2][ARRAY_PACKED_REALS];
+        const Vector3* translations[2][ARRAY_PACKED_REALS];
+        const Vector3* scales[2][ARRAY_PACKED_REALS];
+        Real t[ARRAY_PACKED_REALS], w[ARRAY_PACKED_REALS];
+        Real scaleWeights[ARRAY_PACKED_REALS], blendScales[ARRAY_PACKED_REALS];
+        for (size_t i = 0; i < ARRAY_PACKED_REALS; ++i)
+        {
+            size_t track = std::min(i, count - 1);
+            KeyFrame *k1, *k2;
+            t[i] = tracks[track]->getKeyFramesAtTime(timeIndex, &k1, &k2);
+            for (int k = 0; k < 2; ++k)
+            {
+                const TransformKeyFrame* kf = static_cast<const TransformKeyFrame*>(k ? k2 : k1);
+                rotations[k][i] = &kf->getRotation();
+                translations[k][i] = &kf->getTranslate();
+                scales[k][i] = &kf->getScale();
+            }
+            w[i] = weights[track];
+            // the scaling is only blended, if the scale or the weight changes it
+            scaleWeights[i] = scale != 1.0f ? scale : w[i];
+            blendScales[i] = scale != 1.0f || w[i] != 1.0f;
+        }
+
+        ArrayReal at = load(t);
+        ArrayReal aw = load(w);
+
+        ArrayQuaternion k1, k2;
+        k1.load(rotations[0]);
+        k2.load(rotations[1]);
+        ArrayVector3 translate1, translate2, scale1, scale2;
+        translate1.load(translations[0]);
+        translate2.load(translations[1]);
+        scale1.load(scales[0]);
+        scale2.load(scales[1]);
+
+        ArrayQuaternion rotate;
+        if (mRotationInterpolationMode == RIM_LINEAR)
+            rotate = ArrayQuaternion::nlerp(at, k1, k2, shortestPath);
+        else
+            rotate = ArrayQuaternion::Slerp(at, k1, k2, shortestPath);
+        // at the keyframe, its rotation is used as is
+        ArrayReal interpolate = cmpGreater(at, set1(0));
+        rotate = ArrayQuaternion(select(interpolate, rotate.w, k1.w), select(interpolate, rotate.x, k1.x),
+                                 select(interpolate, rotate.y, k1.y), select(interpolate, rotate.z, k1.z));
+
+        ArrayVector3 translate = translate1 + (translate2 - translate1) * at;
+        translate = translate * aw * set1(scale);
+
+        // interpolate between no-rotation and full rotation, to point 'weight'
+        ArrayQuaternion identity(Quaternion::IDENTITY);
+        if (mRotationInterpolationMode == RIM_LINEAR)
+            rotate = ArrayQuaternion::nlerp(aw, identity, rotate, shortestPath);
+        else
+            rotate = ArrayQuaternion::Slerp(aw, identity, rotate, shortestPath);
+
+        ArrayVector3 scaling = scale1 + (scale2 - scale1) * at;
+        ArrayReal scaleWeight = load(scaleWeights);
+        ArrayVector3 unitScale(Vector3::UNIT_SCALE);
+        ArrayVector3 blendedScaling = unitScale + (scaling - unitScale) * scaleWeight;
+        ArrayReal blendScale = cmpGreater(load(blendScales), set1(0));
+        scaling = ArrayVector3(select(blendScale, blendedScaling.x, scaling.x),
+                               select(blendScale, blendedScaling.y, scaling.y),
+                               select(blendScale, blendedScaling.z, scaling.z));
+
+        Vector3 translateOut[ARRAY_PACKED_REALS], scaleOut[ARRAY_PACKED_REALS];
+        Quaternion rotateOut[ARRAY_PACKED_REALS];
+        translate.storePacked(translateOut, count);
+        rotate.storePacked(rotateOut, count);
+        scaling.storePacked(scaleOut, count);
+
+        for (size_t i = 0; i < count; ++i)
+            bones[i]->_applyAnimation(translateOut[i], rotateOut[i], scaleOut[i]);
+    }
+    //---------------------------------------------------------------------
     void Animation::apply(Entity* entity, Real timePos, Real weight,
         bool software, bool hardware)
     {
@@ -592,6 +711,12 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------
     TimeIndex Animation::_getTimeIndex(Real timePos) const
+    {
+        uint keyIndex = 0;
+        return _getTimeIndex(timePos, keyIndex);
+    }
+    //-----------------------------------------------------------------------
+    TimeIndex Animation::_getTimeIndex(Real timePos, uint& keyIndexHint) const
     {
         // Uncomment following statement for work as previous
         //return timePos;
@@ -612,9 +737,39 @@ namespace Ogre {
         if (mKeyFrameTimes.empty())
             return timePos;
 
+        // The global index is the first key time >= timePos, clamped to the last key.
+        // Try the hint and its successor, before searching for it.
+        uint lastKey = static_cast<uint>(mKeyFrameTimes.size() - 1);
+        for (uint i = keyIndexHint; i <= std::min(keyIndexHint + 1, lastKey); ++i)
+        {
+            if ((i == lastKey || timePos <= mKeyFrameTimes[i]) && (i == 0 || mKeyFrameTimes[i - 1] < timePos))
+            {
+                keyIndexHint = i;
+                return TimeIndex(timePos, i);
+            }
+        }
+
         // Search for global index
         auto it = std::lower_bound(mKeyFrameTimes.begin(), mKeyFrameTimes.end() - 1, timePos);
-        return TimeIndex(timePos, static_cast<uint>(std::distance(mKeyFrameTimes.begin(), it)));
+        keyIndexHint = static_cast<uint>(std::distance(mKeyFrameTimes.begin(), it));
+        return TimeIndex(timePos, keyIndexHint);
+    }
+    //-----------------------------------------------------------------------
+    void Animation::_prepareForApply()
+    {
+        _applyBaseKeyFrame();
+
+        if (mKeyFrameTimesDirty)
+            buildKeyFrameTimeList();
+
+        if (mInterpolationMode == IM_SPLINE)
+        {
+            for (auto& i : mNodeTrackList)
+            {
+                if (i.second->mSplineBuildNeeded)
+                    i.second->buildInterpolationSplines();
+            }
+        }
     }
     //-----------------------------------------------------------------------
     void Animation::buildKeyFrameTimeList(void) const
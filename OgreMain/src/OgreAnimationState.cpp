@@ -41,6 +41,7 @@ namespace Ogre
         , mWeight(rhs.mWeight)
         , mEnabled(rhs.mEnabled)
         , mLoop(rhs.mLoop)
+        , mKeyIndexHint(0)
   {
         mParent->_notifyDirty();
     }
@@ -55,6 +56,7 @@ namespace Ogre
         , mWeight(weight)
         , mEnabled(enabled)
         , mLoop(true)
+        , mKeyIndexHint(0)
     {
         mParent->_notifyDirty();
     }
@@ -0,0 +1,59 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+#include "OgreStableHeaders.h"
+#include "OgreArrayMath.h"
+
+namespace Ogre {
+
+    ArrayQuaternion ArrayQuaternion::Slerp(ArrayReal fT, const ArrayQuaternion& rkP, const ArrayQuaternion& rkQ,
+                                           bool shortestPath)
+    {
+        using namespace ArrayMath;
+
+        // Do we need to invert rotation?
+        ArrayQuaternion rkT = shortestPath ? rkQ.flipTo(rkP) : rkQ;
+        ArrayReal cosAngle = rkP.Dot(rkT);
+
+        // only the angles are computed per lane, everything else is vectorised
+        Real fCos[ARRAY_PACKED_REALS], t[ARRAY_PACKED_REALS];
+        Real coeff0[ARRAY_PACKED_REALS], coeff1[ARRAY_PACKED_REALS], linear[ARRAY_PACKED_REALS];
+        ArrayMath::store(fCos, cosAngle);
+        ArrayMath::store(t, fT);
+        for (size_t i = 0; i < ARRAY_PACKED_REALS; ++i)
+        {
+            if (Math::Abs(fCos[i]) < 1 - Quaternion::msEpsilon)
+            {
+                // Standard case (slerp)
+                Real fSin = std::sqrt(1 - Math::Sqr(fCos[i]));
+                Real fAngle = std::atan2(fSin, fCos[i]);
+                Real fInvSin = 1.0f / fSin;
+                coeff0[i] = std::sin((1.0f - t[i]) * fAngle) * fInvSin;
+                coeff1[i] = std::sin(t[i] * fAngle) * fInvSin;
+                linear[i] = 0;
+            }
+            else
+            {
+                // nearly parallel, linear interpolation as in Quaternion::Slerp
+                coeff0[i] = 1.0f - t[i];
+                coeff1[i] = t[i];
+                linear[i] = 1;
+            }
+        }
+
+        ArrayQuaternion result = rkP * ArrayMath::load(coeff0) + rkT * ArrayMath::load(coeff1);
+
+        ArrayReal linearMask = cmpGreater(ArrayMath::load(linear), set1(0));
+        if (any(linearMask))
+        {
+            // taking the complement requires renormalisation
+            ArrayQuaternion normalised = result;
+            normalised.normalise();
+            result = ArrayQuaternion(select(linearMask, normalised.w, result.w),
+                                     select(linearMask, normalised.x, result.x),
+                                     select(linearMask, normalised.y, result.y),
+                                     select(linearMask, normalised.z, result.z));
+        }
+        return result;
+    }
+}
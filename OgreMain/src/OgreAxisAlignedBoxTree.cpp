@@ -0,0 +1,388 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+#include "OgreStableHeaders.h"
+#include "OgreAxisAlignedBoxTree.h"
+
+namespace Ogre
+{
+    static AxisAlignedBox combine(const AxisAlignedBox& a, const AxisAlignedBox& b)
+    {
+        Vector3 min = a.getMinimum(), max = a.getMaximum();
+        min.makeFloor(b.getMinimum());
+        max.makeCeil(b.getMaximum());
+        return AxisAlignedBox(min, max);
+    }
+
+    /// half the surface area, which is all the cost comparisons need
+    static Real area(const AxisAlignedBox& box)
+    {
+        Vector3 d = box.getMaximum() - box.getMinimum();
+        return d.x * d.y + d.y * d.z + d.z * d.x;
+    }
+
+    static Real combinedArea(const AxisAlignedBox& a, const AxisAlignedBox& b)
+    {
+        Vector3 min = a.getMinimum(), max = a.getMaximum();
+        min.makeFloor(b.getMinimum());
+        max.makeCeil(b.getMaximum());
+        Vector3 d = max - min;
+        return d.x * d.y + d.y * d.z + d.z * d.x;
+    }
+    //-----------------------------------------------------------------------
+    AxisAlignedBoxTree::AxisAlignedBoxTree() : mRoot(NULL_NODE), mFreeList(NULL_NODE), mNumProxies(0), mMargin(0.1)
+    {
+    }
+    //-----------------------------------------------------------------------
+    int AxisAlignedBoxTree::allocateNode()
+    {
+        int index = mFreeList;
+        if (index == NULL_NODE)
+        {
+            index = int(mNodes.size());
+            mNodes.emplace_back();
+        }
+        else
+        {
+            mFreeList = mNodes[index].parent;
+        }
+
+        Node& node = mNodes[index];
+        node.userData = NULL;
+        node.parent = NULL_NODE;
+        node.child1 = NULL_NODE;
+        node.child2 = NULL_NODE;
+        node.height = 0;
+        return index;
+    }
+    //-----------------------------------------------------------------------
+    void AxisAlignedBoxTree::freeNode(int node)
+    {
+        mNodes[node].parent = mFreeList;
+        mNodes[node].height = -1;
+        mFreeList = node;
+    }
+    //-----------------------------------------------------------------------
+    AxisAlignedBox AxisAlignedBoxTree::enlarge(const AxisAlignedBox& box) const
+    {
+        Vector3 margin = box.getSize() * mMargin;
+        return AxisAlignedBox(box.getMinimum() - margin, box.getMaximum() + margin);
+    }
+    //-----------------------------------------------------------------------
+    int AxisAlignedBoxTree::createProxy(const AxisAlignedBox& box, void* userData)
+    {
+        OgreAssert(box.isFinite(), "only finite boxes can be stored");
+        int proxy = allocateNode();
+        mNodes[proxy].box = enlarge(box);
+        mNodes[proxy].userData = userData;
+        insertLeaf(proxy);
+        ++mNumProxies;
+        return proxy;
+    }
+    //-----------------------------------------------------------------------
+    void AxisAlignedBoxTree::destroyProxy(int proxyId)
+    {
+        OgreAssert(proxyId >= 0 && size_t(proxyId) < mNodes.size() && mNodes[proxyId].height == 0,
+                   "invalid proxy");
+        removeLeaf(proxyId);
+        freeNode(proxyId);
+        --mNumProxies;
+    }
+    //-----------------------------------------------------------------------
+    bool AxisAlignedBoxTree::moveProxy(int proxyId, const AxisAlignedBox& box)
+    {
+        OgreAssert(proxyId >= 0 && size_t(proxyId) < mNodes.size() && mNodes[proxyId].height == 0,
+                   "invalid proxy");
+        OgreAssert(box.isFinite(), "only finite boxes can be stored");
+
+        AxisAlignedBox fatBox = enlarge(box);
+        const AxisAlignedBox& current = mNodes[proxyId].box;
+        // also shrink boxes that became far too loose, e.g. of emptied particle systems
+        if (current.contains(box) && area(current) <= 4 * area(fatBox))
+            return false;
+
+        removeLeaf(proxyId);
+        mNodes[proxyId].box = fatBox;
+        insertLeaf(proxyId);
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void AxisAlignedBoxTree::clear()
+    {
+        mNodes.clear();
+        mRoot = NULL_NODE;
+        mFreeList = NULL_NODE;
+        mNumProxies = 0;
+    }
+    //-----------------------------------------------------------------------
+    void AxisAlignedBoxTree::insertLeaf(int leaf)
+    {
+        if (mRoot == NULL_NODE)
+        {
+            mRoot = leaf;
+            mNodes[leaf].parent = NULL_NODE;
+            return;
+        }
+
+        // descend to the sibling with the lowest cost, i.e. the area of the new parent
+        // plus the area increase of all its ancestors
+        const AxisAlignedBox leafBox = mNodes[leaf].box;
+        int index = mRoot;
+        while (!mNodes[index].isLeaf())
+        {
+            const Node& node = mNodes[index];
+            Real nodeArea = area(node.box);
+            Real mergedArea = combinedArea(node.box, leafBox);
+
+            // cost of creating a new parent for this node and the leaf
+            Real cost = 2 * mergedArea;
+            // minimum cost of pushing the leaf further down
+            Real inheritanceCost = 2 * (mergedArea - nodeArea);
+
+            Real childCost[2];
+            int children[2] = {node.child1, node.child2};
+            for (int i = 0; i < 2; ++i)
+            {
+                const Node& child = mNodes[children[i]];
+                childCost[i] = combinedArea(child.box, leafBox) + inheritanceCost;
+                if (!child.isLeaf())
+                    childCost[i] -= area(child.box);
+            }
+
+            if (cost < childCost[0] && cost < childCost[1])
+                break;
+
+            index = childCost[0] < childCost[1] ? children[0] : children[1];
+        }
+
+        int sibling = index;
+        int oldParent = mNodes[sibling].parent;
+        int newParent = allocateNode();
+        Node& parent = mNodes[newParent];
+        parent.parent = oldParent;
+        parent.box = combine(leafBox, mNodes[sibling].box);
+        parent.height = mNodes[sibling].height + 1;
+        parent.child1 = sibling;
+        parent.child2 = leaf;
+
+        if (oldParent != NULL_NODE)
+        {
+            if (mNodes[oldParent].child1 == sibling)
+                mNodes[oldParent].child1 = newParent;
+            else
+                mNodes[oldParent].child2 = newParent;
+        }
+        else
+        {
+            mRoot = newParent;
+        }
+        mNodes[sibling].parent = newParent;
+        mNodes[leaf].parent = newParent;
+
+        refit(oldParent);
+    }
+    //-----------------------------------------------------------------------
+    void AxisAlignedBoxTree::removeLeaf(int leaf)
+    {
+        if (leaf == mRoot)
+        {
+            mRoot = NULL_NODE;
+            return;
+        }
+
+        int parent = mNodes[leaf].parent;
+        int grandParent = mNodes[parent].parent;
+        int sibling = mNodes[parent].child1 == leaf ? mNodes[parent].child2 : mNodes[parent].child1;
+
+        freeNode(parent);
+        mNodes[sibling].parent = grandParent;
+        if (grandParent == NULL_NODE)
+        {
+            mRoot = sibling;
+            return;
+        }
+
+        if (mNodes[grandParent].child1 == parent)
+            mNodes[grandParent].child1 = sibling;
+        else
+            mNodes[grandParent].child2 = sibling;
+        refit(grandParent);
+    }
+    //-----------------------------------------------------------------------
+    void AxisAlignedBoxTree::refit(int index)
+    {
+        while (index != NULL_NODE)
+        {
+            index = balance(index);
+
+            Node& node = mNodes[index];
+            const Node& child1 = mNodes[node.child1];
+            const Node& child2 = mNodes[node.child2];
+            node.height = 1 + std::max(child1.height, child2.height);
+            node.box = combine(child1.box, child2.box);
+
+            index = node.parent;
+        }
+    }
+    //-----------------------------------------------------------------------
+    int AxisAlignedBoxTree::balance(int iA)
+    {
+        Node& A = mNodes[iA];
+        if (A.isLeaf() || A.height < 2)
+            return iA;
+
+        int iB = A.child1;
+        int iC = A.child2;
+        int difference = mNodes[iC].height - mNodes[iB].height;
+        if (difference >= -1 && difference <= 1)
+            return iA;
+
+        // rotate the higher child up, A takes the place of its lower grandchild
+        bool rotateC = difference > 1;
+        int iUp = rotateC ? iC : iB;
+        int iOther = rotateC ? iB : iC;
+        Node& up = mNodes[iUp];
+        int iF = up.child1;
+        int iG = up.child2;
+
+        up.child1 = iA;
+        up.parent = A.parent;
+        A.parent = iUp;
+
+        if (up.parent != NULL_NODE)
+        {
+            if (mNodes[up.parent].child1 == iA)
+                mNodes[up.parent].child1 = iUp;
+            else
+                mNodes[up.parent].child2 = iUp;
+        }
+        else
+        {
+            mRoot = iUp;
+        }
+
+        // the higher grandchild stays below up, the lower one moves below A
+        int iKeep = mNodes[iF].height > mNodes[iG].height ? iF : iG;
+        int iMove = iKeep == iF ? iG : iF;
+        up.child2 = iKeep;
+        if (rotateC)
+            A.child2 = iMove;
+        else
+            A.child1 = iMove;
+        mNodes[iMove].parent = iA;
+
+        A.box = combine(mNodes[iOther].box, mNodes[iMove].box);
+        A.height = 1 + std::max(mNodes[iOther].height, mNodes[iMove].height);
+        up.box = combine(A.box, mNodes[iKeep].box);
+        up.height = 1 + std::max(A.height, mNodes[iKeep].height);
+
+        return iUp;
+    }
+    //-----------------------------------------------------------------------
+    void AxisAlignedBoxTree::rebuild()
+    {
+        std::vector<int> leaves;
+        leaves.reserve(mNumProxies);
+        for (int i = 0; i < int(mNodes.size()); ++i)
+        {
+            if (mNodes[i].height < 0)
+                continue;
+            if (mNodes[i].isLeaf())
+                leaves.push_back(i);
+            else
+                freeNode(i);
+        }
+
+        mRoot = leaves.empty() ? NULL_NODE : build(leaves.data(), leaves.size());
+        if (mRoot != NULL_NODE)
+            mNodes[mRoot].parent = NULL_NODE;
+    }
+    //-----------------------------------------------------------------------
+    int AxisAlignedBoxTree::build(int* leaves, size_t count)
+    {
+        if (count == 1)
+            return leaves[0];
+
+        AxisAlignedBox centroidBounds;
+        for (size_t i = 0; i < count; ++i)
+            centroidBounds.merge(mNodes[leaves[i]].box.getCenter());
+
+        // evaluate the SAH on the bin boundaries of each axis
+        const int NUM_BINS = 16;
+        Vector3 cmin = centroidBounds.getMinimum();
+        Vector3 extent = centroidBounds.getSize();
+        int bestAxis = -1, bestSplit = 0;
+        Real bestCost = std::numeric_limits<Real>::max();
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            if (extent[axis] <= 0)
+                continue;
+
+            AxisAlignedBox binBoxes[NUM_BINS];
+            size_t binCounts[NUM_BINS] = {};
+            Real scale = NUM_BINS / extent[axis];
+            for (size_t i = 0; i < count; ++i)
+            {
+                const AxisAlignedBox& box = mNodes[leaves[i]].box;
+                int bin = std::min(int((box.getCenter()[axis] - cmin[axis]) * scale), NUM_BINS - 1);
+                binBoxes[bin].merge(box);
+                ++binCounts[bin];
+            }
+
+            // sweep from the right, then evaluate the splits while sweeping from the left
+            Real rightCost[NUM_BINS];
+            AxisAlignedBox accum;
+            size_t accumCount = 0;
+            for (int b = NUM_BINS - 1; b > 0; --b)
+            {
+                accum.merge(binBoxes[b]);
+                accumCount += binCounts[b];
+                rightCost[b] = accumCount ? area(accum) * accumCount : 0;
+            }
+            accum.setNull();
+            accumCount = 0;
+            for (int b = 0; b < NUM_BINS - 1; ++b)
+            {
+                accum.merge(binBoxes[b]);
+                accumCount += binCounts[b];
+                Real cost = (accumCount ? area(accum) * accumCount : 0) + rightCost[b + 1];
+                if (accumCount && accumCount < count && cost < bestCost)
+                {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestSplit = b + 1;
+                }
+            }
+        }
+
+        size_t mid;
+        if (bestAxis < 0)
+        {
+            // all centroids coincide, split in the middle
+            mid = count / 2;
+        }
+        else
+        {
+            Real scale = NUM_BINS / extent[bestAxis];
+            Real axisMin = cmin[bestAxis];
+            int* split = std::partition(leaves, leaves + count, [&](int leaf) {
+                int bin = int((mNodes[leaf].box.getCenter()[bestAxis] - axisMin) * scale);
+                return std::min(bin, NUM_BINS - 1) < bestSplit;
+            });
+            mid = split - leaves;
+        }
+
+        int child1 = build(leaves, mid);
+        int child2 = build(leaves + mid, count - mid);
+
+        int index = allocateNode();
+        Node& node = mNodes[index];
+        node.child1 = child1;
+        node.child2 = child2;
+        node.box = combine(mNodes[child1].box, mNodes[child2].box);
+        node.height = 1 + std::max(mNodes[child1].height, mNodes[child2].height);
+        mNodes[child1].parent = index;
+        mNodes[child2].parent = index;
+        return index;
+    }
+}
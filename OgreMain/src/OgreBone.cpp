@@ -26,6 +26,7 @@ THE SOFTWARE.
 -----------------------------------------------------------------------------
 */
 #include "OgreStableHeaders.h"
+#include "OgreArrayMath.h"
 
 namespace Ogre {
 
@@ -104,6 +105,62 @@ namespace Ogre {
         m.makeTransform(locTranslate, locScale, locRotate);
     }
     //---------------------------------------------------------------------
+    void Bone::_getOffsetTransforms(Bone* const* bones, size_t numBones, Affine3* pMatrices)
+    {
+        for (size_t i = 0; i < numBones; i += ARRAY_PACKED_REALS)
+        {
+            size_t count = std::min(numBones - i, ARRAY_PACKED_REALS);
+
+            const Vector3* scale[ARRAY_PACKED_REALS];
+            const Vector3* position[ARRAY_PACKED_REALS];
+            const Quaternion* orientation[ARRAY_PACKED_REALS];
+            const Vector3* bindScale[ARRAY_PACKED_REALS];
+            const Vector3* bindPosition[ARRAY_PACKED_REALS];
+            const Quaternion* bindOrientation[ARRAY_PACKED_REALS];
+            for (size_t j = 0; j < count; ++j)
+            {
+                const Bone* b = bones[i + j];
+                scale[j] = &b->_getDerivedScale();
+                position[j] = &b->_getDerivedPosition();
+                orientation[j] = &b->_getDerivedOrientation();
+                bindScale[j] = &b->mBindDerivedInverseScale;
+                bindPosition[j] = &b->mBindDerivedInversePosition;
+                bindOrientation[j] = &b->mBindDerivedInverseOrientation;
+            }
+
+            ArrayVector3 locScale, locTranslate, tmp;
+            ArrayQuaternion locRotate, bindRotate;
+
+            // same as _getOffsetTransform
+            locScale.load(scale, count);
+            tmp.load(bindScale, count);
+            locScale = locScale * tmp;
+
+            locRotate.load(orientation, count);
+            bindRotate.load(bindOrientation, count);
+            locRotate = locRotate * bindRotate;
+
+            locTranslate.load(position, count);
+            tmp.load(bindPosition, count);
+            locTranslate = locTranslate + locRotate * (locScale * tmp);
+
+            ArrayAffine3 m;
+            m.makeTransform(locTranslate, locScale, locRotate);
+            m.storePacked(pMatrices + i, count);
+        }
+    }
+    //---------------------------------------------------------------------
+    void Bone::_applyAnimation(const Vector3& translation, const Quaternion& rotation, const Vector3& scaling)
+    {
+        // same as translate, rotate and scale
+        mPosition += translation;
+        mOrientation = mOrientation * rotation;
+        mOrientation.normalise();
+        mScale = mScale * scaling;
+
+        needUpdate();
+    }
+    //---------------------------------------------------------------------
     void Bone::needUpdate(bool forceParentUpdate)
     {
         Node::needUpdate(forceParentUpdate);
@@ -896,6 +896,19 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    void Camera::isVisible(const float* const minimum[3], const float* const maximum[3], size_t numBoxes,
+                           uint32* visibleMask) const
+    {
+        if (mCullFrustum)
+        {
+            mCullFrustum->isVisible(minimum, maximum, numBoxes, visibleMask);
+        }
+        else
+        {
+            Frustum::isVisible(minimum, maximum, numBoxes, visibleMask);
+        }
+    }
+    //-----------------------------------------------------------------------
     const Frustum::Corners& Camera::getWorldSpaceCorners(void) const
     {
         if (mCullFrustum)
@@ -457,6 +457,12 @@ namespace Ogre {
         return mPos >= mEnd;
     }
     //-----------------------------------------------------------------------
+    String MemoryDataStream::getAsString(void)
+    {
+        mPos = mEnd;
+        return String(reinterpret_cast<const char*>(mData), mEnd - mData);
+    }
+    //-----------------------------------------------------------------------
     void MemoryDataStream::close(void)    
     {
         mAccess = 0;
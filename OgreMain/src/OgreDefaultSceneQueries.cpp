@@ -29,85 +29,222 @@ THE SOFTWARE.
 
 namespace Ogre {
     //---------------------------------------------------------------------
-    DefaultIntersectionSceneQuery::DefaultIntersectionSceneQuery(SceneManager* creator)
-    : IntersectionSceneQuery(creator)
+    SceneManager::SceneQueryTree::SceneQueryTree() : mSyncCount(0), mChangedLimit(64)
     {
+        for (auto& b : mBounds)
+            b.syncAll = true;
     }
     //---------------------------------------------------------------------
-    DefaultIntersectionSceneQuery::~DefaultIntersectionSceneQuery()
+    void SceneManager::SceneQueryTree::markChanged(const MovableObject* obj, BoundsType type)
     {
+        Bounds& bounds = mBounds[type];
+        // already synchronising everything, which is also the state until the first query
+        if (bounds.syncAll.load(std::memory_order_relaxed))
+            return;
+
+        OGRE_LOCK_MUTEX(mChangedMutex);
+        // rather start over than keep growing, if no queries are made
+        if (bounds.changed.size() >= mChangedLimit)
+        {
+            bounds.changed.clear();
+            bounds.syncAll = true;
+            return;
+        }
+        bounds.changed.push_back(obj);
     }
     //---------------------------------------------------------------------
-    void DefaultIntersectionSceneQuery::execute(IntersectionSceneQueryListener* listener)
+    bool SceneManager::SceneQueryTree::updateProxy(Proxy& proxy, BoundsType type)
     {
-        // Iterate over all movable types
-        const auto& factories = Root::getSingleton().getMovableObjectFactories();
-        auto factIt = factories.begin();
-        while(factIt != factories.end())
+        AxisAlignedBox box;
+        if (type == BT_BOX)
         {
-            const auto& objsA = mParentSceneMgr->getMovableObjects((factIt++)->first);
-            auto objItA = objsA.begin();
-            while (objItA != objsA.end())
-            {
-                MovableObject* a = (objItA++)->second;
-                // skip entire section if type doesn't match
-                if (!(a->getTypeFlags() & mQueryTypeMask))
-                    break;
+            box = proxy.object->getWorldBoundingBox();
+        }
+        else
+        {
+            const Sphere& sphere = proxy.object->getWorldBoundingSphere();
+            Vector3 radius(sphere.getRadius());
+            if (Math::isNaN(sphere.getRadius()) || sphere.getRadius() == Math::POS_INFINITY)
+                box.setInfinite();
+            else
+                box.setExtents(sphere.getCenter() - radius, sphere.getCenter() + radius);
+        }
 
-                // Skip if a does not pass the mask
-                if (!(a->getQueryFlags() & mQueryMask) || !a->isInScene())
-                    continue;
+        Bounds& bounds = mBounds[type];
+        int& id = proxy.id[type];
+        if (box.isInfinite())
+        {
+            if (id >= 0)
+                bounds.tree.destroyProxy(id);
+            if (id != -1)
+                bounds.infinite.push_back(&proxy);
+            id = -1;
+            return false;
+        }
 
-                // Check against later objects in the same group
-                auto objItB = objItA;
-                while (objItB != objsA.end())
-                {
-                    MovableObject* b = (objItB++)->second;
+        if (id == -1)
+        {
+            bounds.infinite.erase(std::find(bounds.infinite.begin(), bounds.infinite.end(), &proxy));
+            id = -2;
+        }
 
-                    // Apply mask to b (both must pass)
-                    if ((b->getQueryFlags() & mQueryMask) && b->isInScene())
-                    {
-                        const AxisAlignedBox& box1 = a->getWorldBoundingBox();
-                        const AxisAlignedBox& box2 = b->getWorldBoundingBox();
+        if (box.isNull())
+        {
+            // null boxes never intersect anything
+            if (id >= 0)
+                bounds.tree.destroyProxy(id);
+            id = -2;
+            return false;
+        }
 
-                        if (box1.intersects(box2))
-                        {
-                            if (!listener->queryResult(a, b)) return;
-                        }
-                    }
-                }
-                // Check  against later groups
-                auto factItLater = factIt;
-                while (factItLater != factories.end())
+        if (id < 0)
+        {
+            id = bounds.tree.createProxy(box, &proxy);
+            return true;
+        }
+        return bounds.tree.moveProxy(id, box);
+    }
+    //---------------------------------------------------------------------
+    void SceneManager::SceneQueryTree::update(SceneManager* sm, BoundsType type)
+    {
+        OGRE_LOCK_MUTEX(mMutex);
+        Bounds& bounds = mBounds[type];
+
+        std::vector<const MovableObject*> changed;
+        bool syncAll;
+        {
+            // reset first, so changes while synchronising are picked up by the next query
+            OGRE_LOCK_MUTEX(mChangedMutex);
+            changed.swap(bounds.changed);
+            syncAll = bounds.syncAll.exchange(false);
+            mChangedLimit = std::max<size_t>(mProxies.size(), 64);
+        }
+
+        size_t inserted = 0;
+        if (!syncAll)
+        {
+            for (auto obj : changed)
+            {
+                // ignore objects not in the collections, e.g. cameras
+                auto it = mProxies.find(const_cast<MovableObject*>(obj));
+                if (it != mProxies.end())
+                    inserted += updateProxy(it->second, type);
+            }
+        }
+        else
+        {
+            ++mSyncCount;
+            uint32 rank = 0;
+
+            // same order as iterating the objects directly
+            for (const auto& factIt : Root::getSingleton().getMovableObjectFactories())
+            {
+                for (const auto& objIt : sm->getMovableObjects(factIt.first))
                 {
-                    for (const auto& objItC :
-                         mParentSceneMgr->getMovableObjects((factItLater++)->first))
+                    Proxy& proxy = mProxies[objIt.second];
+                    if (!proxy.object)
                     {
-                        MovableObject* c = objItC.second;
-                        // skip entire section if type doesn't match
-                        if (!(c->getTypeFlags() & mQueryTypeMask))
-                            break;
-
-                        // Apply mask to c (both must pass)
-                        if ((c->getQueryFlags() & mQueryMask) && c->isInScene())
-                        {
-                            const AxisAlignedBox& box1 = a->getWorldBoundingBox();
-                            const AxisAlignedBox& box2 = c->getWorldBoundingBox();
-
-                            if (box1.intersects(box2))
-                            {
-                                if (!listener->queryResult(a, c)) return;
-                            }
-                        }
+                        proxy.object = objIt.second;
+                        proxy.id[BT_BOX] = proxy.id[BT_SPHERE] = -2;
                     }
-
+                    proxy.rank = rank++;
+                    proxy.syncCount = mSyncCount;
+                    inserted += updateProxy(proxy, type);
                 }
+            }
 
+            // drop the objects not found anymore, without accessing them as they might be deleted
+            for (auto it = mProxies.begin(); it != mProxies.end();)
+            {
+                if (it->second.syncCount == mSyncCount)
+                {
+                    ++it;
+                    continue;
+                }
+                for (int t = BT_BOX; t <= BT_SPHERE; t++)
+                {
+                    Bounds& b = mBounds[t];
+                    if (it->second.id[t] >= 0)
+                        b.tree.destroyProxy(it->second.id[t]);
+                    else if (it->second.id[t] == -1)
+                        b.infinite.erase(std::find(b.infinite.begin(), b.infinite.end(), &it->second));
+                }
+                it = mProxies.erase(it);
             }
+        }
 
+        // incremental insertion degrades the tree quality, start over after large changes
+        if (inserted > bounds.tree.getNumProxies() / 4)
+            bounds.tree.rebuild();
+    }
+    //---------------------------------------------------------------------
+    void SceneManager::SceneQueryTree::findPairs(ProxyPairList& pairs)
+    {
+        pairs.clear();
+        auto addPair = [&pairs](void* a, void* b) {
+            Proxy* pa = static_cast<Proxy*>(a);
+            Proxy* pb = static_cast<Proxy*>(b);
+            if (pb->rank < pa->rank)
+                std::swap(pa, pb);
+            pairs.push_back(std::make_pair(pa, pb));
+        };
+        mBounds[BT_BOX].tree.queryPairs(addPair);
 
+        // infinite boxes overlap all but null ones
+        for (Proxy* inf : mBounds[BT_BOX].infinite)
+        {
+            for (auto& p : mProxies)
+            {
+                if (p.second.id[BT_BOX] >= 0 || (p.second.id[BT_BOX] == -1 && p.second.rank > inf->rank))
+                    addPair(inf, &p.second);
+            }
         }
 
+        typedef std::pair<Proxy*, Proxy*> ProxyPair;
+        std::sort(pairs.begin(), pairs.end(), [](const ProxyPair& a, const ProxyPair& b) {
+            return a.first->rank < b.first->rank || (a.first == b.first && a.second->rank < b.second->rank);
+        });
+    }
+    //---------------------------------------------------------------------
+    DefaultIntersectionSceneQuery::DefaultIntersectionSceneQuery(SceneManager* creator)
+    : IntersectionSceneQuery(creator)
+    {
+    }
+    //---------------------------------------------------------------------
+    DefaultIntersectionSceneQuery::~DefaultIntersectionSceneQuery()
+    {
+    }
+    //---------------------------------------------------------------------
+    void DefaultIntersectionSceneQuery::execute(IntersectionSceneQueryListener* listener)
+    {
+        auto& tree = mParentSceneMgr->mSceneQueryTree;
+        tree.update(mParentSceneMgr, SceneManager::SceneQueryTree::BT_BOX);
+
+        // pairs of objects whose tree leaves overlap, ordered as when comparing each object
+        // with all later ones
+        SceneManager::SceneQueryTree::ProxyPairList pairs;
+        tree.findPairs(pairs);
+
+        for (const auto& p : pairs)
+        {
+            MovableObject* a = p.first->object;
+            MovableObject* b = p.second->object;
+            // both must pass the masks
+            if (!(a->getTypeFlags() & mQueryTypeMask) || !(b->getTypeFlags() & mQueryTypeMask))
+                continue;
+            if (!(a->getQueryFlags() & mQueryMask) || !a->isInScene())
+                continue;
+            if (!(b->getQueryFlags() & mQueryMask) || !b->isInScene())
+                continue;
+
+            const AxisAlignedBox& box1 = a->getWorldBoundingBox();
+            const AxisAlignedBox& box2 = b->getWorldBoundingBox();
+
+            if (box1.intersects(box2))
+            {
+                if (!listener->queryResult(a, b)) return;
+            }
+        }
     }
     //---------------------------------------------------------------------
     DefaultAxisAlignedBoxSceneQuery::
@@ -122,21 +259,20 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void DefaultAxisAlignedBoxSceneQuery::execute(SceneQueryListener* listener)
     {
-        // Iterate over all movable types
-        for(const auto& factIt : Root::getSingleton().getMovableObjectFactories())
+        auto& tree = mParentSceneMgr->mSceneQueryTree;
+        tree.update(mParentSceneMgr, SceneManager::SceneQueryTree::BT_BOX);
+
+        std::vector<SceneManager::SceneQueryTree::Proxy*> candidates;
+        tree.findCandidates(SceneManager::SceneQueryTree::BT_BOX,
+                            [this](const AxisAlignedBox& box) { return mAABB.intersects(box); }, candidates);
+
+        for (auto p : candidates)
         {
-            for (const auto& objIt : mParentSceneMgr->getMovableObjects(factIt.first))
+            MovableObject* a = p->object;
+            if ((a->getTypeFlags() & mQueryTypeMask) && (a->getQueryFlags() & mQueryMask) && a->isInScene() &&
+                mAABB.intersects(a->getWorldBoundingBox()))
             {
-                MovableObject* a = objIt.second;
-                // skip whole group if type doesn't match
-                if (!(a->getTypeFlags() & mQueryTypeMask))
-                    break;
-
-                if ((a->getQueryFlags() & mQueryMask) && a->isInScene() &&
-                    mAABB.intersects(a->getWorldBoundingBox()))
-                {
-                    if (!listener->queryResult(a)) return;
-                }
+                if (!listener->queryResult(a)) return;
             }
         }
     }
@@ -152,35 +288,27 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void DefaultRaySceneQuery::execute(RaySceneQueryListener* listener)
     {
-        // Note that because we have no scene partitioning, we actually
-        // perform a complete scene search even if restricted results are
-        // requested; smarter scene manager queries can utilise the paritioning 
-        // of the scene in order to reduce the number of intersection tests 
-        // required to fulfil the query
+        auto& tree = mParentSceneMgr->mSceneQueryTree;
+        tree.update(mParentSceneMgr, SceneManager::SceneQueryTree::BT_BOX);
+
+        std::vector<SceneManager::SceneQueryTree::Proxy*> candidates;
+        tree.findCandidates(SceneManager::SceneQueryTree::BT_BOX,
+                            [this](const AxisAlignedBox& box) { return mRay.intersects(box).first; }, candidates);
 
-        // Iterate over all movable types
-        for(const auto& factIt : Root::getSingleton().getMovableObjectFactories())
+        for (auto p : candidates)
         {
-            for (const auto& objIt : mParentSceneMgr->getMovableObjects(factIt.first))
+            MovableObject* a = p->object;
+            if ((a->getTypeFlags() & mQueryTypeMask) && (a->getQueryFlags() & mQueryMask) && a->isInScene())
             {
-                MovableObject* a = objIt.second;
-                // skip whole group if type doesn't match
-                if (!(a->getTypeFlags() & mQueryTypeMask))
-                    break;
+                // Do ray / box test
+                std::pair<bool, Real> result = mRay.intersects(a->getWorldBoundingBox());
 
-                if ((a->getQueryFlags() & mQueryMask) && a->isInScene())
+                if (result.first)
                 {
-                    // Do ray / box test
-                    std::pair<bool, Real> result = mRay.intersects(a->getWorldBoundingBox());
-
-                    if (result.first)
-                    {
-                        if (!listener->queryResult(a, result.second)) return;
-                    }
+                    if (!listener->queryResult(a, result.second)) return;
                 }
             }
         }
-
     }
     //---------------------------------------------------------------------
     DefaultSphereSceneQuery::
@@ -194,24 +322,24 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void DefaultSphereSceneQuery::execute(SceneQueryListener* listener)
     {
-        // Iterate over all movable types
-        for(const auto& factIt : Root::getSingleton().getMovableObjectFactories())
+        auto& tree = mParentSceneMgr->mSceneQueryTree;
+        tree.update(mParentSceneMgr, SceneManager::SceneQueryTree::BT_SPHERE);
+
+        std::vector<SceneManager::SceneQueryTree::Proxy*> candidates;
+        tree.findCandidates(SceneManager::SceneQueryTree::BT_SPHERE,
+                            [this](const AxisAlignedBox& box) { return mSphere.intersects(box); }, candidates);
+
+        for (auto p : candidates)
         {
-            for (const auto& objIt : mParentSceneMgr->getMovableObjects(factIt.first))
-            {
-                MovableObject* a = objIt.second;
-                // skip whole group if type doesn't match
-                if (!(a->getTypeFlags() & mQueryTypeMask))
-                    break;
-                // Skip unattached
-                if (!a->isInScene() || !(a->getQueryFlags() & mQueryMask))
-                    continue;
+            MovableObject* a = p->object;
+            // Skip unattached
+            if (!(a->getTypeFlags() & mQueryTypeMask) || !a->isInScene() || !(a->getQueryFlags() & mQueryMask))
+                continue;
 
-                // Do sphere / sphere test
-                if (mSphere.intersects(a->getWorldBoundingSphere()))
-                {
-                    if (!listener->queryResult(a)) return;
-                }
+            // Do sphere / sphere test
+            if (mSphere.intersects(a->getWorldBoundingSphere()))
+            {
+                if (!listener->queryResult(a)) return;
             }
         }
     }
@@ -228,26 +356,29 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void DefaultPlaneBoundedVolumeListSceneQuery::execute(SceneQueryListener* listener)
     {
-        // Iterate over all movable types
-        for(const auto& factIt : Root::getSingleton().getMovableObjectFactories())
-        {
-            for (const auto& objIt : mParentSceneMgr->getMovableObjects(factIt.first))
+        auto& tree = mParentSceneMgr->mSceneQueryTree;
+        tree.update(mParentSceneMgr, SceneManager::SceneQueryTree::BT_BOX);
+
+        auto intersectsAny = [this](const AxisAlignedBox& box) {
+            for (const auto& vol : mVolumes)
             {
-                MovableObject* a = objIt.second;
-                // skip whole group if type doesn't match
-                if (!(a->getTypeFlags() & mQueryTypeMask))
-                    break;
+                if (vol.intersects(box))
+                    return true;
+            }
+            return false;
+        };
 
-                for (const auto& vol : mVolumes)
-                {
-                    // Do AABB / plane volume test
-                    if ((a->getQueryFlags() & mQueryMask) && a->isInScene() &&
-                        vol.intersects(a->getWorldBoundingBox()))
-                    {
-                        if (!listener->queryResult(a)) return;
-                        break;
-                    }
-                }
+        std::vector<SceneManager::SceneQueryTree::Proxy*> candidates;
+        tree.findCandidates(SceneManager::SceneQueryTree::BT_BOX, intersectsAny, candidates);
+
+        for (auto p : candidates)
+        {
+            MovableObject* a = p->object;
+            // Do AABB / plane volume test
+            if ((a->getTypeFlags() & mQueryTypeMask) && (a->getQueryFlags() & mQueryMask) && a->isInScene() &&
+                intersectsAny(a->getWorldBoundingBox()))
+            {
+                if (!listener->queryResult(a)) return;
             }
         }
     }
@@ -132,7 +132,9 @@ namespace Ogre
                 size_t savedIn = mZStream->avail_in;
                 mZStream->avail_out = 4;
                 mZStream->next_out = testOut;
-                if (inflate(mZStream, Z_SYNC_FLUSH) != Z_OK)
+                // tiny streams already end within the probe
+                int status = inflate(mZStream, Z_SYNC_FLUSH);
+                if (status != Z_OK && status != Z_STREAM_END)
                     mStreamType = Invalid;
                 // restore for reading
                 mZStream->avail_in = static_cast<uint>(savedIn);
@@ -363,20 +365,32 @@ namespace Ogre
         {
             if (count > 0)
             {
-                if (!mReadCache.ff(count))
+                if ((size_t)count > mReadCache.avail())
                 {
-                    OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
-                                "You can only skip within the cache range in a deflate stream.",
-                                "DeflateStream::skip");
+                    // inflate and discard the data beyond the cache, read() drains the cache
+                    // first and updates the position
+                    char discard[OGRE_DEFLATE_TMP_SIZE];
+                    size_t remaining = count;
+                    while (remaining)
+                    {
+                        size_t nr = read(discard, std::min(remaining, sizeof(discard)));
+                        if (!nr)
+                            break;
+                        remaining -= nr;
+                    }
+                    return;
                 }
+                mReadCache.ff(count);
             }
             else if (count < 0)
             {
                 if (!mReadCache.rewind((size_t)(-count)))
                 {
-                    OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
-                                "You can only skip within the cache range in a deflate stream.",
-                                "DeflateStream::skip");
+                    // inflate again from the start
+                    size_t pos = static_cast<size_t>(static_cast<long>(mCurrentPos) + count);
+                    seek(0);
+                    skip(static_cast<long>(pos));
+                    return;
                 }
             }
         }       
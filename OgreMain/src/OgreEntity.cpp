@@ -31,6 +31,7 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 #include "OgreOptimisedUtil.h"
 #include "OgreLodStrategy.h"
 #include "OgreLodListener.h"
+#include "OgreTriangleTree.h"
 
 
 namespace Ogre {
@@ -293,6 +294,33 @@ namespace Ogre {
         return getSubEntity(index);
     }
     //-----------------------------------------------------------------------
+    RayTestResult Entity::raycast(const Ray& ray, size_t* subEntity, size_t* triangle)
+    {
+        Affine3 invTransform = _getParentNodeFullTransform().inverse();
+        // the direction is not normalised, so distances remain in world units
+        Ray localRay(invTransform * ray.getOrigin(), invTransform.linear() * ray.getDirection());
+
+        RayTestResult result(false, 0);
+        for (size_t i = 0; i < mSubEntityList.size(); ++i)
+        {
+            SubEntity* sub = mSubEntityList[i];
+            if (!sub->isVisible())
+                continue;
+
+            size_t tri;
+            RayTestResult hit = sub->getTriangleTree().intersects(localRay, &tri);
+            if (hit.first && (!result.first || hit.second < result.second))
+            {
+                result = hit;
+                if (subEntity)
+                    *subEntity = i;
+                if (triangle)
+                    *triangle = tri;
+            }
+        }
+        return result;
+    }
+    //-----------------------------------------------------------------------
     Entity* Entity::clone( const String& newName) const
     {
         OgreAssert(mManager, "Cannot clone an Entity that wasn't created through a SceneManager");
@@ -641,7 +669,10 @@ namespace Ogre {
 #endif
         // Since we know we're going to be rendered, take this opportunity to
         // update the animation
-        if (displayEntity->hasSkeleton() || displayEntity->hasVertexAnimation())
+        // Objects attached to bones need them right away, others may batch the update
+        bool deferAnimation = mChildObjectList.empty() && !mDisplaySkeleton && mManager;
+        if ((displayEntity->hasSkeleton() || displayEntity->hasVertexAnimation()) &&
+            !(deferAnimation && mManager->_queueAnimationUpdate(displayEntity)))
         {
             displayEntity->updateAnimation();
 
@@ -744,7 +775,7 @@ namespace Ogre {
         return true;
     }
     //-----------------------------------------------------------------------
-    void Entity::updateAnimation(void)
+    void Entity::updateAnimation(SoftwareVertexBlendBatch* blendBatch)
     {
         // Do nothing if not initialised yet
         if (!mInitialised)
@@ -806,6 +837,15 @@ namespace Ogre {
                         }
                     }
                 }
+                // morphing reads the mesh buffers, which pending blends may have locked
+                if (blendBatch && !blendBatch->empty())
+                {
+                    bool locked = blendBatch->isLocked(mMesh->sharedVertexData);
+                    for (auto *se : mSubEntityList)
+                        locked = locked || blendBatch->isLocked(se->getSubMesh()->vertexData);
+                    if (locked)
+                        blendBatch->run();
+                }
                 applyVertexAnimation(hwAnimation, stencilShadows);
             }
 
@@ -817,6 +857,15 @@ namespace Ogre {
                 if (softwareAnimation)
                 {
                     const Affine3* blendMatrices[OGRE_MAX_NUM_BONES];
+                    auto softwareVertexBlend = [&](const VertexData* sourceVertexData,
+                                                   const VertexData* targetVertexData, size_t numMatrices) {
+                        if (blendBatch)
+                            blendBatch->add(sourceVertexData, targetVertexData, blendMatrices,
+                                            numMatrices, blendNormals);
+                        else
+                            Mesh::softwareVertexBlend(sourceVertexData, targetVertexData,
+                                                      blendMatrices, numMatrices, blendNormals);
+                    };
 
                     // Ok, we need to do a software blend
                     // Firstly, check out working vertex buffers
@@ -833,12 +882,11 @@ namespace Ogre {
                         Mesh::prepareMatricesForVertexBlend(blendMatrices,
                                                             mBoneMatrices, mMesh->sharedBlendIndexToBoneIndexMap);
                         // Blend, taking source from either mesh data or morph data
-                        Mesh::softwareVertexBlend(
+                        softwareVertexBlend(
                             (mMesh->getSharedVertexDataAnimationType() != VAT_NONE) ?
                             mSoftwareVertexAnimVertexData.get() : mMesh->sharedVertexData,
                             mSkelAnimVertexData.get(),
-                            blendMatrices, mMesh->sharedBlendIndexToBoneIndexMap.size(),
-                            blendNormals);
+                            mMesh->sharedBlendIndexToBoneIndexMap.size());
                     }
 
                     for (auto *se : mSubEntityList)
@@ -853,12 +901,11 @@ namespace Ogre {
                             Mesh::prepareMatricesForVertexBlend(blendMatrices,
                                                                 mBoneMatrices, se->mSubMesh->blendIndexToBoneIndexMap);
                             // Blend, taking source from either mesh data or morph data
-                            Mesh::softwareVertexBlend(
+                            softwareVertexBlend(
                                 (se->getSubMesh()->getVertexAnimationType() != VAT_NONE)?
                                 se->mSoftwareVertexAnimVertexData.get() : se->mSubMesh->vertexData,
                                 se->mSkelAnimVertexData.get(),
-                                blendMatrices, se->mSubMesh->blendIndexToBoneIndexMap.size(),
-                                blendNormals);
+                                se->mSubMesh->blendIndexToBoneIndexMap.size());
                         }
 
                     }
@@ -37,6 +37,13 @@ THE SOFTWARE.
 #   include <sys/param.h>
 #endif
 
+#if OGRE_PLATFORM == OGRE_PLATFORM_LINUX || OGRE_PLATFORM == OGRE_PLATFORM_APPLE
+#   include <sys/mman.h>
+#   include <fcntl.h>
+#   include <unistd.h>
+#   define OGRE_FILESYSTEM_MMAP
+#endif
+
 #if OGRE_PLATFORM == OGRE_PLATFORM_WIN32 || OGRE_PLATFORM == OGRE_PLATFORM_WINRT
 #  define WIN32_LEAN_AND_MEAN
 #  if !defined(NOMINMAX) && defined(_MSC_VER)
@@ -116,6 +123,54 @@ namespace {
     };
 
     bool gIgnoreHidden = true;
+    bool gUseMemoryMapping = false;
+
+#ifdef OGRE_FILESYSTEM_MMAP
+    /** MemoryDataStream on a private mapping of a file.
+
+    Pages are only read when accessed and writes through getPtr() do not reach the file.
+    */
+    class MappedFileDataStream : public MemoryDataStream
+    {
+        void* mMapping;
+        size_t mMappingSize;
+    public:
+        MappedFileDataStream(const String& name, void* mapping, size_t size)
+            : MemoryDataStream(name, mapping, size, false, true), mMapping(mapping), mMappingSize(size)
+        {
+        }
+        ~MappedFileDataStream() { close(); }
+
+        void close(void) override
+        {
+            MemoryDataStream::close();
+            if (mMapping)
+            {
+                munmap(mMapping, mMappingSize);
+                mMapping = NULL;
+            }
+        }
+    };
+
+    DataStreamPtr mapFile(const String& full_path, const String& name)
+    {
+        int fd = ::open(full_path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return DataStreamPtr();
+
+        struct stat tagStat;
+        void* mapping = MAP_FAILED;
+        if (fstat(fd, &tagStat) == 0 && tagStat.st_size > 0)
+            mapping = mmap(NULL, tagStat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        // the mapping keeps the file referenced
+        ::close(fd);
+
+        if (mapping == MAP_FAILED)
+            return DataStreamPtr();
+
+        return std::make_shared<MappedFileDataStream>(name, mapping, tagStat.st_size);
+    }
+#endif
 }
 
     //-----------------------------------------------------------------------
@@ -343,6 +398,13 @@ namespace {
     }
     DataStreamPtr _openFileStream(const String& full_path, std::ios::openmode mode, const String& name)
     {
+#ifdef OGRE_FILESYSTEM_MMAP
+        if (gUseMemoryMapping && !(mode & std::ios::out))
+        {
+            if (auto stream = mapFile(full_path, name.empty() ? full_path : name))
+                return stream;
+        }
+#endif
         // Use filesystem to determine size 
         // (quicker than streaming to the end and back)
 #ifdef _OGRE_FILESYSTEM_ARCHIVE_UNICODE
@@ -569,4 +631,14 @@ namespace {
     {
         return gIgnoreHidden;
     }
+
+    void FileSystemArchiveFactory::setUseMemoryMapping(bool map)
+    {
+        gUseMemoryMapping = map;
+    }
+
+    bool FileSystemArchiveFactory::getUseMemoryMapping()
+    {
+        return gUseMemoryMapping;
+    }
 }
@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "OgreStableHeaders.h"
 #include "OgreHardwareVertexBuffer.h"
 #include "OgreMovablePlane.h"
+#include "OgreOptimisedUtil.h"
 
 namespace Ogre {
 
@@ -226,6 +227,28 @@ namespace Ogre {
         return true;
     }
 
+    //-----------------------------------------------------------------------
+    void Frustum::isVisible(const float* const minimum[3], const float* const maximum[3], size_t numBoxes,
+                            uint32* visibleMask) const
+    {
+        // Make any pending updates to the calculated frustum planes
+        updateFrustumPlanes();
+
+        Plane planes[6];
+        size_t numPlanes = 0;
+        for (int plane = 0; plane < 6; ++plane)
+        {
+            // Skip far plane if infinite view frustum
+            if (plane == FRUSTUM_PLANE_FAR && mFarDist == 0)
+                continue;
+
+            planes[numPlanes++] = mFrustumPlanes[plane];
+        }
+
+        OptimisedUtil::getImplementation()->cullAxisAlignedBoxes(planes, numPlanes, minimum, maximum,
+                                                                 visibleMask, numBoxes);
+    }
+
     //-----------------------------------------------------------------------
     bool Frustum::isVisible(const Vector3& vert, FrustumPlane* culledBy) const
     {
@@ -285,6 +285,8 @@ namespace Ogre
     {
         createParameterMappingStructures();
         *mConstantDefs.get() = namedConstants;
+        if (!mConstantDefs->hasHashIndex())
+            mConstantDefs->generateHashIndex();
 
         mLogicalToPhysical->bufferSize = mConstantDefs->bufferSize;
         mLogicalToPhysical->map.clear();
@@ -29,6 +29,7 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 #include "OgreGpuProgramParams.h"
 #include "OgreGpuProgramManager.h"
 #include "OgreDualQuaternion.h"
+#include "OgreSIMDHelper.h"
 
 namespace Ogre
 {
@@ -196,6 +197,23 @@ namespace Ogre
 
     GpuNamedConstants::GpuNamedConstants() : bufferSize(0), registerCount(0) {}
     GpuNamedConstants::~GpuNamedConstants() {}
+    GpuNamedConstants::GpuNamedConstants(const GpuNamedConstants& oth)
+        : bufferSize(oth.bufferSize), registerCount(oth.registerCount), map(oth.map)
+    {
+        // the index points into the map, so it can not be copied
+        if (!oth.mHashIndex.empty())
+            generateHashIndex();
+    }
+    GpuNamedConstants& GpuNamedConstants::operator=(const GpuNamedConstants& oth)
+    {
+        bufferSize = oth.bufferSize;
+        registerCount = oth.registerCount;
+        map = oth.map;
+        mHashIndex.clear();
+        if (!oth.mHashIndex.empty())
+            generateHashIndex();
+        return *this;
+    }
 
     GpuLogicalBufferStruct::GpuLogicalBufferStruct() : bufferSize(0) {}
     GpuLogicalBufferStruct::~GpuLogicalBufferStruct() {}
@@ -211,8 +229,48 @@ namespace Ogre
     //---------------------------------------------------------------------
     void GpuNamedConstants::load(DataStreamPtr& stream)
     {
+        mHashIndex.clear();
         GpuNamedConstantsSerializer ser;
         ser.importNamedConstants(stream, this);
+        generateHashIndex();
+    }
+    //---------------------------------------------------------------------
+    void GpuNamedConstants::generateHashIndex()
+    {
+        // keep the load factor below 0.5, so probe sequences stay short
+        size_t capacity = 4;
+        while (capacity < map.size() * 2)
+            capacity *= 2;
+
+        mHashIndex.assign(capacity, {0, nullptr});
+        for (const auto& entry : map)
+        {
+            uint32 hash = FastHash(entry.first.c_str(), entry.first.size());
+            size_t slot = hash & (capacity - 1);
+            while (mHashIndex[slot].second)
+                slot = (slot + 1) & (capacity - 1);
+            mHashIndex[slot] = {hash, &entry};
+        }
+    }
+    //---------------------------------------------------------------------
+    const GpuConstantDefinition* GpuNamedConstants::find(const char* name, size_t len) const
+    {
+        if (mHashIndex.empty())
+        {
+            auto i = map.find(String(name, len));
+            return i == map.end() ? NULL : &i->second;
+        }
+
+        uint32 hash = FastHash(name, len);
+        size_t mask = mHashIndex.size() - 1;
+        for (size_t slot = hash & mask; mHashIndex[slot].second; slot = (slot + 1) & mask)
+        {
+            const auto& entry = mHashIndex[slot];
+            if (entry.first == hash && entry.second->first.size() == len &&
+                memcmp(entry.second->first.data(), name, len) == 0)
+                return &entry.second->second;
+        }
+        return NULL;
     }
     //-----------------------------------------------------------------------------
     size_t GpuNamedConstants::calculateSize(void) const
@@ -660,6 +718,7 @@ namespace Ogre
         , mIgnoreMissingParams(false)
         , mActivePassIterationIndex(std::numeric_limits<size_t>::max())
         , mUseLinearColours(false)
+        , mAutoConstantOpsDirty(true)
     {
         static_assert((sizeof(AutoConstantDictionary) / sizeof(AutoConstantDefinition) - 5) == ACT_MATERIAL_LOD_INDEX,
                       "AutoConstantDictionary out of sync");
@@ -690,6 +749,7 @@ namespace Ogre
         mIgnoreMissingParams  = oth.mIgnoreMissingParams;
         mActivePassIterationIndex = oth.mActivePassIterationIndex;
         mUseLinearColours = oth.mUseLinearColours;
+        mAutoConstantOpsDirty = true;
 
         return *this;
     }
@@ -1281,8 +1341,9 @@ namespace Ogre
 
         // strip array extension
         size_t arrStart = name.back() == ']' ? name.find('[') : String::npos;
-        auto i = mNamedConstants->map.find(arrStart == String::npos ? name : name.substr(0, arrStart));
-        if (i == mNamedConstants->map.end() || (i->second.arraySize == 1 && arrStart != String::npos))
+        const GpuConstantDefinition* def =
+            mNamedConstants->find(name.c_str(), arrStart == String::npos ? name.size() : arrStart);
+        if (!def || (def->arraySize == 1 && arrStart != String::npos))
         {
             if (throwExceptionIfNotFound)
 			{
@@ -1290,8 +1351,8 @@ namespace Ogre
 #if OGRE_DEBUG_MODE
 				// make it easy to catch typo and/or unused shader parameter elimination made by some drivers
 				knownNames = "Known names are: ";
-				for (i = mNamedConstants->map.begin(); i != mNamedConstants->map.end(); ++i)
-					knownNames.append(i->first).append(" ");
+				for (const auto& i : mNamedConstants->map)
+					knownNames.append(i.first).append(" ");
 #endif
                 OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
 				"Parameter called " + name + " does not exist. " + knownNames,
@@ -1299,10 +1360,8 @@ namespace Ogre
 			}
             return 0;
         }
-        else
-        {
-            return &(i->second);
-        }
+
+        return def;
     }
     //-----------------------------------------------------------------------------
     void GpuProgramParameters::setAutoConstant(size_t index, AutoConstantType acType, uint32 extraInfo)
@@ -1349,6 +1408,7 @@ namespace Ogre
             mAutoConstants.push_back(AutoConstantEntry(acType, physicalIndex, extraInfo, variability, elementSize));
 
         mCombinedVariability |= variability;
+        mAutoConstantOpsDirty = true;
 
 
     }
@@ -1374,6 +1434,7 @@ namespace Ogre
             mAutoConstants.push_back(AutoConstantEntry(acType, physicalIndex, rData, variability, elementSize));
 
         mCombinedVariability |= variability;
+        mAutoConstantOpsDirty = true;
     }
     //-----------------------------------------------------------------------------
     void GpuProgramParameters::clearAutoConstant(size_t index)
@@ -1392,6 +1453,7 @@ namespace Ogre
                 if (i->physicalIndex == physicalIndex)
                 {
                     mAutoConstants.erase(i);
+                    mAutoConstantOpsDirty = true;
                     break;
                 }
             }
@@ -1413,6 +1475,7 @@ namespace Ogre
                     if (i->physicalIndex == def->physicalIndex)
                     {
                         mAutoConstants.erase(i);
+                        mAutoConstantOpsDirty = true;
                         break;
                     }
                 }
@@ -1423,6 +1486,7 @@ namespace Ogre
     void GpuProgramParameters::clearAutoConstants(void)
     {
         mAutoConstants.clear();
+        mAutoConstantOpsDirty = true;
         mCombinedVariability = GPV_GLOBAL;
     }
     //-----------------------------------------------------------------------------
@@ -1449,6 +1513,117 @@ namespace Ogre
     }
     //-----------------------------------------------------------------------------
 
+    //-----------------------------------------------------------------------------
+    // direct sources for the common 4x4 matrix autos, bypassing updateAutoConstant
+    typedef const TransformBaseReal& (*MatrixSource)(const AutoParamDataSource*);
+    static const TransformBaseReal& worldMatrix(const AutoParamDataSource* s) { return s->getWorldMatrix(); }
+    static const TransformBaseReal& inverseWorldMatrix(const AutoParamDataSource* s) { return s->getInverseWorldMatrix(); }
+    static const TransformBaseReal& inverseTransposeWorldMatrix(const AutoParamDataSource* s) { return s->getInverseTransposeWorldMatrix(); }
+    static const TransformBaseReal& worldViewMatrix(const AutoParamDataSource* s) { return s->getWorldViewMatrix(); }
+    static const TransformBaseReal& inverseWorldViewMatrix(const AutoParamDataSource* s) { return s->getInverseWorldViewMatrix(); }
+    static const TransformBaseReal& inverseTransposeWorldViewMatrix(const AutoParamDataSource* s) { return s->getInverseTransposeWorldViewMatrix(); }
+    static const TransformBaseReal& worldViewProjMatrix(const AutoParamDataSource* s) { return s->getWorldViewProjMatrix(); }
+    static const TransformBaseReal& viewMatrix(const AutoParamDataSource* s) { return s->getViewMatrix(); }
+    static const TransformBaseReal& inverseViewMatrix(const AutoParamDataSource* s) { return s->getInverseViewMatrix(); }
+    static const TransformBaseReal& projectionMatrix(const AutoParamDataSource* s) { return s->getProjectionMatrix(); }
+    static const TransformBaseReal& viewProjMatrix(const AutoParamDataSource* s) { return s->getViewProjectionMatrix(); }
+
+    static MatrixSource getMatrixSource(const GpuProgramParameters::AutoConstantEntry& ac)
+    {
+        if (ac.elementCount != 16)
+            return NULL;
+
+        switch (ac.paramType)
+        {
+        case GpuProgramParameters::ACT_WORLD_MATRIX:
+            return worldMatrix;
+        case GpuProgramParameters::ACT_INVERSE_WORLD_MATRIX:
+            return inverseWorldMatrix;
+        case GpuProgramParameters::ACT_INVERSE_TRANSPOSE_WORLD_MATRIX:
+            return inverseTransposeWorldMatrix;
+        case GpuProgramParameters::ACT_WORLDVIEW_MATRIX:
+            return worldViewMatrix;
+        case GpuProgramParameters::ACT_INVERSE_WORLDVIEW_MATRIX:
+            return inverseWorldViewMatrix;
+        case GpuProgramParameters::ACT_NORMAL_MATRIX:
+        case GpuProgramParameters::ACT_INVERSE_TRANSPOSE_WORLDVIEW_MATRIX:
+            return inverseTransposeWorldViewMatrix;
+        case GpuProgramParameters::ACT_WORLDVIEWPROJ_MATRIX:
+            return worldViewProjMatrix;
+        case GpuProgramParameters::ACT_VIEW_MATRIX:
+            return viewMatrix;
+        case GpuProgramParameters::ACT_INVERSE_VIEW_MATRIX:
+            return inverseViewMatrix;
+        case GpuProgramParameters::ACT_PROJECTION_MATRIX:
+            return projectionMatrix;
+        case GpuProgramParameters::ACT_VIEWPROJ_MATRIX:
+            return viewProjMatrix;
+        default:
+            return NULL;
+        }
+    }
+    //-----------------------------------------------------------------------------
+    void GpuProgramParameters::compileAutoConstants()
+    {
+        mAutoConstantOps.clear();
+        mAutoConstantGroups.clear();
+
+        for (uint32 i = 0; i < mAutoConstants.size(); ++i)
+        {
+            AutoConstantOp op = {getMatrixSource(mAutoConstants[i]), i};
+            mAutoConstantOps.push_back(op);
+        }
+
+        // group by variability, so a per-object update does not visit the global autos.
+        // Inside a group, write in buffer order
+        std::sort(mAutoConstantOps.begin(), mAutoConstantOps.end(),
+                  [this](const AutoConstantOp& a, const AutoConstantOp& b) {
+                      const AutoConstantEntry& ea = mAutoConstants[a.entry];
+                      const AutoConstantEntry& eb = mAutoConstants[b.entry];
+                      if (ea.variability != eb.variability)
+                          return ea.variability < eb.variability;
+                      return ea.physicalIndex < eb.physicalIndex;
+                  });
+
+        for (uint32 i = 0; i < mAutoConstantOps.size(); ++i)
+        {
+            uint16 variability = mAutoConstants[mAutoConstantOps[i].entry].variability;
+            if (mAutoConstantGroups.empty() || mAutoConstantGroups.back().first != variability)
+                mAutoConstantGroups.push_back({variability, i + 1});
+            else
+                mAutoConstantGroups.back().second = i + 1;
+        }
+
+        mAutoConstantOpsDirty = false;
+    }
+    //-----------------------------------------------------------------------------
+    void GpuProgramParameters::writeRawMatrix(size_t physicalIndex, const TransformBaseReal& m)
+    {
+        assert(physicalIndex + sizeof(float) * 16 <= mConstants.size());
+#if __OGRE_HAVE_SSE || __OGRE_HAVE_NEON
+        // vectorized copy, transposing in registers if needed
+        float* dst = reinterpret_cast<float*>(&mConstants[physicalIndex]);
+        __m128 r0 = _mm_loadu_ps(m[0]);
+        __m128 r1 = _mm_loadu_ps(m[1]);
+        __m128 r2 = _mm_loadu_ps(m[2]);
+        __m128 r3 = _mm_loadu_ps(m[3]);
+        if (mTransposeMatrices)
+            __MM_TRANSPOSE4x4_PS(r0, r1, r2, r3);
+        _mm_storeu_ps(dst, r0);
+        _mm_storeu_ps(dst + 4, r1);
+        _mm_storeu_ps(dst + 8, r2);
+        _mm_storeu_ps(dst + 12, r3);
+#else
+        for (int i = 0; i < 4; ++i)
+        {
+            for (int j = 0; j < 4; ++j)
+            {
+                float v = float(mTransposeMatrices ? m[j][i] : m[i][j]);
+                memcpy(&mConstants[physicalIndex + (i * 4 + j) * sizeof(float)], &v, sizeof(float));
+            }
+        }
+#endif
+    }
     //-----------------------------------------------------------------------------
     void GpuProgramParameters::_updateAutoParams(const AutoParamDataSource* source, uint16 mask)
     {
@@ -1458,6 +1633,32 @@ namespace Ogre
         if (!(mask & mCombinedVariability))
             return;
 
+        if (mAutoConstantOpsDirty)
+            compileAutoConstants();
+
+        mActivePassIterationIndex = std::numeric_limits<size_t>::max();
+
+        // only visit the groups that need updating
+        uint32 begin = 0;
+        for (const auto& group : mAutoConstantGroups)
+        {
+            if (group.first & mask)
+            {
+                for (uint32 i = begin; i < group.second; ++i)
+                {
+                    const AutoConstantOp& op = mAutoConstantOps[i];
+                    if (op.matrix)
+                        writeRawMatrix(mAutoConstants[op.entry].physicalIndex, op.matrix(source));
+                    else
+                        updateAutoConstant(mAutoConstants[op.entry], source);
+                }
+            }
+            begin = group.second;
+        }
+    }
+    //-----------------------------------------------------------------------------
+    void GpuProgramParameters::updateAutoConstant(const AutoConstantEntry& ac, const AutoParamDataSource* source)
+    {
         size_t index;
         size_t numMatrices;
         const Affine3* pMatrix;
@@ -1468,639 +1669,628 @@ namespace Ogre
         Matrix4 scaleM;
         DualQuaternion dQuat;
 
-        mActivePassIterationIndex = std::numeric_limits<size_t>::max();
 
-        // Autoconstant index is not a physical index
-        for (const auto& ac : mAutoConstants)
+        switch(ac.paramType)
         {
-            // Only update needed slots
-            if (ac.variability & mask)
-            {
+        case ACT_VIEW_MATRIX:
+            _writeRawConstant(ac.physicalIndex, source->getViewMatrix(),ac.elementCount);
+            break;
+        case ACT_INVERSE_VIEW_MATRIX:
+            _writeRawConstant(ac.physicalIndex, source->getInverseViewMatrix(),ac.elementCount);
+            break;
+        case ACT_TRANSPOSE_VIEW_MATRIX:
+            _writeRawConstant(ac.physicalIndex, source->getTransposeViewMatrix(),ac.elementCount);
+            break;
+        case ACT_INVERSE_TRANSPOSE_VIEW_MATRIX:
+            _writeRawConstant(ac.physicalIndex, source->getInverseTransposeViewMatrix(),ac.elementCount);
+            break;
 
-                switch(ac.paramType)
-                {
-                case ACT_VIEW_MATRIX:
-                    _writeRawConstant(ac.physicalIndex, source->getViewMatrix(),ac.elementCount);
-                    break;
-                case ACT_INVERSE_VIEW_MATRIX:
-                    _writeRawConstant(ac.physicalIndex, source->getInverseViewMatrix(),ac.elementCount);
-                    break;
-                case ACT_TRANSPOSE_VIEW_MATRIX:
-                    _writeRawConstant(ac.physicalIndex, source->getTransposeViewMatrix(),ac.elementCount);
-                    break;
-                case ACT_INVERSE_TRANSPOSE_VIEW_MATRIX:
-                    _writeRawConstant(ac.physicalIndex, source->getInverseTransposeViewMatrix(),ac.elementCount);
-                    break;
+        case ACT_PROJECTION_MATRIX:
+            _writeRawConstant(ac.physicalIndex, source->getProjectionMatrix(),ac.elementCount);
+            break;
+        case ACT_INVERSE_PROJECTION_MATRIX:
+            _writeRawConstant(ac.physicalIndex, source->getInverseProjectionMatrix(),ac.elementCount);
+            break;
+        case ACT_TRANSPOSE_PROJECTION_MATRIX:
+            _writeRawConstant(ac.physicalIndex, source->getTransposeProjectionMatrix(),ac.elementCount);
+            break;
+        case ACT_INVERSE_TRANSPOSE_PROJECTION_MATRIX:
+            _writeRawConstant(ac.physicalIndex, source->getInverseTransposeProjectionMatrix(),ac.elementCount);
+            break;
 
-                case ACT_PROJECTION_MATRIX:
-                    _writeRawConstant(ac.physicalIndex, source->getProjectionMatrix(),ac.elementCount);
-                    break;
-                case ACT_INVERSE_PROJECTION_MATRIX:
-                    _writeRawConstant(ac.physicalIndex, source->getInverseProjectionMatrix(),ac.elementCount);
-                    break;
-                case ACT_TRANSPOSE_PROJECTION_MATRIX:
-                    _writeRawConstant(ac.physicalIndex, source->getTransposeProjectionMatrix(),ac.elementCount);
-                    break;
-                case ACT_INVERSE_TRANSPOSE_PROJECTION_MATRIX:
-                    _writeRawConstant(ac.physicalIndex, source->getInverseTransposeProjectionMatrix(),ac.elementCount);
-                    break;
+        case ACT_VIEWPROJ_MATRIX:
+            _writeRawConstant(ac.physicalIndex, source->getViewProjectionMatrix(),ac.elementCount);
+            break;
+        case ACT_INVERSE_VIEWPROJ_MATRIX:
+            _writeRawConstant(ac.physicalIndex, source->getInverseViewProjMatrix(),ac.elementCount);
+            break;
+        case ACT_TRANSPOSE_VIEWPROJ_MATRIX:
+            _writeRawConstant(ac.physicalIndex, source->getTransposeViewProjMatrix(),ac.elementCount);
+            break;
+        case ACT_INVERSE_TRANSPOSE_VIEWPROJ_MATRIX:
+            _writeRawConstant(ac.physicalIndex, source->getInverseTransposeViewProjMatrix(),ac.elementCount);
+            break;
+        case ACT_RENDER_TARGET_FLIPPING:
+            _writeRawConstant(ac.physicalIndex, source->getCurrentRenderTarget()->requiresTextureFlipping() ? -1.f : +1.f);
+            break;
+        case ACT_VERTEX_WINDING:
+            {
+                RenderSystem* rsys = Root::getSingleton().getRenderSystem();
+                _writeRawConstant(ac.physicalIndex, rsys->getInvertVertexWinding() ? -1.f : +1.f);
+            }
+            break;
 
-                case ACT_VIEWPROJ_MATRIX:
-                    _writeRawConstant(ac.physicalIndex, source->getViewProjectionMatrix(),ac.elementCount);
-                    break;
-                case ACT_INVERSE_VIEWPROJ_MATRIX:
-                    _writeRawConstant(ac.physicalIndex, source->getInverseViewProjMatrix(),ac.elementCount);
-                    break;
-                case ACT_TRANSPOSE_VIEWPROJ_MATRIX:
-                    _writeRawConstant(ac.physicalIndex, source->getTransposeViewProjMatrix(),ac.elementCount);
-                    break;
-                case ACT_INVERSE_TRANSPOSE_VIEWPROJ_MATRIX:
-                    _writeRawConstant(ac.physicalIndex, source->getInverseTransposeViewProjMatrix(),ac.elementCount);
-                    break;
-                case ACT_RENDER_TARGET_FLIPPING:
-                    _writeRawConstant(ac.physicalIndex, source->getCurrentRenderTarget()->requiresTextureFlipping() ? -1.f : +1.f);
-                    break;
-                case ACT_VERTEX_WINDING:
-                    {
-                        RenderSystem* rsys = Root::getSingleton().getRenderSystem();
-                        _writeRawConstant(ac.physicalIndex, rsys->getInvertVertexWinding() ? -1.f : +1.f);
-                    }
-                    break;
+            // NB ambient light still here because it's not related to a specific light
+        case ACT_AMBIENT_LIGHT_COLOUR:
+            _writeRawConstant(ac.physicalIndex, source->getAmbientLightColour(),
+                              ac.elementCount);
+            break;
+        case ACT_DERIVED_AMBIENT_LIGHT_COLOUR:
+            _writeRawConstant(ac.physicalIndex, source->getDerivedAmbientLightColour(),
+                              ac.elementCount);
+            break;
+        case ACT_DERIVED_SCENE_COLOUR:
+            _writeRawConstant(ac.physicalIndex, source->getDerivedSceneColour(),
+                              ac.elementCount);
+            break;
 
-                    // NB ambient light still here because it's not related to a specific light
-                case ACT_AMBIENT_LIGHT_COLOUR:
-                    _writeRawConstant(ac.physicalIndex, source->getAmbientLightColour(),
-                                      ac.elementCount);
-                    break;
-                case ACT_DERIVED_AMBIENT_LIGHT_COLOUR:
-                    _writeRawConstant(ac.physicalIndex, source->getDerivedAmbientLightColour(),
-                                      ac.elementCount);
-                    break;
-                case ACT_DERIVED_SCENE_COLOUR:
-                    _writeRawConstant(ac.physicalIndex, source->getDerivedSceneColour(),
-                                      ac.elementCount);
-                    break;
+        case ACT_FOG_COLOUR:
+            _writeRawConstant(ac.physicalIndex, source->getFogColour(), ac.elementCount);
+            break;
+        case ACT_FOG_PARAMS:
+            _writeRawConstant(ac.physicalIndex, source->getFogParams(), ac.elementCount);
+            break;
+        case ACT_POINT_PARAMS:
+            _writeRawConstant(ac.physicalIndex, source->getPointParams(), ac.elementCount);
+            break;
+        case ACT_SURFACE_AMBIENT_COLOUR:
+            _writeRawConstant(ac.physicalIndex, source->getSurfaceAmbientColour(),
+                              ac.elementCount);
+            break;
+        case ACT_SURFACE_DIFFUSE_COLOUR:
+            _writeRawConstant(ac.physicalIndex, source->getSurfaceDiffuseColour(),
+                              ac.elementCount);
+            break;
+        case ACT_SURFACE_SPECULAR_COLOUR:
+            // we also pass metal-roughness here, so avoid any gamma correction
+            _writeRawConstants(ac.physicalIndex, source->getSurfaceSpecularColour().ptr(),
+                              ac.elementCount);
+            break;
+        case ACT_SURFACE_EMISSIVE_COLOUR:
+            _writeRawConstant(ac.physicalIndex, source->getSurfaceEmissiveColour(),
+                              ac.elementCount);
+            break;
+        case ACT_SURFACE_SHININESS:
+            _writeRawConstant(ac.physicalIndex, source->getSurfaceShininess());
+            break;
+        case ACT_SURFACE_ALPHA_REJECTION_VALUE:
+            _writeRawConstant(ac.physicalIndex, source->getSurfaceAlphaRejectionValue());
+            break;
 
-                case ACT_FOG_COLOUR:
-                    _writeRawConstant(ac.physicalIndex, source->getFogColour(), ac.elementCount);
-                    break;
-                case ACT_FOG_PARAMS:
-                    _writeRawConstant(ac.physicalIndex, source->getFogParams(), ac.elementCount);
-                    break;
-                case ACT_POINT_PARAMS:
-                    _writeRawConstant(ac.physicalIndex, source->getPointParams(), ac.elementCount);
-                    break;
-                case ACT_SURFACE_AMBIENT_COLOUR:
-                    _writeRawConstant(ac.physicalIndex, source->getSurfaceAmbientColour(),
-                                      ac.elementCount);
-                    break;
-                case ACT_SURFACE_DIFFUSE_COLOUR:
-                    _writeRawConstant(ac.physicalIndex, source->getSurfaceDiffuseColour(),
-                                      ac.elementCount);
-                    break;
-                case ACT_SURFACE_SPECULAR_COLOUR:
-                    // we also pass metal-roughness here, so avoid any gamma correction
-                    _writeRawConstants(ac.physicalIndex, source->getSurfaceSpecularColour().ptr(),
-                                      ac.elementCount);
-                    break;
-                case ACT_SURFACE_EMISSIVE_COLOUR:
-                    _writeRawConstant(ac.physicalIndex, source->getSurfaceEmissiveColour(),
-                                      ac.elementCount);
-                    break;
-                case ACT_SURFACE_SHININESS:
-                    _writeRawConstant(ac.physicalIndex, source->getSurfaceShininess());
-                    break;
-                case ACT_SURFACE_ALPHA_REJECTION_VALUE:
-                    _writeRawConstant(ac.physicalIndex, source->getSurfaceAlphaRejectionValue());
-                    break;
+        case ACT_CAMERA_POSITION:
+            _writeRawConstant(ac.physicalIndex, source->getCameraPosition(), ac.elementCount);
+            break;
+        case ACT_CAMERA_RELATIVE_POSITION:
+            _writeRawConstant (ac.physicalIndex, source->getCameraRelativePosition(), ac.elementCount);
+            break;
+        case ACT_TIME:
+            _writeRawConstant(ac.physicalIndex, source->getTime() * ac.fData);
+            break;
+        case ACT_TIME_0_X:
+            _writeRawConstant(ac.physicalIndex, source->getTime_0_X(ac.fData));
+            break;
+        case ACT_COSTIME_0_X:
+            _writeRawConstant(ac.physicalIndex, source->getCosTime_0_X(ac.fData));
+            break;
+        case ACT_SINTIME_0_X:
+            _writeRawConstant(ac.physicalIndex, source->getSinTime_0_X(ac.fData));
+            break;
+        case ACT_TANTIME_0_X:
+            _writeRawConstant(ac.physicalIndex, source->getTanTime_0_X(ac.fData));
+            break;
+        case ACT_TIME_0_X_PACKED:
+            _writeRawConstant(ac.physicalIndex, source->getTime_0_X_packed(ac.fData), ac.elementCount);
+            break;
+        case ACT_TIME_0_1:
+            _writeRawConstant(ac.physicalIndex, source->getTime_0_1(ac.fData));
+            break;
+        case ACT_COSTIME_0_1:
+            _writeRawConstant(ac.physicalIndex, source->getCosTime_0_1(ac.fData));
+            break;
+        case ACT_SINTIME_0_1:
+            _writeRawConstant(ac.physicalIndex, source->getSinTime_0_1(ac.fData));
+            break;
+        case ACT_TANTIME_0_1:
+            _writeRawConstant(ac.physicalIndex, source->getTanTime_0_1(ac.fData));
+            break;
+        case ACT_TIME_0_1_PACKED:
+            _writeRawConstant(ac.physicalIndex, source->getTime_0_1_packed(ac.fData), ac.elementCount);
+            break;
+        case ACT_TIME_0_2PI:
+            _writeRawConstant(ac.physicalIndex, source->getTime_0_2Pi(ac.fData));
+            break;
+        case ACT_COSTIME_0_2PI:
+            _writeRawConstant(ac.physicalIndex, source->getCosTime_0_2Pi(ac.fData));
+            break;
+        case ACT_SINTIME_0_2PI:
+            _writeRawConstant(ac.physicalIndex, source->getSinTime_0_2Pi(ac.fData));
+            break;
+        case ACT_TANTIME_0_2PI:
+            _writeRawConstant(ac.physicalIndex, source->getTanTime_0_2Pi(ac.fData));
+            break;
+        case ACT_TIME_0_2PI_PACKED:
+            _writeRawConstant(ac.physicalIndex, source->getTime_0_2Pi_packed(ac.fData), ac.elementCount);
+            break;
+        case ACT_FRAME_TIME:
+            _writeRawConstant(ac.physicalIndex, source->getFrameTime() * ac.fData);
+            break;
+        case ACT_FPS:
+            _writeRawConstant(ac.physicalIndex, source->getFPS());
+            break;
+        case ACT_VIEWPORT_WIDTH:
+            _writeRawConstant(ac.physicalIndex, source->getViewportWidth());
+            break;
+        case ACT_VIEWPORT_HEIGHT:
+            _writeRawConstant(ac.physicalIndex, source->getViewportHeight());
+            break;
+        case ACT_INVERSE_VIEWPORT_WIDTH:
+            _writeRawConstant(ac.physicalIndex, source->getInverseViewportWidth());
+            break;
+        case ACT_INVERSE_VIEWPORT_HEIGHT:
+            _writeRawConstant(ac.physicalIndex, source->getInverseViewportHeight());
+            break;
+        case ACT_VIEWPORT_SIZE:
+            _writeRawConstant(ac.physicalIndex, Vector4f(
+                source->getViewportWidth(),
+                source->getViewportHeight(),
+                source->getInverseViewportWidth(),
+                source->getInverseViewportHeight()), ac.elementCount);
+            break;
+        case ACT_TEXEL_OFFSETS:
+            {
+                RenderSystem* rsys = Root::getSingleton().getRenderSystem();
+                _writeRawConstant(ac.physicalIndex, Vector4f(
+                    rsys->getHorizontalTexelOffset(),
+                    rsys->getVerticalTexelOffset(),
+                    rsys->getHorizontalTexelOffset() * source->getInverseViewportWidth(),
+                    rsys->getVerticalTexelOffset() * source->getInverseViewportHeight()),
+                                  ac.elementCount);
+            }
+            break;
+        case ACT_TEXTURE_SIZE:
+            _writeRawConstant(ac.physicalIndex, source->getTextureSize(ac.data), ac.elementCount);
+            break;
+        case ACT_INVERSE_TEXTURE_SIZE:
+            _writeRawConstant(ac.physicalIndex, source->getInverseTextureSize(ac.data), ac.elementCount);
+            break;
+        case ACT_PACKED_TEXTURE_SIZE:
+            _writeRawConstant(ac.physicalIndex, source->getPackedTextureSize(ac.data), ac.elementCount);
+            break;
+        case ACT_SCENE_DEPTH_RANGE:
+            _writeRawConstant(ac.physicalIndex, source->getSceneDepthRange(), ac.elementCount);
+            break;
+        case ACT_VIEW_DIRECTION:
+            _writeRawConstant(ac.physicalIndex, source->getViewDirection());
+            break;
+        case ACT_VIEW_SIDE_VECTOR:
+            _writeRawConstant(ac.physicalIndex, source->getViewSideVector());
+            break;
+        case ACT_VIEW_UP_VECTOR:
+            _writeRawConstant(ac.physicalIndex, source->getViewUpVector());
+            break;
+        case ACT_FOV:
+            _writeRawConstant(ac.physicalIndex, source->getFOV());
+            break;
+        case ACT_NEAR_CLIP_DISTANCE:
+            _writeRawConstant(ac.physicalIndex, source->getNearClipDistance());
+            break;
+        case ACT_FAR_CLIP_DISTANCE:
+            _writeRawConstant(ac.physicalIndex, source->getFarClipDistance());
+            break;
+        case ACT_PASS_NUMBER:
+            _writeRawConstant(ac.physicalIndex, (float)source->getPassNumber());
+            break;
+        case ACT_PASS_ITERATION_NUMBER:
+            // this is actually just an initial set-up, it's bound separately, so still global
+            _writeRawConstant(ac.physicalIndex, 0.0f);
+            mActivePassIterationIndex = ac.physicalIndex;
+            break;
+        case ACT_TEXTURE_MATRIX:
+            _writeRawConstant(ac.physicalIndex, source->getTextureTransformMatrix(ac.data),ac.elementCount);
+            break;
+        case ACT_LOD_CAMERA_POSITION:
+            _writeRawConstant(ac.physicalIndex, source->getLodCameraPosition(), ac.elementCount);
+            break;
+        case ACT_MATERIAL_LOD_INDEX:
+            _writeRawConstant(ac.physicalIndex, (float)source->getMaterialLodIndex());
+            break;
+        case ACT_TEXTURE_WORLDVIEWPROJ_MATRIX:
+            // can also be updated in lights
+            _writeRawConstant(ac.physicalIndex, source->getTextureWorldViewProjMatrix(ac.data),ac.elementCount);
+            break;
+        case ACT_TEXTURE_WORLDVIEWPROJ_MATRIX_ARRAY:
+            for (size_t l = 0; l < ac.data; ++l)
+            {
+                // can also be updated in lights
+                _writeRawConstant(ac.physicalIndex + l*sizeof(Matrix4),
+                                  source->getTextureWorldViewProjMatrix(l),ac.elementCount);
+            }
+            break;
+        case ACT_SPOTLIGHT_WORLDVIEWPROJ_MATRIX:
+            _writeRawConstant(ac.physicalIndex, source->getSpotlightWorldViewProjMatrix(ac.data),ac.elementCount);
+            break;
+        case ACT_SPOTLIGHT_WORLDVIEWPROJ_MATRIX_ARRAY:
+            for (size_t l = 0; l < ac.data; ++l)
+                _writeRawConstant(ac.physicalIndex + l*sizeof(Matrix4), source->getSpotlightWorldViewProjMatrix(l), ac.elementCount);
+            break;
+        case ACT_LIGHT_POSITION_OBJECT_SPACE:
+            _writeRawConstant(ac.physicalIndex,
+                              source->getInverseWorldMatrix() *
+                                  source->getLightAs4DVector(ac.data),
+                              ac.elementCount);
+            break;
+        case ACT_LIGHT_DIRECTION_OBJECT_SPACE:
+            // We need the inverse of the inverse transpose
+            m3 = source->getTransposeWorldMatrix().linear();
+            vec3 = m3 * source->getLightDirection(ac.data);
+            vec3.normalise();
+            // Set as 4D vector for compatibility
+            _writeRawConstant(ac.physicalIndex, Vector4f(vec3.x, vec3.y, vec3.z, 0.0f), ac.elementCount);
+            break;
+        case ACT_LIGHT_DISTANCE_OBJECT_SPACE:
+            vec3 = source->getInverseWorldMatrix() * source->getLightPosition(ac.data);
+            _writeRawConstant(ac.physicalIndex, vec3.length());
+            break;
+        case ACT_LIGHT_POSITION_OBJECT_SPACE_ARRAY:
+            for (size_t l = 0; l < ac.data; ++l)
+                _writeRawConstant(ac.physicalIndex + l*sizeof(Vector4f),
+                                  source->getInverseWorldMatrix() *
+                                      source->getLightAs4DVector(l),
+                                  ac.elementCount);
+            break;
 
-                case ACT_CAMERA_POSITION:
-                    _writeRawConstant(ac.physicalIndex, source->getCameraPosition(), ac.elementCount);
-                    break;
-                case ACT_CAMERA_RELATIVE_POSITION:
-                    _writeRawConstant (ac.physicalIndex, source->getCameraRelativePosition(), ac.elementCount);
-                    break;
-                case ACT_TIME:
-                    _writeRawConstant(ac.physicalIndex, source->getTime() * ac.fData);
-                    break;
-                case ACT_TIME_0_X:
-                    _writeRawConstant(ac.physicalIndex, source->getTime_0_X(ac.fData));
-                    break;
-                case ACT_COSTIME_0_X:
-                    _writeRawConstant(ac.physicalIndex, source->getCosTime_0_X(ac.fData));
-                    break;
-                case ACT_SINTIME_0_X:
-                    _writeRawConstant(ac.physicalIndex, source->getSinTime_0_X(ac.fData));
-                    break;
-                case ACT_TANTIME_0_X:
-                    _writeRawConstant(ac.physicalIndex, source->getTanTime_0_X(ac.fData));
-                    break;
-                case ACT_TIME_0_X_PACKED:
-                    _writeRawConstant(ac.physicalIndex, source->getTime_0_X_packed(ac.fData), ac.elementCount);
-                    break;
-                case ACT_TIME_0_1:
-                    _writeRawConstant(ac.physicalIndex, source->getTime_0_1(ac.fData));
-                    break;
-                case ACT_COSTIME_0_1:
-                    _writeRawConstant(ac.physicalIndex, source->getCosTime_0_1(ac.fData));
-                    break;
-                case ACT_SINTIME_0_1:
-                    _writeRawConstant(ac.physicalIndex, source->getSinTime_0_1(ac.fData));
-                    break;
-                case ACT_TANTIME_0_1:
-                    _writeRawConstant(ac.physicalIndex, source->getTanTime_0_1(ac.fData));
-                    break;
-                case ACT_TIME_0_1_PACKED:
-                    _writeRawConstant(ac.physicalIndex, source->getTime_0_1_packed(ac.fData), ac.elementCount);
-                    break;
-                case ACT_TIME_0_2PI:
-                    _writeRawConstant(ac.physicalIndex, source->getTime_0_2Pi(ac.fData));
-                    break;
-                case ACT_COSTIME_0_2PI:
-                    _writeRawConstant(ac.physicalIndex, source->getCosTime_0_2Pi(ac.fData));
-                    break;
-                case ACT_SINTIME_0_2PI:
-                    _writeRawConstant(ac.physicalIndex, source->getSinTime_0_2Pi(ac.fData));
-                    break;
-                case ACT_TANTIME_0_2PI:
-                    _writeRawConstant(ac.physicalIndex, source->getTanTime_0_2Pi(ac.fData));
-                    break;
-                case ACT_TIME_0_2PI_PACKED:
-                    _writeRawConstant(ac.physicalIndex, source->getTime_0_2Pi_packed(ac.fData), ac.elementCount);
-                    break;
-                case ACT_FRAME_TIME:
-                    _writeRawConstant(ac.physicalIndex, source->getFrameTime() * ac.fData);
-                    break;
-                case ACT_FPS:
-                    _writeRawConstant(ac.physicalIndex, source->getFPS());
-                    break;
-                case ACT_VIEWPORT_WIDTH:
-                    _writeRawConstant(ac.physicalIndex, source->getViewportWidth());
-                    break;
-                case ACT_VIEWPORT_HEIGHT:
-                    _writeRawConstant(ac.physicalIndex, source->getViewportHeight());
-                    break;
-                case ACT_INVERSE_VIEWPORT_WIDTH:
-                    _writeRawConstant(ac.physicalIndex, source->getInverseViewportWidth());
-                    break;
-                case ACT_INVERSE_VIEWPORT_HEIGHT:
-                    _writeRawConstant(ac.physicalIndex, source->getInverseViewportHeight());
-                    break;
-                case ACT_VIEWPORT_SIZE:
-                    _writeRawConstant(ac.physicalIndex, Vector4f(
-                        source->getViewportWidth(),
-                        source->getViewportHeight(),
-                        source->getInverseViewportWidth(),
-                        source->getInverseViewportHeight()), ac.elementCount);
-                    break;
-                case ACT_TEXEL_OFFSETS:
-                    {
-                        RenderSystem* rsys = Root::getSingleton().getRenderSystem();
-                        _writeRawConstant(ac.physicalIndex, Vector4f(
-                            rsys->getHorizontalTexelOffset(),
-                            rsys->getVerticalTexelOffset(),
-                            rsys->getHorizontalTexelOffset() * source->getInverseViewportWidth(),
-                            rsys->getVerticalTexelOffset() * source->getInverseViewportHeight()),
-                                          ac.elementCount);
-                    }
-                    break;
-                case ACT_TEXTURE_SIZE:
-                    _writeRawConstant(ac.physicalIndex, source->getTextureSize(ac.data), ac.elementCount);
-                    break;
-                case ACT_INVERSE_TEXTURE_SIZE:
-                    _writeRawConstant(ac.physicalIndex, source->getInverseTextureSize(ac.data), ac.elementCount);
-                    break;
-                case ACT_PACKED_TEXTURE_SIZE:
-                    _writeRawConstant(ac.physicalIndex, source->getPackedTextureSize(ac.data), ac.elementCount);
-                    break;
-                case ACT_SCENE_DEPTH_RANGE:
-                    _writeRawConstant(ac.physicalIndex, source->getSceneDepthRange(), ac.elementCount);
-                    break;
-                case ACT_VIEW_DIRECTION:
-                    _writeRawConstant(ac.physicalIndex, source->getViewDirection());
-                    break;
-                case ACT_VIEW_SIDE_VECTOR:
-                    _writeRawConstant(ac.physicalIndex, source->getViewSideVector());
-                    break;
-                case ACT_VIEW_UP_VECTOR:
-                    _writeRawConstant(ac.physicalIndex, source->getViewUpVector());
-                    break;
-                case ACT_FOV:
-                    _writeRawConstant(ac.physicalIndex, source->getFOV());
-                    break;
-                case ACT_NEAR_CLIP_DISTANCE:
-                    _writeRawConstant(ac.physicalIndex, source->getNearClipDistance());
-                    break;
-                case ACT_FAR_CLIP_DISTANCE:
-                    _writeRawConstant(ac.physicalIndex, source->getFarClipDistance());
-                    break;
-                case ACT_PASS_NUMBER:
-                    _writeRawConstant(ac.physicalIndex, (float)source->getPassNumber());
-                    break;
-                case ACT_PASS_ITERATION_NUMBER:
-                    // this is actually just an initial set-up, it's bound separately, so still global
-                    _writeRawConstant(ac.physicalIndex, 0.0f);
-                    mActivePassIterationIndex = ac.physicalIndex;
-                    break;
-                case ACT_TEXTURE_MATRIX:
-                    _writeRawConstant(ac.physicalIndex, source->getTextureTransformMatrix(ac.data),ac.elementCount);
-                    break;
-                case ACT_LOD_CAMERA_POSITION:
-                    _writeRawConstant(ac.physicalIndex, source->getLodCameraPosition(), ac.elementCount);
-                    break;
-                case ACT_MATERIAL_LOD_INDEX:
-                    _writeRawConstant(ac.physicalIndex, (float)source->getMaterialLodIndex());
-                    break;
-                case ACT_TEXTURE_WORLDVIEWPROJ_MATRIX:
-                    // can also be updated in lights
-                    _writeRawConstant(ac.physicalIndex, source->getTextureWorldViewProjMatrix(ac.data),ac.elementCount);
-                    break;
-                case ACT_TEXTURE_WORLDVIEWPROJ_MATRIX_ARRAY:
-                    for (size_t l = 0; l < ac.data; ++l)
-                    {
-                        // can also be updated in lights
-                        _writeRawConstant(ac.physicalIndex + l*sizeof(Matrix4),
-                                          source->getTextureWorldViewProjMatrix(l),ac.elementCount);
-                    }
-                    break;
-                case ACT_SPOTLIGHT_WORLDVIEWPROJ_MATRIX:
-                    _writeRawConstant(ac.physicalIndex, source->getSpotlightWorldViewProjMatrix(ac.data),ac.elementCount);
-                    break;
-                case ACT_SPOTLIGHT_WORLDVIEWPROJ_MATRIX_ARRAY:
-                    for (size_t l = 0; l < ac.data; ++l)
-                        _writeRawConstant(ac.physicalIndex + l*sizeof(Matrix4), source->getSpotlightWorldViewProjMatrix(l), ac.elementCount);
-                    break;
-                case ACT_LIGHT_POSITION_OBJECT_SPACE:
-                    _writeRawConstant(ac.physicalIndex,
-                                      source->getInverseWorldMatrix() *
-                                          source->getLightAs4DVector(ac.data),
-                                      ac.elementCount);
-                    break;
-                case ACT_LIGHT_DIRECTION_OBJECT_SPACE:
-                    // We need the inverse of the inverse transpose
-                    m3 = source->getTransposeWorldMatrix().linear();
-                    vec3 = m3 * source->getLightDirection(ac.data);
-                    vec3.normalise();
-                    // Set as 4D vector for compatibility
-                    _writeRawConstant(ac.physicalIndex, Vector4f(vec3.x, vec3.y, vec3.z, 0.0f), ac.elementCount);
-                    break;
-                case ACT_LIGHT_DISTANCE_OBJECT_SPACE:
-                    vec3 = source->getInverseWorldMatrix() * source->getLightPosition(ac.data);
-                    _writeRawConstant(ac.physicalIndex, vec3.length());
-                    break;
-                case ACT_LIGHT_POSITION_OBJECT_SPACE_ARRAY:
-                    for (size_t l = 0; l < ac.data; ++l)
-                        _writeRawConstant(ac.physicalIndex + l*sizeof(Vector4f),
-                                          source->getInverseWorldMatrix() *
-                                              source->getLightAs4DVector(l),
-                                          ac.elementCount);
-                    break;
+        case ACT_LIGHT_DIRECTION_OBJECT_SPACE_ARRAY:
+            // We need the inverse of the inverse transpose
+            m3 = source->getTransposeWorldMatrix().linear();
+            for (size_t l = 0; l < ac.data; ++l)
+            {
+                vec3 = m3 * source->getLightDirection(l);
+                vec3.normalise();
+                _writeRawConstant(ac.physicalIndex + l*sizeof(Vector4f),
+                                  Vector4f(vec3.x, vec3.y, vec3.z, 0.0f), ac.elementCount);
+            }
+            break;
 
-                case ACT_LIGHT_DIRECTION_OBJECT_SPACE_ARRAY:
-                    // We need the inverse of the inverse transpose
-                    m3 = source->getTransposeWorldMatrix().linear();
-                    for (size_t l = 0; l < ac.data; ++l)
-                    {
-                        vec3 = m3 * source->getLightDirection(l);
-                        vec3.normalise();
-                        _writeRawConstant(ac.physicalIndex + l*sizeof(Vector4f),
-                                          Vector4f(vec3.x, vec3.y, vec3.z, 0.0f), ac.elementCount);
-                    }
-                    break;
+        case ACT_LIGHT_DISTANCE_OBJECT_SPACE_ARRAY:
+            for (size_t l = 0; l < ac.data; ++l)
+            {
+                vec3 = source->getInverseWorldMatrix() * source->getLightPosition(l);
+                _writeRawConstant(ac.physicalIndex + l*sizeof(Real), vec3.length());
+            }
+            break;
 
-                case ACT_LIGHT_DISTANCE_OBJECT_SPACE_ARRAY:
-                    for (size_t l = 0; l < ac.data; ++l)
-                    {
-                        vec3 = source->getInverseWorldMatrix() * source->getLightPosition(l);
-                        _writeRawConstant(ac.physicalIndex + l*sizeof(Real), vec3.length());
-                    }
-                    break;
+        case ACT_WORLD_MATRIX:
+            _writeRawConstant(ac.physicalIndex, source->getWorldMatrix(),ac.elementCount);
+            break;
+        case ACT_INVERSE_WORLD_MATRIX:
+            _writeRawConstant(ac.physicalIndex, source->getInverseWorldMatrix(),ac.elementCount);
+            break;
+        case ACT_TRANSPOSE_WORLD_MATRIX:
+            _writeRawConstant(ac.physicalIndex, source->getTransposeWorldMatrix(),ac.elementCount);
+            break;
+        case ACT_INVERSE_TRANSPOSE_WORLD_MATRIX:
+            _writeRawConstant(ac.physicalIndex, source->getInverseTransposeWorldMatrix(),ac.elementCount);
+            break;
+
+        case ACT_BONE_MATRIX_ARRAY_3x4:
+            // Loop over matrices
+            pMatrix = source->getBoneMatrixArray();
+            numMatrices = source->getBoneMatrixCount();
+            index = ac.physicalIndex;
+            for (m = 0; m < numMatrices; ++m)
+            {
+                _writeRawConstants(index, (*pMatrix)[0], 12);
+                index += 12*sizeof(Real);
+                ++pMatrix;
+            }
+            break;
+        case ACT_BONE_MATRIX_ARRAY:
+            _writeRawConstant(ac.physicalIndex, source->getBoneMatrixArray(),
+                              source->getBoneMatrixCount());
+            break;
+        case ACT_BONE_DUALQUATERNION_ARRAY_2x4:
+            // Loop over matrices
+            pMatrix = source->getBoneMatrixArray();
+            numMatrices = source->getBoneMatrixCount();
+            index = ac.physicalIndex;
+            for (m = 0; m < numMatrices; ++m)
+            {
+                dQuat.fromTransformationMatrix(*pMatrix);
+                _writeRawConstants(index, dQuat.ptr(), 8);
+                index += sizeof(DualQuaternion);
+                ++pMatrix;
+            }
+            break;
+        case ACT_BONE_SCALE_SHEAR_MATRIX_ARRAY_3x4:
+            // Loop over matrices
+            pMatrix = source->getBoneMatrixArray();
+            numMatrices = source->getBoneMatrixCount();
+            index = ac.physicalIndex;
 
-                case ACT_WORLD_MATRIX:
-                    _writeRawConstant(ac.physicalIndex, source->getWorldMatrix(),ac.elementCount);
-                    break;
-                case ACT_INVERSE_WORLD_MATRIX:
-                    _writeRawConstant(ac.physicalIndex, source->getInverseWorldMatrix(),ac.elementCount);
-                    break;
-                case ACT_TRANSPOSE_WORLD_MATRIX:
-                    _writeRawConstant(ac.physicalIndex, source->getTransposeWorldMatrix(),ac.elementCount);
-                    break;
-                case ACT_INVERSE_TRANSPOSE_WORLD_MATRIX:
-                    _writeRawConstant(ac.physicalIndex, source->getInverseTransposeWorldMatrix(),ac.elementCount);
-                    break;
+            scaleM = Matrix4::IDENTITY;
 
-                case ACT_BONE_MATRIX_ARRAY_3x4:
-                    // Loop over matrices
-                    pMatrix = source->getBoneMatrixArray();
-                    numMatrices = source->getBoneMatrixCount();
-                    index = ac.physicalIndex;
-                    for (m = 0; m < numMatrices; ++m)
-                    {
-                        _writeRawConstants(index, (*pMatrix)[0], 12);
-                        index += 12*sizeof(Real);
-                        ++pMatrix;
-                    }
-                    break;
-                case ACT_BONE_MATRIX_ARRAY:
-                    _writeRawConstant(ac.physicalIndex, source->getBoneMatrixArray(),
-                                      source->getBoneMatrixCount());
-                    break;
-                case ACT_BONE_DUALQUATERNION_ARRAY_2x4:
-                    // Loop over matrices
-                    pMatrix = source->getBoneMatrixArray();
-                    numMatrices = source->getBoneMatrixCount();
-                    index = ac.physicalIndex;
-                    for (m = 0; m < numMatrices; ++m)
-                    {
-                        dQuat.fromTransformationMatrix(*pMatrix);
-                        _writeRawConstants(index, dQuat.ptr(), 8);
-                        index += sizeof(DualQuaternion);
-                        ++pMatrix;
-                    }
-                    break;
-                case ACT_BONE_SCALE_SHEAR_MATRIX_ARRAY_3x4:
-                    // Loop over matrices
-                    pMatrix = source->getBoneMatrixArray();
-                    numMatrices = source->getBoneMatrixCount();
-                    index = ac.physicalIndex;
-
-                    scaleM = Matrix4::IDENTITY;
-
-                    for (m = 0; m < numMatrices; ++m)
-                    {
-                        //Based on Matrix4::decompostion, but we don't need the rotation or position components
-                        //but do need the scaling and shearing. Shearing isn't available from Matrix4::decomposition
-                        m3 = pMatrix->linear();
-
-                        Matrix3 matQ;
-                        Vector3 scale;
-
-                        //vecU is the scaling component with vecU[0] = u01, vecU[1] = u02, vecU[2] = u12
-                        //vecU[0] is shearing (x,y), vecU[1] is shearing (x,z), and vecU[2] is shearing (y,z)
-                        //The first component represents the coordinate that is being sheared,
-                        //while the second component represents the coordinate which performs the shearing.
-                        Vector3 vecU;
-                        m3.QDUDecomposition( matQ, scale, vecU );
-
-                        scaleM[0][0] = scale.x;
-                        scaleM[1][1] = scale.y;
-                        scaleM[2][2] = scale.z;
-
-                        scaleM[0][1] = vecU[0];
-                        scaleM[0][2] = vecU[1];
-                        scaleM[1][2] = vecU[2];
-
-                        _writeRawConstants(index, scaleM[0], 12);
-                        index += 12*sizeof(Real);
-                        ++pMatrix;
-                    }
-                    break;
-                case ACT_WORLDVIEW_MATRIX:
-                    _writeRawConstant(ac.physicalIndex, source->getWorldViewMatrix(),ac.elementCount);
-                    break;
-                case ACT_INVERSE_WORLDVIEW_MATRIX:
-                    _writeRawConstant(ac.physicalIndex, source->getInverseWorldViewMatrix(),ac.elementCount);
-                    break;
-                case ACT_TRANSPOSE_WORLDVIEW_MATRIX:
-                    _writeRawConstant(ac.physicalIndex, source->getTransposeWorldViewMatrix(),ac.elementCount);
-                    break;
-                case ACT_NORMAL_MATRIX:
-                    if(ac.elementCount == 9) // check if shader supports packed data
-                    {
-                        _writeRawConstant(ac.physicalIndex, source->getInverseTransposeWorldViewMatrix().linear(),ac.elementCount);
-                        break;
-                    }
-                    OGRE_FALLTHROUGH; // fallthrough to padded 4x4 matrix
-                case ACT_INVERSE_TRANSPOSE_WORLDVIEW_MATRIX:
-                    _writeRawConstant(ac.physicalIndex, source->getInverseTransposeWorldViewMatrix(),ac.elementCount);
-                    break;
-
-                case ACT_WORLDVIEWPROJ_MATRIX:
-                    _writeRawConstant(ac.physicalIndex, source->getWorldViewProjMatrix(),ac.elementCount);
-                    break;
-                case ACT_INVERSE_WORLDVIEWPROJ_MATRIX:
-                    _writeRawConstant(ac.physicalIndex, source->getInverseWorldViewProjMatrix(),ac.elementCount);
-                    break;
-                case ACT_TRANSPOSE_WORLDVIEWPROJ_MATRIX:
-                    _writeRawConstant(ac.physicalIndex, source->getTransposeWorldViewProjMatrix(),ac.elementCount);
-                    break;
-                case ACT_INVERSE_TRANSPOSE_WORLDVIEWPROJ_MATRIX:
-                    _writeRawConstant(ac.physicalIndex, source->getInverseTransposeWorldViewProjMatrix(),ac.elementCount);
-                    break;
-                case ACT_WORLDVIEWPROJ_MATRIX_ARRAY:
-                    for (size_t l = 0; l < ac.data; ++l)
-                    {
-                        _writeRawConstant(ac.physicalIndex + l*sizeof(Matrix4),
-                                          source->getWorldViewProjMatrix(l),ac.elementCount);
-                    }
-                    break;
-                case ACT_CAMERA_POSITION_OBJECT_SPACE:
-                    _writeRawConstant(ac.physicalIndex, source->getCameraPositionObjectSpace(), ac.elementCount);
-                    break;
-                case ACT_LOD_CAMERA_POSITION_OBJECT_SPACE:
-                    _writeRawConstant(ac.physicalIndex, source->getLodCameraPositionObjectSpace(), ac.elementCount);
-                    break;
+            for (m = 0; m < numMatrices; ++m)
+            {
+                //Based on Matrix4::decompostion, but we don't need the rotation or position components
+                //but do need the scaling and shearing. Shearing isn't available from Matrix4::decomposition
+                m3 = pMatrix->linear();
+
+                Matrix3 matQ;
+                Vector3 scale;
+
+                //vecU is the scaling component with vecU[0] = u01, vecU[1] = u02, vecU[2] = u12
+                //vecU[0] is shearing (x,y), vecU[1] is shearing (x,z), and vecU[2] is shearing (y,z)
+                //The first component represents the coordinate that is being sheared,
+                //while the second component represents the coordinate which performs the shearing.
+                Vector3 vecU;
+                m3.QDUDecomposition( matQ, scale, vecU );
+
+                scaleM[0][0] = scale.x;
+                scaleM[1][1] = scale.y;
+                scaleM[2][2] = scale.z;
+
+                scaleM[0][1] = vecU[0];
+                scaleM[0][2] = vecU[1];
+                scaleM[1][2] = vecU[2];
+
+                _writeRawConstants(index, scaleM[0], 12);
+                index += 12*sizeof(Real);
+                ++pMatrix;
+            }
+            break;
+        case ACT_WORLDVIEW_MATRIX:
+            _writeRawConstant(ac.physicalIndex, source->getWorldViewMatrix(),ac.elementCount);
+            break;
+        case ACT_INVERSE_WORLDVIEW_MATRIX:
+            _writeRawConstant(ac.physicalIndex, source->getInverseWorldViewMatrix(),ac.elementCount);
+            break;
+        case ACT_TRANSPOSE_WORLDVIEW_MATRIX:
+            _writeRawConstant(ac.physicalIndex, source->getTransposeWorldViewMatrix(),ac.elementCount);
+            break;
+        case ACT_NORMAL_MATRIX:
+            if(ac.elementCount == 9) // check if shader supports packed data
+            {
+                _writeRawConstant(ac.physicalIndex, source->getInverseTransposeWorldViewMatrix().linear(),ac.elementCount);
+                break;
+            }
+            OGRE_FALLTHROUGH; // fallthrough to padded 4x4 matrix
+        case ACT_INVERSE_TRANSPOSE_WORLDVIEW_MATRIX:
+            _writeRawConstant(ac.physicalIndex, source->getInverseTransposeWorldViewMatrix(),ac.elementCount);
+            break;
 
-                case ACT_CUSTOM:
-                case ACT_ANIMATION_PARAMETRIC:
-                    source->getCurrentRenderable()->_updateCustomGpuParameter(ac, this);
-                    break;
-                case ACT_LIGHT_CUSTOM:
-                    source->updateLightCustomGpuParameter(ac, this);
-                    break;
-                case ACT_LIGHT_COUNT:
-                    _writeRawConstant(ac.physicalIndex, source->getLightCount());
-                    break;
-                case ACT_LIGHT_DIFFUSE_COLOUR:
-                    _writeRawConstant(ac.physicalIndex, source->getLightDiffuseColour(ac.data), ac.elementCount);
-                    break;
-                case ACT_LIGHT_SPECULAR_COLOUR:
-                    _writeRawConstant(ac.physicalIndex, source->getLightSpecularColour(ac.data), ac.elementCount);
-                    break;
-                case ACT_LIGHT_POSITION:
-                    // Get as 4D vector, works for directional lights too
-                    // Use element count in case uniform slot is smaller
-                    _writeRawConstant(ac.physicalIndex,
-                                      source->getLightAs4DVector(ac.data), ac.elementCount);
-                    break;
-                case ACT_LIGHT_DIRECTION:
-                    vec3 = source->getLightDirection(ac.data);
-                    // Set as 4D vector for compatibility
-                    // Use element count in case uniform slot is smaller
-                    _writeRawConstant(ac.physicalIndex, Vector4f(vec3.x, vec3.y, vec3.z, 1.0f), ac.elementCount);
-                    break;
-                case ACT_LIGHT_POSITION_VIEW_SPACE:
-                    _writeRawConstant(ac.physicalIndex,
-                                      source->getViewMatrix() * source->getLightAs4DVector(ac.data), ac.elementCount);
-                    break;
-                case ACT_LIGHT_DIRECTION_VIEW_SPACE:
-                    m3 = source->getInverseTransposeViewMatrix().linear();
-                    // inverse transpose in case of scaling
-                    vec3 = m3 * source->getLightDirection(ac.data);
-                    vec3.normalise();
-                    // Set as 4D vector for compatibility
-                    _writeRawConstant(ac.physicalIndex, Vector4f(vec3.x, vec3.y, vec3.z, 0.0f),ac.elementCount);
-                    break;
-                case ACT_SHADOW_EXTRUSION_DISTANCE:
-                    // extrusion is in object-space, so we have to rescale by the inverse
-                    // of the world scaling to deal with scaled objects
-                    m3 = source->getWorldMatrix().linear();
-                    _writeRawConstant(ac.physicalIndex, source->getShadowExtrusionDistance() /
-                                      Math::Sqrt(std::max(std::max(m3.GetColumn(0).squaredLength(), m3.GetColumn(1).squaredLength()), m3.GetColumn(2).squaredLength())));
-                    break;
-                case ACT_SHADOW_SCENE_DEPTH_RANGE:
-                    _writeRawConstant(ac.physicalIndex, source->getShadowSceneDepthRange(ac.data));
-                    break;
-                case ACT_SHADOW_SCENE_DEPTH_RANGE_ARRAY:
-                    for (size_t l = 0; l < ac.data; ++l)
-                        _writeRawConstant(ac.physicalIndex + l*ac.elementCount, source->getShadowSceneDepthRange(l), ac.elementCount);
-                    break;
-                case ACT_SHADOW_COLOUR:
-                    _writeRawConstant(ac.physicalIndex, source->getShadowColour(), ac.elementCount);
-                    break;
-                case ACT_LIGHT_POWER_SCALE:
-                    _writeRawConstant(ac.physicalIndex, source->getLightPowerScale(ac.data));
-                    break;
-                case ACT_LIGHT_DIFFUSE_COLOUR_POWER_SCALED:
-                    _writeRawConstant(ac.physicalIndex, source->getLightDiffuseColourWithPower(ac.data), ac.elementCount);
-                    break;
-                case ACT_LIGHT_SPECULAR_COLOUR_POWER_SCALED:
-                    _writeRawConstant(ac.physicalIndex, source->getLightSpecularColourWithPower(ac.data), ac.elementCount);
-                    break;
-                case ACT_LIGHT_NUMBER:
-                    _writeRawConstant(ac.physicalIndex, source->getLightNumber(ac.data));
-                    break;
-                case ACT_LIGHT_CASTS_SHADOWS:
-                    _writeRawConstant(ac.physicalIndex, source->getLightCastsShadows(ac.data));
-                    break;
-                case ACT_LIGHT_CASTS_SHADOWS_ARRAY:
-                    for (size_t l = 0; l < ac.data; ++l)
-                        _writeRawConstant(ac.physicalIndex + l*sizeof(float), source->getLightCastsShadows(l));
-                    break;
-                case ACT_LIGHT_ATTENUATION:
-                    _writeRawConstant(ac.physicalIndex, source->getLightAttenuation(ac.data), ac.elementCount);
-                    break;
-                case ACT_SPOTLIGHT_PARAMS:
-                    _writeRawConstant(ac.physicalIndex, source->getSpotlightParams(ac.data), ac.elementCount);
-                    break;
-                case ACT_LIGHT_DIFFUSE_COLOUR_ARRAY:
-                    for (size_t l = 0; l < ac.data; ++l)
-                        _writeRawConstant(ac.physicalIndex + l*sizeof(ColourValue),
-                                          source->getLightDiffuseColour(l), ac.elementCount);
-                    break;
+        case ACT_WORLDVIEWPROJ_MATRIX:
+            _writeRawConstant(ac.physicalIndex, source->getWorldViewProjMatrix(),ac.elementCount);
+            break;
+        case ACT_INVERSE_WORLDVIEWPROJ_MATRIX:
+            _writeRawConstant(ac.physicalIndex, source->getInverseWorldViewProjMatrix(),ac.elementCount);
+            break;
+        case ACT_TRANSPOSE_WORLDVIEWPROJ_MATRIX:
+            _writeRawConstant(ac.physicalIndex, source->getTransposeWorldViewProjMatrix(),ac.elementCount);
+            break;
+        case ACT_INVERSE_TRANSPOSE_WORLDVIEWPROJ_MATRIX:
+            _writeRawConstant(ac.physicalIndex, source->getInverseTransposeWorldViewProjMatrix(),ac.elementCount);
+            break;
+        case ACT_WORLDVIEWPROJ_MATRIX_ARRAY:
+            for (size_t l = 0; l < ac.data; ++l)
+            {
+                _writeRawConstant(ac.physicalIndex + l*sizeof(Matrix4),
+                                  source->getWorldViewProjMatrix(l),ac.elementCount);
+            }
+            break;
+        case ACT_CAMERA_POSITION_OBJECT_SPACE:
+            _writeRawConstant(ac.physicalIndex, source->getCameraPositionObjectSpace(), ac.elementCount);
+            break;
+        case ACT_LOD_CAMERA_POSITION_OBJECT_SPACE:
+            _writeRawConstant(ac.physicalIndex, source->getLodCameraPositionObjectSpace(), ac.elementCount);
+            break;
 
-                case ACT_LIGHT_SPECULAR_COLOUR_ARRAY:
-                    for (size_t l = 0; l < ac.data; ++l)
-                        _writeRawConstant(ac.physicalIndex + l*sizeof(ColourValue),
-                                          source->getLightSpecularColour(l), ac.elementCount);
-                    break;
-                case ACT_LIGHT_DIFFUSE_COLOUR_POWER_SCALED_ARRAY:
-                    _writeRawConstants(ac.physicalIndex, source->getLightDiffuseColourPowerScaledArray(ac.data),
-                                       ac.data);
-                    break;
+        case ACT_CUSTOM:
+        case ACT_ANIMATION_PARAMETRIC:
+            source->getCurrentRenderable()->_updateCustomGpuParameter(ac, this);
+            break;
+        case ACT_LIGHT_CUSTOM:
+            source->updateLightCustomGpuParameter(ac, this);
+            break;
+        case ACT_LIGHT_COUNT:
+            _writeRawConstant(ac.physicalIndex, source->getLightCount());
+            break;
+        case ACT_LIGHT_DIFFUSE_COLOUR:
+            _writeRawConstant(ac.physicalIndex, source->getLightDiffuseColour(ac.data), ac.elementCount);
+            break;
+        case ACT_LIGHT_SPECULAR_COLOUR:
+            _writeRawConstant(ac.physicalIndex, source->getLightSpecularColour(ac.data), ac.elementCount);
+            break;
+        case ACT_LIGHT_POSITION:
+            // Get as 4D vector, works for directional lights too
+            // Use element count in case uniform slot is smaller
+            _writeRawConstant(ac.physicalIndex,
+                              source->getLightAs4DVector(ac.data), ac.elementCount);
+            break;
+        case ACT_LIGHT_DIRECTION:
+            vec3 = source->getLightDirection(ac.data);
+            // Set as 4D vector for compatibility
+            // Use element count in case uniform slot is smaller
+            _writeRawConstant(ac.physicalIndex, Vector4f(vec3.x, vec3.y, vec3.z, 1.0f), ac.elementCount);
+            break;
+        case ACT_LIGHT_POSITION_VIEW_SPACE:
+            _writeRawConstant(ac.physicalIndex,
+                              source->getViewMatrix() * source->getLightAs4DVector(ac.data), ac.elementCount);
+            break;
+        case ACT_LIGHT_DIRECTION_VIEW_SPACE:
+            m3 = source->getInverseTransposeViewMatrix().linear();
+            // inverse transpose in case of scaling
+            vec3 = m3 * source->getLightDirection(ac.data);
+            vec3.normalise();
+            // Set as 4D vector for compatibility
+            _writeRawConstant(ac.physicalIndex, Vector4f(vec3.x, vec3.y, vec3.z, 0.0f),ac.elementCount);
+            break;
+        case ACT_SHADOW_EXTRUSION_DISTANCE:
+            // extrusion is in object-space, so we have to rescale by the inverse
+            // of the world scaling to deal with scaled objects
+            m3 = source->getWorldMatrix().linear();
+            _writeRawConstant(ac.physicalIndex, source->getShadowExtrusionDistance() /
+                              Math::Sqrt(std::max(std::max(m3.GetColumn(0).squaredLength(), m3.GetColumn(1).squaredLength()), m3.GetColumn(2).squaredLength())));
+            break;
+        case ACT_SHADOW_SCENE_DEPTH_RANGE:
+            _writeRawConstant(ac.physicalIndex, source->getShadowSceneDepthRange(ac.data));
+            break;
+        case ACT_SHADOW_SCENE_DEPTH_RANGE_ARRAY:
+            for (size_t l = 0; l < ac.data; ++l)
+                _writeRawConstant(ac.physicalIndex + l*ac.elementCount, source->getShadowSceneDepthRange(l), ac.elementCount);
+            break;
+        case ACT_SHADOW_COLOUR:
+            _writeRawConstant(ac.physicalIndex, source->getShadowColour(), ac.elementCount);
+            break;
+        case ACT_LIGHT_POWER_SCALE:
+            _writeRawConstant(ac.physicalIndex, source->getLightPowerScale(ac.data));
+            break;
+        case ACT_LIGHT_DIFFUSE_COLOUR_POWER_SCALED:
+            _writeRawConstant(ac.physicalIndex, source->getLightDiffuseColourWithPower(ac.data), ac.elementCount);
+            break;
+        case ACT_LIGHT_SPECULAR_COLOUR_POWER_SCALED:
+            _writeRawConstant(ac.physicalIndex, source->getLightSpecularColourWithPower(ac.data), ac.elementCount);
+            break;
+        case ACT_LIGHT_NUMBER:
+            _writeRawConstant(ac.physicalIndex, source->getLightNumber(ac.data));
+            break;
+        case ACT_LIGHT_CASTS_SHADOWS:
+            _writeRawConstant(ac.physicalIndex, source->getLightCastsShadows(ac.data));
+            break;
+        case ACT_LIGHT_CASTS_SHADOWS_ARRAY:
+            for (size_t l = 0; l < ac.data; ++l)
+                _writeRawConstant(ac.physicalIndex + l*sizeof(float), source->getLightCastsShadows(l));
+            break;
+        case ACT_LIGHT_ATTENUATION:
+            _writeRawConstant(ac.physicalIndex, source->getLightAttenuation(ac.data), ac.elementCount);
+            break;
+        case ACT_SPOTLIGHT_PARAMS:
+            _writeRawConstant(ac.physicalIndex, source->getSpotlightParams(ac.data), ac.elementCount);
+            break;
+        case ACT_LIGHT_DIFFUSE_COLOUR_ARRAY:
+            for (size_t l = 0; l < ac.data; ++l)
+                _writeRawConstant(ac.physicalIndex + l*sizeof(ColourValue),
+                                  source->getLightDiffuseColour(l), ac.elementCount);
+            break;
 
-                case ACT_LIGHT_SPECULAR_COLOUR_POWER_SCALED_ARRAY:
-                    for (size_t l = 0; l < ac.data; ++l)
-                        _writeRawConstant(ac.physicalIndex + l*sizeof(ColourValue),
-                                          source->getLightSpecularColourWithPower(l), ac.elementCount);
-                    break;
+        case ACT_LIGHT_SPECULAR_COLOUR_ARRAY:
+            for (size_t l = 0; l < ac.data; ++l)
+                _writeRawConstant(ac.physicalIndex + l*sizeof(ColourValue),
+                                  source->getLightSpecularColour(l), ac.elementCount);
+            break;
+        case ACT_LIGHT_DIFFUSE_COLOUR_POWER_SCALED_ARRAY:
+            _writeRawConstants(ac.physicalIndex, source->getLightDiffuseColourPowerScaledArray(ac.data),
+                               ac.data);
+            break;
 
-                case ACT_LIGHT_POSITION_ARRAY:
-                    // Get as 4D vector, works for directional lights too
-                    for (size_t l = 0; l < ac.data; ++l)
-                        _writeRawConstant(ac.physicalIndex + l*sizeof(Vector4f),
-                                          source->getLightAs4DVector(l), ac.elementCount);
-                    break;
+        case ACT_LIGHT_SPECULAR_COLOUR_POWER_SCALED_ARRAY:
+            for (size_t l = 0; l < ac.data; ++l)
+                _writeRawConstant(ac.physicalIndex + l*sizeof(ColourValue),
+                                  source->getLightSpecularColourWithPower(l), ac.elementCount);
+            break;
 
-                case ACT_LIGHT_DIRECTION_ARRAY:
-                    for (size_t l = 0; l < ac.data; ++l)
-                    {
-                        vec3 = source->getLightDirection(l);
-                        // Set as 4D vector for compatibility
-                        _writeRawConstant(ac.physicalIndex + l*sizeof(Vector4f),
-                                          Vector4f(vec3.x, vec3.y, vec3.z, 0.0f), ac.elementCount);
-                    }
-                    break;
+        case ACT_LIGHT_POSITION_ARRAY:
+            // Get as 4D vector, works for directional lights too
+            for (size_t l = 0; l < ac.data; ++l)
+                _writeRawConstant(ac.physicalIndex + l*sizeof(Vector4f),
+                                  source->getLightAs4DVector(l), ac.elementCount);
+            break;
 
-                case ACT_LIGHT_POSITION_VIEW_SPACE_ARRAY:
-                    _writeRawConstants(ac.physicalIndex, source->getLightPositionViewSpaceArray(ac.data), ac.data);
-                    break;
+        case ACT_LIGHT_DIRECTION_ARRAY:
+            for (size_t l = 0; l < ac.data; ++l)
+            {
+                vec3 = source->getLightDirection(l);
+                // Set as 4D vector for compatibility
+                _writeRawConstant(ac.physicalIndex + l*sizeof(Vector4f),
+                                  Vector4f(vec3.x, vec3.y, vec3.z, 0.0f), ac.elementCount);
+            }
+            break;
 
-                case ACT_LIGHT_DIRECTION_VIEW_SPACE_ARRAY:
-                    _writeRawConstants(ac.physicalIndex, source->getLightDirectionViewSpaceArray(ac.data), ac.data);
-                    break;
+        case ACT_LIGHT_POSITION_VIEW_SPACE_ARRAY:
+            _writeRawConstants(ac.physicalIndex, source->getLightPositionViewSpaceArray(ac.data), ac.data);
+            break;
 
-                case ACT_LIGHT_POWER_SCALE_ARRAY:
-                    for (size_t l = 0; l < ac.data; ++l)
-                        _writeRawConstant(ac.physicalIndex + l*sizeof(Real),
-                                          source->getLightPowerScale(l));
-                    break;
+        case ACT_LIGHT_DIRECTION_VIEW_SPACE_ARRAY:
+            _writeRawConstants(ac.physicalIndex, source->getLightDirectionViewSpaceArray(ac.data), ac.data);
+            break;
 
-                case ACT_LIGHT_ATTENUATION_ARRAY:
-                    _writeRawConstants(ac.physicalIndex, source->getLightAttenuationArray(ac.data), ac.data);
-                    break;
-                case ACT_SPOTLIGHT_PARAMS_ARRAY:
-                    _writeRawConstants(ac.physicalIndex, source->getSpotlightParamsArray(ac.data), ac.data);
-                    break;
-                case ACT_DERIVED_LIGHT_DIFFUSE_COLOUR:
-                    _writeRawConstant(ac.physicalIndex,
-                                      source->getLightDiffuseColourWithPower(ac.data) * source->getSurfaceDiffuseColour(),
-                                      ac.elementCount);
-                    break;
-                case ACT_DERIVED_LIGHT_SPECULAR_COLOUR:
-                    _writeRawConstant(ac.physicalIndex,
-                                      source->getLightSpecularColourWithPower(ac.data) * source->getSurfaceSpecularColour(),
-                                      ac.elementCount);
-                    break;
-                case ACT_DERIVED_LIGHT_DIFFUSE_COLOUR_ARRAY:
-                    for (size_t l = 0; l < ac.data; ++l)
-                    {
-                        _writeRawConstant(ac.physicalIndex + l*sizeof(ColourValue),
-                                          source->getLightDiffuseColourWithPower(l) * source->getSurfaceDiffuseColour(),
-                                          ac.elementCount);
-                    }
-                    break;
-                case ACT_DERIVED_LIGHT_SPECULAR_COLOUR_ARRAY:
-                    for (size_t l = 0; l < ac.data; ++l)
-                    {
-                        _writeRawConstant(ac.physicalIndex + l*sizeof(ColourValue),
-                                          source->getLightSpecularColourWithPower(l) * source->getSurfaceSpecularColour(),
-                                          ac.elementCount);
-                    }
-                    break;
-                case ACT_TEXTURE_VIEWPROJ_MATRIX:
-                    // can also be updated in lights
-                    _writeRawConstant(ac.physicalIndex, source->getTextureViewProjMatrix(ac.data),ac.elementCount);
-                    break;
-                case ACT_TEXTURE_VIEWPROJ_MATRIX_ARRAY:
-                    for (size_t l = 0; l < ac.data; ++l)
-                    {
-                        // can also be updated in lights
-                        _writeRawConstant(ac.physicalIndex + l*sizeof(Matrix4),
-                                          source->getTextureViewProjMatrix(l),ac.elementCount);
-                    }
-                    break;
-                case ACT_SPOTLIGHT_VIEWPROJ_MATRIX:
-                    _writeRawConstant(ac.physicalIndex, source->getSpotlightViewProjMatrix(ac.data),ac.elementCount);
-                    break;
-                case ACT_SPOTLIGHT_VIEWPROJ_MATRIX_ARRAY:
-                    for (size_t l = 0; l < ac.data; ++l)
-                    {
-                        // can also be updated in lights
-                        _writeRawConstant(ac.physicalIndex + l*sizeof(Matrix4),
-                                          source->getSpotlightViewProjMatrix(l),ac.elementCount);
-                    }
-                    break;
+        case ACT_LIGHT_POWER_SCALE_ARRAY:
+            for (size_t l = 0; l < ac.data; ++l)
+                _writeRawConstant(ac.physicalIndex + l*sizeof(Real),
+                                  source->getLightPowerScale(l));
+            break;
 
-                default:
-                    break;
-                };
+        case ACT_LIGHT_ATTENUATION_ARRAY:
+            _writeRawConstants(ac.physicalIndex, source->getLightAttenuationArray(ac.data), ac.data);
+            break;
+        case ACT_SPOTLIGHT_PARAMS_ARRAY:
+            _writeRawConstants(ac.physicalIndex, source->getSpotlightParamsArray(ac.data), ac.data);
+            break;
+        case ACT_DERIVED_LIGHT_DIFFUSE_COLOUR:
+            _writeRawConstant(ac.physicalIndex,
+                              source->getLightDiffuseColourWithPower(ac.data) * source->getSurfaceDiffuseColour(),
+                              ac.elementCount);
+            break;
+        case ACT_DERIVED_LIGHT_SPECULAR_COLOUR:
+            _writeRawConstant(ac.physicalIndex,
+                              source->getLightSpecularColourWithPower(ac.data) * source->getSurfaceSpecularColour(),
+                              ac.elementCount);
+            break;
+        case ACT_DERIVED_LIGHT_DIFFUSE_COLOUR_ARRAY:
+            for (size_t l = 0; l < ac.data; ++l)
+            {
+                _writeRawConstant(ac.physicalIndex + l*sizeof(ColourValue),
+                                  source->getLightDiffuseColourWithPower(l) * source->getSurfaceDiffuseColour(),
+                                  ac.elementCount);
             }
-        }
+            break;
+        case ACT_DERIVED_LIGHT_SPECULAR_COLOUR_ARRAY:
+            for (size_t l = 0; l < ac.data; ++l)
+            {
+                _writeRawConstant(ac.physicalIndex + l*sizeof(ColourValue),
+                                  source->getLightSpecularColourWithPower(l) * source->getSurfaceSpecularColour(),
+                                  ac.elementCount);
+            }
+            break;
+        case ACT_TEXTURE_VIEWPROJ_MATRIX:
+            // can also be updated in lights
+            _writeRawConstant(ac.physicalIndex, source->getTextureViewProjMatrix(ac.data),ac.elementCount);
+            break;
+        case ACT_TEXTURE_VIEWPROJ_MATRIX_ARRAY:
+            for (size_t l = 0; l < ac.data; ++l)
+            {
+                // can also be updated in lights
+                _writeRawConstant(ac.physicalIndex + l*sizeof(Matrix4),
+                                  source->getTextureViewProjMatrix(l),ac.elementCount);
+            }
+            break;
+        case ACT_SPOTLIGHT_VIEWPROJ_MATRIX:
+            _writeRawConstant(ac.physicalIndex, source->getSpotlightViewProjMatrix(ac.data),ac.elementCount);
+            break;
+        case ACT_SPOTLIGHT_VIEWPROJ_MATRIX_ARRAY:
+            for (size_t l = 0; l < ac.data; ++l)
+            {
+                // can also be updated in lights
+                _writeRawConstant(ac.physicalIndex + l*sizeof(Matrix4),
+                                  source->getSpotlightViewProjMatrix(l),ac.elementCount);
+            }
+            break;
 
+        default:
+            break;
+        }
     }
     //---------------------------------------------------------------------------
-    static size_t withArrayOffset(const GpuConstantDefinition* def, const String& name)
+    static size_t withArrayOffset(const GpuConstantDefinition* def, const String& name, uint32* arrayIndex = NULL)
     {
         uint32 offset = 0;
         if(name.back() == ']')
@@ -2108,161 +2298,232 @@ namespace Ogre
             size_t start = name.find('[');
             offset = StringConverter::parseInt(name.substr(start + 1, name.size() - start - 2));
             offset = std::min(offset, def->arraySize - 1);
+            if (arrayIndex)
+                *arrayIndex = offset;
             size_t type_sz = def->isDouble() ? 8 : ( def->isSampler() ? 1 : 4);
             offset *= type_sz;
         }
 
         return def->physicalIndex + offset * def->elementSize;
     }
+    //---------------------------------------------------------------------------
+    /// name of the constant a handle refers to, only searched for error messages
+    static String getConstantName(const GpuNamedConstants* namedConstants, const GpuConstantHandle& handle)
+    {
+        if (namedConstants)
+        {
+            for (const auto& c : namedConstants->map)
+            {
+                const GpuConstantDefinition& def = c.second;
+                size_t type_sz = def.isDouble() ? 8 : (def.isSampler() ? 1 : 4);
+                if (def.isSampler() == GpuConstantDefinition::isSampler(handle.constType) &&
+                    handle.physicalIndex >= def.physicalIndex &&
+                    handle.physicalIndex < def.physicalIndex + def.arraySize * def.elementSize * type_sz)
+                    return c.first;
+            }
+        }
+        return "<unknown>";
+    }
 
-    void GpuProgramParameters::setNamedConstant(const String& name, float val)
+    GpuConstantHandle GpuProgramParameters::getNamedConstantHandle(const String& name) const
     {
+        GpuConstantHandle handle;
         // look up, and throw an exception if we're not ignoring missing
-        const GpuConstantDefinition* def =
-            _findNamedConstantDefinition(name, !mIgnoreMissingParams);
+        const GpuConstantDefinition* def = _findNamedConstantDefinition(name, !mIgnoreMissingParams);
         if (!def)
-            return;
-        OgreAssert(def->isFloat(), "Constant type mismatch");
-        _writeRawConstant(withArrayOffset(def, name), val);
+            return handle;
+
+        uint32 arrayIndex = 0;
+        handle.physicalIndex = withArrayOffset(def, name, &arrayIndex);
+        handle.size = (def->arraySize - arrayIndex) * def->elementSize;
+        handle.elementSize = def->elementSize;
+        handle.constType = def->constType;
+        return handle;
+    }
+    //---------------------------------------------------------------------------
+    void GpuProgramParameters::setNamedConstant(const String& name, float val)
+    {
+        setNamedConstant(getNamedConstantHandle(name), val);
     }
     //---------------------------------------------------------------------------
     void GpuProgramParameters::setNamedConstant(const String& name, int val)
     {
-        // look up, and throw an exception if we're not ignoring missing
-        const GpuConstantDefinition* def = _findNamedConstantDefinition(name, !mIgnoreMissingParams);
-
-        if(!def)
-            return;
-
-        if(def->isSampler())
-        {
-            _writeRegisters(withArrayOffset(def, name), &val, 1);
-            return;
-        }
-
-        OgreAssert(def->isInt(), "Constant type mismatch");
-        _writeRawConstant(withArrayOffset(def, name), val);
+        setNamedConstant(getNamedConstantHandle(name), val);
     }
     //---------------------------------------------------------------------------
     void GpuProgramParameters::setNamedConstant(const String& name, uint val)
     {
-        // look up, and throw an exception if we're not ignoring missing
-        const GpuConstantDefinition* def =
-            _findNamedConstantDefinition(name, !mIgnoreMissingParams);
-        if (!def)
-            return;
-
-        OgreAssert(def->isUnsignedInt(), "Constant type mismatch");
-        _writeRawConstant(withArrayOffset(def, name), val);
+        setNamedConstant(getNamedConstantHandle(name), val);
     }
     //---------------------------------------------------------------------------
     void GpuProgramParameters::setNamedConstant(const String& name, const Vector4& vec)
     {
-        // look up, and throw an exception if we're not ignoring missing
-        const GpuConstantDefinition* def =
-            _findNamedConstantDefinition(name, !mIgnoreMissingParams);
-        if (def)
-            _writeRawConstant(withArrayOffset(def, name), vec, def->elementSize);
+        setNamedConstant(getNamedConstantHandle(name), vec);
     }
     //---------------------------------------------------------------------------
     void GpuProgramParameters::setNamedConstant(const String& name, const Vector3& vec)
     {
-        // look up, and throw an exception if we're not ignoring missing
-        const GpuConstantDefinition* def =
-            _findNamedConstantDefinition(name, !mIgnoreMissingParams);
-        if (def)
-            _writeRawConstant(withArrayOffset(def, name), vec);
+        setNamedConstant(getNamedConstantHandle(name), vec);
     }
     //---------------------------------------------------------------------------
     void GpuProgramParameters::setNamedConstant(const String& name, const Vector2& vec)
     {
-        // look up, and throw an exception if we're not ignoring missing
-        const GpuConstantDefinition* def =
-            _findNamedConstantDefinition(name, !mIgnoreMissingParams);
-        if (def)
-            _writeRawConstant(withArrayOffset(def, name), vec);
+        setNamedConstant(getNamedConstantHandle(name), vec);
     }
     //---------------------------------------------------------------------------
     void GpuProgramParameters::setNamedConstant(const String& name, const Matrix4& m)
     {
-        // look up, and throw an exception if we're not ignoring missing
-        const GpuConstantDefinition* def =
-            _findNamedConstantDefinition(name, !mIgnoreMissingParams);
-        if (def)
-            _writeRawConstant(withArrayOffset(def, name), m, def->elementSize);
+        setNamedConstant(getNamedConstantHandle(name), m);
     }
     //---------------------------------------------------------------------------
     void GpuProgramParameters::setNamedConstant(const String& name, const Matrix4* m,
                                                 size_t numEntries)
     {
-        // look up, and throw an exception if we're not ignoring missing
-        const GpuConstantDefinition* def =
-            _findNamedConstantDefinition(name, !mIgnoreMissingParams);
-        if (def)
-            _writeRawConstant(withArrayOffset(def, name), m, numEntries);
+        setNamedConstant(getNamedConstantHandle(name), m, numEntries);
     }
     //---------------------------------------------------------------------------
     void GpuProgramParameters::setNamedConstant(const String& name, const ColourValue& colour)
     {
-        // look up, and throw an exception if we're not ignoring missing
-        const GpuConstantDefinition* def =
-            _findNamedConstantDefinition(name, !mIgnoreMissingParams);
-        if (def)
-            _writeRawConstant(withArrayOffset(def, name), colour, def->elementSize);
+        setNamedConstant(getNamedConstantHandle(name), colour);
     }
     //---------------------------------------------------------------------------
-    template <typename T> void GpuProgramParameters::_setNamedConstant(const String& name, const T* val, size_t count)
+    void GpuProgramParameters::setNamedConstant(const String& name, const float* val, size_t count, size_t multiple)
     {
-        // look up, and throw an exception if we're not ignoring missing
-        const GpuConstantDefinition* def = _findNamedConstantDefinition(name, !mIgnoreMissingParams);
+        setNamedConstant(getNamedConstantHandle(name), val, count, multiple);
+    }
+    //---------------------------------------------------------------------------
+    void GpuProgramParameters::setNamedConstant(const String& name, const double* val, size_t count, size_t multiple)
+    {
+        setNamedConstant(getNamedConstantHandle(name), val, count, multiple);
+    }
+    //---------------------------------------------------------------------------
+    void GpuProgramParameters::setNamedConstant(const String& name,
+                                                const int *val, size_t count, size_t multiple)
+    {
+        setNamedConstant(getNamedConstantHandle(name), val, count, multiple);
+    }
+    //---------------------------------------------------------------------------
+    void GpuProgramParameters::setNamedConstant(const String& name, const uint* val, size_t count, size_t multiple)
+    {
+        setNamedConstant(getNamedConstantHandle(name), val, count, multiple);
+    }
+    //---------------------------------------------------------------------------
+    void GpuProgramParameters::setNamedConstant(const GpuConstantHandle& handle, float val)
+    {
+        if (!handle.isValid())
+            return;
+        OgreAssert(GpuConstantDefinition::isFloat(handle.constType), "Constant type mismatch");
+        _writeRawConstant(handle.physicalIndex, val);
+    }
+    //---------------------------------------------------------------------------
+    void GpuProgramParameters::setNamedConstant(const GpuConstantHandle& handle, int val)
+    {
+        if (!handle.isValid())
+            return;
 
-        if (!def)
+        if (GpuConstantDefinition::isSampler(handle.constType))
+        {
+            _writeRegisters(handle.physicalIndex, &val, 1);
             return;
+        }
 
-        if (count > def->arraySize * def->elementSize)
+        OgreAssert(GpuConstantDefinition::isInt(handle.constType), "Constant type mismatch");
+        _writeRawConstant(handle.physicalIndex, val);
+    }
+    //---------------------------------------------------------------------------
+    void GpuProgramParameters::setNamedConstant(const GpuConstantHandle& handle, uint val)
+    {
+        if (!handle.isValid())
+            return;
+        OgreAssert(GpuConstantDefinition::isUnsignedInt(handle.constType), "Constant type mismatch");
+        _writeRawConstant(handle.physicalIndex, val);
+    }
+    //---------------------------------------------------------------------------
+    void GpuProgramParameters::setNamedConstant(const GpuConstantHandle& handle, const Vector4& vec)
+    {
+        if (handle.isValid())
+            _writeRawConstant(handle.physicalIndex, vec, handle.elementSize);
+    }
+    //---------------------------------------------------------------------------
+    void GpuProgramParameters::setNamedConstant(const GpuConstantHandle& handle, const Vector3& vec)
+    {
+        if (handle.isValid())
+            _writeRawConstant(handle.physicalIndex, vec);
+    }
+    //---------------------------------------------------------------------------
+    void GpuProgramParameters::setNamedConstant(const GpuConstantHandle& handle, const Vector2& vec)
+    {
+        if (handle.isValid())
+            _writeRawConstant(handle.physicalIndex, vec);
+    }
+    //---------------------------------------------------------------------------
+    void GpuProgramParameters::setNamedConstant(const GpuConstantHandle& handle, const Matrix4& m)
+    {
+        if (handle.isValid())
+            _writeRawConstant(handle.physicalIndex, m, handle.elementSize);
+    }
+    //---------------------------------------------------------------------------
+    void GpuProgramParameters::setNamedConstant(const GpuConstantHandle& handle, const Matrix4* m,
+                                                size_t numEntries)
+    {
+        if (handle.isValid())
+            _writeRawConstant(handle.physicalIndex, m, numEntries);
+    }
+    //---------------------------------------------------------------------------
+    void GpuProgramParameters::setNamedConstant(const GpuConstantHandle& handle, const ColourValue& colour)
+    {
+        if (handle.isValid())
+            _writeRawConstant(handle.physicalIndex, colour, handle.elementSize);
+    }
+    //---------------------------------------------------------------------------
+    template <typename T> void GpuProgramParameters::_setNamedConstant(const GpuConstantHandle& handle, const T* val, size_t count)
+    {
+        if (!handle.isValid())
+            return;
+
+        if (count > handle.size)
         {
             // The shader compiler may trim the array if the trailing elements
             // are unused or their usage can be optimized away. Therefore,
             // a count exceeding the array size not not an error.
-            count = def->arraySize * def->elementSize;
+            count = handle.size;
         }
 
-        _writeRawConstants(withArrayOffset(def, name), val, count);
+        _writeRawConstants(handle.physicalIndex, val, count);
     }
-    void GpuProgramParameters::setNamedConstant(const String& name, const float* val, size_t count, size_t multiple)
+    //---------------------------------------------------------------------------
+    void GpuProgramParameters::setNamedConstant(const GpuConstantHandle& handle, const float* val, size_t count, size_t multiple)
     {
-        _setNamedConstant(name, val, count * multiple);
+        _setNamedConstant(handle, val, count * multiple);
     }
     //---------------------------------------------------------------------------
-    void GpuProgramParameters::setNamedConstant(const String& name, const double* val, size_t count, size_t multiple)
+    void GpuProgramParameters::setNamedConstant(const GpuConstantHandle& handle, const double* val, size_t count, size_t multiple)
     {
-        _setNamedConstant(name, val, count * multiple);
+        _setNamedConstant(handle, val, count * multiple);
     }
     //---------------------------------------------------------------------------
-    void GpuProgramParameters::setNamedConstant(const String& name,
+    void GpuProgramParameters::setNamedConstant(const GpuConstantHandle& handle,
                                                 const int *val, size_t count, size_t multiple)
     {
-        size_t rawCount = count * multiple;
-        // look up, and throw an exception if we're not ignoring missing
-        const GpuConstantDefinition* def = _findNamedConstantDefinition(name, !mIgnoreMissingParams);
-
-        if(!def)
+        if (!handle.isValid())
             return;
 
-        if (rawCount > def->arraySize * def->elementSize)
+        size_t rawCount = count * multiple;
+        if (rawCount > handle.size)
             OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
-                        StringUtil::format("Too many values for parameter %s: %zu > %d", name.c_str(), count,
-                                           def->arraySize * def->elementSize));
+                        StringUtil::format("Too many values for parameter %s: %zu > %d",
+                                           getConstantName(mNamedConstants.get(), handle).c_str(), rawCount,
+                                           handle.size));
 
-        if (def->isSampler())
-            _writeRegisters(withArrayOffset(def, name), val, rawCount);
+        if (GpuConstantDefinition::isSampler(handle.constType))
+            _writeRegisters(handle.physicalIndex, val, rawCount);
         else
-            _writeRawConstants(withArrayOffset(def, name), val, rawCount);
+            _writeRawConstants(handle.physicalIndex, val, rawCount);
     }
     //---------------------------------------------------------------------------
-    void GpuProgramParameters::setNamedConstant(const String& name, const uint* val, size_t count, size_t multiple)
+    void GpuProgramParameters::setNamedConstant(const GpuConstantHandle& handle, const uint* val, size_t count, size_t multiple)
     {
-        _setNamedConstant(name, val, count * multiple);
+        _setNamedConstant(handle, val, count * multiple);
     }
     //---------------------------------------------------------------------------
     void GpuProgramParameters::setNamedAutoConstant(const String& name,
@@ -2302,6 +2563,8 @@ namespace Ogre
     {
         if (index < mAutoConstants.size())
         {
+            // the caller may modify the entry, so the cached operations must be rebuilt
+            mAutoConstantOpsDirty = true;
             return &(mAutoConstants[index]);
         }
         else
@@ -2359,6 +2622,7 @@ namespace Ogre
         mConstants = source.getConstantList();
         mRegisters = source.mRegisters;
         mAutoConstants = source.getAutoConstantList();
+        mAutoConstantOpsDirty = true;
         mCombinedVariability = source.mCombinedVariability;
         mUseLinearColours = source.mUseLinearColours;
         copySharedParamSetUsage(source.mSharedParamSets);
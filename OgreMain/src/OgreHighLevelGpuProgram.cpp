@@ -260,6 +260,8 @@ namespace Ogre
         if (!mConstantDefsBuilt)
         {
             buildConstantDefinitions();
+            // index once here, as the definitions are shared by all parameters of this program
+            mConstantDefs->generateHashIndex();
             mConstantDefsBuilt = true;
         }
         return *mConstantDefs.get();
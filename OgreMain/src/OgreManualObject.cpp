@@ -27,6 +27,7 @@ THE SOFTWARE.
 */
 #include "OgreStableHeaders.h"
 #include "OgreEdgeListBuilder.h"
+#include "OgreTriangleTree.h"
 
 namespace Ogre {
 
@@ -311,6 +312,7 @@ ManualObject::ManualObject(const String& name)
     ManualObject::ManualObjectSection* ManualObject::end(void)
     {
         OgreAssert(mCurrentSection, "You cannot call end() until after you call begin()");
+        mCurrentSection->_invalidateTriangleTree();
         if (mTempVertexPending)
         {
             // bake current vertex
@@ -521,6 +523,29 @@ ManualObject::ManualObject(const String& name)
 
     }
     //-----------------------------------------------------------------------------
+    RayTestResult ManualObject::raycast(const Ray& ray, size_t* section, size_t* triangle)
+    {
+        Affine3 invTransform = _getParentNodeFullTransform().inverse();
+        // the direction is not normalised, so distances remain in world units
+        Ray localRay(invTransform * ray.getOrigin(), invTransform.linear() * ray.getDirection());
+
+        RayTestResult result(false, 0);
+        for (size_t i = 0; i < mSectionList.size(); ++i)
+        {
+            size_t tri;
+            RayTestResult hit = mSectionList[i]->_getTriangleTree().intersects(localRay, &tri);
+            if (hit.first && (!result.first || hit.second < result.second))
+            {
+                result = hit;
+                if (section)
+                    *section = i;
+                if (triangle)
+                    *triangle = tri;
+            }
+        }
+        return result;
+    }
+    //-----------------------------------------------------------------------------
     EdgeData* ManualObject::getEdgeList(void)
     {
         // Build on demand
@@ -716,6 +741,23 @@ ManualObject::ManualObject(const String& name)
         }
     }
     //-----------------------------------------------------------------------------
+    const TriangleTree& ManualObject::ManualObjectSection::_getTriangleTree()
+    {
+        if (!mTriangleTree)
+        {
+            mTriangleTree.reset(new TriangleTree());
+            mTriangleTree->build(mRenderOperation.vertexData,
+                                 mRenderOperation.useIndexes ? mRenderOperation.indexData : NULL,
+                                 mRenderOperation.operationType);
+        }
+        return *mTriangleTree;
+    }
+    //-----------------------------------------------------------------------------
+    void ManualObject::ManualObjectSection::_invalidateTriangleTree()
+    {
+        mTriangleTree.reset();
+    }
+    //-----------------------------------------------------------------------------
     //-----------------------------------------------------------------------------
     const String MOT_MANUAL_OBJECT = "ManualObject";
     //-----------------------------------------------------------------------------
@@ -207,8 +207,9 @@ namespace Ogre {
             ResourceGroupManager::getSingleton().openResource(
                 mName, mGroup, this);
 
-        // fully prebuffer into host RAM
-        mFreshFromDisk = DataStreamPtr(OGRE_NEW MemoryDataStream(mName,mFreshFromDisk));
+        // fully prebuffer into host RAM, unless the archive already did
+        if (!dynamic_cast<MemoryDataStream*>(mFreshFromDisk.get()))
+            mFreshFromDisk = DataStreamPtr(OGRE_NEW MemoryDataStream(mName,mFreshFromDisk));
     }
     //-----------------------------------------------------------------------
     void Mesh::unprepareImpl()
@@ -1789,19 +1790,19 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
-    void Mesh::softwareVertexBlend(const VertexData* sourceVertexData,
-        const VertexData* targetVertexData,
-        const Affine3* const* blendMatrices, size_t numMatrices,
-        bool blendNormals)
+    /// Locks the buffers of a software vertex blend using lockBuffer(buf, options)
+    template <typename LockFunc>
+    static SoftwareVertexBlendBatch::Blend prepareVertexBlend(const VertexData* sourceVertexData,
+                                                              const VertexData* targetVertexData,
+                                                              bool blendNormals, LockFunc lockBuffer)
     {
+        SoftwareVertexBlendBatch::Blend blend = {};
         float *pSrcPos = 0;
         float *pSrcNorm = 0;
         float *pDestPos = 0;
         float *pDestNorm = 0;
         float *pBlendWeight = 0;
         unsigned char* pBlendIdx = 0;
-        size_t srcNormStride = 0;
-        size_t destNormStride = 0;
 
         // Get elements for source
         auto srcElemPos = sourceVertexData->vertexDeclaration->findElementBySemantic(VES_POSITION);
@@ -1818,82 +1819,111 @@ namespace Ogre {
         HardwareVertexBufferSharedPtr srcPosBuf = sourceVertexData->vertexBufferBinding->getBuffer(srcElemPos->getSource());
         HardwareVertexBufferSharedPtr srcIdxBuf = sourceVertexData->vertexBufferBinding->getBuffer(srcElemBlendIndices->getSource());
         HardwareVertexBufferSharedPtr srcWeightBuf = sourceVertexData->vertexBufferBinding->getBuffer(srcElemBlendWeights->getSource());
-        HardwareVertexBufferSharedPtr srcNormBuf;
 
         // Get buffers for target
         HardwareVertexBufferSharedPtr destPosBuf = targetVertexData->vertexBufferBinding->getBuffer(destElemPos->getSource());
 
         // Lock source buffers for reading
-        HardwareBufferLockGuard srcPosLock(srcPosBuf, HardwareBuffer::HBL_READ_ONLY);
-        srcElemPos->baseVertexPointerToElement(srcPosLock.pData, &pSrcPos);
+        srcElemPos->baseVertexPointerToElement(lockBuffer(srcPosBuf.get(), HardwareBuffer::HBL_READ_ONLY), &pSrcPos);
 
         // Do we have normals and want to blend them?
         bool includeNormals = blendNormals && srcElemNorm && destElemNorm;
         HardwareVertexBufferSharedPtr destNormBuf;
-        HardwareBufferLockGuard srcNormLock;
         if (includeNormals)
         {
             // Get buffers for source
-            srcNormBuf = sourceVertexData->vertexBufferBinding->getBuffer(srcElemNorm->getSource());
-            srcNormStride = srcNormBuf->getVertexSize();
+            HardwareVertexBufferSharedPtr srcNormBuf = sourceVertexData->vertexBufferBinding->getBuffer(srcElemNorm->getSource());
+            blend.srcNormStride = srcNormBuf->getVertexSize();
             // Get buffers for target
             destNormBuf = targetVertexData->vertexBufferBinding->getBuffer(destElemNorm->getSource());
-            destNormStride = destNormBuf->getVertexSize();
+            blend.destNormStride = destNormBuf->getVertexSize();
 
-            if (srcNormBuf != srcPosBuf)
-            {
-                // Different buffer
-                srcNormLock.lock(srcNormBuf, HardwareBuffer::HBL_READ_ONLY);
-            }
-            srcElemNorm->baseVertexPointerToElement(srcNormLock.pData ? srcNormLock.pData : srcPosLock.pData, &pSrcNorm);
+            srcElemNorm->baseVertexPointerToElement(lockBuffer(srcNormBuf.get(), HardwareBuffer::HBL_READ_ONLY), &pSrcNorm);
         }
 
         // Indices must be 4 bytes
         assert(srcElemBlendIndices->getType() == VET_UBYTE4 && "Blend indices must be VET_UBYTE4");
-        HardwareBufferLockGuard srcIdxLock(srcIdxBuf, HardwareBuffer::HBL_READ_ONLY);
-        srcElemBlendIndices->baseVertexPointerToElement(srcIdxLock.pData, &pBlendIdx);
-        HardwareBufferLockGuard srcWeightLock;
-        if (srcWeightBuf != srcIdxBuf)
-        {
-            // Lock buffer
-            srcWeightLock.lock(srcWeightBuf, HardwareBuffer::HBL_READ_ONLY);
-        }
-        srcElemBlendWeights->baseVertexPointerToElement(srcWeightLock.pData ? srcWeightLock.pData : srcIdxLock.pData, &pBlendWeight);
-        unsigned short numWeightsPerVertex = VertexElement::getTypeCount(srcElemBlendWeights->getType());
+        srcElemBlendIndices->baseVertexPointerToElement(lockBuffer(srcIdxBuf.get(), HardwareBuffer::HBL_READ_ONLY), &pBlendIdx);
+        srcElemBlendWeights->baseVertexPointerToElement(lockBuffer(srcWeightBuf.get(), HardwareBuffer::HBL_READ_ONLY), &pBlendWeight);
 
         // Lock destination buffers for writing
-        HardwareBufferLockGuard destPosLock(destPosBuf,
+        void* destPosData = lockBuffer(destPosBuf.get(),
             (destNormBuf != destPosBuf && destPosBuf->getVertexSize() == destElemPos->getSize()) ||
             (destNormBuf == destPosBuf && destPosBuf->getVertexSize() == destElemPos->getSize() + destElemNorm->getSize()) ?
             HardwareBuffer::HBL_DISCARD : HardwareBuffer::HBL_NORMAL);
-        destElemPos->baseVertexPointerToElement(destPosLock.pData, &pDestPos);
-        HardwareBufferLockGuard destNormLock;
+        destElemPos->baseVertexPointerToElement(destPosData, &pDestPos);
         if (includeNormals)
         {
+            void* destNormData = destPosData;
             if (destNormBuf != destPosBuf)
             {
-                destNormLock.lock(destNormBuf, destNormBuf->getVertexSize() == destElemNorm->getSize()
-                                                   ? HardwareBuffer::HBL_DISCARD
-                                                   : HardwareBuffer::HBL_NORMAL);
+                destNormData = lockBuffer(destNormBuf.get(), destNormBuf->getVertexSize() == destElemNorm->getSize()
+                                                                 ? HardwareBuffer::HBL_DISCARD
+                                                                 : HardwareBuffer::HBL_NORMAL);
             }
-            destElemNorm->baseVertexPointerToElement(destNormLock.pData ? destNormLock.pData : destPosLock.pData, &pDestNorm);
-        }
-
-        auto srcPosStride = srcPosBuf->getVertexSize();
-        auto destPosStride = destPosBuf->getVertexSize();
-        auto blendIdxStride = srcIdxBuf->getVertexSize();
-        auto blendWeightStride = srcWeightBuf->getVertexSize();
-
+            destElemNorm->baseVertexPointerToElement(destNormData, &pDestNorm);
+        }
+
+        blend.srcPos = pSrcPos;
+        blend.destPos = pDestPos;
+        blend.srcNorm = pSrcNorm;
+        blend.destNorm = pDestNorm;
+        blend.blendWeight = pBlendWeight;
+        blend.blendIndex = pBlendIdx;
+        blend.srcPosStride = srcPosBuf->getVertexSize();
+        blend.destPosStride = destPosBuf->getVertexSize();
+        blend.blendIndexStride = srcIdxBuf->getVertexSize();
+        blend.blendWeightStride = srcWeightBuf->getVertexSize();
+        blend.numWeightsPerVertex = VertexElement::getTypeCount(srcElemBlendWeights->getType());
+        blend.numVertices = targetVertexData->vertexCount;
+        return blend;
+    }
+    //---------------------------------------------------------------------
+    template <typename T> static T* vertexPointer(T* p, size_t stride, size_t index)
+    {
+        typedef typename std::conditional<std::is_const<T>::value, const char, char>::type Byte;
+        return p ? reinterpret_cast<T*>(reinterpret_cast<Byte*>(p) + index * stride) : p;
+    }
+    /// Blends the vertices [first, first + count) of the blend
+    static void softwareVertexSkinning(const SoftwareVertexBlendBatch::Blend& blend,
+                                       const Affine3* const* blendMatrices, size_t first, size_t count)
+    {
         OptimisedUtil::getImplementation()->softwareVertexSkinning(
-            pSrcPos, pDestPos,
-            pSrcNorm, pDestNorm,
-            pBlendWeight, pBlendIdx,
+            vertexPointer(blend.srcPos, blend.srcPosStride, first),
+            vertexPointer(blend.destPos, blend.destPosStride, first),
+            vertexPointer(blend.srcNorm, blend.srcNormStride, first),
+            vertexPointer(blend.destNorm, blend.destNormStride, first),
+            vertexPointer(blend.blendWeight, blend.blendWeightStride, first),
+            vertexPointer(blend.blendIndex, blend.blendIndexStride, first),
             blendMatrices,
-            srcPosStride, destPosStride,
-            srcNormStride, destNormStride,
-            blendWeightStride, blendIdxStride,
-            numWeightsPerVertex,
-            targetVertexData->vertexCount);
+            blend.srcPosStride, blend.destPosStride,
+            blend.srcNormStride, blend.destNormStride,
+            blend.blendWeightStride, blend.blendIndexStride,
+            blend.numWeightsPerVertex,
+            count);
+    }
+    //---------------------------------------------------------------------
+    void Mesh::softwareVertexBlend(const VertexData* sourceVertexData,
+        const VertexData* targetVertexData,
+        const Affine3* const* blendMatrices, size_t numMatrices,
+        bool blendNormals)
+    {
+        // positions, normals, indices and weights of source and target, each locked once
+        HardwareBufferLockGuard locks[6];
+        size_t numLocks = 0;
+        auto lockBuffer = [&](HardwareBuffer* buf, HardwareBuffer::LockOptions options)
+        {
+            for (size_t i = 0; i < numLocks; ++i)
+            {
+                if (locks[i].pBuf == buf)
+                    return locks[i].pData;
+            }
+            locks[numLocks].lock(buf, options);
+            return locks[numLocks++].pData;
+        };
+
+        auto blend = prepareVertexBlend(sourceVertexData, targetVertexData, blendNormals, lockBuffer);
+        softwareVertexSkinning(blend, blendMatrices, 0, blend.numVertices);
     }
     //---------------------------------------------------------------------
     void Mesh::softwareVertexMorph(float t,
@@ -2368,5 +2398,73 @@ namespace Ogre {
             if (s->vertexData)
                 s->vertexData->convertVertexElement(semantic, dstType);
     }
-}
 
+    //---------------------------------------------------------------------
+    SoftwareVertexBlendBatch::SoftwareVertexBlendBatch() : mVerticesPerTask(4096) {}
+    //---------------------------------------------------------------------
+    SoftwareVertexBlendBatch::~SoftwareVertexBlendBatch() { run(); }
+    //---------------------------------------------------------------------
+    void SoftwareVertexBlendBatch::add(const VertexData* sourceVertexData,
+                                       const VertexData* targetVertexData,
+                                       const Affine3* const* blendMatrices, size_t numMatrices,
+                                       bool blendNormals)
+    {
+        auto lockBuffer = [this](HardwareBuffer* buf, HardwareBuffer::LockOptions options)
+        {
+            auto it = mLockedBuffers.find(buf);
+            if (it == mLockedBuffers.end())
+                it = mLockedBuffers.emplace(buf, buf->lock(options)).first;
+            return it->second;
+        };
+
+        mBlends.push_back(prepareVertexBlend(sourceVertexData, targetVertexData, blendNormals, lockBuffer));
+        mBlends.back().firstMatrix = mMatrices.size();
+        mMatrices.insert(mMatrices.end(), blendMatrices, blendMatrices + numMatrices);
+    }
+    //---------------------------------------------------------------------
+    bool SoftwareVertexBlendBatch::isLocked(const VertexData* vertexData) const
+    {
+        if (!vertexData || mLockedBuffers.empty())
+            return false;
+
+        for (const auto& b : vertexData->vertexBufferBinding->getBindings())
+        {
+            if (mLockedBuffers.count(b.second.get()))
+                return true;
+        }
+        return false;
+    }
+    //---------------------------------------------------------------------
+    void SoftwareVertexBlendBatch::run()
+    {
+        // split large blends, so few entities with many vertices keep all workers busy
+        mTasks.clear();
+        for (size_t i = 0; i < mBlends.size(); ++i)
+        {
+            for (size_t v = 0; v < mBlends[i].numVertices; v += mVerticesPerTask)
+                mTasks.emplace_back(i, v);
+        }
+
+        auto blendRange = [this](size_t begin, size_t end) {
+            for (size_t t = begin; t < end; ++t)
+            {
+                const Blend& blend = mBlends[mTasks[t].first];
+                size_t first = mTasks[t].second;
+                softwareVertexSkinning(blend, mMatrices.data() + blend.firstMatrix, first,
+                                       std::min(mVerticesPerTask, blend.numVertices - first));
+            }
+        };
+
+        if (mTasks.size() > 1)
+            Root::getSingleton().getWorkQueue()->parallelFor(0, mTasks.size(), 1, blendRange);
+        else
+            blendRange(0, mTasks.size());
+
+        for (auto& b : mLockedBuffers)
+            b.first->unlock();
+
+        mLockedBuffers.clear();
+        mBlends.clear();
+        mMatrices.clear();
+    }
+}
@@ -286,8 +286,11 @@ namespace Ogre {
     {
         if (derive)
         {
+            AxisAlignedBox previous = mWorldAABB;
             mWorldAABB = this->getBoundingBox();
             mWorldAABB.transform(_getParentNodeFullTransform());
+            if (mManager && mWorldAABB != previous)
+                mManager->_notifyWorldBoundsChanged(this);
         }
 
         return mWorldAABB;
@@ -298,8 +301,12 @@ namespace Ogre {
     {
         if (derive)
         {
+            Sphere previous = mWorldBoundingSphere;
             mWorldBoundingSphere.setRadius(getBoundingRadiusScaled());
             mWorldBoundingSphere.setCenter(mParentNode->_getDerivedPosition());
+            if (mManager && (mWorldBoundingSphere.getCenter() != previous.getCenter() ||
+                             mWorldBoundingSphere.getRadius() != previous.getRadius()))
+                mManager->_notifyWorldBoundsChanged(this, true);
         }
         return mWorldBoundingSphere;
     }
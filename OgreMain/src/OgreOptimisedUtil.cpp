@@ -38,6 +38,9 @@ namespace Ogre {
 #if __OGRE_HAVE_SSE || __OGRE_HAVE_NEON
     extern OptimisedUtil* _getOptimisedUtilSSE(void);
 #endif
+#if __OGRE_HAVE_AVX2
+    extern OptimisedUtil* _getOptimisedUtilAVX2(void);
+#endif
 
 #ifdef __DO_PROFILE__
     //---------------------------------------------------------------------
@@ -50,6 +53,9 @@ namespace Ogre {
             IMPL_DEFAULT,
 #if __OGRE_HAVE_SSE || __OGRE_HAVE_NEON
             IMPL_SSE,
+#endif
+#if __OGRE_HAVE_AVX2
+            IMPL_AVX2,
 #endif
             IMPL_COUNT
         };
@@ -97,6 +103,13 @@ namespace Ogre {
             {
                 mOptimisedUtils.push_back(_getOptimisedUtilSSE());
             }
+#endif
+#if __OGRE_HAVE_AVX2
+            if (PlatformInformation::hasCpuFeature(PlatformInformation::CPU_FEATURE_AVX2) &&
+                PlatformInformation::hasCpuFeature(PlatformInformation::CPU_FEATURE_FMA))
+            {
+                mOptimisedUtils.push_back(_getOptimisedUtilAVX2());
+            }
 #endif
         }
 
@@ -315,6 +328,38 @@ namespace Ogre {
             ++index;    // So we can put break point here even if in release build
         }
 
+        virtual void cullAxisAlignedBoxes(
+            const Plane* planes,
+            size_t numPlanes,
+            const float* const minimum[3],
+            const float* const maximum[3],
+            uint32* visibleMask,
+            size_t numBoxes)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->cullAxisAlignedBoxes(
+                planes,
+                numPlanes,
+                minimum,
+                maximum,
+                visibleMask,
+                numBoxes);
+            profile.end();
+
+            LogManager::getSingleton().logMessage(StringUtil::format(
+                "OptimisedUtilProfiler: %s - impl %zu = %u avg ticks\n", __FUNCTION__, index, profile.mAvgTicks));
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
     };
 #endif // __DO_PROFILE__
 
@@ -368,6 +413,13 @@ namespace Ogre {
 
 #else   // !__DO_PROFILE__
 
+#if __OGRE_HAVE_AVX2
+        if (PlatformInformation::hasCpuFeature(PlatformInformation::CPU_FEATURE_AVX2) &&
+            PlatformInformation::hasCpuFeature(PlatformInformation::CPU_FEATURE_FMA))
+        {
+            return _getOptimisedUtilAVX2();
+        }
+#endif
 #if __OGRE_HAVE_SSE
         if (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_SSE)
         {
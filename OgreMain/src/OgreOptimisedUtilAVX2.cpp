@@ -0,0 +1,627 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+#include "OgreStableHeaders.h"
+#include "OgreOptimisedUtil.h"
+
+#if __OGRE_HAVE_AVX2
+
+#include <immintrin.h>
+
+// Unlike OgreOptimisedUtilSSE.cpp, this file is compiled with the default compiler flags.
+// AVX2 and FMA are enabled per function instead, so nothing in here may be called unless
+// PlatformInformation reports CPU and operating system support. Every function that uses
+// the intrinsics, including the inlined helpers, must be marked with OGRE_AVX2_TARGET.
+#if OGRE_COMPILER == OGRE_COMPILER_GNUC || OGRE_COMPILER == OGRE_COMPILER_CLANG
+#   define OGRE_AVX2_TARGET __attribute__((target("avx2,fma")))
+#else
+#   define OGRE_AVX2_TARGET
+#endif
+
+namespace Ogre {
+
+//-------------------------------------------------------------------------
+// Local classes
+//-------------------------------------------------------------------------
+
+    /** AVX2 implementation of OptimisedUtil.
+
+        Processes eight floats per instruction where the data layout allows, otherwise two
+        vertices at once, one in each 128-bit lane.
+    @note
+        Don't use this class directly, use OptimisedUtil instead.
+    */
+    class _OgrePrivate OptimisedUtilAVX2 : public OptimisedUtil
+    {
+    public:
+        /// @copydoc OptimisedUtil::softwareVertexSkinning
+        OGRE_AVX2_TARGET void softwareVertexSkinning(
+            const float *srcPosPtr, float *destPosPtr,
+            const float *srcNormPtr, float *destNormPtr,
+            const float *blendWeightPtr, const unsigned char* blendIndexPtr,
+            const Affine3* const* blendMatrices,
+            size_t srcPosStride, size_t destPosStride,
+            size_t srcNormStride, size_t destNormStride,
+            size_t blendWeightStride, size_t blendIndexStride,
+            size_t numWeightsPerVertex,
+            size_t numVertices) override;
+
+        /// @copydoc OptimisedUtil::softwareVertexMorph
+        OGRE_AVX2_TARGET void softwareVertexMorph(
+            float t,
+            const float *srcPos1, const float *srcPos2,
+            float *dstPos,
+            size_t pos1VSize, size_t pos2VSize, size_t dstVSize,
+            size_t numVertices,
+            bool morphNormals) override;
+
+        /// @copydoc OptimisedUtil::concatenateAffineMatrices
+        OGRE_AVX2_TARGET void concatenateAffineMatrices(
+            const Affine3& baseMatrix,
+            const Affine3* srcMatrices,
+            Affine3* dstMatrices,
+            size_t numMatrices) override;
+
+        /// @copydoc OptimisedUtil::calculateFaceNormals
+        OGRE_AVX2_TARGET void calculateFaceNormals(
+            const float *positions,
+            const EdgeData::Triangle *triangles,
+            Vector4 *faceNormals,
+            size_t numTriangles) override;
+
+        /// @copydoc OptimisedUtil::calculateLightFacing
+        OGRE_AVX2_TARGET void calculateLightFacing(
+            const Vector4& lightPos,
+            const Vector4* faceNormals,
+            char* lightFacings,
+            size_t numFaces) override;
+
+        /// @copydoc OptimisedUtil::extrudeVertices
+        OGRE_AVX2_TARGET void extrudeVertices(
+            const Vector4& lightPos,
+            Real extrudeDist,
+            const float* srcPositions,
+            float* destPositions,
+            size_t numVertices) override;
+
+        /// @copydoc OptimisedUtil::cullAxisAlignedBoxes
+        OGRE_AVX2_TARGET void cullAxisAlignedBoxes(
+            const Plane* planes,
+            size_t numPlanes,
+            const float* const minimum[3],
+            const float* const maximum[3],
+            uint32* visibleMask,
+            size_t numBoxes) override;
+    };
+    //---------------------------------------------------------------------
+    // Helpers
+    //---------------------------------------------------------------------
+    /// Returns [lo | hi]
+    static OGRE_FORCE_INLINE OGRE_AVX2_TARGET __m256 combine_AVX2(__m128 lo, __m128 hi)
+    {
+        return _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1);
+    }
+    //---------------------------------------------------------------------
+    /// Loads four floats from each pointer, no alignment requirements
+    static OGRE_FORCE_INLINE OGRE_AVX2_TARGET __m256 load2_AVX2(const float* lo, const float* hi)
+    {
+        return combine_AVX2(_mm_loadu_ps(lo), _mm_loadu_ps(hi));
+    }
+    //---------------------------------------------------------------------
+    /// Loads a 3D vector from each pointer, the w components are zero
+    static OGRE_FORCE_INLINE OGRE_AVX2_TARGET __m256 load3x2_AVX2(const float* lo, const float* hi)
+    {
+        const __m128i mask = _mm_setr_epi32(-1, -1, -1, 0);
+        return combine_AVX2(_mm_maskload_ps(lo, mask), _mm_maskload_ps(hi, mask));
+    }
+    //---------------------------------------------------------------------
+    /// Stores the x, y and z components
+    static OGRE_FORCE_INLINE OGRE_AVX2_TARGET void store3_AVX2(float* dst, __m128 v)
+    {
+        _mm_storel_pi((__m64*)dst, v);
+        _mm_store_ss(dst + 2, _mm_movehl_ps(v, v));
+    }
+    //---------------------------------------------------------------------
+    /// Stores the low lane to lo and, if hi is not NULL, the high lane to hi
+    static OGRE_FORCE_INLINE OGRE_AVX2_TARGET void store3x2_AVX2(float* lo, float* hi, __m256 v)
+    {
+        store3_AVX2(lo, _mm256_castps256_ps128(v));
+        if (hi)
+            store3_AVX2(hi, _mm256_extractf128_ps(v, 1));
+    }
+    //---------------------------------------------------------------------
+    /// Returns 1 / sqrt(x), or 0 where x is 0, same as Vector3::normalise
+    static OGRE_FORCE_INLINE OGRE_AVX2_TARGET __m256 invSqrt_AVX2(__m256 x)
+    {
+        // One Newton-Raphson iteration, rsqrt alone is only accurate to 12 bits
+        __m256 r = _mm256_rsqrt_ps(x);
+        r = _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(0.5f), r),
+                          _mm256_fnmadd_ps(_mm256_mul_ps(x, r), r, _mm256_set1_ps(3.0f)));
+        return _mm256_and_ps(r, _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_NEQ_OQ));
+    }
+    //---------------------------------------------------------------------
+    /// Normalises the xyz parts of both lanes, w is undefined afterwards
+    static OGRE_FORCE_INLINE OGRE_AVX2_TARGET __m256 normalise3x2_AVX2(__m256 v)
+    {
+        return _mm256_mul_ps(v, invSqrt_AVX2(_mm256_dp_ps(v, v, 0x7F)));
+    }
+    //---------------------------------------------------------------------
+    /** Blends the matrices of two vertices, row i of the first vertex ends up in the low
+        lane of rows[i], the one of the second vertex in the high lane.
+    */
+    static OGRE_FORCE_INLINE OGRE_AVX2_TARGET void blendMatrices_AVX2(
+        __m256 rows[3], const Affine3* const* blendMatrices,
+        const float* weightsA, const unsigned char* indicesA,
+        const float* weightsB, const unsigned char* indicesB,
+        size_t numWeightsPerVertex)
+    {
+        rows[0] = rows[1] = rows[2] = _mm256_setzero_ps();
+        for (size_t i = 0; i < numWeightsPerVertex; ++i)
+        {
+            __m256 weight = combine_AVX2(_mm_set1_ps(weightsA[i]), _mm_set1_ps(weightsB[i]));
+            const float* a = (*blendMatrices[indicesA[i]])[0];
+            const float* b = (*blendMatrices[indicesB[i]])[0];
+            rows[0] = _mm256_fmadd_ps(weight, load2_AVX2(a + 0, b + 0), rows[0]);
+            rows[1] = _mm256_fmadd_ps(weight, load2_AVX2(a + 4, b + 4), rows[1]);
+            rows[2] = _mm256_fmadd_ps(weight, load2_AVX2(a + 8, b + 8), rows[2]);
+        }
+    }
+    //---------------------------------------------------------------------
+    /// Multiplies the 3x4 matrix in each lane by the vector in the same lane
+    static OGRE_FORCE_INLINE OGRE_AVX2_TARGET __m256 transform_AVX2(const __m256 rows[3], __m256 v)
+    {
+        __m256 t0 = _mm256_mul_ps(rows[0], v);
+        __m256 t1 = _mm256_mul_ps(rows[1], v);
+        __m256 t2 = _mm256_mul_ps(rows[2], v);
+        return _mm256_hadd_ps(_mm256_hadd_ps(t0, t1), _mm256_hadd_ps(t2, t2));
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    OGRE_AVX2_TARGET void OptimisedUtilAVX2::softwareVertexSkinning(
+        const float *pSrcPos, float *pDestPos,
+        const float *pSrcNorm, float *pDestNorm,
+        const float *pBlendWeight, const unsigned char* pBlendIndex,
+        const Affine3* const* blendMatrices,
+        size_t srcPosStride, size_t destPosStride,
+        size_t srcNormStride, size_t destNormStride,
+        size_t blendWeightStride, size_t blendIndexStride,
+        size_t numWeightsPerVertex,
+        size_t numVertices)
+    {
+        const __m256 one = _mm256_set1_ps(1.0f);
+        __m256 rows[3];
+
+        // Two vertices per-iteration, an odd last vertex is processed twice but stored once
+        for (size_t i = 0; i < numVertices; i += 2)
+        {
+            bool pair = i + 1 < numVertices;
+
+            const float* pBlendWeightB = pair ? rawOffsetPointer(pBlendWeight, blendWeightStride) : pBlendWeight;
+            const unsigned char* pBlendIndexB = pair ? rawOffsetPointer(pBlendIndex, blendIndexStride) : pBlendIndex;
+            blendMatrices_AVX2(rows, blendMatrices, pBlendWeight, pBlendIndex,
+                               pBlendWeightB, pBlendIndexB, numWeightsPerVertex);
+
+            // Positions use the full 3x4 matrix
+            const float* pSrcPosB = pair ? rawOffsetPointer(pSrcPos, srcPosStride) : pSrcPos;
+            __m256 pos = _mm256_blend_ps(load3x2_AVX2(pSrcPos, pSrcPosB), one, 0x88);
+            store3x2_AVX2(pDestPos, pair ? rawOffsetPointer(pDestPos, destPosStride) : NULL,
+                          transform_AVX2(rows, pos));
+
+            if (pSrcNorm)
+            {
+                // Normals only use the 3x3 part, as w is zero, see the general implementation
+                // for why this is fine
+                const float* pSrcNormB = pair ? rawOffsetPointer(pSrcNorm, srcNormStride) : pSrcNorm;
+                __m256 norm = normalise3x2_AVX2(transform_AVX2(rows, load3x2_AVX2(pSrcNorm, pSrcNormB)));
+                store3x2_AVX2(pDestNorm, pair ? rawOffsetPointer(pDestNorm, destNormStride) : NULL, norm);
+
+                advanceRawPointer(pSrcNorm, 2 * srcNormStride);
+                advanceRawPointer(pDestNorm, 2 * destNormStride);
+            }
+
+            advanceRawPointer(pSrcPos, 2 * srcPosStride);
+            advanceRawPointer(pDestPos, 2 * destPosStride);
+            advanceRawPointer(pBlendWeight, 2 * blendWeightStride);
+            advanceRawPointer(pBlendIndex, 2 * blendIndexStride);
+        }
+    }
+    //---------------------------------------------------------------------
+    OGRE_AVX2_TARGET void OptimisedUtilAVX2::softwareVertexMorph(
+        float t,
+        const float *pSrc1, const float *pSrc2,
+        float *pDst,
+        size_t pos1VSize, size_t pos2VSize, size_t dstVSize,
+        size_t numVertices,
+        bool morphNormals)
+    {
+        if (!morphNormals && pos1VSize == 12 && pos2VSize == 12 && dstVSize == 12)
+        {
+            // Packed positions, just interpolate all floats eight at a time
+            __m256 t8 = _mm256_set1_ps(t);
+            size_t numFloats = numVertices * 3;
+            size_t i = 0;
+            for (; i + 8 <= numFloats; i += 8)
+            {
+                __m256 src1 = _mm256_loadu_ps(pSrc1 + i);
+                __m256 src2 = _mm256_loadu_ps(pSrc2 + i);
+                _mm256_storeu_ps(pDst + i, _mm256_fmadd_ps(t8, _mm256_sub_ps(src2, src1), src1));
+            }
+            for (; i < numFloats; ++i)
+            {
+                pDst[i] = pSrc1[i] + t * (pSrc2[i] - pSrc1[i]);
+            }
+            return;
+        }
+
+        // Any vertex size, or normals which need to be normalised separately, two vertices
+        // per-iteration
+        __m256 t8 = _mm256_set1_ps(t);
+        for (size_t i = 0; i < numVertices; i += 2)
+        {
+            bool pair = i + 1 < numVertices;
+            const float* pSrc1B = pair ? rawOffsetPointer(pSrc1, pos1VSize) : pSrc1;
+            const float* pSrc2B = pair ? rawOffsetPointer(pSrc2, pos2VSize) : pSrc2;
+            float* pDstB = pair ? rawOffsetPointer(pDst, dstVSize) : NULL;
+
+            __m256 src1 = load3x2_AVX2(pSrc1, pSrc1B);
+            __m256 src2 = load3x2_AVX2(pSrc2, pSrc2B);
+            store3x2_AVX2(pDst, pDstB, _mm256_fmadd_ps(t8, _mm256_sub_ps(src2, src1), src1));
+
+            if (morphNormals)
+            {
+                // Normals must be in the same buffer as positions, perform an nlerp
+                src1 = load3x2_AVX2(pSrc1 + 3, pSrc1B + 3);
+                src2 = load3x2_AVX2(pSrc2 + 3, pSrc2B + 3);
+                __m256 norm = normalise3x2_AVX2(_mm256_fmadd_ps(t8, _mm256_sub_ps(src2, src1), src1));
+                store3x2_AVX2(pDst + 3, pDstB ? pDstB + 3 : NULL, norm);
+            }
+
+            advanceRawPointer(pSrc1, 2 * pos1VSize);
+            advanceRawPointer(pSrc2, 2 * pos2VSize);
+            advanceRawPointer(pDst, 2 * dstVSize);
+        }
+    }
+    //---------------------------------------------------------------------
+    OGRE_AVX2_TARGET void OptimisedUtilAVX2::concatenateAffineMatrices(
+        const Affine3& baseMatrix,
+        const Affine3* pSrcMat,
+        Affine3* pDstMat,
+        size_t numMatrices)
+    {
+        const float* base = baseMatrix[0];
+
+        // Rows 0 and 1 of the base matrix, one per lane
+        const __m256 b01_0 = combine_AVX2(_mm_set1_ps(base[0]), _mm_set1_ps(base[4]));
+        const __m256 b01_1 = combine_AVX2(_mm_set1_ps(base[1]), _mm_set1_ps(base[5]));
+        const __m256 b01_2 = combine_AVX2(_mm_set1_ps(base[2]), _mm_set1_ps(base[6]));
+        const __m256 b01_3 = _mm256_setr_ps(0, 0, 0, base[3], 0, 0, 0, base[7]);
+
+        // Row 2 of the base matrix, and row 3 of the result which is always (0, 0, 0, 1)
+        const __m128 b2_0 = _mm_set1_ps(base[8]);
+        const __m128 b2_1 = _mm_set1_ps(base[9]);
+        const __m128 b2_2 = _mm_set1_ps(base[10]);
+        const __m128 b2_3 = _mm_setr_ps(0, 0, 0, base[11]);
+        const __m128 row3 = _mm_setr_ps(0, 0, 0, 1);
+
+        for (size_t i = 0; i < numMatrices; ++i)
+        {
+            const float* src = pSrcMat[i][0];
+            float* dst = pDstMat[i][0];
+
+            __m256 s0 = _mm256_broadcast_ps((const __m128*)(src + 0));
+            __m256 s1 = _mm256_broadcast_ps((const __m128*)(src + 4));
+            __m256 s2 = _mm256_broadcast_ps((const __m128*)(src + 8));
+
+            __m256 d01 = _mm256_fmadd_ps(b01_0, s0,
+                         _mm256_fmadd_ps(b01_1, s1,
+                         _mm256_fmadd_ps(b01_2, s2, b01_3)));
+            __m128 d2 = _mm_fmadd_ps(b2_0, _mm256_castps256_ps128(s0),
+                        _mm_fmadd_ps(b2_1, _mm256_castps256_ps128(s1),
+                        _mm_fmadd_ps(b2_2, _mm256_castps256_ps128(s2), b2_3)));
+
+            _mm256_storeu_ps(dst, d01);
+            _mm256_storeu_ps(dst + 8, combine_AVX2(d2, row3));
+        }
+    }
+    //---------------------------------------------------------------------
+    OGRE_AVX2_TARGET void OptimisedUtilAVX2::calculateFaceNormals(
+        const float *positions,
+        const EdgeData::Triangle *triangles,
+        Vector4 *faceNormals,
+        size_t numTriangles)
+    {
+        // Eight triangles per-iteration, gathering the vertices into x, y and z vectors
+        size_t numIterations = numTriangles / 8;
+        for (size_t i = 0; i < numIterations; ++i, triangles += 8, faceNormals += 8)
+        {
+            __m256 x[3], y[3], z[3];
+            for (int v = 0; v < 3; ++v)
+            {
+                __m256i offsets = _mm256_mullo_epi32(_mm256_setr_epi32(
+                    triangles[0].vertIndex[v], triangles[1].vertIndex[v],
+                    triangles[2].vertIndex[v], triangles[3].vertIndex[v],
+                    triangles[4].vertIndex[v], triangles[5].vertIndex[v],
+                    triangles[6].vertIndex[v], triangles[7].vertIndex[v]), _mm256_set1_epi32(3));
+                x[v] = _mm256_i32gather_ps(positions + 0, offsets, 4);
+                y[v] = _mm256_i32gather_ps(positions + 1, offsets, 4);
+                z[v] = _mm256_i32gather_ps(positions + 2, offsets, 4);
+            }
+
+            // Same operations as Math::calculateFaceNormalWithoutNormalize
+            __m256 e1x = _mm256_sub_ps(x[1], x[0]);
+            __m256 e1y = _mm256_sub_ps(y[1], y[0]);
+            __m256 e1z = _mm256_sub_ps(z[1], z[0]);
+            __m256 e2x = _mm256_sub_ps(x[2], x[0]);
+            __m256 e2y = _mm256_sub_ps(y[2], y[0]);
+            __m256 e2z = _mm256_sub_ps(z[2], z[0]);
+
+            __m256 nx = _mm256_fmsub_ps(e1y, e2z, _mm256_mul_ps(e1z, e2y));
+            __m256 ny = _mm256_fmsub_ps(e1z, e2x, _mm256_mul_ps(e1x, e2z));
+            __m256 nz = _mm256_fmsub_ps(e1x, e2y, _mm256_mul_ps(e1y, e2x));
+            __m256 nw = _mm256_sub_ps(_mm256_setzero_ps(),
+                _mm256_fmadd_ps(nx, x[0], _mm256_fmadd_ps(ny, y[0], _mm256_mul_ps(nz, z[0]))));
+
+            // Transpose to eight Vector4
+            __m256 xy01 = _mm256_unpacklo_ps(nx, ny);
+            __m256 xy23 = _mm256_unpackhi_ps(nx, ny);
+            __m256 zw01 = _mm256_unpacklo_ps(nz, nw);
+            __m256 zw23 = _mm256_unpackhi_ps(nz, nw);
+            __m256 n04 = _mm256_shuffle_ps(xy01, zw01, _MM_SHUFFLE(1, 0, 1, 0));
+            __m256 n15 = _mm256_shuffle_ps(xy01, zw01, _MM_SHUFFLE(3, 2, 3, 2));
+            __m256 n26 = _mm256_shuffle_ps(xy23, zw23, _MM_SHUFFLE(1, 0, 1, 0));
+            __m256 n37 = _mm256_shuffle_ps(xy23, zw23, _MM_SHUFFLE(3, 2, 3, 2));
+
+            float* dst = faceNormals[0].ptr();
+            _mm256_storeu_ps(dst + 0, _mm256_permute2f128_ps(n04, n15, 0x20));
+            _mm256_storeu_ps(dst + 8, _mm256_permute2f128_ps(n26, n37, 0x20));
+            _mm256_storeu_ps(dst + 16, _mm256_permute2f128_ps(n04, n15, 0x31));
+            _mm256_storeu_ps(dst + 24, _mm256_permute2f128_ps(n26, n37, 0x31));
+        }
+
+        for (numTriangles &= 7; numTriangles; --numTriangles)
+        {
+            const EdgeData::Triangle& t = *triangles++;
+            Vector3 v1(positions + t.vertIndex[0] * 3);
+            Vector3 v2(positions + t.vertIndex[1] * 3);
+            Vector3 v3(positions + t.vertIndex[2] * 3);
+            *faceNormals++ = Math::calculateFaceNormalWithoutNormalize(v1, v2, v3);
+        }
+    }
+    //---------------------------------------------------------------------
+    OGRE_AVX2_TARGET void OptimisedUtilAVX2::calculateLightFacing(
+        const Vector4& lightPos,
+        const Vector4* faceNormals,
+        char* lightFacings,
+        size_t numFaces)
+    {
+        const __m256 lp = _mm256_broadcast_ps((const __m128*)lightPos.ptr());
+        // Undoes the lane interleaving of the horizontal adds below
+        const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+        // Eight faces per-iteration
+        size_t numIterations = numFaces / 8;
+        for (size_t i = 0; i < numIterations; ++i, faceNormals += 8, lightFacings += 8)
+        {
+            const float* n = faceNormals[0].ptr();
+            __m256 d01 = _mm256_mul_ps(_mm256_loadu_ps(n + 0), lp);
+            __m256 d23 = _mm256_mul_ps(_mm256_loadu_ps(n + 8), lp);
+            __m256 d45 = _mm256_mul_ps(_mm256_loadu_ps(n + 16), lp);
+            __m256 d67 = _mm256_mul_ps(_mm256_loadu_ps(n + 24), lp);
+
+            // [0 2 4 6 | 1 3 5 7]
+            __m256 dots = _mm256_hadd_ps(_mm256_hadd_ps(d01, d23), _mm256_hadd_ps(d45, d67));
+            dots = _mm256_permutevar8x32_ps(dots, order);
+
+            int mask = _mm256_movemask_ps(_mm256_cmp_ps(dots, _mm256_setzero_ps(), _CMP_GT_OQ));
+            for (int j = 0; j < 8; ++j)
+                lightFacings[j] = (mask >> j) & 1;
+        }
+
+        for (numFaces &= 7; numFaces; --numFaces)
+        {
+            *lightFacings++ = (lightPos.dotProduct(*faceNormals++) > 0);
+        }
+    }
+    //---------------------------------------------------------------------
+    OGRE_AVX2_TARGET void OptimisedUtilAVX2::extrudeVertices(
+        const Vector4& lightPos,
+        Real extrudeDist,
+        const float* pSrcPos,
+        float* pDestPos,
+        size_t numVertices)
+    {
+        size_t numIterations = numVertices / 8;
+
+        if (lightPos.w == 0.0f)
+        {
+            // Directional light, extrusion is along light direction
+            Vector3 dir(-lightPos.x, -lightPos.y, -lightPos.z);
+            dir.normalise();
+            dir *= extrudeDist;
+
+            // The direction repeated over 24 floats, i.e. eight vertices
+            const __m256 dir0 = _mm256_setr_ps(dir.x, dir.y, dir.z, dir.x, dir.y, dir.z, dir.x, dir.y);
+            const __m256 dir1 = _mm256_setr_ps(dir.z, dir.x, dir.y, dir.z, dir.x, dir.y, dir.z, dir.x);
+            const __m256 dir2 = _mm256_setr_ps(dir.y, dir.z, dir.x, dir.y, dir.z, dir.x, dir.y, dir.z);
+
+            for (size_t i = 0; i < numIterations; ++i, pSrcPos += 24, pDestPos += 24)
+            {
+                _mm256_storeu_ps(pDestPos + 0, _mm256_add_ps(_mm256_loadu_ps(pSrcPos + 0), dir0));
+                _mm256_storeu_ps(pDestPos + 8, _mm256_add_ps(_mm256_loadu_ps(pSrcPos + 8), dir1));
+                _mm256_storeu_ps(pDestPos + 16, _mm256_add_ps(_mm256_loadu_ps(pSrcPos + 16), dir2));
+            }
+
+            for (numVertices &= 7; numVertices; --numVertices)
+            {
+                *pDestPos++ = *pSrcPos++ + dir.x;
+                *pDestPos++ = *pSrcPos++ + dir.y;
+                *pDestPos++ = *pSrcPos++ + dir.z;
+            }
+        }
+        else
+        {
+            // Point light, calculate extrusionDir for every vertex
+            assert(lightPos.w == 1.0f);
+
+            const __m256 lx = _mm256_set1_ps(lightPos.x);
+            const __m256 ly = _mm256_set1_ps(lightPos.y);
+            const __m256 lz = _mm256_set1_ps(lightPos.z);
+            const __m256 dist = _mm256_set1_ps(extrudeDist);
+
+            for (size_t i = 0; i < numIterations; ++i, pSrcPos += 24, pDestPos += 24)
+            {
+                // Load eight packed vertices as x, y and z vectors
+                __m256 m03 = load2_AVX2(pSrcPos + 0, pSrcPos + 12);     // x0 y0 z0 x1 | x4 y4 z4 x5
+                __m256 m14 = load2_AVX2(pSrcPos + 4, pSrcPos + 16);     // y1 z1 x2 y2 | y5 z5 x6 y6
+                __m256 m25 = load2_AVX2(pSrcPos + 8, pSrcPos + 20);     // z2 x3 y3 z3 | z6 x7 y7 z7
+                __m256 xy = _mm256_shuffle_ps(m14, m25, _MM_SHUFFLE(2, 1, 3, 2));
+                __m256 yz = _mm256_shuffle_ps(m03, m14, _MM_SHUFFLE(1, 0, 2, 1));
+                __m256 x = _mm256_shuffle_ps(m03, xy, _MM_SHUFFLE(2, 0, 3, 0));
+                __m256 y = _mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+                __m256 z = _mm256_shuffle_ps(yz, m25, _MM_SHUFFLE(3, 0, 3, 1));
+
+                __m256 dx = _mm256_sub_ps(x, lx);
+                __m256 dy = _mm256_sub_ps(y, ly);
+                __m256 dz = _mm256_sub_ps(z, lz);
+                __m256 scale = _mm256_mul_ps(dist, invSqrt_AVX2(
+                    _mm256_fmadd_ps(dx, dx, _mm256_fmadd_ps(dy, dy, _mm256_mul_ps(dz, dz)))));
+                x = _mm256_fmadd_ps(dx, scale, x);
+                y = _mm256_fmadd_ps(dy, scale, y);
+                z = _mm256_fmadd_ps(dz, scale, z);
+
+                // And back to packed vertices
+                __m256 rxy = _mm256_shuffle_ps(x, y, _MM_SHUFFLE(2, 0, 2, 0));
+                __m256 ryz = _mm256_shuffle_ps(y, z, _MM_SHUFFLE(3, 1, 3, 1));
+                __m256 rzx = _mm256_shuffle_ps(z, x, _MM_SHUFFLE(3, 1, 2, 0));
+                __m256 r03 = _mm256_shuffle_ps(rxy, rzx, _MM_SHUFFLE(2, 0, 2, 0));
+                __m256 r14 = _mm256_shuffle_ps(ryz, rxy, _MM_SHUFFLE(3, 1, 2, 0));
+                __m256 r25 = _mm256_shuffle_ps(rzx, ryz, _MM_SHUFFLE(3, 1, 3, 1));
+                _mm256_storeu_ps(pDestPos + 0, _mm256_permute2f128_ps(r03, r14, 0x20));
+                _mm256_storeu_ps(pDestPos + 8, _mm256_permute2f128_ps(r25, r03, 0x30));
+                _mm256_storeu_ps(pDestPos + 16, _mm256_permute2f128_ps(r14, r25, 0x31));
+            }
+
+            for (numVertices &= 7; numVertices; --numVertices)
+            {
+                Vector3 extrusionDir(
+                    pSrcPos[0] - lightPos.x,
+                    pSrcPos[1] - lightPos.y,
+                    pSrcPos[2] - lightPos.z);
+                extrusionDir.normalise();
+                extrusionDir *= extrudeDist;
+
+                *pDestPos++ = *pSrcPos++ + extrusionDir.x;
+                *pDestPos++ = *pSrcPos++ + extrusionDir.y;
+                *pDestPos++ = *pSrcPos++ + extrusionDir.z;
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    /// Returns the 8-bits visible mask of the eight boxes starting at first
+    static OGRE_FORCE_INLINE OGRE_AVX2_TARGET int cullAxisAlignedBoxes_AVX2_Eight(
+        const Plane* planes, size_t numPlanes,
+        const float* const minimum[3], const float* const maximum[3], size_t first)
+    {
+        const __m256 half = _mm256_set1_ps(0.5f);
+
+        __m256 minX = _mm256_loadu_ps(minimum[0] + first);
+        __m256 minY = _mm256_loadu_ps(minimum[1] + first);
+        __m256 minZ = _mm256_loadu_ps(minimum[2] + first);
+        __m256 maxX = _mm256_loadu_ps(maximum[0] + first);
+        __m256 maxY = _mm256_loadu_ps(maximum[1] + first);
+        __m256 maxZ = _mm256_loadu_ps(maximum[2] + first);
+
+        // Same operations as AxisAlignedBox::getCenter/ getHalfSize
+        __m256 cx = _mm256_mul_ps(_mm256_add_ps(maxX, minX), half);
+        __m256 cy = _mm256_mul_ps(_mm256_add_ps(maxY, minY), half);
+        __m256 cz = _mm256_mul_ps(_mm256_add_ps(maxZ, minZ), half);
+        __m256 hx = _mm256_mul_ps(_mm256_sub_ps(maxX, minX), half);
+        __m256 hy = _mm256_mul_ps(_mm256_sub_ps(maxY, minY), half);
+        __m256 hz = _mm256_mul_ps(_mm256_sub_ps(maxZ, minZ), half);
+
+        int mask = 0xFF;
+        for (size_t p = 0; p < numPlanes && mask; ++p)
+        {
+            const Plane& plane = planes[p];
+
+            // dist = normal.dotProduct(centre) + d
+            __m256 dist = _mm256_fmadd_ps(_mm256_set1_ps(plane.normal.x), cx,
+                          _mm256_fmadd_ps(_mm256_set1_ps(plane.normal.y), cy,
+                          _mm256_fmadd_ps(_mm256_set1_ps(plane.normal.z), cz, _mm256_set1_ps(plane.d))));
+
+            // maxAbsDist = normal.absDotProduct(halfSize), half sizes are never negative
+            __m256 maxAbsDist = _mm256_fmadd_ps(_mm256_set1_ps(Math::Abs(plane.normal.x)), hx,
+                                _mm256_fmadd_ps(_mm256_set1_ps(Math::Abs(plane.normal.y)), hy,
+                                _mm256_mul_ps(_mm256_set1_ps(Math::Abs(plane.normal.z)), hz)));
+
+            // Keep boxes which are not completely on the negative side
+            mask &= _mm256_movemask_ps(_mm256_cmp_ps(
+                dist, _mm256_sub_ps(_mm256_setzero_ps(), maxAbsDist), _CMP_GE_OQ));
+        }
+
+        return mask;
+    }
+    //---------------------------------------------------------------------
+    OGRE_AVX2_TARGET void OptimisedUtilAVX2::cullAxisAlignedBoxes(
+        const Plane* planes,
+        size_t numPlanes,
+        const float* const minimum[3],
+        const float* const maximum[3],
+        uint32* visibleMask,
+        size_t numBoxes)
+    {
+        size_t numIterations = numBoxes / 8;
+
+        // Eight boxes per-iteration, which never cross a mask element
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            size_t first = i * 8;
+            uint32 mask = cullAxisAlignedBoxes_AVX2_Eight(planes, numPlanes, minimum, maximum, first);
+
+            if ((first & 31) == 0)
+                visibleMask[first >> 5] = mask;
+            else
+                visibleMask[first >> 5] |= mask << (first & 31);
+        }
+
+        size_t first = numIterations * 8;
+        size_t numRemaining = numBoxes - first;
+        if (numRemaining)
+        {
+            // Pad the remaining boxes to eight by repeating the last one
+            float tmp[6][8];
+            const float* tmpMinimum[3] = {tmp[0], tmp[1], tmp[2]};
+            const float* tmpMaximum[3] = {tmp[3], tmp[4], tmp[5]};
+            for (size_t c = 0; c < 3; ++c)
+            {
+                for (size_t j = 0; j < 8; ++j)
+                {
+                    size_t src = first + std::min(j, numRemaining - 1);
+                    tmp[c][j] = minimum[c][src];
+                    tmp[c + 3][j] = maximum[c][src];
+                }
+            }
+
+            uint32 mask = cullAxisAlignedBoxes_AVX2_Eight(planes, numPlanes, tmpMinimum, tmpMaximum, 0);
+            mask &= (1u << numRemaining) - 1;
+
+            if ((first & 31) == 0)
+                visibleMask[first >> 5] = mask;
+            else
+                visibleMask[first >> 5] |= mask << (first & 31);
+        }
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    extern OptimisedUtil* _getOptimisedUtilAVX2(void);
+    extern OptimisedUtil* _getOptimisedUtilAVX2(void)
+    {
+        static OptimisedUtilAVX2 msOptimisedUtilAVX2;
+        return &msOptimisedUtilAVX2;
+    }
+
+}
+
+#endif // __OGRE_HAVE_AVX2
@@ -91,6 +91,15 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices) override;
+
+        /// @copydoc OptimisedUtil::cullAxisAlignedBoxes
+        void cullAxisAlignedBoxes(
+            const Plane* planes,
+            size_t numPlanes,
+            const float* const minimum[3],
+            const float* const maximum[3],
+            uint32* visibleMask,
+            size_t numBoxes) override;
     };
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
@@ -364,6 +373,35 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::cullAxisAlignedBoxes(
+        const Plane* planes,
+        size_t numPlanes,
+        const float* const minimum[3],
+        const float* const maximum[3],
+        uint32* visibleMask,
+        size_t numBoxes)
+    {
+        for (size_t i = 0; i < numBoxes; ++i)
+        {
+            if ((i & 31) == 0)
+                visibleMask[i >> 5] = 0;
+
+            Vector3 boxMin(minimum[0][i], minimum[1][i], minimum[2][i]);
+            Vector3 boxMax(maximum[0][i], maximum[1][i], maximum[2][i]);
+            Vector3 centre = (boxMax + boxMin) * 0.5f;
+            Vector3 halfSize = (boxMax - boxMin) * 0.5f;
+
+            bool visible = true;
+            for (size_t p = 0; p < numPlanes && visible; ++p)
+            {
+                visible = planes[p].getSide(centre, halfSize) != Plane::NEGATIVE_SIDE;
+            }
+
+            if (visible)
+                visibleMask[i >> 5] |= uint32(1) << (i & 31);
+        }
+    }
+    //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     extern OptimisedUtil* _getOptimisedUtilGeneral(void);
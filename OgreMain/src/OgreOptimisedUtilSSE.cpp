@@ -129,6 +129,15 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices) override;
+
+        /// @copydoc OptimisedUtil::cullAxisAlignedBoxes
+        void __OGRE_SIMD_ALIGN_ATTRIBUTE cullAxisAlignedBoxes(
+            const Plane* planes,
+            size_t numPlanes,
+            const float* const minimum[3],
+            const float* const maximum[3],
+            uint32* visibleMask,
+            size_t numBoxes) override;
     };
 
 #if defined(__OGRE_SIMD_ALIGN_STACK)
@@ -268,6 +277,26 @@ namespace Ogre {
                 destPositions,
                 numVertices);
         }
+
+        /// @copydoc OptimisedUtil::cullAxisAlignedBoxes
+        virtual void cullAxisAlignedBoxes(
+            const Plane* planes,
+            size_t numPlanes,
+            const float* const minimum[3],
+            const float* const maximum[3],
+            uint32* visibleMask,
+            size_t numBoxes)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->cullAxisAlignedBoxes(
+                planes,
+                numPlanes,
+                minimum,
+                maximum,
+                visibleMask,
+                numBoxes);
+        }
     };
 #endif  // !defined(__OGRE_SIMD_ALIGN_STACK)
 
@@ -2134,6 +2163,107 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    /// Returns the 4-bits visible mask of the four boxes starting at first
+    static OGRE_FORCE_INLINE int cullAxisAlignedBoxes_SSE_Four(
+        const Plane* planes, size_t numPlanes,
+        const float* const minimum[3], const float* const maximum[3], size_t first)
+    {
+        const __m128 half = _mm_set1_ps(0.5f);
+        const __m128 zero = _mm_setzero_ps();
+
+        // Load box extents, unaligned
+        __m128 minX = _mm_loadu_ps(minimum[0] + first);
+        __m128 minY = _mm_loadu_ps(minimum[1] + first);
+        __m128 minZ = _mm_loadu_ps(minimum[2] + first);
+        __m128 maxX = _mm_loadu_ps(maximum[0] + first);
+        __m128 maxY = _mm_loadu_ps(maximum[1] + first);
+        __m128 maxZ = _mm_loadu_ps(maximum[2] + first);
+
+        // Same operations as AxisAlignedBox::getCenter/ getHalfSize
+        __m128 cx = _mm_mul_ps(_mm_add_ps(maxX, minX), half);
+        __m128 cy = _mm_mul_ps(_mm_add_ps(maxY, minY), half);
+        __m128 cz = _mm_mul_ps(_mm_add_ps(maxZ, minZ), half);
+        __m128 hx = _mm_mul_ps(_mm_sub_ps(maxX, minX), half);
+        __m128 hy = _mm_mul_ps(_mm_sub_ps(maxY, minY), half);
+        __m128 hz = _mm_mul_ps(_mm_sub_ps(maxZ, minZ), half);
+
+        int mask = 0xF;
+        for (size_t p = 0; p < numPlanes && mask; ++p)
+        {
+            const Plane& plane = planes[p];
+
+            // dist = normal.dotProduct(centre) + d
+            __m128 dist = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(_mm_set1_ps(plane.normal.x), cx),
+                _mm_mul_ps(_mm_set1_ps(plane.normal.y), cy)),
+                _mm_mul_ps(_mm_set1_ps(plane.normal.z), cz)),
+                _mm_set1_ps(plane.d));
+
+            // maxAbsDist = normal.absDotProduct(halfSize), half sizes are never negative
+            __m128 maxAbsDist = _mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(_mm_set1_ps(Math::Abs(plane.normal.x)), hx),
+                _mm_mul_ps(_mm_set1_ps(Math::Abs(plane.normal.y)), hy)),
+                _mm_mul_ps(_mm_set1_ps(Math::Abs(plane.normal.z)), hz));
+
+            // Keep boxes which are not completely on the negative side
+            mask &= _mm_movemask_ps(_mm_cmpge_ps(dist, _mm_sub_ps(zero, maxAbsDist)));
+        }
+
+        return mask;
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::cullAxisAlignedBoxes(
+        const Plane* planes,
+        size_t numPlanes,
+        const float* const minimum[3],
+        const float* const maximum[3],
+        uint32* visibleMask,
+        size_t numBoxes)
+    {
+        __OGRE_CHECK_STACK_ALIGNED_FOR_SSE();
+
+        size_t numIterations = numBoxes / 4;
+
+        // Four boxes per-iteration, which never cross a mask element
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            size_t first = i * 4;
+            uint32 mask = cullAxisAlignedBoxes_SSE_Four(planes, numPlanes, minimum, maximum, first);
+
+            if ((first & 31) == 0)
+                visibleMask[first >> 5] = mask;
+            else
+                visibleMask[first >> 5] |= mask << (first & 31);
+        }
+
+        size_t first = numIterations * 4;
+        size_t numRemaining = numBoxes - first;
+        if (numRemaining)
+        {
+            // Pad the remaining boxes to four by repeating the last one
+            float tmp[6][4];
+            const float* tmpMinimum[3] = {tmp[0], tmp[1], tmp[2]};
+            const float* tmpMaximum[3] = {tmp[3], tmp[4], tmp[5]};
+            for (size_t c = 0; c < 3; ++c)
+            {
+                for (size_t j = 0; j < 4; ++j)
+                {
+                    size_t src = first + std::min(j, numRemaining - 1);
+                    tmp[c][j] = minimum[c][src];
+                    tmp[c + 3][j] = maximum[c][src];
+                }
+            }
+
+            uint32 mask = cullAxisAlignedBoxes_SSE_Four(planes, numPlanes, tmpMinimum, tmpMaximum, 0);
+            mask &= (1u << numRemaining) - 1;
+
+            if ((first & 31) == 0)
+                visibleMask[first >> 5] = mask;
+            else
+                visibleMask[first >> 5] |= mask << (first & 31);
+        }
+    }
+    //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     extern OptimisedUtil* _getOptimisedUtilSSE(void);
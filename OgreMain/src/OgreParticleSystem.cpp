@@ -897,6 +897,8 @@ namespace Ogre {
             }
 
             mParentNode->needUpdate();
+            if (mManager)
+                mManager->_notifyWorldBoundsChanged(this);
 
             if (mRenderer)
                 mRenderer->_notifyBoundingBox(mAABB);
@@ -146,12 +146,12 @@ namespace Ogre {
     }
 
     //---------------------------------------------------------------------
-    // Performs CPUID instruction with 'query', fill the results, and return value of eax.
-    static uint _performCpuid(int query, CpuidResult& result)
+    // Performs CPUID instruction with 'query' and 'subQuery' (in ecx), fill the results, and return value of eax.
+    static uint _performCpuid(int query, CpuidResult& result, int subQuery = 0)
     {
 #if OGRE_COMPILER == OGRE_COMPILER_MSVC
         int CPUInfo[4];
-        __cpuid(CPUInfo, query);
+        __cpuidex(CPUInfo, query, subQuery);
         result._eax = CPUInfo[0];
         result._ebx = CPUInfo[1];
         result._ecx = CPUInfo[2];
@@ -161,7 +161,7 @@ namespace Ogre {
         #if OGRE_ARCH_TYPE == OGRE_ARCHITECTURE_64
         __asm__
         (
-            "cpuid": "=a" (result._eax), "=b" (result._ebx), "=c" (result._ecx), "=d" (result._edx) : "a" (query)
+            "cpuid": "=a" (result._eax), "=b" (result._ebx), "=c" (result._ecx), "=d" (result._edx) : "a" (query), "c" (subQuery)
         );
         #else
         __asm__
@@ -171,7 +171,7 @@ namespace Ogre {
             "movl   %%ebx, %%edi    \n\t"
             "popl   %%ebx           \n\t"
             : "=a" (result._eax), "=D" (result._ebx), "=c" (result._ecx), "=d" (result._edx)
-            : "a" (query)
+            : "a" (query), "c" (subQuery)
         );
        #endif // OGRE_ARCHITECTURE_64
         return result._eax;
@@ -258,6 +258,60 @@ namespace Ogre {
 #endif
     }
 
+    //---------------------------------------------------------------------
+    // Returns the XCR0 register, i.e. the register states enabled by the operating system.
+    // Must only be called if CPUID reports OSXSAVE.
+    static uint64 _getEnabledRegisterStates(void)
+    {
+#if OGRE_COMPILER == OGRE_COMPILER_MSVC
+        return _xgetbv(0);
+#elif (OGRE_COMPILER == OGRE_COMPILER_GNUC || OGRE_COMPILER == OGRE_COMPILER_CLANG) && OGRE_PLATFORM != OGRE_PLATFORM_EMSCRIPTEN
+        uint32 eax, edx;
+        __asm__ __volatile__ (".byte 0x0f, 0x01, 0xd0" : "=a" (eax), "=d" (edx) : "c" (0)); // xgetbv
+        return (uint64(edx) << 32) | eax;
+#else
+        return 0;
+#endif
+    }
+    //---------------------------------------------------------------------
+    // Detect AVX, FMA, AVX2 and AVX-512F, which need both CPU and operating system support.
+    static uint _queryAvxFeatures(uint maxStandardFunction)
+    {
+        const uint CPUID_STD_FMA = 1 << 12;     // ECX[12] of standard function 1
+        const uint CPUID_STD_OSXSAVE = 1 << 27; // ECX[27] of standard function 1
+        const uint CPUID_STD_AVX = 1 << 28;     // ECX[28] of standard function 1
+        const uint CPUID_EXT7_AVX2 = 1 << 5;    // EBX[5] of function 7, sub-function 0
+        const uint CPUID_EXT7_AVX512F = 1 << 16;// EBX[16] of function 7, sub-function 0
+
+        const uint64 XSTATE_YMM = 0x6;          // SSE and AVX state
+        const uint64 XSTATE_ZMM = 0xE6;         // SSE, AVX, opmask and ZMM state
+
+        uint features = 0;
+        CpuidResult result;
+        _performCpuid(1, result);
+        if (!(result._ecx & CPUID_STD_OSXSAVE))
+            return features;
+
+        uint64 xcr0 = _getEnabledRegisterStates();
+        if ((xcr0 & XSTATE_YMM) != XSTATE_YMM || !(result._ecx & CPUID_STD_AVX))
+            return features;
+
+        features |= PlatformInformation::CPU_FEATURE_AVX;
+        if (result._ecx & CPUID_STD_FMA)
+            features |= PlatformInformation::CPU_FEATURE_FMA;
+
+        if (maxStandardFunction >= 7)
+        {
+            _performCpuid(7, result, 0);
+            if (result._ebx & CPUID_EXT7_AVX2)
+                features |= PlatformInformation::CPU_FEATURE_AVX2;
+            if ((result._ebx & CPUID_EXT7_AVX512F) && (xcr0 & XSTATE_ZMM) == XSTATE_ZMM)
+                features |= PlatformInformation::CPU_FEATURE_AVX512F;
+        }
+
+        return features;
+    }
+
     //---------------------------------------------------------------------
     // Compiler-independent routines
     //---------------------------------------------------------------------
@@ -305,8 +359,12 @@ namespace Ogre {
             if (_performCpuid(CPUID_FUNC_VENDOR_ID, result))
             {
                 // Check vendor strings
+                const uint maxStandardFunction = result._eax;
+
                 if (memcmp(&result._ebx, "GenuineIntel", 12) == 0)
                 {
+                    features |= _queryAvxFeatures(maxStandardFunction);
+
                     if (result._eax > 2)
                         features |= PlatformInformation::CPU_FEATURE_PRO;
 
@@ -353,6 +411,8 @@ namespace Ogre {
                 }
                 else if (memcmp(&result._ebx, "AuthenticAMD", 12) == 0)
                 {
+                    features |= _queryAvxFeatures(maxStandardFunction);
+
                     features |= PlatformInformation::CPU_FEATURE_PRO;
 
                     // Check standard feature
@@ -413,7 +473,11 @@ namespace Ogre {
             | PlatformInformation::CPU_FEATURE_SSE2
             | PlatformInformation::CPU_FEATURE_SSE3
             | PlatformInformation::CPU_FEATURE_SSE41
-            | PlatformInformation::CPU_FEATURE_SSE42;
+            | PlatformInformation::CPU_FEATURE_SSE42
+            | PlatformInformation::CPU_FEATURE_AVX
+            | PlatformInformation::CPU_FEATURE_AVX2
+            | PlatformInformation::CPU_FEATURE_FMA
+            | PlatformInformation::CPU_FEATURE_AVX512F;
 
         if ((features & sse_features) && !_checkOperatingSystemSupportSSE())
         {
@@ -687,6 +751,14 @@ namespace Ogre {
                 " *        SSE41: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_SSE41), true));
             pLog->logMessage(
                 " *        SSE42: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_SSE42), true));
+            pLog->logMessage(
+                " *          AVX: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_AVX), true));
+            pLog->logMessage(
+                " *         AVX2: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_AVX2), true));
+            pLog->logMessage(
+                " *          FMA: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_FMA), true));
+            pLog->logMessage(
+                " *      AVX512F: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_AVX512F), true));
             pLog->logMessage(
                 " *          MMX: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_MMX), true));
             pLog->logMessage(
@@ -28,7 +28,6 @@ THE SOFTWARE.
 #include "OgreStableHeaders.h"
 #include "OgreRenderQueueSortingGrouping.h"
 #include <algorithm>
-#include <unordered_map>
 
 namespace Ogre {
 namespace {
@@ -88,7 +87,34 @@ namespace {
             return static_cast<float>(- p.renderable->getSquaredViewDepth(camera));
         }
     };
+
+    /// Compact draw record used to state sort a pass group
+    struct DrawPacket
+    {
+        uint32 key;
+        Renderable* renderable;
+    };
+    typedef std::vector<DrawPacket> DrawPacketList;
+
+    /// Functor for accessing the state key of a draw packet for radix sort
+    struct DrawPacketFunctorKey
+    {
+        uint32 operator()(const DrawPacket& p) const
+        {
+            return p.key;
+        }
+    };
 }
+    //-----------------------------------------------------------------------
+    struct QueuedRenderableCollection::StateSortScratch
+    {
+        /// Radix sorter for the draw packets of a pass group
+        RadixSort<DrawPacketList, DrawPacket, uint32> packetSorter;
+        /// Kept around so recording does not allocate
+        DrawPacketList packets;
+        /// Open addressing table mapping geometry to dense ids
+        std::vector<std::pair<const void*, uint32>> geometryIds;
+    };
     //-----------------------------------------------------------------------
     RenderPriorityGroup::RenderPriorityGroup(RenderQueueGroup* parent, 
             bool splitPassesByLightingType,
@@ -105,6 +131,8 @@ namespace {
 
         // Transparents will always be sorted this way
         mTransparents.addOrganisationMode(QueuedRenderableCollection::OM_SORT_DESCENDING);
+        // Unsorted transparents blend in the order they were submitted
+        mTransparentsUnsorted.setStateSortEnabled(false);
 
         
     }
@@ -286,7 +314,11 @@ namespace {
     }
     //-----------------------------------------------------------------------
     QueuedRenderableCollection::QueuedRenderableCollection(void)
-        :mOrganisationMode(0)
+        :mOrganisationMode(0), mStateSortEnabled(true)
+    {
+    }
+    //-----------------------------------------------------------------------
+    QueuedRenderableCollection::~QueuedRenderableCollection()
     {
     }
 
@@ -353,27 +385,74 @@ namespace {
                     DistanceSortDescendingLess(cam));
             }
         }
-        else if (mOrganisationMode & OM_PASS_GROUP)
+        else if ((mOrganisationMode & OM_PASS_GROUP) && mStateSortEnabled)
         {
-            // cluster by submesh
-            for(auto& it : mGrouped)
+            if (!mStateSortScratch)
+                mStateSortScratch.reset(new StateSortScratch);
+            DrawPacketList& packets = mStateSortScratch->packets;
+            auto& geometryIds = mStateSortScratch->geometryIds;
+
+            // state sort: within a group the pass is already bound once, so order the
+            // renderables by the geometry they bind. Renderables sharing vertex data are
+            // drawn back to back and instanced batches of the same SubMesh stay contiguous
+            for (auto& it : mGrouped)
             {
-                auto instanced = it.first->hasVertexProgram() && it.first->getVertexProgram()->isInstancingIncluded();
-                if (!instanced)
+                RenderableList& rends = it.second;
+                if (rends.size() < 2)
                     continue;
 
-                std::unordered_map<SubMesh*, RenderableList> bySubMesh;
-                for (auto* rend : it.second)
-                {
-                    auto subEntity = dynamic_cast<SubEntity*>(rend);
-                    SubMesh* subMesh = subEntity ? subEntity->getSubMesh() : 0;
-                    bySubMesh[subMesh].push_back(rend);
-                }
-                it.second.clear();
-                for (auto& it2 : bySubMesh)
+                auto instanced = it.first->hasVertexProgram() && it.first->getVertexProgram()->isInstancingIncluded();
+
+                // record: translate each renderable into a compact key + packet. Keys are
+                // dense ids in order of first appearance, so they are exact and an
+                // already coherent group is detected without sorting
+                packets.clear();
+                size_t tableSize = Bitwise::firstPO2From(uint32(rends.size() * 2));
+                geometryIds.assign(tableSize, {NULL, 0});
+                uint32 numIds = 0;
+                bool needsSorting = false;
+                uint32 prevKey = 0;
+                RenderOperation op;
+                for (auto* rend : rends)
                 {
-                    it.second.insert(it.second.end(), it2.second.begin(), it2.second.end());
+                    const void* geometry = NULL;
+                    if (instanced)
+                    {
+                        // must match the batching in SceneManager, which goes by SubMesh
+                        auto subEntity = dynamic_cast<SubEntity*>(rend);
+                        geometry = subEntity ? subEntity->getSubMesh() : NULL;
+                    }
+                    else
+                    {
+                        rend->getRenderOperation(op);
+                        geometry = op.vertexData;
+                    }
+
+                    size_t slot = (size_t(geometry) >> 4) * 2654435761u;
+                    for (;; ++slot)
+                    {
+                        auto& entry = geometryIds[slot & (tableSize - 1)];
+                        if (entry.second && entry.first == geometry)
+                            break;
+                        if (!entry.second)
+                        {
+                            entry = {geometry, ++numIds};
+                            break;
+                        }
+                    }
+                    uint32 key = geometryIds[slot & (tableSize - 1)].second;
+                    needsSorting |= key < prevKey;
+                    prevKey = key;
+                    packets.push_back({key, rend});
                 }
+
+                if (!needsSorting)
+                    continue;
+
+                // sort and replay the packets into the group
+                mStateSortScratch->packetSorter.sort(packets, DrawPacketFunctorKey());
+                for (size_t i = 0; i < packets.size(); ++i)
+                    rends[i] = packets[i].renderable;
             }
         }
     }
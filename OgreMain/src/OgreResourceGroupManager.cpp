@@ -826,7 +826,8 @@ namespace Ogre {
                         if (mLoadingListener)
                             mLoadingListener->resourceStreamOpened(fii.filename, grp->name, 0, stream);
 
-                        if(fii.archive->getType() == "FileSystem" && stream->size() <= 1024 * 1024)
+                        if(fii.archive->getType() == "FileSystem" && stream->size() <= 1024 * 1024 &&
+                           !dynamic_cast<MemoryDataStream*>(stream.get()))
                         {
                             DataStreamPtr cachedCopy(OGRE_NEW MemoryDataStream(stream->getName(), stream));
                             su->parseScript(cachedCopy, grp->name);
@@ -51,6 +51,7 @@ THE SOFTWARE.
 #include "OgreFileSystemLayer.h"
 #include "OgreStaticGeometry.h"
 #include "OgreSceneManagerEnumerator.h"
+#include "OgreWorkStealingWorkQueue.h"
 
 #if OGRE_NO_DDS_CODEC == 0
 #include "OgreDDSCodec.h"
@@ -142,12 +143,23 @@ namespace Ogre {
         mResourceGroupManager = std::make_unique<ResourceGroupManager>();
 
         // WorkQueue (note: users can replace this if they want)
-        DefaultWorkQueue* defaultQ = OGRE_NEW DefaultWorkQueue("Root");
+        DefaultWorkQueueBase* defaultQ;
         // match threads to hardware
         int threadCount = OGRE_THREAD_HARDWARE_CONCURRENCY;
-        // but clamp it at 2 by default - we dont scale much beyond that currently
-        // yet it helps on android where it needlessly burns CPU
-        threadCount = Math::Clamp(threadCount, 1, 2);
+        const char* queueType = getenv("OGRE_WORK_QUEUE");
+        if (queueType && strcmp(queueType, "workstealing") == 0)
+        {
+            defaultQ = OGRE_NEW WorkStealingWorkQueue("Root");
+            // idle workers sleep, so leave only one core for the calling thread
+            threadCount = std::max(threadCount - 1, 1);
+        }
+        else
+        {
+            defaultQ = OGRE_NEW DefaultWorkQueue("Root");
+            // but clamp it at 2 by default - we dont scale much beyond that currently
+            // yet it helps on android where it needlessly burns CPU
+            threadCount = Math::Clamp(threadCount, 1, 2);
+        }
         defaultQ->setWorkerThreadCount(threadCount);
 
         // only allow workers to access rendersystem if threadsupport is 1
@@ -0,0 +1,284 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+#include "OgreStableHeaders.h"
+#include "OgreEntity.h"
+#include "OgreSkeletonInstance.h"
+#include "OgreAnimationState.h"
+
+namespace Ogre
+{
+SceneManager::SceneGraphUpdater::SceneGraphUpdater() : mNumLevels(0), mNodesPerTask(256), mEnabled(false) {}
+
+void SceneManager::SceneGraphUpdater::collect(SceneNode* node, bool parentHasChanged, size_t depth)
+{
+    if (mNumLevels == depth)
+    {
+        if (mLevels.size() == depth)
+            mLevels.emplace_back();
+        mLevels[depth].nodes.clear();
+        mLevels[depth].transformDirty.clear();
+        mNumLevels = depth + 1;
+    }
+
+    // mirrors the traversal of Node::_update
+    mLevels[depth].nodes.push_back(node);
+    mLevels[depth].transformDirty.push_back(node->mNeedParentUpdate || parentHasChanged);
+
+    node->mParentNotified = false;
+
+    if (node->mNeedChildUpdate || parentHasChanged)
+    {
+        for (auto child : node->mChildren)
+            collect(static_cast<SceneNode*>(child), true, depth + 1);
+    }
+    else
+    {
+        for (auto child : node->mChildrenToUpdate)
+            collect(static_cast<SceneNode*>(child), false, depth + 1);
+    }
+
+    node->mChildrenToUpdate.clear();
+    node->mNeedChildUpdate = false;
+}
+
+void SceneManager::SceneGraphUpdater::update(SceneNode* root)
+{
+    mNumLevels = 0;
+    collect(root, false, 0);
+
+    auto wq = Root::getSingleton().getWorkQueue();
+
+    // transforms top-down, a level only reads the derived transforms of the previous one
+    for (size_t d = 0; d < mNumLevels; ++d)
+    {
+        const Level& level = mLevels[d];
+        wq->parallelFor(0, level.nodes.size(), mNodesPerTask, [&level](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                SceneNode* node = level.nodes[i];
+                if (level.transformDirty[i])
+                    node->_updateFromParent();
+                // fill the lazily computed cache now, so children do not race on it
+                node->_getFullTransform();
+            }
+        });
+    }
+
+    // bounds bottom-up, a level only reads the world bounds of the next one
+    for (size_t d = mNumLevels; d-- > 0;)
+    {
+        const Level& level = mLevels[d];
+        wq->parallelFor(0, level.nodes.size(), mNodesPerTask, [&level](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+                level.nodes[i]->_updateBounds();
+        });
+    }
+}
+
+namespace
+{
+/// children whose world bounds are tested at once
+const size_t CULL_PACK_SIZE = 8;
+
+/// calls func for each child of node that is visible in frustum, in the order of the children
+template <typename F> void forEachVisibleChild(SceneNode* node, const Frustum& frustum, F func)
+{
+    const auto& children = node->getChildren();
+    for (size_t base = 0; base < children.size(); base += CULL_PACK_SIZE)
+    {
+        size_t count = std::min(CULL_PACK_SIZE, children.size() - base);
+
+        float minimum[3][CULL_PACK_SIZE], maximum[3][CULL_PACK_SIZE];
+        for (size_t i = 0; i < count; ++i)
+        {
+            // null and infinite boxes are resolved below, they only need a finite placeholder
+            const auto& box = static_cast<SceneNode*>(children[base + i])->_getWorldAABB();
+            const Vector3& min = box.isFinite() ? box.getMinimum() : Vector3::ZERO;
+            const Vector3& max = box.isFinite() ? box.getMaximum() : Vector3::ZERO;
+            for (int c = 0; c < 3; ++c)
+            {
+                minimum[c][i] = float(min[c]);
+                maximum[c][i] = float(max[c]);
+            }
+        }
+
+        const float* const minPtrs[3] = {minimum[0], minimum[1], minimum[2]};
+        const float* const maxPtrs[3] = {maximum[0], maximum[1], maximum[2]};
+        uint32 visibleMask = 0;
+        frustum.isVisible(minPtrs, maxPtrs, count, &visibleMask);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto child = static_cast<SceneNode*>(children[base + i]);
+            const auto& box = child->_getWorldAABB();
+            if (box.isInfinite() || (box.isFinite() && (visibleMask & (1u << i))))
+                func(child);
+        }
+    }
+}
+
+/// collects the visible nodes below the visible node in serial traversal order
+void cullSubtree(SceneNode* node, const Frustum& frustum, std::vector<SceneNode*>& visible)
+{
+    visible.push_back(node);
+    forEachVisibleChild(node, frustum, [&frustum, &visible](SceneNode* child) {
+        cullSubtree(child, frustum, visible);
+    });
+}
+} // namespace
+
+SceneManager::SceneGraphCuller::SceneGraphCuller() : mMinSubtrees(64), mSubtreesPerTask(16), mEnabled(false) {}
+
+void SceneManager::SceneGraphCuller::collect(SceneNode* node, const Frustum& frustum, size_t depth,
+                                             size_t splitDepth)
+{
+    if (depth == splitDepth)
+    {
+        mSequence.push_back({NULL, mSubtrees.size()});
+        mSubtrees.push_back(node);
+        return;
+    }
+
+    mSequence.push_back({node, 0});
+    forEachVisibleChild(node, frustum, [this, &frustum, depth, splitDepth](SceneNode* child) {
+        collect(child, frustum, depth + 1, splitDepth);
+    });
+}
+
+void SceneManager::SceneGraphCuller::processVisibleNode(SceneNode* node, Camera* cam, RenderQueue* queue,
+                                                        VisibleObjectsBoundsInfo* visibleBounds,
+                                                        bool onlyShadowCasters, DebugDrawer* debugDrawer)
+{
+    for (auto o : node->getAttachedObjects())
+        queue->processVisibleObject(o, cam, onlyShadowCasters, visibleBounds);
+
+    if (!debugDrawer)
+        return;
+
+    // the nodes arrive in pre-order, while a node is drawn after its children were processed
+    while (!mDrawStack.empty() && mDrawStack.back() != node->getParent())
+    {
+        debugDrawer->drawSceneNode(mDrawStack.back());
+        mDrawStack.pop_back();
+    }
+    mDrawStack.push_back(node);
+}
+
+void SceneManager::SceneGraphCuller::findVisibleObjects(SceneNode* root, Camera* cam, RenderQueue* queue,
+                                                        VisibleObjectsBoundsInfo* visibleBounds,
+                                                        bool onlyShadowCasters)
+{
+    // split at the first depth that provides enough subtrees to keep the workers busy
+    size_t splitDepth = 0;
+    mLevel.assign(1, root);
+    while (mLevel.size() < mMinSubtrees)
+    {
+        mNextLevel.clear();
+        for (auto node : mLevel)
+            for (auto child : node->getChildren())
+                mNextLevel.push_back(static_cast<SceneNode*>(child));
+
+        if (mNextLevel.empty())
+        {
+            // too small to be worth it
+            root->_findVisibleObjects(cam, queue, visibleBounds, true, false, onlyShadowCasters);
+            return;
+        }
+        std::swap(mLevel, mNextLevel);
+        splitDepth++;
+    }
+
+    // the frustum planes are updated lazily, so do that before the frustum is shared
+    const Frustum& frustum = cam->getCullingFrustum() ? *cam->getCullingFrustum() : *cam;
+    frustum.getFrustumPlane(FRUSTUM_PLANE_NEAR);
+
+    mSequence.clear();
+    mSubtrees.clear();
+    if (frustum.isVisible(root->_getWorldAABB()))
+        collect(root, frustum, 0, splitDepth);
+
+    if (mVisible.size() < mSubtrees.size())
+        mVisible.resize(mSubtrees.size());
+
+    auto wq = Root::getSingleton().getWorkQueue();
+    wq->parallelFor(0, mSubtrees.size(), mSubtreesPerTask, [this, &frustum](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            mVisible[i].clear();
+            cullSubtree(mSubtrees[i], frustum, mVisible[i]);
+        }
+    });
+
+    // the RenderQueue is not thread safe, so objects are added in serial traversal order here
+    DebugDrawer* debugDrawer = root->getCreator() ? root->getCreator()->getDebugDrawer() : NULL;
+    mDrawStack.clear();
+    for (const auto& e : mSequence)
+    {
+        if (e.node)
+        {
+            processVisibleNode(e.node, cam, queue, visibleBounds, onlyShadowCasters, debugDrawer);
+            continue;
+        }
+
+        for (auto node : mVisible[e.subtree])
+            processVisibleNode(node, cam, queue, visibleBounds, onlyShadowCasters, debugDrawer);
+    }
+
+    while (!mDrawStack.empty())
+    {
+        debugDrawer->drawSceneNode(mDrawStack.back());
+        mDrawStack.pop_back();
+    }
+}
+
+SceneManager::AnimationUpdater::AnimationUpdater() : mEnabled(false), mCollecting(false) {}
+
+void SceneManager::AnimationUpdater::update()
+{
+    mCollecting = false;
+    if (mEntities.empty())
+        return;
+
+    // Collect the skeleton instances to update. Shared instances and manually moved bones
+    // are left to Entity::updateAnimation, as their entities track the update differently.
+    unsigned long frameNumber = Root::getSingleton().getNextFrameNumber();
+    mSkeletonOwners.clear();
+    for (auto e : mEntities)
+    {
+        if (!e->mInitialised || !e->hasSkeleton() || e->sharesSkeletonInstance() ||
+            e->mSkeletonInstance->getManualBonesDirty() ||
+            e->mFrameAnimationLastUpdated == e->mAnimationState->getDirtyFrameNumber() ||
+            *e->mFrameBonesLastUpdated == frameNumber)
+            continue;
+
+        // build what the animations would otherwise build lazily while being applied
+        if (!e->mSkipAnimStateUpdates)
+        {
+            for (auto state : e->mAnimationState->getEnabledAnimationStates())
+            {
+                if (auto anim = e->mSkeletonInstance->_getAnimationImpl(state->getAnimationName()))
+                    anim->_prepareForApply();
+            }
+        }
+        mSkeletonOwners.push_back(e);
+    }
+
+    // an entity might have been queued twice
+    std::sort(mSkeletonOwners.begin(), mSkeletonOwners.end());
+    mSkeletonOwners.erase(std::unique(mSkeletonOwners.begin(), mSkeletonOwners.end()), mSkeletonOwners.end());
+
+    Root::getSingleton().getWorkQueue()->parallelFor(0, mSkeletonOwners.size(), 1,
+                                                     [this](size_t begin, size_t end) {
+                                                         for (size_t i = begin; i < end; i++)
+                                                             mSkeletonOwners[i]->cacheBoneMatrices();
+                                                     });
+
+    // the bone matrices are up to date now, so this only collects the software skinning
+    for (auto e : mEntities)
+        e->updateAnimation(&mBlendBatch);
+
+    mBlendBatch.run();
+    mEntities.clear();
+}
+} // namespace Ogre
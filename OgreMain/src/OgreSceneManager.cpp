@@ -1063,8 +1063,10 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
 
             // Parse the scene and tag visibles
             firePreFindVisibleObjects(vp);
+            mAnimationUpdater.mCollecting = mAnimationUpdater.mEnabled;
             _findVisibleObjects(camera, &(camVisObjIt->second),
                 mIlluminationStage == IRS_RENDER_TO_TEXTURE? true : false);
+            mAnimationUpdater.update();
             firePostFindVisibleObjects(vp);
 
             mAutoParamDataSource->setMainCamBoundsInfo(&(camVisObjIt->second));
@@ -1271,7 +1273,10 @@ void SceneManager::_updateSceneGraph(Camera* cam)
     // In this implementation, just update from the root
     // Smarter SceneManager subclasses may choose to update only
     //   certain scene graph branches
-    getRootSceneNode()->_update(true, false);
+    if (mSceneGraphUpdater.mEnabled)
+        mSceneGraphUpdater.update(getRootSceneNode());
+    else
+        getRootSceneNode()->_update(true, false);
 
     firePostUpdateSceneGraph(cam);
 }
@@ -1279,6 +1284,13 @@ void SceneManager::_updateSceneGraph(Camera* cam)
 void SceneManager::_findVisibleObjects(
     Camera* cam, VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters)
 {
+    if (mSceneGraphCuller.mEnabled)
+    {
+        mSceneGraphCuller.findVisibleObjects(getRootSceneNode(), cam, getRenderQueue(), visibleBounds,
+                                             onlyShadowCasters);
+        return;
+    }
+
     // Tell nodes to find, cascade down all nodes
     getRootSceneNode()->_findVisibleObjects(cam, getRenderQueue(), visibleBounds, true,
         mDisplayNodes, onlyShadowCasters);
@@ -3238,6 +3250,7 @@ MovableObject* SceneManager::createMovableObject(const String& name,
 
         MovableObject* newObj = factory->createInstance(name, this, params);
         objectMap->map[name] = newObj;
+        mSceneQueryTree.markDirty();
         return newObj;
     }
 
@@ -3269,6 +3282,7 @@ void SceneManager::destroyMovableObject(const String& name, const String& typeNa
         {
             factory->destroyInstance(mi->second);
             objectMap->map.erase(mi);
+            mSceneQueryTree.markDirty();
         }
     }
 }
@@ -3296,6 +3310,7 @@ void SceneManager::destroyAllMovableObjectsByType(const String& typeName)
             }
         }
         objectMap->map.clear();
+        mSceneQueryTree.markDirty();
     }
 }
 //---------------------------------------------------------------------
@@ -3325,6 +3340,7 @@ void SceneManager::destroyAllMovableObjects(void)
         }
         coll->map.clear();
     }
+    mSceneQueryTree.markDirty();
 }
 //---------------------------------------------------------------------
 MovableObject* SceneManager::getMovableObject(const String& name, const String& typeName) const
@@ -3399,6 +3415,7 @@ void SceneManager::injectMovableObject(MovableObject* m)
             OGRE_LOCK_MUTEX(objectMap->mutex);
 
         objectMap->map[m->getName()] = m;
+        mSceneQueryTree.markDirty();
     }
 }
 //---------------------------------------------------------------------
@@ -3412,6 +3429,7 @@ void SceneManager::extractMovableObject(const String& name, const String& typeNa
         {
             // no delete
             objectMap->map.erase(mi);
+            mSceneQueryTree.markDirty();
         }
     }
 
@@ -3429,6 +3447,7 @@ void SceneManager::extractAllMovableObjectsByType(const String& typeName)
             OGRE_LOCK_MUTEX(objectMap->mutex);
         // no deletion
         objectMap->map.clear();
+        mSceneQueryTree.markDirty();
     }
 }
 //---------------------------------------------------------------------
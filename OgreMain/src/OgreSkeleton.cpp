@@ -203,16 +203,11 @@ namespace Ogre {
             // tolerate state entries for animations we're not aware of
             if (anim)
             {
-              if(animState->hasBlendMask())
-              {
-                anim->apply(this, animState->getTimePosition(), animState->getWeight() * weightFactor,
-                  animState->getBlendMask(), linked ? linked->scale : 1.0f);
-              }
-              else
-              {
-                anim->apply(this, animState->getTimePosition(), 
-                  animState->getWeight() * weightFactor, linked ? linked->scale : 1.0f);
-              }
+                // continue the keyframe search where the previous update found it
+                TimeIndex timeIndex = anim->_getTimeIndex(animState->getTimePosition(), animState->_getKeyIndexHint());
+                anim->apply(this, timeIndex, animState->getWeight() * weightFactor,
+                            animState->hasBlendMask() ? animState->getBlendMask() : NULL,
+                            linked ? linked->scale : 1.0f);
             }
         }
 
@@ -415,11 +410,7 @@ namespace Ogre {
             Also note we combine scale as equivalent axes, no shearing.
         */
 
-        for (auto *b : mBoneList)
-        {
-            b->_getOffsetTransform(*pMatrices);
-            pMatrices++;
-        }
+        Bone::_getOffsetTransforms(mBoneList.data(), mBoneList.size(), pMatrices);
 
     }
     //---------------------------------------------------------------------
@@ -118,6 +118,7 @@ void SceneManager::SkyPlaneRenderer::create(
 
     MovableObjectCollection* objectMap = mSceneManager->getMovableObjectCollection(MOT_ENTITY);
     objectMap->map[meshName] = mSkyPlaneEntity;
+    mSceneManager->mSceneQueryTree.markDirty();
 
     // Create node and attach
     mSceneNode = mSceneManager->createSceneNode();
@@ -259,6 +260,7 @@ void SceneManager::SkyDomeRenderer::create(
 
         MovableObjectCollection* objectMap = mSceneManager->getMovableObjectCollection(MOT_ENTITY);
         objectMap->map[entName] = mSkyDomeEntity[i];
+        mSceneManager->mSceneQueryTree.markDirty();
 
         // Attach to node
         mSceneNode->attachObject(mSkyDomeEntity[i]);
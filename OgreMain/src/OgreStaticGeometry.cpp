@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "OgreStaticGeometry.h"
 #include "OgreEdgeListBuilder.h"
 #include "OgreLodStrategy.h"
+#include "OgreTriangleTree.h"
 
 namespace Ogre {
 
@@ -666,6 +667,26 @@ namespace Ogre {
         return RegionIterator(mRegionMap.begin(), mRegionMap.end());
     }
     //--------------------------------------------------------------------------
+    RayTestResult StaticGeometry::raycast(const Ray& ray, Region** region)
+    {
+        RayTestResult result(false, 0);
+        for (const auto& r : mRegionMap)
+        {
+            RayTestResult bounds = ray.intersects(r.second->getWorldBoundingBox(true));
+            if (!bounds.first || (result.first && bounds.second > result.second))
+                continue;
+
+            RayTestResult hit = r.second->raycast(ray);
+            if (hit.first && (!result.first || hit.second < result.second))
+            {
+                result = hit;
+                if (region)
+                    *region = r.second;
+            }
+        }
+        return result;
+    }
+    //--------------------------------------------------------------------------
     //--------------------------------------------------------------------------
     StaticGeometry::Region::Region(StaticGeometry* parent, const String& name,
         SceneManager* mgr, uint32 regionID, const Vector3& centre)
@@ -841,6 +862,28 @@ namespace Ogre {
         return mBoundingRadius;
     }
     //--------------------------------------------------------------------------
+    RayTestResult StaticGeometry::Region::raycast(const Ray& ray)
+    {
+        RayTestResult result(false, 0);
+        if (mLodBucketList.empty())
+            return result;
+
+        Affine3 invTransform = _getParentNodeFullTransform().inverse();
+        // the direction is not normalised, so distances remain in world units
+        Ray localRay(invTransform * ray.getOrigin(), invTransform.linear() * ray.getDirection());
+
+        for (const auto& m : mLodBucketList[0]->getMaterialBuckets())
+        {
+            for (auto* geom : m.second->getGeometryList())
+            {
+                RayTestResult hit = geom->_getTriangleTree().intersects(localRay);
+                if (hit.first && (!result.first || hit.second < result.second))
+                    result = hit;
+            }
+        }
+        return result;
+    }
+    //--------------------------------------------------------------------------
     void StaticGeometry::Region::_updateRenderQueue(RenderQueue* queue)
     {
         mLodBucketList[mCurrentLod]->addRenderables(queue, mRenderQueueID,
@@ -1369,6 +1412,16 @@ namespace Ogre {
         return mParent->getParent()->getParent()->getCastShadows();
     }
     //--------------------------------------------------------------------------
+    const TriangleTree& StaticGeometry::GeometryBucket::_getTriangleTree()
+    {
+        if (!mTriangleTree)
+        {
+            mTriangleTree.reset(new TriangleTree());
+            mTriangleTree->build(mVertexData, mIndexData);
+        }
+        return *mTriangleTree;
+    }
+    //--------------------------------------------------------------------------
     bool StaticGeometry::GeometryBucket::assign(QueuedGeometry* qgeom)
     {
         // Do we have enough space?
@@ -26,12 +26,13 @@ THE SOFTWARE.
 -----------------------------------------------------------------------------
 */
 #include "OgreStableHeaders.h"
+#include "OgreTriangleTree.h"
 
 namespace Ogre {
     //-----------------------------------------------------------------------
     SubEntity::SubEntity (Entity* parent, SubMesh* subMeshBasis)
         : Renderable(), mParentEntity(parent),
-        mSubMesh(subMeshBasis), mCachedCamera(0)
+        mSubMesh(subMeshBasis), mCachedCamera(0), mAnimatedTriangleTreeFrame(0)
     {
         mVisible = true;
         mRenderQueueID = 0;
@@ -116,6 +117,52 @@ namespace Ogre {
         mIndexEnd = 0;
     }
     //-----------------------------------------------------------------------
+    const TriangleTree& SubEntity::getTriangleTree(void)
+    {
+        Entity* entity = mParentEntity;
+        VertexData* animatedData = NULL;
+        bool softwareAnimation =
+            !entity->isHardwareAnimationEnabled() || entity->getSoftwareAnimationRequests() > 0;
+        if (softwareAnimation && entity->_isAnimated())
+        {
+            entity->_updateAnimation();
+            bool shared = mSubMesh->useSharedVertices;
+            if (entity->hasSkeleton())
+            {
+                // includes any morph animation, which is applied first
+                animatedData = shared ? entity->mSkelAnimVertexData.get() : mSkelAnimVertexData.get();
+            }
+            else if (shared ? entity->getMesh()->getSharedVertexDataAnimationType() != VAT_NONE
+                            : mSubMesh->getVertexAnimationType() != VAT_NONE)
+            {
+                animatedData = shared ? entity->mSoftwareVertexAnimVertexData.get()
+                                      : mSoftwareVertexAnimVertexData.get();
+            }
+        }
+
+        if (!animatedData)
+            return mSubMesh->_getTriangleTree();
+
+        // rebuilt at most once per frame
+        unsigned long frame = Root::getSingleton().getNextFrameNumber();
+        if (!mAnimatedTriangleTree || mAnimatedTriangleTreeFrame != frame)
+        {
+            if (!mAnimatedTriangleTree)
+                mAnimatedTriangleTree.reset(new TriangleTree());
+            mAnimatedTriangleTree->build(animatedData, mSubMesh->indexData, mSubMesh->operationType);
+            mAnimatedTriangleTreeFrame = frame;
+        }
+        return *mAnimatedTriangleTree;
+    }
+    //-----------------------------------------------------------------------
+    RayTestResult SubEntity::raycast(const Ray& ray, size_t* triangle)
+    {
+        Affine3 invTransform = mParentEntity->_getParentNodeFullTransform().inverse();
+        // the direction is not normalised, so distances remain in world units
+        Ray localRay(invTransform * ray.getOrigin(), invTransform.linear() * ray.getDirection());
+        return getTriangleTree().intersects(localRay, triangle);
+    }
+    //-----------------------------------------------------------------------
     VertexData* SubEntity::getVertexDataForBinding(void)
     {
         if (mSubMesh->useSharedVertices)
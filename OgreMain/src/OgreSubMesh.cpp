@@ -26,6 +26,7 @@ THE SOFTWARE.
 -----------------------------------------------------------------------------
 */
 #include "OgreStableHeaders.h"
+#include "OgreTriangleTree.h"
 
 namespace Ogre {
     //-----------------------------------------------------------------------
@@ -395,6 +396,17 @@ namespace Ogre {
         }
         return newSub;
     }
+    //-----------------------------------------------------------------------
+    const TriangleTree& SubMesh::_getTriangleTree()
+    {
+        if (!mTriangleTree)
+        {
+            mTriangleTree.reset(new TriangleTree());
+            mTriangleTree->build(useSharedVertices ? parent->sharedVertexData : vertexData, indexData,
+                                 operationType);
+        }
+        return *mTriangleTree;
+    }
 }
 
 
@@ -0,0 +1,503 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+#include "OgreStableHeaders.h"
+#include "OgreTriangleTree.h"
+
+namespace Ogre
+{
+    namespace
+    {
+        const size_t NUM_BINS = 16;
+        /// deeper nodes are made leaves, so the traversal stack can not overflow
+        const size_t MAX_DEPTH = 48;
+        const size_t MAX_BATCHES = 0xFFFF;
+        /// cost of visiting an inner node relative to testing a batch of triangles
+        const Real TRAVERSAL_COST = 0.5f;
+        /// same as Math::intersects
+        const Real DET_EPSILON = 1e-6f;
+
+        size_t getNumBatches(size_t count) { return (count + ARRAY_PACKED_REALS - 1) / ARRAY_PACKED_REALS; }
+
+        Real getHalfArea(const Vector3& size) { return size.x * size.y + size.y * size.z + size.z * size.x; }
+
+        /// slab test of a single ray against the box of a node
+        bool intersectsBox(const float* min, const float* max, const Vector3& origin, const Vector3& invDir,
+                        Real maxDist)
+        {
+            Real tmin = 0, tmax = maxDist;
+            for (int i = 0; i < 3; ++i)
+            {
+                Real t0 = (min[i] - origin[i]) * invDir[i];
+                Real t1 = (max[i] - origin[i]) * invDir[i];
+                // NaN, i.e. an origin on the slab of a zero direction, leaves the interval unchanged
+                tmin = std::max(tmin, std::min(t0, t1));
+                tmax = std::min(tmax, std::max(t0, t1));
+            }
+            return tmin <= tmax;
+        }
+    }
+
+    struct TriangleTree::BuildTriangle
+    {
+        Vector3 v[3];
+        Vector3 min, max, centroid;
+        uint32 index;
+    };
+
+    TriangleTree::TriangleTree() : mNumTriangles(0) {}
+
+    void TriangleTree::clear()
+    {
+        mNodes.clear();
+        mBatches.clear();
+        mNumTriangles = 0;
+    }
+
+    void TriangleTree::build(const VertexData* vertexData, const IndexData* indexData,
+                             RenderOperation::OperationType opType)
+    {
+        std::vector<Vector3> positions;
+        std::vector<uint32> indices;
+
+        bool triangles = opType == RenderOperation::OT_TRIANGLE_LIST ||
+                         opType == RenderOperation::OT_TRIANGLE_STRIP ||
+                         opType == RenderOperation::OT_TRIANGLE_FAN;
+        if (!triangles || !vertexData || vertexData->vertexCount == 0)
+        {
+            clear();
+            return;
+        }
+
+        const VertexElement* posElem = vertexData->vertexDeclaration->findElementBySemantic(VES_POSITION);
+        OgreAssert(posElem && posElem->getType() == VET_FLOAT3, "positions must be of type VET_FLOAT3");
+
+        const HardwareVertexBufferSharedPtr& vbuf = vertexData->vertexBufferBinding->getBuffer(posElem->getSource());
+        size_t vertexSize = vbuf->getVertexSize();
+        positions.resize(vertexData->vertexCount);
+        {
+            HardwareBufferLockGuard vertexLock(vbuf, vertexData->vertexStart * vertexSize,
+                                               vertexData->vertexCount * vertexSize,
+                                               HardwareBuffer::HBL_READ_ONLY);
+            uchar* vertex = static_cast<uchar*>(vertexLock.pData);
+            for (auto& p : positions)
+            {
+                float* pFloat;
+                posElem->baseVertexPointerToElement(vertex, &pFloat);
+                p = Vector3(pFloat[0], pFloat[1], pFloat[2]);
+                vertex += vertexSize;
+            }
+        }
+
+        // the vertices in the order they are drawn
+        std::vector<uint32> vertices;
+        if (indexData && indexData->indexBuffer && indexData->indexCount > 0)
+        {
+            const HardwareIndexBufferSharedPtr& ibuf = indexData->indexBuffer;
+            vertices.resize(indexData->indexCount);
+            HardwareBufferLockGuard indexLock(ibuf, indexData->indexStart * ibuf->getIndexSize(),
+                                              indexData->indexCount * ibuf->getIndexSize(),
+                                              HardwareBuffer::HBL_READ_ONLY);
+            if (ibuf->getType() == HardwareIndexBuffer::IT_32BIT)
+                std::copy_n(static_cast<uint32*>(indexLock.pData), vertices.size(), vertices.begin());
+            else
+                std::copy_n(static_cast<uint16*>(indexLock.pData), vertices.size(), vertices.begin());
+        }
+        else
+        {
+            vertices.resize(vertexData->vertexCount);
+            for (uint32 i = 0; i < vertices.size(); ++i)
+                vertices[i] = i;
+        }
+
+        switch (opType)
+        {
+        case RenderOperation::OT_TRIANGLE_STRIP:
+            for (size_t i = 2; i < vertices.size(); ++i)
+            {
+                // the winding does not matter, as the triangles are two sided
+                indices.push_back(vertices[i - 2]);
+                indices.push_back(vertices[i - 1]);
+                indices.push_back(vertices[i]);
+            }
+            break;
+        case RenderOperation::OT_TRIANGLE_FAN:
+            for (size_t i = 2; i < vertices.size(); ++i)
+            {
+                indices.push_back(vertices[0]);
+                indices.push_back(vertices[i - 1]);
+                indices.push_back(vertices[i]);
+            }
+            break;
+        default:
+            vertices.resize(vertices.size() - vertices.size() % 3);
+            indices.swap(vertices);
+            break;
+        }
+
+        build(positions, indices);
+    }
+
+    void TriangleTree::build(const std::vector<Vector3>& positions, const std::vector<uint32>& indices)
+    {
+        std::vector<BuildTriangle> triangles(indices.size() / 3);
+        for (size_t i = 0; i < triangles.size(); ++i)
+        {
+            BuildTriangle& tri = triangles[i];
+            for (int j = 0; j < 3; ++j)
+            {
+                uint32 index = indices[i * 3 + j];
+                OgreAssert(index < positions.size(), "index out of range");
+                tri.v[j] = positions[index];
+            }
+            tri.min = tri.v[0];
+            tri.min.makeFloor(tri.v[1]);
+            tri.min.makeFloor(tri.v[2]);
+            tri.max = tri.v[0];
+            tri.max.makeCeil(tri.v[1]);
+            tri.max.makeCeil(tri.v[2]);
+            tri.centroid = (tri.min + tri.max) * 0.5f;
+            tri.index = uint32(i);
+        }
+
+        build(triangles);
+    }
+
+    void TriangleTree::build(std::vector<BuildTriangle>& triangles)
+    {
+        clear();
+        if (triangles.empty())
+            return;
+
+        mNumTriangles = triangles.size();
+        // estimate for mostly full leaves
+        mNodes.reserve(2 * getNumBatches(triangles.size()));
+        mBatches.reserve(getNumBatches(triangles.size()));
+        buildNode(triangles.data(), triangles.size(), 0);
+    }
+
+    void TriangleTree::buildNode(BuildTriangle* triangles, size_t count, size_t depth)
+    {
+        Vector3 min(Math::POS_INFINITY), max(Math::NEG_INFINITY);
+        Vector3 cmin(Math::POS_INFINITY), cmax(Math::NEG_INFINITY);
+        for (size_t i = 0; i < count; ++i)
+        {
+            min.makeFloor(triangles[i].min);
+            max.makeCeil(triangles[i].max);
+            cmin.makeFloor(triangles[i].centroid);
+            cmax.makeCeil(triangles[i].centroid);
+        }
+
+        size_t nodeIndex = mNodes.size();
+        mNodes.push_back(Node());
+        {
+            // enlarge slightly, so rounding in the slab test does not miss triangles on the faces
+            Vector3 pad = (max - min) * 1e-5f + Vector3(1e-6f);
+            Node& node = mNodes.back();
+            for (int i = 0; i < 3; ++i)
+            {
+                node.min[i] = min[i] - pad[i];
+                node.max[i] = max[i] + pad[i];
+            }
+            node.offset = 0;
+            node.numBatches = 0;
+            node.axis = 0;
+        }
+
+        size_t numBatches = getNumBatches(count);
+        bool leaf = count <= ARRAY_PACKED_REALS || depth >= MAX_DEPTH;
+
+        // find the split with the lowest surface area cost over the bins of all axes
+        int bestAxis = -1;
+        size_t bestSplit = 0;
+        Real bestCost = Math::POS_INFINITY;
+        Vector3 binScale = Vector3::ZERO;
+        if (!leaf)
+        {
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                Real extent = cmax[axis] - cmin[axis];
+                if (extent <= 0)
+                    continue;
+                binScale[axis] = NUM_BINS * (1 - 1e-5f) / extent;
+
+                size_t binCount[NUM_BINS] = {};
+                Vector3 binMin[NUM_BINS], binMax[NUM_BINS];
+                std::fill_n(binMin, NUM_BINS, Vector3(Math::POS_INFINITY));
+                std::fill_n(binMax, NUM_BINS, Vector3(Math::NEG_INFINITY));
+                for (size_t i = 0; i < count; ++i)
+                {
+                    size_t bin = size_t((triangles[i].centroid[axis] - cmin[axis]) * binScale[axis]);
+                    binCount[bin]++;
+                    binMin[bin].makeFloor(triangles[i].min);
+                    binMax[bin].makeCeil(triangles[i].max);
+                }
+
+                // sweep from the right to get the cost of all splits
+                Real rightArea[NUM_BINS];
+                size_t rightCount[NUM_BINS];
+                Vector3 rmin(Math::POS_INFINITY), rmax(Math::NEG_INFINITY);
+                size_t n = 0;
+                for (size_t bin = NUM_BINS - 1; bin > 0; --bin)
+                {
+                    rmin.makeFloor(binMin[bin]);
+                    rmax.makeCeil(binMax[bin]);
+                    n += binCount[bin];
+                    rightCount[bin] = n;
+                    rightArea[bin] = n ? getHalfArea(rmax - rmin) : 0;
+                }
+
+                Vector3 lmin(Math::POS_INFINITY), lmax(Math::NEG_INFINITY);
+                n = 0;
+                for (size_t split = 1; split < NUM_BINS; ++split)
+                {
+                    lmin.makeFloor(binMin[split - 1]);
+                    lmax.makeCeil(binMax[split - 1]);
+                    n += binCount[split - 1];
+                    if (n == 0 || rightCount[split] == 0)
+                        continue;
+                    Real cost = getHalfArea(lmax - lmin) * getNumBatches(n) +
+                                rightArea[split] * getNumBatches(rightCount[split]);
+                    if (cost < bestCost)
+                    {
+                        bestCost = cost;
+                        bestAxis = axis;
+                        bestSplit = split;
+                    }
+                }
+            }
+
+            Real area = getHalfArea(max - min);
+            bool fitsLeaf = numBatches <= MAX_BATCHES;
+            if (bestAxis < 0)
+                leaf = fitsLeaf;
+            else if (fitsLeaf && area > 0 && TRAVERSAL_COST + bestCost / area >= numBatches)
+                leaf = true;
+        }
+
+        if (leaf)
+        {
+            OgreAssert(numBatches <= MAX_BATCHES, "too many triangles with the same centroid");
+            Node& node = mNodes[nodeIndex];
+            node.offset = uint32(mBatches.size());
+            node.numBatches = uint16(numBatches);
+
+            for (size_t b = 0; b < numBatches; ++b)
+            {
+                TriangleBatch batch;
+                for (size_t lane = 0; lane < ARRAY_PACKED_REALS; ++lane)
+                {
+                    size_t i = b * ARRAY_PACKED_REALS + lane;
+                    // unused lanes hold degenerate triangles, which are never hit
+                    Vector3 v0 = Vector3::ZERO, e1 = Vector3::ZERO, e2 = Vector3::ZERO;
+                    batch.index[lane] = ~uint32(0);
+                    if (i < count)
+                    {
+                        v0 = triangles[i].v[0];
+                        e1 = triangles[i].v[1] - v0;
+                        e2 = triangles[i].v[2] - v0;
+                        batch.index[lane] = triangles[i].index;
+                    }
+                    for (int j = 0; j < 3; ++j)
+                    {
+                        batch.v0[j][lane] = v0[j];
+                        batch.e1[j][lane] = e1[j];
+                        batch.e2[j][lane] = e2[j];
+                    }
+                }
+                mBatches.push_back(batch);
+            }
+            return;
+        }
+
+        BuildTriangle* mid;
+        if (bestAxis >= 0)
+        {
+            Real offset = cmin[bestAxis], scale = binScale[bestAxis];
+            mid = std::partition(triangles, triangles + count, [=](const BuildTriangle& t) {
+                return size_t((t.centroid[bestAxis] - offset) * scale) < bestSplit;
+            });
+        }
+        else
+        {
+            // all centroids are equal, but there are too many triangles for a leaf
+            mid = triangles + count / 2;
+            bestAxis = 0;
+        }
+
+        mNodes[nodeIndex].axis = uint16(bestAxis);
+        buildNode(triangles, mid - triangles, depth + 1);
+        mNodes[nodeIndex].offset = uint32(mNodes.size());
+        buildNode(mid, triangles + count - mid, depth + 1);
+    }
+
+    void TriangleTree::intersects(const TriangleBatch& batch, const Ray& ray, RayTestResult& hit,
+                                  size_t& triangle) const
+    {
+        using namespace ArrayMath;
+
+        ArrayVector3 dir(ray.getDirection());
+        ArrayVector3 e1(load(batch.e1[0]), load(batch.e1[1]), load(batch.e1[2]));
+        ArrayVector3 e2(load(batch.e2[0]), load(batch.e2[1]), load(batch.e2[2]));
+        ArrayVector3 p = dir.crossProduct(e2);
+        ArrayReal det = e1.dotProduct(p);
+        ArrayReal valid = cmpGreater(ArrayMath::abs(det), set1(DET_EPSILON));
+        if (!any(valid))
+            return;
+
+        ArrayReal zero = set1(0), one = set1(1);
+        ArrayReal invDet = div(one, select(valid, det, one));
+
+        ArrayVector3 t = ArrayVector3(ray.getOrigin()) -
+                         ArrayVector3(load(batch.v0[0]), load(batch.v0[1]), load(batch.v0[2]));
+        ArrayReal u = mul(t.dotProduct(p), invDet);
+        ArrayVector3 q = t.crossProduct(e1);
+        ArrayReal v = mul(dir.dotProduct(q), invDet);
+        ArrayReal dist = mul(e2.dotProduct(q), invDet);
+
+        // masks are combined with select, valid = valid && !outside
+        ArrayReal maxDist = set1(hit.first ? hit.second : Math::POS_INFINITY);
+        ArrayReal outside = cmpLess(u, zero);
+        outside = select(outside, outside, cmpLess(v, zero));
+        outside = select(outside, outside, cmpGreater(add(u, v), one));
+        outside = select(outside, outside, cmpLess(dist, zero));
+        outside = select(outside, outside, cmpLess(maxDist, dist));
+        valid = select(outside, zero, valid);
+        if (!any(valid))
+            return;
+
+        Real mask[ARRAY_PACKED_REALS], distances[ARRAY_PACKED_REALS];
+        store(mask, valid);
+        store(distances, dist);
+        for (size_t i = 0; i < ARRAY_PACKED_REALS; ++i)
+        {
+            // mask lanes are either all bits or 1 depending on the implementation
+            if (mask[i] != 0 && (!hit.first || distances[i] < hit.second))
+            {
+                hit = RayTestResult(true, distances[i]);
+                triangle = batch.index[i];
+            }
+        }
+    }
+
+    RayTestResult TriangleTree::intersects(const Ray& ray, size_t* triangle) const
+    {
+        RayTestResult hit(false, 0);
+        if (mNodes.empty())
+            return hit;
+
+        const Vector3& origin = ray.getOrigin();
+        Vector3 invDir = 1 / ray.getDirection();
+        size_t hitTriangle = 0;
+
+        uint32 stack[MAX_DEPTH + 2];
+        size_t size = 0;
+        stack[size++] = 0;
+        while (size > 0)
+        {
+            uint32 index = stack[--size];
+            const Node& node = mNodes[index];
+            if (!intersectsBox(node.min, node.max, origin, invDir, hit.first ? hit.second : Math::POS_INFINITY))
+                continue;
+
+            if (node.numBatches > 0)
+            {
+                for (uint32 b = node.offset; b < node.offset + node.numBatches; ++b)
+                    intersects(mBatches[b], ray, hit, hitTriangle);
+                continue;
+            }
+
+            // visit the child on the side of the ray origin first
+            uint32 nearChild = index + 1, farChild = node.offset;
+            if (ray.getDirection()[node.axis] < 0)
+                std::swap(nearChild, farChild);
+            stack[size++] = farChild;
+            stack[size++] = nearChild;
+        }
+
+        if (hit.first && triangle)
+            *triangle = hitTriangle;
+        return hit;
+    }
+
+    void TriangleTree::intersects(const Ray* rays, size_t count, RayTestResult* results) const
+    {
+        using namespace ArrayMath;
+
+        std::fill_n(results, count, RayTestResult(false, 0));
+        if (mNodes.empty())
+            return;
+
+        ArrayReal zero = set1(0);
+        ArrayReal trueMask = cmpLess(zero, set1(1));
+
+        for (size_t first = 0; first < count; first += ARRAY_PACKED_REALS)
+        {
+            size_t numRays = std::min(ARRAY_PACKED_REALS, count - first);
+            const Ray* packet = rays + first;
+            RayTestResult* hits = results + first;
+
+            // unused lanes repeat the last ray
+            Vector3 origins[ARRAY_PACKED_REALS], invDirs[ARRAY_PACKED_REALS];
+            Real maxDist[ARRAY_PACKED_REALS];
+            for (size_t i = 0; i < ARRAY_PACKED_REALS; ++i)
+            {
+                const Ray& ray = packet[std::min(i, numRays - 1)];
+                origins[i] = ray.getOrigin();
+                invDirs[i] = 1 / ray.getDirection();
+                maxDist[i] = i < numRays ? Math::POS_INFINITY : -1;
+            }
+            ArrayVector3 origin, invDir;
+            origin.loadPacked(origins);
+            invDir.loadPacked(invDirs);
+            ArrayReal originAxis[3] = {origin.x, origin.y, origin.z};
+            ArrayReal invDirAxis[3] = {invDir.x, invDir.y, invDir.z};
+
+            size_t triangle;
+            uint32 stack[MAX_DEPTH + 2];
+            size_t size = 0;
+            stack[size++] = 0;
+            while (size > 0)
+            {
+                uint32 index = stack[--size];
+                const Node& node = mNodes[index];
+
+                // slab test of all rays against the node
+                ArrayReal tmin = zero, tmax = load(maxDist);
+                for (int i = 0; i < 3; ++i)
+                {
+                    ArrayReal t0 = mul(sub(set1(node.min[i]), originAxis[i]), invDirAxis[i]);
+                    ArrayReal t1 = mul(sub(set1(node.max[i]), originAxis[i]), invDirAxis[i]);
+                    tmin = ArrayMath::max(tmin, ArrayMath::min(t0, t1));
+                    tmax = ArrayMath::min(tmax, ArrayMath::max(t0, t1));
+                }
+                ArrayReal active = select(cmpGreater(tmin, tmax), zero, trueMask);
+                if (!any(active))
+                    continue;
+
+                if (node.numBatches > 0)
+                {
+                    Real mask[ARRAY_PACKED_REALS];
+                    store(mask, active);
+                    for (size_t i = 0; i < numRays; ++i)
+                    {
+                        if (mask[i] == 0)
+                            continue;
+                        for (uint32 b = node.offset; b < node.offset + node.numBatches; ++b)
+                            intersects(mBatches[b], packet[i], hits[i], triangle);
+                        if (hits[i].first)
+                            maxDist[i] = hits[i].second;
+                    }
+                    continue;
+                }
+
+                // order the children for the first ray, assuming the rays are coherent
+                uint32 nearChild = index + 1, farChild = node.offset;
+                if (packet[0].getDirection()[node.axis] < 0)
+                    std::swap(nearChild, farChild);
+                stack[size++] = farChild;
+                stack[size++] = nearChild;
+            }
+        }
+    }
+}
@@ -29,7 +29,76 @@ THE SOFTWARE.
 #include "OgreWorkQueue.h"
 #include "OgreTimer.h"
 
+#if OGRE_THREAD_SUPPORT
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#endif
+
 namespace Ogre {
+#if OGRE_THREAD_SUPPORT
+    namespace
+    {
+        /// range split into chunks that the calling thread and the workers pull from
+        struct ParallelRange
+        {
+            std::atomic<size_t> next;
+            std::atomic<size_t> done;
+            size_t begin;
+            size_t count;
+            size_t grain;
+            std::function<void(size_t, size_t)> func;
+            std::mutex mutex;
+            std::condition_variable finished;
+
+            ParallelRange(size_t b, size_t n, size_t g, const std::function<void(size_t, size_t)>& f)
+                : next(0), done(0), begin(b), count(n), grain(g), func(f)
+            {
+            }
+
+            void run()
+            {
+                size_t first;
+                while ((first = next.fetch_add(grain)) < count)
+                {
+                    size_t last = std::min(first + grain, count);
+                    func(begin + first, begin + last);
+                    if (done.fetch_add(last - first) + (last - first) == count)
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        finished.notify_all();
+                    }
+                }
+            }
+        };
+    }
+#endif
+    //---------------------------------------------------------------------
+    void WorkQueue::parallelFor(size_t begin, size_t end, size_t grain,
+                                const std::function<void(size_t, size_t)>& func)
+    {
+        grain = std::max<size_t>(grain, 1);
+        size_t count = end > begin ? end - begin : 0;
+#if OGRE_THREAD_SUPPORT
+        size_t numChunks = (count + grain - 1) / grain;
+        size_t numHelpers = numChunks > 1 ? std::min(getWorkerThreadCount(), numChunks - 1) : 0;
+        if (numHelpers)
+        {
+            // the calling thread participates, so this completes even if all workers are busy
+            auto range = std::make_shared<ParallelRange>(begin, count, grain, func);
+            for (size_t i = 0; i < numHelpers; ++i)
+                addTask([range]() { range->run(); });
+            range->run();
+
+            std::unique_lock<std::mutex> lock(range->mutex);
+            range->finished.wait(lock, [&range]() { return range->done == range->count; });
+            return;
+        }
+#endif
+        for (size_t first = 0; first < count; first += grain)
+            func(begin + first, begin + std::min(first + grain, count));
+    }
+    //---------------------------------------------------------------------
     void WorkQueue::processMainThreadTasks()
     {
         OGRE_IGNORE_DEPRECATED_BEGIN
@@ -116,6 +185,20 @@ namespace Ogre {
             << "DefaultWorkQueueBase('" << mName << "') - QUEUED(thread:" << OGRE_THREAD_CURRENT_ID << ")";
     }
     //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::parallelFor(size_t begin, size_t end, size_t grain,
+                                           const std::function<void(size_t, size_t)>& func)
+    {
+        // nobody would pick up the helper tasks otherwise
+        if (!mIsRunning)
+        {
+            grain = std::max<size_t>(grain, 1);
+            for (size_t first = begin; first < end; first += grain)
+                func(first, std::min(first + grain, end));
+            return;
+        }
+        WorkQueue::parallelFor(begin, end, grain, func);
+    }
+    //---------------------------------------------------------------------
     void DefaultWorkQueueBase::setPaused(bool pause)
     {
             OGRE_WQ_LOCK_MUTEX(mRequestMutex);
@@ -184,4 +267,89 @@ namespace Ogre {
             }
         }
     }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    TaskGraph::TaskID TaskGraph::addTask(std::function<void()> task)
+    {
+        mTasks.push_back({std::move(task), {}, 0});
+        return mTasks.size() - 1;
+    }
+    //---------------------------------------------------------------------
+    void TaskGraph::addDependency(TaskID task, TaskID dependency)
+    {
+        OgreAssert(task < mTasks.size() && dependency < mTasks.size(), "invalid TaskID");
+        mTasks[dependency].successors.push_back(task);
+        mTasks[task].numDependencies++;
+    }
+    //---------------------------------------------------------------------
+    void TaskGraph::run(WorkQueue* queue)
+    {
+        size_t numTasks = mTasks.size();
+
+        // dependencies which are not finished yet
+        std::vector<size_t> remaining(numTasks);
+        std::vector<TaskID> ready;
+        for (TaskID id = 0; id < numTasks; ++id)
+        {
+            remaining[id] = mTasks[id].numDependencies;
+            if (!remaining[id])
+                ready.push_back(id);
+        }
+
+        size_t numFinished = 0;
+#if OGRE_THREAD_SUPPORT
+        size_t numParticipants = queue ? std::min(queue->getWorkerThreadCount() + 1, numTasks) : 1;
+        if (numParticipants > 1)
+        {
+            std::mutex mutex;
+            std::condition_variable changed;
+            size_t numRunning = 0;
+
+            queue->parallelFor(0, numParticipants, 1, [&](size_t, size_t) {
+                std::unique_lock<std::mutex> lock(mutex);
+                while (true)
+                {
+                    // running tasks might make further ones ready
+                    changed.wait(lock, [&]() { return !ready.empty() || !numRunning; });
+                    if (ready.empty())
+                        break;
+
+                    TaskID id = ready.back();
+                    ready.pop_back();
+                    numRunning++;
+
+                    lock.unlock();
+                    mTasks[id].func();
+                    lock.lock();
+
+                    numRunning--;
+                    numFinished++;
+                    for (auto succ : mTasks[id].successors)
+                    {
+                        if (!--remaining[succ])
+                            ready.push_back(succ);
+                    }
+                    changed.notify_all();
+                }
+            });
+
+            OgreAssert(numFinished == numTasks, "TaskGraph contains a cycle");
+            return;
+        }
+#endif
+        while (!ready.empty())
+        {
+            TaskID id = ready.back();
+            ready.pop_back();
+
+            mTasks[id].func();
+            numFinished++;
+            for (auto succ : mTasks[id].successors)
+            {
+                if (!--remaining[succ])
+                    ready.push_back(succ);
+            }
+        }
+        OgreAssert(numFinished == numTasks, "TaskGraph contains a cycle");
+    }
 }
@@ -0,0 +1,407 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+#include "OgreStableHeaders.h"
+#include "OgreWorkStealingWorkQueue.h"
+
+#include <thread>
+
+namespace Ogre
+{
+namespace
+{
+typedef std::function<void()> Task;
+
+/// the deque owned by the calling thread
+struct ThreadDeque
+{
+    const WorkStealingWorkQueue* queue;
+    uint32 generation;
+    size_t index;
+};
+thread_local ThreadDeque tlsDeque = {NULL, 0, 0};
+
+std::atomic<uint32> gNextGeneration(1);
+} // namespace
+
+/** Chase-Lev deque, only the owning thread pushes and takes at the bottom, any thread steals
+    at the top.
+*/
+class WorkStealingWorkQueue::TaskDeque
+{
+    struct Array
+    {
+        int64 capacity;
+        std::unique_ptr<std::atomic<Task*>[]> tasks;
+
+        explicit Array(int64 c) : capacity(c), tasks(new std::atomic<Task*>[c]) {}
+        Task* get(int64 i) const { return tasks[i & (capacity - 1)].load(std::memory_order_relaxed); }
+        void put(int64 i, Task* t) { tasks[i & (capacity - 1)].store(t, std::memory_order_relaxed); }
+    };
+
+    std::atomic<int64> mTop;
+    std::atomic<int64> mBottom;
+    std::atomic<Array*> mArray;
+    /// grown arrays, thieves might still read from them until the deque is destroyed
+    std::vector<std::unique_ptr<Array>> mArrays;
+
+public:
+    TaskDeque() : mTop(0), mBottom(0)
+    {
+        mArrays.emplace_back(new Array(64));
+        mArray = mArrays.back().get();
+    }
+
+    void push(Task* task)
+    {
+        int64 b = mBottom.load(std::memory_order_relaxed);
+        int64 t = mTop.load(std::memory_order_acquire);
+        Array* a = mArray.load(std::memory_order_relaxed);
+        if (b - t > a->capacity - 1)
+        {
+            Array* grown = new Array(a->capacity * 2);
+            for (int64 i = t; i < b; ++i)
+                grown->put(i, a->get(i));
+            mArrays.emplace_back(grown);
+            mArray.store(grown, std::memory_order_release);
+            a = grown;
+        }
+        a->put(b, task);
+        std::atomic_thread_fence(std::memory_order_release);
+        mBottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    Task* take()
+    {
+        int64 b = mBottom.load(std::memory_order_relaxed) - 1;
+        Array* a = mArray.load(std::memory_order_relaxed);
+        mBottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64 t = mTop.load(std::memory_order_relaxed);
+
+        if (t > b)
+        {
+            // empty
+            mBottom.store(b + 1, std::memory_order_relaxed);
+            return NULL;
+        }
+
+        Task* task = a->get(b);
+        if (t == b)
+        {
+            // last one, race against thieves
+            if (!mTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                task = NULL;
+            mBottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return task;
+    }
+
+    Task* steal()
+    {
+        int64 t = mTop.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64 b = mBottom.load(std::memory_order_acquire);
+        if (t >= b)
+            return NULL;
+
+        Array* a = mArray.load(std::memory_order_acquire);
+        Task* task = a->get(t);
+        if (!mTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return NULL; // lost against another thief or the owner
+        return task;
+    }
+};
+//---------------------------------------------------------------------
+struct WorkStealingWorkQueue::TaskGroup::State
+{
+    WorkStealingWorkQueue* queue;
+    /// unfinished tasks, plus one while the group is open
+    std::atomic<size_t> count;
+    std::function<void()> continuation;
+
+    State(WorkStealingWorkQueue* q) : queue(q), count(1) {}
+
+    void release()
+    {
+        if (count.fetch_sub(1) == 1 && continuation)
+            queue->addTask(std::move(continuation));
+    }
+};
+//---------------------------------------------------------------------
+WorkStealingWorkQueue::TaskGroup::TaskGroup(WorkStealingWorkQueue* queue)
+    : mQueue(queue), mState(std::make_shared<State>(queue)), mOpen(true)
+{
+}
+//---------------------------------------------------------------------
+WorkStealingWorkQueue::TaskGroup::~TaskGroup() { wait(); }
+//---------------------------------------------------------------------
+void WorkStealingWorkQueue::TaskGroup::run(std::function<void()> task)
+{
+    OgreAssert(mOpen, "no tasks can be added after then()");
+    mState->count++;
+    auto state = mState;
+    mQueue->addTask([state, task = std::move(task)]() {
+        task();
+        state->release();
+    });
+}
+//---------------------------------------------------------------------
+void WorkStealingWorkQueue::TaskGroup::wait()
+{
+    size_t target = mOpen ? 1 : 0;
+    while (mState->count > target)
+    {
+        // help instead of blocking, the tasks might not even be picked up otherwise
+        if (!mQueue->_processPendingTask())
+            std::this_thread::yield();
+    }
+}
+//---------------------------------------------------------------------
+void WorkStealingWorkQueue::TaskGroup::then(std::function<void()> continuation)
+{
+    OgreAssert(mOpen, "then() was already called");
+    mOpen = false;
+    mState->continuation = std::move(continuation);
+    mState->release();
+}
+//---------------------------------------------------------------------
+//---------------------------------------------------------------------
+WorkStealingWorkQueue::WorkStealingWorkQueue(const String& name)
+    : DefaultWorkQueueBase(name), mNumPending(0), mNumSleeping(0), mGeneration(0), mNumThreadsRegisteredWithRS(0)
+{
+}
+//---------------------------------------------------------------------
+WorkStealingWorkQueue::~WorkStealingWorkQueue() { shutdown(); }
+//---------------------------------------------------------------------
+void WorkStealingWorkQueue::startup(bool forceRestart)
+{
+    if (mIsRunning)
+    {
+        if (forceRestart)
+            shutdown();
+        else
+            return;
+    }
+
+    mShuttingDown = false;
+
+    LogManager::getSingleton().stream() << "WorkStealingWorkQueue('" << mName << "') initialising on thread "
+                                        << OGRE_THREAD_CURRENT_ID << ".";
+
+#if OGRE_THREAD_SUPPORT
+    mGeneration = gNextGeneration++;
+
+    // one deque per worker, plus one for the calling thread
+    for (size_t i = 0; i <= mWorkerThreadCount; ++i)
+        mDeques.push_back(new TaskDeque());
+    tlsDeque = {this, mGeneration, 0};
+
+    if (mWorkerRenderSystemAccess)
+        Root::getSingleton().getRenderSystem()->preExtraThreadsStarted();
+
+    mNumThreadsRegisteredWithRS = 0;
+    for (size_t i = 0; i < mWorkerThreadCount; ++i)
+    {
+        ThreadDeque owned = {this, mGeneration, i + 1};
+        auto worker = [this, owned]() {
+            tlsDeque = owned;
+            _threadMain();
+        };
+        OGRE_THREAD_CREATE(t, worker);
+        mWorkers.push_back(t);
+    }
+
+    if (mWorkerRenderSystemAccess)
+    {
+        OGRE_WQ_LOCK_MUTEX_NAMED(mInitMutex, initLock);
+        // have to wait until all threads are registered with the render system
+        while (mNumThreadsRegisteredWithRS < mWorkerThreadCount)
+            OGRE_THREAD_WAIT(mInitSync, mInitMutex, initLock);
+
+        Root::getSingleton().getRenderSystem()->postExtraThreadsStarted();
+    }
+#endif
+
+    mIsRunning = true;
+}
+//---------------------------------------------------------------------
+void WorkStealingWorkQueue::notifyThreadRegistered()
+{
+    OGRE_WQ_LOCK_MUTEX(mInitMutex);
+
+    ++mNumThreadsRegisteredWithRS;
+
+    // wake up main thread
+    OGRE_THREAD_NOTIFY_ALL(mInitSync);
+}
+//---------------------------------------------------------------------
+void WorkStealingWorkQueue::shutdown()
+{
+    if (!mIsRunning)
+        return;
+
+    LogManager::getSingleton().stream() << "WorkStealingWorkQueue('" << mName << "') shutting down on thread "
+                                        << OGRE_THREAD_CURRENT_ID << ".";
+
+#if OGRE_THREAD_SUPPORT
+    {
+        OGRE_WQ_LOCK_MUTEX(mSleepMutex);
+        mShuttingDown = true;
+        OGRE_THREAD_NOTIFY_ALL(mWakeCondition);
+    }
+
+    for (auto w : mWorkers)
+    {
+        w->join();
+        OGRE_THREAD_DESTROY(w);
+    }
+    mWorkers.clear();
+
+    // keep the tasks that were not processed yet for the next startup
+    mGeneration = 0;
+    for (auto deque : mDeques)
+    {
+        while (Task* task = deque->take())
+        {
+            mTasks.push_back(std::move(*task));
+            delete task;
+        }
+        delete deque;
+    }
+    mDeques.clear();
+#else
+    mShuttingDown = true;
+#endif
+
+    mIsRunning = false;
+}
+//---------------------------------------------------------------------
+WorkStealingWorkQueue::TaskDeque* WorkStealingWorkQueue::getThreadDeque() const
+{
+    if (tlsDeque.queue == this && tlsDeque.generation == mGeneration && mGeneration)
+        return mDeques[tlsDeque.index];
+    return NULL;
+}
+//---------------------------------------------------------------------
+void WorkStealingWorkQueue::addTask(std::function<void()> task)
+{
+    if (!mAcceptRequests || mShuttingDown)
+        return;
+
+#if OGRE_THREAD_SUPPORT
+    if (TaskDeque* deque = getThreadDeque())
+    {
+        deque->push(new Task(std::move(task)));
+    }
+    else
+    {
+        OGRE_WQ_LOCK_MUTEX(mRequestMutex);
+        mTasks.push_back(std::move(task));
+    }
+    mNumPending++;
+    notifyWorkers();
+#else
+    task(); // no threading, just run it
+#endif
+}
+//---------------------------------------------------------------------
+void WorkStealingWorkQueue::notifyWorkers()
+{
+    // only take the lock if somebody is actually waiting
+    if (mNumSleeping)
+    {
+        OGRE_WQ_LOCK_MUTEX(mSleepMutex);
+        OGRE_THREAD_NOTIFY_ONE(mWakeCondition);
+    }
+}
+//---------------------------------------------------------------------
+bool WorkStealingWorkQueue::_processPendingTask()
+{
+    if (!mNumPending)
+        return false;
+
+    std::unique_ptr<Task> task;
+
+    // own tasks first, most recent one is the most likely to be in cache
+    size_t numDeques = mDeques.size();
+    size_t self = numDeques;
+    if (TaskDeque* deque = getThreadDeque())
+    {
+        self = tlsDeque.index;
+        task.reset(deque->take());
+    }
+
+    // then steal the oldest task of somebody else
+    for (size_t i = 1; !task && i <= numDeques; ++i)
+    {
+        size_t victim = (self + i) % numDeques;
+        if (victim != self)
+            task.reset(mDeques[victim]->steal());
+    }
+
+    if (!task)
+    {
+        OGRE_WQ_LOCK_MUTEX(mRequestMutex);
+        if (mTasks.empty())
+            return false;
+        task.reset(new Task(std::move(mTasks.front())));
+        mTasks.pop_front();
+    }
+
+    mNumPending--;
+    (*task)();
+    return true;
+}
+//---------------------------------------------------------------------
+void WorkStealingWorkQueue::_processNextRequest() { _processPendingTask(); }
+//---------------------------------------------------------------------
+void WorkStealingWorkQueue::parallelFor(size_t begin, size_t end, size_t grain,
+                                        const std::function<void(size_t, size_t)>& func)
+{
+    grain = std::max<size_t>(grain, 1);
+
+    TaskGroup group(this);
+    for (size_t b = begin + grain; b < end; b += grain)
+    {
+        size_t e = std::min(b + grain, end);
+        group.run([&func, b, e]() { func(b, e); });
+    }
+
+    // the calling thread takes the first range
+    if (begin < end)
+        func(begin, std::min(begin + grain, end));
+    group.wait();
+}
+//---------------------------------------------------------------------
+void WorkStealingWorkQueue::_threadMain()
+{
+#if OGRE_THREAD_SUPPORT
+    LogManager::getSingleton().stream() << "WorkStealingWorkQueue('" << getName() << "')::WorkerFunc - thread "
+                                        << OGRE_THREAD_CURRENT_ID << " starting.";
+
+    // Initialise the thread for RS if necessary
+    if (mWorkerRenderSystemAccess)
+    {
+        Root::getSingleton().getRenderSystem()->registerThread();
+        notifyThreadRegistered();
+    }
+
+    while (!isShuttingDown())
+    {
+        if (_processPendingTask())
+            continue;
+
+        // nothing left, sleep until a task is added
+        OGRE_WQ_LOCK_MUTEX_NAMED(mSleepMutex, sleepLock);
+        mNumSleeping++;
+        while (!mNumPending && !mShuttingDown)
+            OGRE_THREAD_WAIT(mWakeCondition, mSleepMutex, sleepLock);
+        mNumSleeping--;
+    }
+
+    LogManager::getSingleton().stream() << "WorkStealingWorkQueue('" << getName() << "')::WorkerFunc - thread "
+                                        << OGRE_THREAD_CURRENT_ID << " stopped.";
+#endif
+}
+} // namespace Ogre
@@ -29,9 +29,35 @@ THE SOFTWARE.
 
 #if OGRE_NO_ZIP_ARCHIVE == 0
 #include <zip.h>
+#include <shared_mutex>
+#include "OgreDeflate.h"
 
 namespace Ogre {
 namespace {
+    bool gStreamCompressedEntries = false;
+
+    /// Stream on an entry stored in the archive buffer, which it keeps alive
+    class ZipEntryDataStream : public MemoryDataStream
+    {
+        MemoryDataStreamPtr mArchiveBuffer;
+    public:
+        ZipEntryDataStream(const String& name, const MemoryDataStreamPtr& buffer, size_t offset, size_t size)
+            : MemoryDataStream(name, buffer->getPtr() + offset, size, false, true), mArchiveBuffer(buffer)
+        {
+        }
+    };
+
+    /// Stream inflating a deflated entry while it is read
+    class ZipInflateDataStream : public DeflateStream
+    {
+    public:
+        ZipInflateDataStream(const String& name, const DataStreamPtr& compressedStream, size_t size)
+            : DeflateStream(name, compressedStream, DeflateStream::Deflate)
+        {
+            mSize = size;
+        }
+    };
+
     class ZipArchive : public Archive
     {
     protected:
@@ -40,7 +66,25 @@ namespace {
         MemoryDataStreamPtr mBuffer;
         /// File list (since zziplib seems to only allow scanning of dir tree once)
         FileInfoList mFileList;
+        /// Map from FileInfo::filename to the position in mFileList, which is also the zip entry index
+        std::unordered_map<String, size_t> mFileIndex;
+        /// Compression method and offset of the data in mBuffer, for entries that can be read directly
+        std::vector<std::pair<uint16, size_t>> mEntryData;
+#if !OGRE_RESOURCEMANAGER_STRICT
+        /// Lower case entry paths and basenames of the files, SIZE_MAX for ambiguous basenames
+        std::unordered_map<String, size_t> mLowerCaseIndex, mBasenameIndex;
+#endif
+        /// Zip handles that are not in use. Each open() uses its own handle, so entries
+        /// can be decompressed concurrently
+        mutable std::vector<zip_t*> mReaders;
         OGRE_AUTO_MUTEX;
+        /// Guards the index and buffer against unload(), lookups only take it shared
+        mutable std::shared_timed_mutex mIndexMutex;
+
+        std::pair<uint16, size_t> getEntryData(size_t compressedSize) const;
+        size_t findEntry(const String& filename) const;
+        zip_t* acquireReader() const;
+        void releaseReader(zip_t* reader) const;
     public:
         ZipArchive(const String& name, const String& archType, const uint8* externBuf = 0, size_t externBufSz = 0);
         ~ZipArchive();
@@ -97,11 +141,17 @@ namespace {
     //-----------------------------------------------------------------------
     void ZipArchive::load()
     {
-        OGRE_LOCK_AUTO_MUTEX;
+        std::unique_lock<std::shared_timed_mutex> lock(mIndexMutex);
         if (!mZipFile)
         {
             if(!mBuffer)
-                mBuffer.reset(new MemoryDataStream(_openFileStream(mName, std::ios::binary)));
+            {
+                auto stream = _openFileStream(mName, std::ios::binary);
+                // use the file mapping directly, if there is one
+                mBuffer = std::dynamic_pointer_cast<MemoryDataStream>(stream);
+                if (!mBuffer)
+                    mBuffer.reset(new MemoryDataStream(stream));
+            }
 
             mZipFile = zip_stream_open((const char*)mBuffer->getPtr(), mBuffer->size(), 0, 'r');
 
@@ -135,7 +185,23 @@ namespace {
                     info.filename = info.basename;
                 }
 #endif
+                mEntryData.push_back(getEntryData(info.compressedSize));
                 zip_entry_close(mZipFile);
+                mFileIndex.emplace(info.filename, mFileList.size());
+#if !OGRE_RESOURCEMANAGER_STRICT
+                if (info.compressedSize != size_t(-1))
+                {
+                    String lowerCasePath = info.path + info.basename;
+                    StringUtil::toLowerCase(lowerCasePath);
+                    mLowerCaseIndex.emplace(lowerCasePath, mFileList.size());
+
+                    String lowerCaseBasename = info.basename;
+                    StringUtil::toLowerCase(lowerCaseBasename);
+                    auto it = mBasenameIndex.emplace(lowerCaseBasename, mFileList.size());
+                    if (!it.second)
+                        it.first->second = SIZE_MAX;
+                }
+#endif
                 mFileList.push_back(info);
             }
         }
@@ -143,65 +209,145 @@ namespace {
     //-----------------------------------------------------------------------
     void ZipArchive::unload()
     {
-        OGRE_LOCK_AUTO_MUTEX;
+        // no lookup is in progress, so neither are the readers in use
+        std::unique_lock<std::shared_timed_mutex> lock(mIndexMutex);
         if (mZipFile)
         {
             zip_close(mZipFile);
             mZipFile = 0;
+            for (auto reader : mReaders)
+                zip_close(reader);
+            mReaders.clear();
             mFileList.clear();
+            mFileIndex.clear();
+            mEntryData.clear();
+#if !OGRE_RESOURCEMANAGER_STRICT
+            mLowerCaseIndex.clear();
+            mBasenameIndex.clear();
+#endif
             mBuffer.reset();
         }
     
     }
     //-----------------------------------------------------------------------
-    DataStreamPtr ZipArchive::open(const String& filename, bool readOnly) const
+    std::pair<uint16, size_t> ZipArchive::getEntryData(size_t compressedSize) const
+    {
+        // see the zip APPNOTE for the local file header layout
+        const size_t LOCAL_HEADER_SIZE = 30;
+        const uint8* data = mBuffer->getPtr();
+        size_t size = mBuffer->size();
+        size_t headerOffset = zip_entry_header_offset(mZipFile);
+        if (compressedSize == size_t(-1) || size < LOCAL_HEADER_SIZE || headerOffset > size - LOCAL_HEADER_SIZE ||
+            memcmp(data + headerOffset, "PK\3\4", 4) != 0)
+            return std::make_pair(uint16(-1), 0);
+
+        auto readUint16 = [](const uint8* p) { return uint16(p[0] | (p[1] << 8)); };
+        uint16 flags = readUint16(data + headerOffset + 6);
+        uint16 method = readUint16(data + headerOffset + 8);
+        size_t offset = headerOffset + LOCAL_HEADER_SIZE + readUint16(data + headerOffset + 26) +
+                        readUint16(data + headerOffset + 28);
+
+        // encrypted entries need the zip library
+        if ((flags & 1) || offset > size || compressedSize > size - offset)
+            return std::make_pair(uint16(-1), 0);
+
+        return std::make_pair(method, offset);
+    }
+    //-----------------------------------------------------------------------
+    size_t ZipArchive::findEntry(const String& filename) const
     {
-        // zip is not threadsafe
-        OGRE_LOCK_AUTO_MUTEX;
-        String lookUpFileName = filename;
-
 #if OGRE_RESOURCEMANAGER_STRICT
-        bool open = zip_entry_opencasesensitive(mZipFile, lookUpFileName.c_str()) == 0;
+        auto it = mFileIndex.find(filename);
+        if (it != mFileIndex.end() && mFileList[it->second].compressedSize != size_t(-1))
+            return it->second;
 #else
-        bool open = zip_entry_open(mZipFile, lookUpFileName.c_str()) == 0;
-        if (!open) // Try if we find the file
+        String lookUpFileName = filename;
+        StringUtil::toLowerCase(lookUpFileName);
+        auto it = mLowerCaseIndex.find(lookUpFileName);
+        if (it != mLowerCaseIndex.end())
+            return it->second;
+
+        // Try if we find the file, unless there are more files with the same name
+        String basename, path;
+        StringUtil::splitFilename(lookUpFileName, basename, path);
+        it = mBasenameIndex.find(basename);
+        if (it != mBasenameIndex.end())
+            return it->second;
+#endif
+        return SIZE_MAX;
+    }
+    //-----------------------------------------------------------------------
+    zip_t* ZipArchive::acquireReader() const
+    {
         {
-            String basename, path;
-            StringUtil::splitFilename(lookUpFileName, basename, path);
-            const FileInfoListPtr fileNfo = findFileInfo(basename, true);
-            if (fileNfo->size() == 1) // If there are more files with the same do not open anyone
+            OGRE_LOCK_AUTO_MUTEX;
+            if (!mReaders.empty())
             {
-                Ogre::FileInfo info = fileNfo->at(0);
-                lookUpFileName = info.path + info.basename;
-                open = zip_entry_open(mZipFile, lookUpFileName.c_str()) == 0;
+                zip_t* reader = mReaders.back();
+                mReaders.pop_back();
+                return reader;
             }
         }
-#endif
 
-        if (!open)
+        // zip is not threadsafe, but independent handles on the same buffer are
+        return zip_stream_open((const char*)mBuffer->getPtr(), mBuffer->size(), 0, 'r');
+    }
+    //-----------------------------------------------------------------------
+    void ZipArchive::releaseReader(zip_t* reader) const
+    {
+        zip_entry_close(reader);
+        OGRE_LOCK_AUTO_MUTEX;
+        mReaders.push_back(reader);
+    }
+    //-----------------------------------------------------------------------
+    DataStreamPtr ZipArchive::open(const String& filename, bool readOnly) const
+    {
+        std::shared_lock<std::shared_timed_mutex> lock(mIndexMutex);
+        size_t index = findEntry(filename);
+        if (index == SIZE_MAX)
         {
-            OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND, "could not open "+lookUpFileName);
+            OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND, "could not open "+filename);
         }
 
+        const FileInfo& info = mFileList[index];
+        const String lookUpFileName = info.path + info.basename;
+
         // Construct & return stream
-        size_t entrySize = zip_entry_size(mZipFile);
-        size_t compSize  = zip_entry_comp_size(mZipFile);
+        size_t entrySize = info.uncompressedSize;
+        size_t compSize  = info.compressedSize;
         // repetitive log files have a typical ratio of ~50:1, XML 30:1, images 5:1
         const size_t MAX_RATIO = 100;
         if ((entrySize > 0 && (compSize == 0 || entrySize / compSize > MAX_RATIO)) || compSize > mBuffer->size())
         {
-            zip_entry_close(mZipFile);
             OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
                         "zip entry has suspicious compression ratio (possible decompression bomb): " + lookUpFileName);
         }
+
+        const auto& entryData = mEntryData[index];
+        const uint16 STORED = 0, DEFLATED = 8;
+        if (entryData.first == STORED && compSize == entrySize)
+        {
+            // no need to copy what is already in memory
+            return std::make_shared<ZipEntryDataStream>(lookUpFileName, mBuffer, entryData.second, entrySize);
+        }
+
+        if (entryData.first == DEFLATED && gStreamCompressedEntries)
+        {
+            auto compressed = std::make_shared<ZipEntryDataStream>(lookUpFileName, mBuffer, entryData.second, compSize);
+            return std::make_shared<ZipInflateDataStream>(lookUpFileName, compressed, entrySize);
+        }
+
         auto ret = std::make_shared<MemoryDataStream>(lookUpFileName, entrySize, true, true);
 
-        if(zip_entry_noallocread(mZipFile, ret->getPtr(), ret->size()) < 0)
+        zip_t* reader = acquireReader();
+        bool read = zip_entry_openbyindex(reader, index) == 0 &&
+                    zip_entry_noallocread(reader, ret->getPtr(), ret->size()) >= 0;
+        releaseReader(reader);
+
+        if(!read)
         {
-            zip_entry_close(mZipFile);
             OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND, "could not read "+lookUpFileName);
         }
-        zip_entry_close(mZipFile);
 
         return ret;
     }
@@ -218,7 +364,7 @@ namespace {
     //-----------------------------------------------------------------------
     StringVectorPtr ZipArchive::list(bool recursive, bool dirs) const
     {
-        OGRE_LOCK_AUTO_MUTEX;
+        std::shared_lock<std::shared_timed_mutex> lock(mIndexMutex);
         auto ret = std::make_shared<StringVector>();
 
         for (auto& f : mFileList)
@@ -231,7 +377,7 @@ namespace {
     //-----------------------------------------------------------------------
     FileInfoListPtr ZipArchive::listFileInfo(bool recursive, bool dirs) const
     {
-        OGRE_LOCK_AUTO_MUTEX;
+        std::shared_lock<std::shared_timed_mutex> lock(mIndexMutex);
         auto ret = std::make_shared<FileInfoList>();
         for (auto& f : mFileList)
             if ((dirs == (f.compressedSize == size_t (-1))) &&
@@ -243,7 +389,7 @@ namespace {
     //-----------------------------------------------------------------------
     StringVectorPtr ZipArchive::find(const String& pattern, bool recursive, bool dirs) const
     {
-        OGRE_LOCK_AUTO_MUTEX;
+        std::shared_lock<std::shared_timed_mutex> lock(mIndexMutex);
         auto ret = std::make_shared<StringVector>();
         // If pattern contains a directory name, do a full match
         bool full_match = (pattern.find ('/') != String::npos) ||
@@ -264,7 +410,7 @@ namespace {
     FileInfoListPtr ZipArchive::findFileInfo(const String& pattern, 
         bool recursive, bool dirs) const
     {
-        OGRE_LOCK_AUTO_MUTEX;
+        std::shared_lock<std::shared_timed_mutex> lock(mIndexMutex);
         auto ret = std::make_shared<FileInfoList>();
         // If pattern contains a directory name, do a full match
         bool full_match = (pattern.find ('/') != String::npos) ||
@@ -284,7 +430,7 @@ namespace {
     //-----------------------------------------------------------------------
     bool ZipArchive::exists(const String& filename) const
     {       
-        OGRE_LOCK_AUTO_MUTEX;
+        std::shared_lock<std::shared_timed_mutex> lock(mIndexMutex);
         String cleanName = filename;
 #if !OGRE_RESOURCEMANAGER_STRICT
         if(filename.rfind('/') != String::npos)
@@ -294,9 +440,7 @@ namespace {
         }
 #endif
 
-        return std::find_if(mFileList.begin(), mFileList.end(), [&cleanName](const Ogre::FileInfo& fi) {
-                   return fi.filename == cleanName;
-               }) != mFileList.end();
+        return mFileIndex.find(cleanName) != mFileIndex.end();
     }
     //---------------------------------------------------------------------
     time_t ZipArchive::getModifiedTime(const String& filename) const
@@ -333,6 +477,16 @@ namespace {
         return name;
     }
     //-----------------------------------------------------------------------
+    void ZipArchiveFactory::setStreamCompressedEntries(bool stream)
+    {
+        gStreamCompressedEntries = stream;
+    }
+    //-----------------------------------------------------------------------
+    bool ZipArchiveFactory::getStreamCompressedEntries()
+    {
+        return gStreamCompressedEntries;
+    }
+    //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
     //  EmbeddedZipArchiveFactory
     //-----------------------------------------------------------------------
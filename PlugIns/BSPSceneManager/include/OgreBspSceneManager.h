@@ -176,6 +176,8 @@ namespace Ogre {
         SceneNode * createSceneNodeImpl ( void ) override;
         /** Creates a specialized BspSceneNode */
         SceneNode * createSceneNodeImpl ( const String &name ) override;
+        /** Not supported, as BspSceneNode::_update tags the BSP leaves the objects intersect */
+        void setParallelSceneGraphUpdate( bool ) override {}
 
         /** Internal method for tagging BspNodes with objects which intersect them. */
         void _notifyObjectMoved(const MovableObject* mov, const Vector3& pos);
@@ -512,6 +512,9 @@ void GLSLangProgram::prepareImpl()
         mConstantDefs->bufferSize = program.getUniformBlockSize(blockIdx) / 4;
         mLogicalToPhysical.reset();
     }
+
+    // the definitions were filled after getConstantDefinitions indexed them
+    mConstantDefs->generateHashIndex();
 }
 
 void GLSLangProgram::loadFromSource() {}
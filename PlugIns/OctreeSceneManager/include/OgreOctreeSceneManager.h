@@ -102,6 +102,8 @@ public:
 
     /** Does nothing more */
     void _updateSceneGraph( Camera * cam ) override;
+    /** Not supported, as OctreeNode::_updateBounds relocates the node in the octree */
+    void setParallelSceneGraphUpdate( bool ) override {}
     /** Recurses through the octree determining which nodes are visible. */
     void _findVisibleObjects ( Camera * cam,
         VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters ) override;
@@ -133,6 +133,8 @@ namespace Ogre
 
         /** Update Scene Graph (does several things now) */
         void _updateSceneGraph( Camera * cam ) override;
+        /** Not supported, as PCZSceneNode::_update tracks the node movement between zones */
+        void setParallelSceneGraphUpdate( bool ) override {}
 
         /** Recurses through the PCZTree determining which nodes are visible. */
         void _findVisibleObjects ( Camera * cam,
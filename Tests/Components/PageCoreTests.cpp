@@ -37,6 +37,8 @@ THE SOFTWARE.
 #include "OgrePaging.h"
 #include "OgreLogManager.h"
 
+#include <thread>
+
 using namespace Ogre;
 
 class PageCoreTests : public ::testing::Test
@@ -102,3 +104,79 @@ TEST_F(PageCoreTests,SimpleCreateSaveLoadWorld)
 }
 //--------------------------------------------------------------------------
 
+TEST_F(PageCoreTests,PrioritisedPredictiveLoading)
+{
+    // the work queue is not started, so requested pages stay in flight
+    Camera* cam = mSceneMgr->createCamera("cam");
+    SceneNode* camNode = mSceneMgr->getRootSceneNode()->createChildSceneNode();
+    camNode->attachObject(cam);
+    mPageManager->addCamera(cam);
+    mPageManager->setMaxConcurrentPageLoads(1);
+    mPageManager->setPrefetchTime(1);
+
+    FrameEvent evt;
+    evt.timeSinceLastFrame = 0.1;
+    auto fireFrame = [&]()
+    {
+        mRoot->_fireFrameStarted(evt);
+        mRoot->_fireFrameRenderingQueued(evt);
+        mRoot->_fireFrameEnded(evt);
+    };
+
+    // establish a velocity of 500 units/s along x
+    fireFrame();
+    camNode->setPosition(50, 0, 0);
+    fireFrame();
+    EXPECT_EQ(Vector3(500, 0, 0), mPageManager->getCameraVelocity(cam));
+    EXPECT_EQ(Vector3(550, 0, 0), mPageManager->getPredictedCameraPosition(cam));
+
+    PagedWorld* world = mPageManager->createWorld();
+    PagedWorldSection* section = world->createSection("Grid2D", mSceneMgr);
+    Grid2DPageStrategyData* data = static_cast<Grid2DPageStrategyData*>(section->getStrategyData());
+    data->setCellSize(100);
+    data->setLoadRadius(150);
+    data->setHoldRadius(300);
+
+    auto pageAt = [&](const Vector3& worldPos)
+    {
+        Vector2 gridPos;
+        data->convertWorldToGridSpace(worldPos, gridPos);
+        int32 x, y;
+        data->determineGridLocation(gridPos, &x, &y);
+        return data->calculatePageID(x, y);
+    };
+
+    // the page around the camera is loaded before those on its way
+    camNode->setPosition(100, 0, 0);
+    fireFrame();
+    EXPECT_TRUE(section->getPage(pageAt(Vector3(100, 0, 0))));
+    EXPECT_FALSE(section->getPage(pageAt(Vector3(600, 0, 0))));
+
+    // the limit holds while the load is in flight
+    camNode->setPosition(150, 0, 0);
+    fireFrame();
+    EXPECT_TRUE(section->getPage(pageAt(Vector3(100, 0, 0))));
+    EXPECT_FALSE(section->getPage(pageAt(Vector3(300, 0, 0))));
+    EXPECT_FALSE(section->getPage(pageAt(Vector3(650, 0, 0))));
+
+    // moving away cancels the in flight load
+    camNode->setPosition(100000, 0, 0);
+    for (int i = 0; i < 10; ++i)
+        fireFrame();
+    EXPECT_FALSE(section->getPage(pageAt(Vector3(100, 0, 0))));
+
+    mPageManager->removeCamera(cam);
+    EXPECT_EQ(Vector3::ZERO, mPageManager->getCameraVelocity(cam));
+
+    // the section goes away while the cancelled load is still queued
+    mPageManager->destroyWorld(world);
+    auto wq = mRoot->getWorkQueue();
+    std::atomic<bool> started(false);
+    wq->startup();
+    wq->addTask([&started]() { started = true; });
+    while (!started)
+        std::this_thread::yield();
+    wq->shutdown();
+    wq->processMainThreadTasks();
+}
+//--------------------------------------------------------------------------
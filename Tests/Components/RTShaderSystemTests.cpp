@@ -121,3 +121,174 @@ TEST_F(RTShaderSystem, FunctionInvocationOrder)
     EXPECT_TRUE(c == a);
     EXPECT_FALSE(c < a);
 }
+
+static void createTestMaterials(const String& scheme, int count, StringVector& names)
+{
+    auto& shaderGen = RTShader::ShaderGenerator::getSingleton();
+    for (int i = 0; i < count; ++i)
+    {
+        auto mat = MaterialManager::getSingleton().create(StringConverter::toString(i), RGN_DEFAULT);
+        auto pass = mat->getTechniques()[0]->getPasses()[0];
+
+        // only some of the combinations differ, so many materials share their programs
+        pass->setLightingEnabled(i % 2);
+        pass->setVertexColourTracking(i % 3 ? TVC_NONE : TVC_DIFFUSE);
+        for (int t = 0; t < i % 4; ++t)
+            pass->createTextureUnitState()->setTextureCoordSet(t % 2);
+
+        shaderGen.createShaderBasedTechnique(mat->getTechniques()[0], scheme);
+        names.push_back(mat->getName());
+    }
+    shaderGen.getRenderState(scheme)->setLightCountAutoUpdate(false);
+}
+
+static const GpuProgramPtr& getProgram(const String& name, const String& scheme, GpuProgramType type)
+{
+    auto mat = MaterialManager::getSingleton().getByName(name, RGN_DEFAULT);
+    for (auto t : mat->getTechniques())
+    {
+        if (t->getSchemeName() == scheme)
+            return t->getPasses()[0]->getGpuProgram(type);
+    }
+    static GpuProgramPtr nullPtr;
+    return nullPtr;
+}
+
+TEST_F(RTShaderSystem, ProgramSignatureCache)
+{
+    auto& shaderGen = RTShader::ShaderGenerator::getSingleton();
+    StringVector names;
+    createTestMaterials("MyScheme", 24, names);
+    shaderGen.validateScheme("MyScheme");
+
+    std::map<std::pair<String, GpuProgramType>, String> programNames;
+    std::set<GpuProgramPtr> programs;
+    for (const auto& name : names)
+    {
+        for (auto type : {GPT_VERTEX_PROGRAM, GPT_FRAGMENT_PROGRAM})
+        {
+            const auto& prg = getProgram(name, "MyScheme", type);
+            ASSERT_TRUE(prg);
+            programNames[std::make_pair(name, type)] = prg->getName();
+            programs.insert(prg);
+        }
+    }
+    // many materials share their programs
+    EXPECT_LT(programs.size(), names.size());
+    EXPECT_EQ(shaderGen.getShaderCount(GPT_VERTEX_PROGRAM) + shaderGen.getShaderCount(GPT_FRAGMENT_PROGRAM),
+              programs.size());
+
+    // programs found via their signature match the ones generated from scratch
+    for (const auto& name : names)
+    {
+        shaderGen.flushShaderCache();
+        shaderGen.validateMaterial("MyScheme", name);
+        for (auto type : {GPT_VERTEX_PROGRAM, GPT_FRAGMENT_PROGRAM})
+        {
+            const auto& prg = getProgram(name, "MyScheme", type);
+            EXPECT_EQ(programNames[std::make_pair(name, type)], prg->getName()) << name;
+        }
+    }
+}
+
+TEST_F(RTShaderSystem, ProgramSignatureBinaryOp)
+{
+    auto& shaderGen = RTShader::ShaderGenerator::getSingleton();
+    for (auto op : {LBX_MODULATE, LBX_ADD})
+    {
+        auto mat = MaterialManager::getSingleton().create(StringConverter::toString(op), RGN_DEFAULT);
+        mat->getTechniques()[0]->getPasses()[0]->createTextureUnitState()->setColourOperationEx(op);
+        shaderGen.createShaderBasedTechnique(mat->getTechniques()[0], "MyScheme");
+    }
+    shaderGen.getRenderState("MyScheme")->setLightCountAutoUpdate(false);
+    shaderGen.validateScheme("MyScheme");
+
+    // the blends only differ in the operator of the generated statement
+    auto modulate = getProgram(StringConverter::toString(LBX_MODULATE), "MyScheme", GPT_FRAGMENT_PROGRAM);
+    auto add = getProgram(StringConverter::toString(LBX_ADD), "MyScheme", GPT_FRAGMENT_PROGRAM);
+    ASSERT_TRUE(modulate && add);
+    EXPECT_NE(modulate, add);
+    EXPECT_NE(modulate->getSource(), add->getSource());
+}
+
+TEST_F(RTShaderSystem, PersistentShaderCache)
+{
+    auto& shaderGen = RTShader::ShaderGenerator::getSingleton();
+    auto& programMgr = RTShader::ProgramManager::getSingleton();
+    StringVector names;
+    createTestMaterials("MyScheme", 16, names);
+    shaderGen.validateScheme("MyScheme");
+    EXPECT_TRUE(programMgr.isShaderCacheDirty());
+
+    std::map<std::pair<String, GpuProgramType>, std::pair<String, String>> programs;
+    for (const auto& name : names)
+    {
+        for (auto type : {GPT_VERTEX_PROGRAM, GPT_FRAGMENT_PROGRAM})
+        {
+            const auto& prg = getProgram(name, "MyScheme", type);
+            programs[std::make_pair(name, type)] = std::make_pair(prg->getName(), prg->getSource());
+        }
+    }
+
+    const String cacheFile = "./RTShaderSystemTests.cache";
+    programMgr.saveShaderCache(Root::createFileStream(cacheFile, RGN_DEFAULT, true));
+
+    // all programs are taken from the cache, none is generated
+    shaderGen.flushShaderCache();
+    EXPECT_TRUE(programMgr.loadShaderCache(Root::openFileStream(cacheFile)));
+    shaderGen.validateScheme("MyScheme");
+    EXPECT_FALSE(programMgr.isShaderCacheDirty());
+    for (const auto& name : names)
+    {
+        for (auto type : {GPT_VERTEX_PROGRAM, GPT_FRAGMENT_PROGRAM})
+        {
+            const auto& prg = getProgram(name, "MyScheme", type);
+            EXPECT_EQ(programs[std::make_pair(name, type)], std::make_pair(prg->getName(), prg->getSource()));
+        }
+    }
+
+    // caches of other versions and truncated caches are rejected
+    String data = Root::openFileStream(cacheFile)->getAsString();
+    std::remove(cacheFile.c_str());
+
+    String outdated = data;
+    outdated[4] ^= 1; // format version
+    EXPECT_FALSE(programMgr.loadShaderCache(
+        std::make_shared<MemoryDataStream>(&outdated[0], outdated.size())));
+    outdated = data;
+    outdated[8] ^= 1; // signature version
+    EXPECT_FALSE(programMgr.loadShaderCache(
+        std::make_shared<MemoryDataStream>(&outdated[0], outdated.size())));
+    EXPECT_FALSE(programMgr.loadShaderCache(
+        std::make_shared<MemoryDataStream>(&data[0], data.size() / 2)));
+    EXPECT_TRUE(programMgr.loadShaderCache(std::make_shared<MemoryDataStream>(&data[0], data.size())));
+}
+
+TEST_F(RTShaderSystem, ParallelValidation)
+{
+    auto& shaderGen = RTShader::ShaderGenerator::getSingleton();
+    StringVector names;
+    createTestMaterials("Serial", 32, names);
+    for (const auto& name : names)
+        shaderGen.createShaderBasedTechnique(
+            MaterialManager::getSingleton().getByName(name)->getTechniques()[0], "Parallel");
+    shaderGen.getRenderState("Parallel")->setLightCountAutoUpdate(false);
+
+    shaderGen.validateScheme("Serial");
+
+    mRoot->getWorkQueue()->startup();
+    shaderGen.setParallelValidation(true);
+    EXPECT_TRUE(shaderGen.validateMaterials("Parallel", names));
+    shaderGen.setParallelValidation(false);
+    mRoot->getWorkQueue()->shutdown();
+
+    for (const auto& name : names)
+    {
+        for (auto type : {GPT_VERTEX_PROGRAM, GPT_FRAGMENT_PROGRAM})
+        {
+            const auto& prg = getProgram(name, "Parallel", type);
+            ASSERT_TRUE(prg);
+            EXPECT_EQ(getProgram(name, "Serial", type), prg) << name;
+        }
+    }
+}
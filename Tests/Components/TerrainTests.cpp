@@ -29,6 +29,7 @@ THE SOFTWARE.
 
 #include "OgreRoot.h"
 #include "OgreTerrain.h"
+#include "OgreTerrainQuadTreeNode.h"
 #include "OgreFileSystemLayer.h"
 
 #include "OgreBuildSettings.h"
@@ -125,3 +126,147 @@ TEST_F(TerrainTests, create)
     FileSystemLayer::removeFile("TerrainTest.dat");
 }
 //--------------------------------------------------------------------------
+TEST_F(TerrainTests, CompactPage)
+{
+    DefaultHardwareBufferManager hbm;
+    Terrain* t = OGRE_NEW Terrain(mSceneMgr);
+    Image img;
+    img.load("terrain.png", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+
+    Terrain::ImportData imp;
+    imp.inputImage = &img;
+    imp.inputScale = 300;
+    imp.terrainSize = 129;
+    imp.worldSize = 1000;
+    imp.minBatchSize = 17;
+    imp.maxBatchSize = 33;
+    imp.pos = Vector3(100, 0, -200);
+    imp.layerList.resize(1);
+    imp.layerList[0].worldSize = 100;
+    imp.layerList[0].textureNames = {"dirt_diffusespecular.dds", "dirt_normalheight.dds"};
+    ASSERT_TRUE(t->prepare(imp));
+
+    t->savePage(Root::createFileStream("TerrainTest.page"));
+
+    Terrain* p = OGRE_NEW Terrain(mSceneMgr);
+    DataStreamPtr stream = Root::openFileStream("TerrainTest.page");
+    ASSERT_TRUE(p->prepare(stream));
+    ASSERT_EQ(p->getSize(), t->getSize());
+    EXPECT_EQ(p->getWorldSize(), t->getWorldSize());
+    EXPECT_EQ(p->getPosition(), t->getPosition());
+    ASSERT_EQ(p->getLayerCount(), 1);
+    EXPECT_EQ(p->getLayerWorldSize(0), 100);
+    EXPECT_EQ(p->getLayerTextureName(0, 1), "dirt_normalheight.dds");
+
+    // heights are quantized to 16 bits of the height range
+    float tolerance = t->getMaxHeight() / 65535;
+    for (size_t i = 0; i < size_t(t->getSize()) * t->getSize(); ++i)
+        ASSERT_NEAR(p->getHeightData()[i], t->getHeightData()[i], tolerance) << i;
+
+    auto lod = t->getQuadTree()->getLodLevel(0);
+    EXPECT_EQ(p->getQuadTree()->getLodLevel(0)->maxHeightDelta, lod->maxHeightDelta);
+
+    OGRE_DELETE p;
+    OGRE_DELETE t;
+
+    FileSystemLayer::removeFile("TerrainTest.page");
+}
+//--------------------------------------------------------------------------
+TEST_F(TerrainTests, HorizonLightmap)
+{
+    mTerrainOpts->setLightMapSize(128);
+    mTerrainOpts->setLightMapDirection(Vector3(1, -1, 0.6).normalisedCopy());
+
+    Terrain* t = OGRE_NEW Terrain(mSceneMgr);
+    Image img;
+    img.load("terrain.png", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+
+    Terrain::ImportData imp;
+    imp.inputImage = &img;
+    imp.inputScale = 300;
+    imp.terrainSize = 129;
+    imp.worldSize = 1000;
+    imp.minBatchSize = 33;
+    imp.maxBatchSize = 65;
+    ASSERT_TRUE(t->prepare(imp));
+
+    Rect rect(0, 0, t->getSize(), t->getSize());
+    Rect raycastRect, horizonRect;
+    PixelBox* raycast = t->calculateLightmap(rect, Rect(), raycastRect);
+    mTerrainOpts->setUseHorizonLightMap(true);
+    PixelBox* horizon = t->calculateLightmap(rect, Rect(), horizonRect);
+    EXPECT_EQ(raycastRect, horizonRect);
+
+    // both resolve the same shadows, up to sampling differences at the shadow borders
+    // and the tolerance of the raycast quad tests
+    size_t numTexels = horizon->getWidth() * horizon->getHeight();
+    size_t numShadowed = 0, numMatching = 0;
+    for (size_t i = 0; i < numTexels; ++i)
+    {
+        numShadowed += horizon->data[i] == 0;
+        numMatching += horizon->data[i] == raycast->data[i];
+    }
+    EXPECT_GT(numShadowed, numTexels / 100);
+    EXPECT_GT(numMatching, numTexels * 9 / 10);
+
+    for (auto box : {raycast, horizon})
+    {
+        OGRE_FREE(box->data, MEMCATEGORY_GENERAL);
+        OGRE_DELETE box;
+    }
+    OGRE_DELETE t;
+}
+//--------------------------------------------------------------------------
+TEST_F(TerrainTests, ParallelNormals)
+{
+    mRoot->getWorkQueue()->startup();
+
+    Terrain* t = OGRE_NEW Terrain(mSceneMgr);
+    Image img;
+    img.load("terrain.png", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+
+    Terrain::ImportData imp;
+    imp.inputImage = &img;
+    imp.inputScale = 300;
+    imp.terrainSize = 129;
+    imp.worldSize = 1000;
+    imp.minBatchSize = 17;
+    imp.maxBatchSize = 33;
+    ASSERT_TRUE(t->prepare(imp));
+
+    Rect finalRect;
+    PixelBox* normals = t->calculateNormals(Rect(10, 20, 101, 67), finalRect);
+    EXPECT_EQ(finalRect, Rect(9, 19, 102, 68));
+
+    // reference: sum of the 8 surrounding face normals, edges clamped
+    int32 size = t->getSize();
+    auto getPoint = [t, size](int32 x, int32 y)
+    {
+        Vector3 pos;
+        t->getPoint(Math::Clamp(x, 0, size - 1), Math::Clamp(y, 0, size - 1), &pos);
+        return pos;
+    };
+    const int offsets[8][2] = {{1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}, {0, -1}, {1, -1}};
+    for (int32 y = finalRect.top; y < finalRect.bottom; ++y)
+    {
+        for (int32 x = finalRect.left; x < finalRect.right; ++x)
+        {
+            Vector3 centre = getPoint(x, y);
+            Vector3 normal = Vector3::ZERO;
+            for (int i = 0; i < 8; ++i)
+                normal += Math::calculateBasicFaceNormal(
+                    centre, getPoint(x + offsets[i][0], y + offsets[i][1]),
+                    getPoint(x + offsets[(i + 1) % 8][0], y + offsets[(i + 1) % 8][1]));
+            normal.normalise();
+
+            const uint8* pix = normals->data + ((finalRect.bottom - y - 1) * finalRect.width() + x - finalRect.left) * 3;
+            for (int c = 0; c < 3; ++c)
+                EXPECT_NEAR(pix[c], (normal[c] + 1) * 0.5f * 255, 1) << x << ", " << y;
+        }
+    }
+
+    OGRE_FREE(normals->data, MEMCATEGORY_GENERAL);
+    OGRE_DELETE normals;
+    OGRE_DELETE t;
+}
+//--------------------------------------------------------------------------
@@ -0,0 +1,178 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreRoot.h"
+#include "OgreVolumeCSGSource.h"
+#include "OgreVolumeGridSource.h"
+#include "OgreVolumeMeshBuilder.h"
+
+using namespace Ogre;
+using namespace Ogre::Volume;
+
+namespace
+{
+    /// Deterministic positions around the test shapes, more than one batch of the CSG operations
+    std::vector<Vector3> makePositions()
+    {
+        std::vector<Vector3> positions;
+        for (int i = 0; i < 150; ++i)
+            positions.push_back(Vector3(Real(i % 7) - 3, Real(i % 11) * Real(0.7) - 3, Real(i % 13) * Real(0.45) - 3));
+        return positions;
+    }
+
+    void expectBatchedValuesMatch(const Source& src, const std::vector<Vector3>& positions)
+    {
+        std::vector<Real> values(positions.size());
+        std::vector<Vector4> gradients(positions.size());
+        src.getValues(positions.data(), values.data(), positions.size());
+        src.getValuesAndGradients(positions.data(), gradients.data(), positions.size());
+        for (size_t i = 0; i < positions.size(); ++i)
+        {
+            EXPECT_FLOAT_EQ(src.getValue(positions[i]), values[i]) << positions[i];
+            Vector4 expected = src.getValueAndGradient(positions[i]);
+            for (size_t j = 0; j < 4; ++j)
+                EXPECT_NEAR(expected[j], gradients[i][j], 1e-5) << positions[i];
+        }
+    }
+
+    class TestGridSource : public GridSource
+    {
+        std::vector<float> mData;
+
+    public:
+        TestGridSource(bool trilinearGradient = false, bool sobelGradient = false)
+            : GridSource(true, trilinearGradient, sobelGradient)
+        {
+            mWidth = mHeight = mDepth = 8;
+            mPosXScale = mPosYScale = mPosZScale = 2;
+            mVolumeSpaceToWorldSpaceFactor = 1;
+            mData.resize(mWidth * mHeight * mDepth);
+            for (size_t i = 0; i < mData.size(); ++i)
+                mData[i] = float(i % 5) - 2;
+        }
+
+        float getVolumeGridValue(size_t x, size_t y, size_t z) const override
+        {
+            x = std::min(x, mWidth - 1);
+            y = std::min(y, mHeight - 1);
+            z = std::min(z, mDepth - 1);
+            return mData[(z * mHeight + y) * mWidth + x];
+        }
+
+        void setVolumeGridValue(int x, int y, int z, float value) override
+        {
+            mData[(z * mHeight + y) * mWidth + x] = value;
+        }
+    };
+
+    class CollectingCallback : public MeshBuilderCallback
+    {
+    public:
+        VecVertex vertices;
+        VecIndices indices;
+
+        void ready(const SimpleRenderable*, const VecVertex& v, const VecIndices& i, size_t, int) override
+        {
+            vertices = v;
+            indices = i;
+        }
+    };
+}
+
+TEST(VolumeTests, BatchedCSGValues)
+{
+    std::vector<Vector3> positions = makePositions();
+
+    CSGSphereSource sphere(2, Vector3(0.5, 0, 0));
+    CSGPlaneSource plane(1, Vector3(0.2, 1, 0));
+    CSGCubeSource cube(Vector3(-1.5, -1, -2), Vector3(1, 2, 1.5));
+    CSGUnionSource unionSrc(&sphere, &cube);
+    CSGIntersectionSource intersection(&unionSrc, &plane);
+    CSGNegateSource negate(&sphere);
+    CSGScaleSource scale(&cube, 1.5);
+    CSGDifferenceSource difference(&intersection, &scale);
+
+    const Source* sources[] = {&sphere, &plane, &cube, &unionSrc, &intersection, &negate, &scale, &difference};
+    for (auto src : sources)
+        expectBatchedValuesMatch(*src, positions);
+}
+
+TEST(VolumeTests, BatchedGridValuesAndCombine)
+{
+    TestGridSource grid;
+
+    // inside of the grid, trilinear interpolation
+    std::vector<Vector3> positions;
+    for (int i = 0; i < 23; ++i)
+        positions.push_back(Vector3(Real(i % 7) * Real(0.55), Real(i % 5) * Real(0.7), Real(i % 3) * Real(1.2)));
+    std::vector<Real> values(positions.size());
+    grid.getValues(positions.data(), values.data(), positions.size());
+    for (size_t i = 0; i < positions.size(); ++i)
+        EXPECT_FLOAT_EQ(grid.getValue(positions[i]), values[i]) << positions[i];
+
+    // all the ways to take the gradient
+    for (int mode = 0; mode < 4; ++mode)
+        expectBatchedValuesMatch(TestGridSource(mode & 1, mode & 2), positions);
+
+    Root root("");
+    CSGSphereSource sphere(1, Vector3(2, 2, 2));
+    CSGUnionSource unionSrc;
+    std::vector<float> expected;
+    for (int z = 0; z < 8; ++z)
+        for (int y = 0; y < 8; ++y)
+            for (int x = 0; x < 8; ++x)
+            {
+                bool inArea = x >= 1 && x < 7 && y >= 1 && y < 7 && z >= 1 && z < 7;
+                Real value = grid.getValue(Vector3(x * Real(0.5), y * Real(0.5), z * Real(0.5)));
+                Real sphereValue = sphere.getValue(Vector3(x * Real(0.5), y * Real(0.5), z * Real(0.5)));
+                expected.push_back(float(inArea ? std::max(value, sphereValue) : value));
+            }
+    grid.combineWithSource(&unionSrc, &sphere, Vector3(2, 2, 2), Real(1.5));
+
+    size_t i = 0;
+    for (int z = 0; z < 8; ++z)
+        for (int y = 0; y < 8; ++y)
+            for (int x = 0; x < 8; ++x)
+                EXPECT_FLOAT_EQ(expected[i++], grid.getVolumeGridValue(x, y, z)) << x << " " << y << " " << z;
+}
+
+TEST(VolumeTests, MeshBuilderWeldsVertices)
+{
+    MeshBuilder mb;
+    // two triangles sharing an edge, the shared normal differs only in the sign of zero
+    mb.addTriangle(Vector3(0, 0, 0), Vector3(0, 1, 0), Vector3(1, 0, 0), Vector3(0, 1, 0), Vector3(0, 0, 1), Vector3(0, 1, 0));
+    mb.addTriangle(Vector3(1, 0, 0), Vector3(0, 1, 0), Vector3(1, 0, 1), Vector3(0, 1, 0), Vector3(0, 0, 1), Vector3(-0.0f, 1, 0));
+
+    CollectingCallback callback;
+    mb.executeCallback(&callback, NULL, 0, 0);
+    EXPECT_EQ(4u, callback.vertices.size());
+    VecIndices expectedIndices = {0, 1, 2, 1, 3, 2};
+    EXPECT_EQ(expectedIndices, callback.indices);
+    EXPECT_EQ(AxisAlignedBox(Vector3(0, 0, 0), Vector3(1, 0, 1)), mb.getBoundingBox());
+}
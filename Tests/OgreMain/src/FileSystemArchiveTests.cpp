@@ -264,6 +264,24 @@ TEST_F(FileSystemArchiveTests,FileRead)
     EXPECT_TRUE(stream->eof());
 }
 //--------------------------------------------------------------------------
+TEST_F(FileSystemArchiveTests,FileReadMapped)
+{
+    String contents = mArch->open("rootfile.txt")->getAsString();
+
+    FileSystemArchiveFactory::setUseMemoryMapping(true);
+    DataStreamPtr stream = mArch->open("rootfile.txt");
+    FileSystemArchiveFactory::setUseMemoryMapping(false);
+
+#if OGRE_PLATFORM == OGRE_PLATFORM_LINUX
+    EXPECT_TRUE(dynamic_cast<MemoryDataStream*>(stream.get()));
+#endif
+    EXPECT_EQ("rootfile.txt", stream->getName());
+    EXPECT_EQ(contents.size(), stream->size());
+    EXPECT_EQ(String("this is line 1 in file 1"), stream->getLine());
+    EXPECT_EQ(contents, stream->getAsString());
+    EXPECT_TRUE(stream->eof());
+}
+//--------------------------------------------------------------------------
 TEST_F(FileSystemArchiveTests,ReadInterleave)
 {
     // Test overlapping reads from same archive
@@ -30,7 +30,11 @@ THE SOFTWARE.
 #include "OgreRoot.h"
 #include "OgreSceneNode.h"
 #include "OgreEntity.h"
+#include "OgreSubEntity.h"
+#include "OgreAnimationState.h"
 #include "OgreCamera.h"
+#include "OgreWorkQueue.h"
+#include "OgreWorkStealingWorkQueue.h"
 #include "RootWithoutRenderSystemFixture.h"
 #include "OgreStaticPluginLoader.h"
 
@@ -43,21 +47,30 @@ THE SOFTWARE.
 #include "OgreHighLevelGpuProgramManager.h"
 #include "OgreMeshManager.h"
 #include "OgreMesh.h"
+#include "OgreSubMesh.h"
 #include "OgreSkeletonManager.h"
 #include "OgreSkeletonInstance.h"
+#include "OgreBone.h"
 #include "OgreCompositorManager.h"
 #include "OgreTextureManager.h"
 #include "OgreFileSystem.h"
 #include "OgreArchiveManager.h"
 
 #include "OgreHighLevelGpuProgram.h"
+#include "OgreRenderQueueSortingGrouping.h"
 
 #include "OgreKeyFrame.h"
+#include "OgreAutoParamDataSource.h"
+#include "OgreOptimisedUtil.h"
+#include "OgreArrayMath.h"
+#include "OgreTriangleTree.h"
+#include "OgreManualObject.h"
 
 #include "OgreBillboardSet.h"
 #include "OgreBillboard.h"
 
 #include <random>
+#include <thread>
 using std::minstd_rand;
 
 using namespace Ogre;
@@ -92,6 +105,50 @@ TEST_F(CameraTests,customProjectionMatrix)
 
 }
 
+TEST_F(CameraTests, batchedIsVisible)
+{
+    Camera cam("", NULL);
+    cam.setNearClipDistance(1);
+    cam.setFarClipDistance(100);
+
+    minstd_rand rng;
+    std::uniform_real_distribution<float> pos(-150, 150), size(0, 20);
+
+    // odd count, so the last mask element is only partially used
+    const size_t numBoxes = 103;
+    std::vector<float> mins[3], maxs[3];
+    for (size_t i = 0; i < numBoxes; ++i)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            mins[k].push_back(pos(rng));
+            maxs[k].push_back(mins[k].back() + size(rng));
+        }
+    }
+    const float* minimum[3] = {mins[0].data(), mins[1].data(), mins[2].data()};
+    const float* maximum[3] = {maxs[0].data(), maxs[1].data(), maxs[2].data()};
+
+    for (Real farDist : {Real(100), Real(0)})
+    {
+        cam.setFarClipDistance(farDist);
+
+        std::vector<uint32> mask((numBoxes + 31) / 32, 0xFFFFFFFF);
+        cam.isVisible(minimum, maximum, numBoxes, mask.data());
+
+        size_t numVisible = 0;
+        for (size_t i = 0; i < numBoxes; ++i)
+        {
+            AxisAlignedBox box(mins[0][i], mins[1][i], mins[2][i], maxs[0][i], maxs[1][i], maxs[2][i]);
+            bool visible = (mask[i / 32] >> (i % 32)) & 1;
+            EXPECT_EQ(cam.isVisible(box), visible) << "box " << i;
+            numVisible += visible;
+        }
+        EXPECT_GT(numVisible, 0u);
+        EXPECT_LT(numVisible, numBoxes);
+        EXPECT_EQ(mask.back() >> (numBoxes % 32), 0u);
+    }
+}
+
 TEST(Root,shutdown)
 {
 #ifdef OGRE_STATIC_LIB
@@ -233,6 +290,56 @@ TEST_F(SceneNodeTest, setDirection) {
     EXPECT_DIR_EQ(child->getOrientation() * Vector3::NEGATIVE_UNIT_Z, Vector3::UNIT_X);
 }
 
+static std::vector<SceneNode*> createRandomTree(SceneManager* mgr, size_t nodeCount)
+{
+    minstd_rand rng;
+    std::vector<SceneNode*> nodes = {mgr->getRootSceneNode()};
+    for (size_t n = 0; n < nodeCount; ++n)
+    {
+        SceneNode* parent = nodes[rng() % nodes.size()];
+        SceneNode* node = parent->createChildSceneNode(Vector3(rng() % 100, rng() % 100, rng() % 100),
+                                                       Quaternion(Degree(rng() % 360), Vector3::UNIT_Y));
+        node->setScale(Vector3(1 + (rng() % 3) / 2.0f));
+        if (n % 3 == 0)
+            node->attachObject(mgr->createEntity("sphere.mesh"));
+        nodes.push_back(node);
+    }
+    return nodes;
+}
+
+TEST_F(SceneNodeTest, parallelUpdate)
+{
+    mRoot->getWorkQueue()->startup();
+
+    SceneManager* parallelMgr = mRoot->createSceneManager();
+    parallelMgr->setParallelSceneGraphUpdate(true);
+
+    auto expected = createRandomTree(mSceneMgr, 2000);
+    auto actual = createRandomTree(parallelMgr, 2000);
+
+    for (int frame = 0; frame < 2; frame++)
+    {
+        mSceneMgr->_updateSceneGraph(NULL);
+        parallelMgr->_updateSceneGraph(NULL);
+
+        for (size_t i = 0; i < expected.size(); i++)
+        {
+            EXPECT_EQ(expected[i]->_getDerivedPosition(), actual[i]->_getDerivedPosition());
+            EXPECT_EQ(expected[i]->_getDerivedOrientation(), actual[i]->_getDerivedOrientation());
+            EXPECT_EQ(expected[i]->_getWorldAABB(), actual[i]->_getWorldAABB());
+        }
+
+        // only update some branches next frame
+        for (size_t i = 0; i < expected.size(); i += 7)
+        {
+            expected[i]->translate(Vector3::UNIT_X);
+            actual[i]->translate(Vector3::UNIT_X);
+        }
+    }
+
+    mRoot->getWorkQueue()->shutdown();
+}
+
 static void createRandomEntityClones(Entity* ent, size_t cloneCount, const Vector3& min,
                                      const Vector3& max, SceneManager* mgr)
 {
@@ -322,6 +429,360 @@ TEST_F(SceneQueryTest, Ray) {
     ASSERT_EQ("397", results[1].movable->getName());
 }
 
+TEST_F(SceneQueryTest, TreeMatchesBruteForce)
+{
+    // build the tree, then move and destroy objects so it is updated incrementally
+    AxisAlignedBoxSceneQuery* boxQuery =
+        mSceneMgr->createAABBQuery(AxisAlignedBox(Vector3(-1000), Vector3(1000)));
+    EXPECT_FALSE(boxQuery->execute().movables.empty());
+
+    std::vector<MovableObject*> all;
+    std::list<MovableObject*> expected;
+    for (int pass = 0; pass < 2; pass++)
+    {
+        for (int i = pass; i < 500; i += 7)
+            mSceneMgr->getEntity(StringConverter::toString(i))->getParentSceneNode()->translate(120, -40, 0);
+        // only update the moved objects first, then synchronise all of them
+        if (pass == 1)
+        {
+            for (int i = 3; i < 500; i += 50)
+                mSceneMgr->destroyEntity(StringConverter::toString(i));
+        }
+        mSceneMgr->_updateSceneGraph(mCamera);
+
+        all.clear();
+        for (const auto& f : mRoot->getMovableObjectFactories())
+            for (const auto& o : mSceneMgr->getMovableObjects(f.first))
+                all.push_back(o.second);
+
+        expected.clear();
+        for (auto mo : all)
+            if (mo->isInScene() && boxQuery->getBox().intersects(mo->getWorldBoundingBox()))
+                expected.push_back(mo);
+        EXPECT_EQ(expected, boxQuery->execute().movables);
+    }
+
+    Sphere sphere(Vector3(300, 0, -200), 800);
+    SphereSceneQuery* sphereQuery = mSceneMgr->createSphereQuery(sphere);
+    expected.clear();
+    for (auto mo : all)
+        if (mo->isInScene() && sphere.intersects(mo->getWorldBoundingSphere()))
+            expected.push_back(mo);
+    EXPECT_EQ(expected, sphereQuery->execute().movables);
+
+    // passes the entity at the origin
+    Ray ray(Vector3(-3000, -30, 20), Vector3(1, 0.01, 0).normalisedCopy());
+    RaySceneQuery* rayQuery = mSceneMgr->createRayQuery(ray);
+    std::vector<std::pair<MovableObject*, Real>> expectedHits, actualHits;
+    for (auto mo : all)
+    {
+        auto hit = ray.intersects(mo->getWorldBoundingBox());
+        if (mo->isInScene() && hit.first)
+            expectedHits.push_back(std::make_pair(mo, hit.second));
+    }
+    for (const auto& entry : rayQuery->execute())
+        actualHits.push_back(std::make_pair(entry.movable, entry.distance));
+    EXPECT_FALSE(expectedHits.empty());
+    EXPECT_EQ(expectedHits, actualHits);
+
+    std::vector<std::pair<MovableObject*, MovableObject*>> expectedPairs, actualPairs;
+    for (size_t i = 0; i < all.size(); i++)
+        for (size_t j = i + 1; j < all.size(); j++)
+            if (all[i]->isInScene() && all[j]->isInScene() &&
+                all[i]->getWorldBoundingBox().intersects(all[j]->getWorldBoundingBox()))
+                expectedPairs.push_back(std::make_pair(all[i], all[j]));
+    IntersectionSceneQuery* intersectionQuery = mSceneMgr->createIntersectionQuery();
+    for (const auto& p : intersectionQuery->execute().movables2movables)
+        actualPairs.push_back(p);
+    EXPECT_EQ(expectedPairs, actualPairs);
+}
+
+TEST_F(SceneQueryTest, SkyDomeAfterQuery)
+{
+    AxisAlignedBoxSceneQuery* boxQuery =
+        mSceneMgr->createAABBQuery(AxisAlignedBox(Vector3(-100000), Vector3(100000)));
+    EXPECT_EQ(boxQuery->execute().movables.size(), 501u);
+
+    // the sky entities are added to the collections directly, bypassing createEntity
+    mSceneMgr->setSkyDome(true, "BaseWhite");
+    SceneNode* skyNode = mSceneMgr->getEntity("SkyDomePlane0")->getParentSceneNode();
+    mSceneMgr->getRootSceneNode()->addChild(skyNode);
+    mSceneMgr->_updateSceneGraph(mCamera);
+
+    std::set<String> names;
+    for (auto mo : boxQuery->execute().movables)
+        names.insert(mo->getName());
+    EXPECT_EQ(names.size(), 506u);
+    for (int i = 0; i < 5; i++)
+        EXPECT_TRUE(names.count("SkyDomePlane" + StringConverter::toString(i)));
+
+    mSceneMgr->getRootSceneNode()->removeChild(skyNode);
+}
+
+struct QueuedRenderables : public RenderQueue::RenderableListener
+{
+    std::vector<Renderable*> renderables;
+    bool renderableQueued(Renderable* rend, uint8 groupID, ushort priority, Technique** ppTech,
+                          RenderQueue* pQueue) override
+    {
+        renderables.push_back(rend);
+        return true;
+    }
+};
+
+TEST_F(SceneQueryTest, ParallelFindVisibleObjects)
+{
+    mRoot->getWorkQueue()->startup();
+    mCameraNode->setPosition(0, 0, 3000);
+    mSceneMgr->_updateSceneGraph(mCamera);
+
+    QueuedRenderables expected, actual;
+    VisibleObjectsBoundsInfo expectedBounds, actualBounds;
+
+    mSceneMgr->getRenderQueue()->setRenderableListener(&expected);
+    mSceneMgr->_findVisibleObjects(mCamera, &expectedBounds, false);
+    mSceneMgr->getRenderQueue()->clear();
+
+    mSceneMgr->setParallelFindVisibleObjects(true);
+    mSceneMgr->getRenderQueue()->setRenderableListener(&actual);
+    mSceneMgr->_findVisibleObjects(mCamera, &actualBounds, false);
+    mSceneMgr->getRenderQueue()->setRenderableListener(NULL);
+
+    EXPECT_GT(expected.renderables.size(), 1u);
+    EXPECT_LT(expected.renderables.size(), 501u);
+    EXPECT_EQ(expected.renderables, actual.renderables);
+    EXPECT_EQ(expectedBounds.aabb, actualBounds.aabb);
+    EXPECT_EQ(expectedBounds.minDistance, actualBounds.minDistance);
+    EXPECT_EQ(expectedBounds.maxDistance, actualBounds.maxDistance);
+
+    mRoot->getWorkQueue()->shutdown();
+}
+
+struct AnimationUpdateSceneManager : public SceneManager
+{
+    AnimationUpdateSceneManager() : SceneManager("AnimationUpdateTest")
+    {
+        // exercise splitting the blends into several tasks
+        mAnimationUpdater.mBlendBatch.mVerticesPerTask = 256;
+    }
+    const String& getTypeName() const override { return BLANKSTRING; }
+
+    // what _renderScene does before rendering the queue, returns the number of queued entities
+    size_t findVisibleObjects(Camera* cam)
+    {
+        VisibleObjectsBoundsInfo bounds;
+        mAnimationUpdater.mCollecting = mAnimationUpdater.mEnabled;
+        _findVisibleObjects(cam, &bounds, false);
+        size_t queued = mAnimationUpdater.mEntities.size();
+        mAnimationUpdater.update();
+        getRenderQueue()->clear();
+        return queued;
+    }
+};
+
+static std::vector<float> getSkinnedPositions(Entity* ent)
+{
+    std::vector<float> positions;
+    for (auto se : ent->getSubEntities())
+    {
+        const VertexData* data = se->_getSkelAnimVertexData();
+        auto elem = data->vertexDeclaration->findElementBySemantic(VES_POSITION);
+        auto buf = data->vertexBufferBinding->getBuffer(elem->getSource());
+        HardwareBufferLockGuard lock(buf, HardwareBuffer::HBL_READ_ONLY);
+        for (size_t v = 0; v < data->vertexCount; v++)
+        {
+            float* pos;
+            elem->baseVertexPointerToElement(static_cast<uchar*>(lock.pData) + v * buf->getVertexSize(), &pos);
+            positions.insert(positions.end(), pos, pos + 3);
+        }
+    }
+    return positions;
+}
+
+typedef RootWithoutRenderSystemFixture AnimationUpdateTests;
+TEST_F(AnimationUpdateTests, ParallelAnimationUpdate)
+{
+    mRoot->getWorkQueue()->startup();
+
+    AnimationUpdateSceneManager serialMgr, parallelMgr;
+    parallelMgr.setParallelAnimationUpdate(true);
+
+    std::vector<Entity*> expected, actual;
+    std::vector<Camera*> cameras;
+    for (auto mgr : {&serialMgr, &parallelMgr})
+    {
+        auto& entities = mgr == &serialMgr ? expected : actual;
+        for (int i = 0; i < 8; i++)
+        {
+            Entity* ent = mgr->createEntity("Sinbad.mesh");
+            ent->addSoftwareAnimationRequest(true);
+            auto state = ent->getAnimationState(i % 2 ? "Dance" : "IdleTop");
+            state->setEnabled(true);
+            state->setTimePosition(0.1f * i);
+            mgr->getRootSceneNode()->createChildSceneNode(Vector3(10.0f * i, 0, 0))->attachObject(ent);
+            entities.push_back(ent);
+        }
+
+        Camera* cam = mgr->createCamera("Camera");
+        SceneNode* camNode = mgr->getRootSceneNode()->createChildSceneNode(Vector3(35, 0, 300));
+        camNode->attachObject(cam);
+        mgr->_updateSceneGraph(cam);
+        cameras.push_back(cam);
+    }
+
+    for (int frame = 0; frame < 2; frame++)
+    {
+        EXPECT_EQ(serialMgr.findVisibleObjects(cameras[0]), 0u);
+        EXPECT_EQ(parallelMgr.findVisibleObjects(cameras[1]), actual.size());
+
+        for (size_t i = 0; i < expected.size(); i++)
+        {
+            EXPECT_EQ(getSkinnedPositions(expected[i]), getSkinnedPositions(actual[i]));
+        }
+        EXPECT_NE(getSkinnedPositions(expected[0]), getSkinnedPositions(expected[1]));
+
+        for (size_t i = 0; i < expected.size(); i++)
+        {
+            expected[i]->getAllAnimationStates()->getEnabledAnimationStates().front()->addTime(0.5f);
+            actual[i]->getAllAnimationStates()->getEnabledAnimationStates().front()->addTime(0.5f);
+        }
+        mRoot->_fireFrameRenderingQueued();
+    }
+
+    mRoot->getWorkQueue()->shutdown();
+}
+
+typedef RootWithoutRenderSystemFixture WorkStealingWorkQueueTests;
+TEST_F(WorkStealingWorkQueueTests, TaskGroup)
+{
+    WorkStealingWorkQueue queue("Test");
+    queue.setWorkerThreadCount(3);
+    queue.startup();
+
+    // tasks adding tasks from the worker threads
+    std::atomic<int> count(0);
+    {
+        WorkStealingWorkQueue::TaskGroup group(&queue);
+        for (int i = 0; i < 100; i++)
+        {
+            group.run([&]() {
+                WorkStealingWorkQueue::TaskGroup inner(&queue);
+                for (int j = 0; j < 10; j++)
+                    inner.run([&]() { count++; });
+            });
+        }
+        group.wait();
+        EXPECT_EQ(count, 1000);
+    }
+
+    std::atomic<bool> done(false);
+    {
+        WorkStealingWorkQueue::TaskGroup group(&queue);
+        group.run([&]() { count++; });
+        group.then([&]() { done = count == 1001; });
+    }
+    while (!done)
+        queue._processPendingTask();
+
+    std::vector<size_t> values(10000);
+    queue.parallelFor(0, values.size(), 64, [&values](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+            values[i] += i;
+    });
+    for (size_t i = 0; i < values.size(); i++)
+        ASSERT_EQ(values[i], i);
+
+    queue.shutdown();
+
+    // the waiting thread processes the tasks, if there are no workers
+    WorkStealingWorkQueue stopped("Stopped");
+    {
+        WorkStealingWorkQueue::TaskGroup group(&stopped);
+        for (int i = 0; i < 10; i++)
+            group.run([&]() { count--; });
+    }
+    EXPECT_EQ(count, 991);
+}
+
+typedef RootWithoutRenderSystemFixture WorkQueueTests;
+TEST_F(WorkQueueTests, parallelFor)
+{
+    WorkQueue* wq = mRoot->getWorkQueue();
+
+    // not running, so everything happens on the calling thread
+    auto caller = std::this_thread::get_id();
+    size_t numCalls = 0;
+    wq->parallelFor(10, 110, 8, [&](size_t begin, size_t end) {
+        EXPECT_EQ(std::this_thread::get_id(), caller);
+        EXPECT_LE(end - begin, 8u);
+        numCalls++;
+    });
+    EXPECT_EQ(numCalls, 13u);
+
+    wq->startup();
+    std::vector<size_t> values(10000);
+    wq->parallelFor(0, values.size(), 64, [&values](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+            values[i] += i;
+    });
+    for (size_t i = 0; i < values.size(); i++)
+        ASSERT_EQ(values[i], i);
+    wq->shutdown();
+}
+
+TEST_F(WorkQueueTests, TaskGraph)
+{
+    // a grid, where each task depends on its left and upper neighbour
+    const size_t N = 8;
+    std::atomic<int> counter(0);
+    std::vector<int> order(N * N, -1);
+
+    TaskGraph graph;
+    for (size_t i = 0; i < N * N; i++)
+        graph.addTask([&, i]() { order[i] = counter++; });
+    for (size_t y = 0; y < N; y++)
+    {
+        for (size_t x = 0; x < N; x++)
+        {
+            if (x > 0)
+                graph.addDependency(y * N + x, y * N + x - 1);
+            if (y > 0)
+                graph.addDependency(y * N + x, (y - 1) * N + x);
+        }
+    }
+
+    auto checkOrder = [&]() {
+        for (size_t y = 0; y < N; y++)
+        {
+            for (size_t x = 0; x < N; x++)
+            {
+                if (x > 0)
+                    EXPECT_GT(order[y * N + x], order[y * N + x - 1]);
+                if (y > 0)
+                    EXPECT_GT(order[y * N + x], order[(y - 1) * N + x]);
+            }
+        }
+    };
+
+    graph.run(NULL);
+    EXPECT_EQ(counter, int(N * N));
+    checkOrder();
+
+    WorkQueue* wq = mRoot->getWorkQueue();
+    wq->startup();
+    for (int i = 0; i < 10; i++)
+    {
+        counter = 0;
+        graph.run(wq);
+        EXPECT_EQ(counter, int(N * N));
+        checkOrder();
+    }
+    wq->shutdown();
+
+    graph.addDependency(0, N * N - 1);
+    EXPECT_THROW(graph.run(NULL), RuntimeAssertionException);
+}
+
 TEST(MaterialSerializer, Basic)
 {
     Root root;
@@ -608,6 +1069,223 @@ TEST(Math, TriangleRayIntersection)
     EXPECT_FALSE(Math::intersects(ray, tri[0], tri[1], tri[2], false, false).first);
 }
 
+static void expectVector3Near(const float* expected, const float* actual, float tolerance)
+{
+    for (int i = 0; i < 3; ++i)
+        EXPECT_NEAR(expected[i], actual[i], tolerance);
+}
+
+TEST(OptimisedUtil, MatchesReference)
+{
+    // odd and not a multiple of 8, so the tails of the vectorised loops are covered too
+    const size_t numVertices = 37;
+    OptimisedUtil* impl = OptimisedUtil::getImplementation();
+
+    std::vector<float> positions(numVertices * 3), normals(numVertices * 3);
+    for (size_t i = 0; i < positions.size(); ++i)
+    {
+        positions[i] = Math::RangeRandom(-10, 10);
+        normals[i] = Math::RangeRandom(-1, 1);
+    }
+
+    // skinning, two weights per vertex
+    Affine3 matrices[4];
+    const Affine3* blendMatrices[4];
+    for (int i = 0; i < 4; ++i)
+    {
+        Quaternion q(Radian(Math::RangeRandom(0, Math::TWO_PI)), Vector3(1, i, 2).normalisedCopy());
+        matrices[i].makeTransform(Vector3(i, 2 * i, -i), Vector3(1 + i), q);
+        blendMatrices[i] = &matrices[i];
+    }
+    std::vector<float> weights(numVertices * 2);
+    std::vector<uchar> indices(numVertices * 2);
+    for (size_t i = 0; i < numVertices; ++i)
+    {
+        weights[i * 2] = Math::UnitRandom();
+        weights[i * 2 + 1] = 1 - weights[i * 2];
+        indices[i * 2] = i % 4;
+        indices[i * 2 + 1] = (i + 1) % 4;
+    }
+
+    std::vector<float> dstPositions(numVertices * 3), dstNormals(numVertices * 3);
+    impl->softwareVertexSkinning(positions.data(), dstPositions.data(), normals.data(), dstNormals.data(),
+                                 weights.data(), indices.data(), blendMatrices, 12, 12, 12, 12, 8, 2, 2,
+                                 numVertices);
+    for (size_t i = 0; i < numVertices; ++i)
+    {
+        Vector3 pos(&positions[i * 3]), norm(&normals[i * 3]);
+        Vector3 expectedPos = Vector3::ZERO, expectedNorm = Vector3::ZERO;
+        for (int w = 0; w < 2; ++w)
+        {
+            const Affine3& m = matrices[indices[i * 2 + w]];
+            expectedPos += m * pos * weights[i * 2 + w];
+            expectedNorm += m.linear() * norm * weights[i * 2 + w];
+        }
+        expectedNorm.normalise();
+        expectVector3Near(expectedPos.ptr(), &dstPositions[i * 3], 1e-3);
+        expectVector3Near(expectedNorm.ptr(), &dstNormals[i * 3], 1e-4);
+    }
+
+    // morph, packed positions and interleaved normals
+    std::vector<float> interleaved1(numVertices * 6), interleaved2(numVertices * 6), morphed(numVertices * 6);
+    for (size_t i = 0; i < interleaved1.size(); ++i)
+    {
+        interleaved1[i] = Math::RangeRandom(-1, 1);
+        interleaved2[i] = Math::RangeRandom(-1, 1);
+    }
+    impl->softwareVertexMorph(0.25, positions.data(), normals.data(), dstPositions.data(), 12, 12, 12,
+                              numVertices, false);
+    for (size_t i = 0; i < positions.size(); ++i)
+        EXPECT_NEAR(positions[i] + 0.25f * (normals[i] - positions[i]), dstPositions[i], 1e-5);
+
+    impl->softwareVertexMorph(0.75, interleaved1.data(), interleaved2.data(), morphed.data(), 24, 24, 24,
+                              numVertices, true);
+    for (size_t i = 0; i < numVertices; ++i)
+    {
+        Vector3 p1(&interleaved1[i * 6]), p2(&interleaved2[i * 6]);
+        Vector3 n1(&interleaved1[i * 6 + 3]), n2(&interleaved2[i * 6 + 3]);
+        Vector3 expectedNorm = n1 + (n2 - n1) * 0.75;
+        expectedNorm.normalise();
+        expectVector3Near((p1 + (p2 - p1) * 0.75).ptr(), &morphed[i * 6], 1e-5);
+        expectVector3Near(expectedNorm.ptr(), &morphed[i * 6 + 3], 1e-4);
+    }
+
+    // matrix concatenation
+    Affine3 concatenated[4];
+    impl->concatenateAffineMatrices(matrices[1], matrices, concatenated, 4);
+    for (int i = 0; i < 4; ++i)
+    {
+        Affine3 expected = matrices[1] * matrices[i];
+        for (int j = 0; j < 16; ++j)
+            EXPECT_NEAR(expected[0][j], concatenated[i][0][j], 1e-4);
+    }
+
+    // face normals and light facing
+    const size_t numTriangles = 29;
+    std::vector<EdgeData::Triangle> triangles(numTriangles);
+    for (size_t i = 0; i < numTriangles; ++i)
+    {
+        for (int v = 0; v < 3; ++v)
+            triangles[i].vertIndex[v] = (i * 7 + v * 5) % numVertices;
+    }
+    std::vector<Vector4> faceNormals(numTriangles);
+    impl->calculateFaceNormals(positions.data(), triangles.data(), faceNormals.data(), numTriangles);
+    for (size_t i = 0; i < numTriangles; ++i)
+    {
+        const uint32* idx = triangles[i].vertIndex;
+        Vector4 expected = Math::calculateFaceNormalWithoutNormalize(
+            Vector3(&positions[idx[0] * 3]), Vector3(&positions[idx[1] * 3]), Vector3(&positions[idx[2] * 3]));
+        for (int j = 0; j < 4; ++j)
+            EXPECT_NEAR(expected[j], faceNormals[i][j], 1e-2);
+    }
+
+    Vector4 lightPos(3, -2, 1, 1);
+    std::vector<char> lightFacings(numTriangles);
+    impl->calculateLightFacing(lightPos, faceNormals.data(), lightFacings.data(), numTriangles);
+    for (size_t i = 0; i < numTriangles; ++i)
+        EXPECT_EQ(lightPos.dotProduct(faceNormals[i]) > 0, lightFacings[i]);
+
+    // extrusion for directional and point lights
+    for (Real w : {0, 1})
+    {
+        lightPos.w = w;
+        impl->extrudeVertices(lightPos, 100, positions.data(), dstPositions.data(), numVertices);
+        for (size_t i = 0; i < numVertices; ++i)
+        {
+            Vector3 pos(&positions[i * 3]);
+            Vector3 dir = w == 0 ? -lightPos.xyz() : pos - lightPos.xyz();
+            expectVector3Near((pos + dir.normalisedCopy() * 100).ptr(), &dstPositions[i * 3], 1e-3);
+        }
+    }
+}
+
+static void expectQuaternionNear(const Quaternion& expected, const Quaternion& actual, float tolerance)
+{
+    for (int i = 0; i < 4; ++i)
+        EXPECT_NEAR(expected[i], actual[i], tolerance);
+}
+
+TEST(ArrayMath, MatchesScalar)
+{
+    const size_t num = ARRAY_PACKED_REALS;
+    Vector3 positions[num], scales[num], vectors[num];
+    Quaternion p[num], q[num];
+    Real t[num];
+    for (size_t i = 0; i < num; ++i)
+    {
+        positions[i] = Vector3(Math::RangeRandom(-10, 10), Math::RangeRandom(-10, 10), Math::RangeRandom(-10, 10));
+        scales[i] = Vector3(Math::RangeRandom(0.5, 2), Math::RangeRandom(0.5, 2), Math::RangeRandom(0.5, 2));
+        vectors[i] = Vector3(Math::RangeRandom(-1, 1), Math::RangeRandom(-1, 1), Math::RangeRandom(-1, 1));
+        p[i] = Quaternion(Radian(Math::RangeRandom(-3, 3)), vectors[i].normalisedCopy());
+        q[i] = Quaternion(Radian(Math::RangeRandom(-3, 3)), scales[i].normalisedCopy());
+        t[i] = Math::UnitRandom();
+    }
+    // cover the nearly parallel and opposite slerp cases
+    q[1] = p[1];
+    q[2] = -p[2];
+    vectors[3] = Vector3::ZERO;
+
+    ArrayVector3 aPositions, aScales, aVectors;
+    ArrayQuaternion aP, aQ;
+    aPositions.loadPacked(positions);
+    aScales.loadPacked(scales);
+    aVectors.loadPacked(vectors);
+    aP.loadPacked(p);
+    aQ.loadPacked(q);
+    ArrayReal aT = ArrayMath::load(t);
+
+    Quaternion products[num], nlerped[num], slerped[num], slerpedShortest[num];
+    (aP * aQ).storePacked(products);
+    ArrayQuaternion::nlerp(aT, aP, aQ, true).storePacked(nlerped);
+    ArrayQuaternion::Slerp(aT, aP, aQ).storePacked(slerped);
+    ArrayQuaternion::Slerp(aT, aP, aQ, true).storePacked(slerpedShortest);
+
+    Vector3 rotated[num], transformed[num], normalised[num];
+    (aP * aVectors).storePacked(rotated);
+    ArrayVector3 aNormalised = aVectors;
+    aNormalised.normalise();
+    aNormalised.storePacked(normalised);
+
+    ArrayAffine3 aTransform, aConcatenated;
+    aTransform.makeTransform(aPositions, aScales, aP);
+    aConcatenated.makeTransform(aVectors, aScales, aQ);
+    aConcatenated = aTransform * aConcatenated;
+    (aConcatenated * aPositions).storePacked(transformed);
+
+    Affine3 transforms[num], concatenated[num];
+    aTransform.storePacked(transforms);
+    aConcatenated.storePacked(concatenated);
+
+    for (size_t i = 0; i < num; ++i)
+    {
+        expectQuaternionNear(p[i] * q[i], products[i], 1e-5);
+        expectQuaternionNear(Quaternion::nlerp(t[i], p[i], q[i], true), nlerped[i], 1e-5);
+        expectQuaternionNear(Quaternion::Slerp(t[i], p[i], q[i]), slerped[i], 1e-4);
+        expectQuaternionNear(Quaternion::Slerp(t[i], p[i], q[i], true), slerpedShortest[i], 1e-4);
+
+        expectVector3Near((p[i] * vectors[i]).ptr(), rotated[i].ptr(), 1e-5);
+        expectVector3Near(vectors[i].normalisedCopy().ptr(), normalised[i].ptr(), 1e-5);
+
+        Affine3 transform(positions[i], p[i], scales[i]);
+        Affine3 expected = transform * Affine3(vectors[i], q[i], scales[i]);
+        for (int j = 0; j < 16; ++j)
+        {
+            EXPECT_NEAR(transform[j / 4][j % 4], transforms[i][j / 4][j % 4], 1e-5);
+            EXPECT_NEAR(expected[j / 4][j % 4], concatenated[i][j / 4][j % 4], 1e-4);
+        }
+        expectVector3Near((expected * positions[i]).ptr(), transformed[i].ptr(), 1e-3);
+    }
+
+    // partial batches only write count elements
+    Vector3 partial[num] = {Vector3::ZERO, Vector3::ZERO, Vector3::ZERO, Vector3::ZERO};
+    aVectors.loadPacked(vectors, 2);
+    aVectors.storePacked(partial, 3);
+    EXPECT_EQ(vectors[0], partial[0]);
+    EXPECT_EQ(vectors[1], partial[1]);
+    EXPECT_EQ(vectors[1], partial[2]);
+    EXPECT_EQ(Vector3::ZERO, partial[3]);
+}
+
 typedef RootWithoutRenderSystemFixture SkeletonTests;
 TEST_F(SkeletonTests, linkedSkeletonAnimationSource)
 {
@@ -618,6 +1296,235 @@ TEST_F(SkeletonTests, linkedSkeletonAnimationSource)
     EXPECT_TRUE(entity->getAnimationState("Stealth")); // animation from ninja.sekeleton
 }
 
+TEST_F(SkeletonTests, batchedBoneMatrices)
+{
+    auto sceneMgr = mRoot->createSceneManager();
+    auto entity = sceneMgr->createEntity("jaiqua.mesh");
+    auto animState = entity->getAnimationState("Sneak");
+    animState->setEnabled(true);
+    animState->addTime(0.5);
+
+    SkeletonInstance* skeleton = entity->getSkeleton();
+    skeleton->setAnimationState(*entity->getAllAnimationStates());
+    ASSERT_NE(0u, skeleton->getNumBones() % ARRAY_PACKED_REALS); // covers a partial batch
+
+    std::vector<Affine3> matrices(skeleton->getNumBones());
+    skeleton->_getBoneMatrices(matrices.data());
+
+    for (unsigned short i = 0; i < skeleton->getNumBones(); ++i)
+    {
+        Affine3 expected;
+        skeleton->getBone(i)->_getOffsetTransform(expected);
+        for (int j = 0; j < 16; ++j)
+            EXPECT_NEAR(expected[j / 4][j % 4], matrices[i][j / 4][j % 4], 1e-4);
+    }
+}
+
+TEST_F(SkeletonTests, batchedAnimation)
+{
+    SkeletonPtr skeleton =
+        static_pointer_cast<Skeleton>(SkeletonManager::getSingleton().load("jaiqua.skeleton", RGN_DEFAULT));
+    Animation* anim = skeleton->getAnimation("Sneak");
+
+    AnimationState::BoneBlendMask blendMask(skeleton->getNumBones(), 0.5f);
+    blendMask[0] = 0;
+    blendMask[1] = 1;
+
+    for (auto rim : {Animation::RIM_LINEAR, Animation::RIM_SPHERICAL})
+    {
+        anim->setRotationInterpolationMode(rim);
+        // at a keyframe and in between, with and without scaling
+        for (Real scale : {1.0f, 0.8f})
+        {
+            for (Real time : {0.0f, 0.3f, 1.7f})
+            {
+                skeleton->reset();
+                anim->apply(skeleton.get(), time, 0.7f, &blendMask, scale);
+
+                std::vector<Vector3> positions, scales;
+                std::vector<Quaternion> orientations;
+                for (auto b : skeleton->getBones())
+                {
+                    positions.push_back(b->getPosition());
+                    orientations.push_back(b->getOrientation());
+                    scales.push_back(b->getScale());
+                }
+
+                // reference: apply the tracks one by one
+                skeleton->reset();
+                TimeIndex timeIndex = anim->_getTimeIndex(time);
+                for (const auto& t : anim->_getNodeTrackList())
+                {
+                    Bone* b = skeleton->getBone(t.first);
+                    t.second->applyToNode(b, timeIndex, blendMask[b->getHandle()] * 0.7f, scale);
+                }
+
+                for (auto b : skeleton->getBones())
+                {
+                    expectVector3Near(b->getPosition().ptr(), positions[b->getHandle()].ptr(), 1e-4);
+                    expectQuaternionNear(b->getOrientation(), orientations[b->getHandle()], 1e-5);
+                    expectVector3Near(b->getScale().ptr(), scales[b->getHandle()].ptr(), 1e-5);
+                }
+            }
+        }
+    }
+    skeleton->reset();
+
+    // the key index hint gives the same result as searching, including when time wraps
+    uint keyIndexHint = 0;
+    for (Real time = 0; time < anim->getLength() * 2; time += 0.05f)
+    {
+        EXPECT_EQ(anim->_getTimeIndex(time).getKeyIndex(), anim->_getTimeIndex(time, keyIndexHint).getKeyIndex());
+        EXPECT_EQ(anim->_getTimeIndex(time).getKeyIndex(), keyIndexHint);
+    }
+}
+
+static void getWorldTriangles(const VertexData* vertexData, const IndexData* indexData, const Affine3& xform,
+                              std::vector<Vector3>& triangles)
+{
+    auto posElem = vertexData->vertexDeclaration->findElementBySemantic(VES_POSITION);
+    auto vbuf = vertexData->vertexBufferBinding->getBuffer(posElem->getSource());
+    HardwareBufferLockGuard vertexLock(vbuf, HardwareBuffer::HBL_READ_ONLY);
+    HardwareBufferLockGuard indexLock(indexData->indexBuffer, HardwareBuffer::HBL_READ_ONLY);
+    bool use32Bit = indexData->indexBuffer->getType() == HardwareIndexBuffer::IT_32BIT;
+    for (size_t i = indexData->indexStart; i < indexData->indexStart + indexData->indexCount; ++i)
+    {
+        uint32 index = use32Bit ? static_cast<uint32*>(indexLock.pData)[i] : static_cast<uint16*>(indexLock.pData)[i];
+        float* pos;
+        posElem->baseVertexPointerToElement(
+            static_cast<uchar*>(vertexLock.pData) + (vertexData->vertexStart + index) * vbuf->getVertexSize(), &pos);
+        triangles.push_back(xform * Vector3(pos[0], pos[1], pos[2]));
+    }
+}
+
+static RayTestResult bruteForceRaycast(const Ray& ray, const std::vector<Vector3>& triangles)
+{
+    RayTestResult result(false, 0);
+    for (size_t i = 0; i < triangles.size(); i += 3)
+    {
+        RayTestResult hit = Math::intersects(ray, triangles[i], triangles[i + 1], triangles[i + 2]);
+        if (hit.first && (!result.first || hit.second < result.second))
+            result = hit;
+    }
+    return result;
+}
+
+typedef RootWithoutRenderSystemFixture TriangleTreeTests;
+TEST_F(TriangleTreeTests, EntityMatchesBruteForce)
+{
+    auto sceneMgr = mRoot->createSceneManager();
+    Entity* entity = sceneMgr->createEntity("Sinbad.mesh");
+    SceneNode* node = sceneMgr->getRootSceneNode()->createChildSceneNode(Vector3(10, -5, 3));
+    node->attachObject(entity);
+    node->setOrientation(Quaternion(Degree(30), Vector3(1, 2, 3).normalisedCopy()));
+    node->setScale(Vector3(1.5));
+
+    minstd_rand rng;
+    auto random = [&rng](Real min, Real max) { return min + (max - min) * Real(rng()) / rng.max(); };
+
+    // the bind pose first, then the software skinned positions
+    std::vector<Vector3> bindPose;
+    for (bool animated : {false, true})
+    {
+        if (animated)
+        {
+            AnimationState* state = entity->getAnimationState("Dance");
+            state->setEnabled(true);
+            state->addTime(0.5);
+            entity->_updateAnimation();
+        }
+
+        std::vector<Vector3> triangles;
+        for (auto sub : entity->getSubEntities())
+        {
+            const VertexData* vertexData = sub->getSubMesh()->useSharedVertices
+                                               ? entity->getMesh()->sharedVertexData
+                                               : sub->getSubMesh()->vertexData;
+            if (animated)
+                vertexData = sub->getSubMesh()->useSharedVertices ? entity->_getSkelAnimVertexData()
+                                                                  : sub->_getSkelAnimVertexData();
+            getWorldTriangles(vertexData, sub->getSubMesh()->indexData, node->_getFullTransform(), triangles);
+        }
+
+        if (!animated)
+            bindPose = triangles;
+
+        const AxisAlignedBox& box = entity->getWorldBoundingBox(true);
+        size_t numHits = 0, numMoved = 0;
+        for (int i = 0; i < 200; ++i)
+        {
+            Vector3 origin = box.getCenter() + Vector3(random(-1, 1), random(-1, 1), random(-1, 1)) * box.getSize();
+            Vector3 target(random(box.getMinimum().x, box.getMaximum().x),
+                           random(box.getMinimum().y, box.getMaximum().y),
+                           random(box.getMinimum().z, box.getMaximum().z));
+            Ray ray(origin, (target - origin).normalisedCopy());
+
+            RayTestResult expected = bruteForceRaycast(ray, triangles);
+            RayTestResult hit = entity->raycast(ray);
+            ASSERT_EQ(expected.first, hit.first);
+            if (hit.first)
+                EXPECT_NEAR(expected.second, hit.second, 1e-3);
+            numHits += hit.first;
+            RayTestResult bindPoseHit = bruteForceRaycast(ray, bindPose);
+            numMoved += hit.first != bindPoseHit.first || std::abs(hit.second - bindPoseHit.second) > 1e-3;
+        }
+        EXPECT_GT(numHits, 20u);
+        EXPECT_EQ(animated, numMoved > 0);
+    }
+
+    // ray packets match single rays, including a partial packet
+    const TriangleTree& tree = entity->getMesh()->getSubMesh(0)->_getTriangleTree();
+    const AxisAlignedBox& bounds = entity->getMesh()->getBounds();
+    std::vector<Ray> rays;
+    for (int i = 0; i < 4 * 16 + 3; ++i)
+    {
+        Vector3 origin = bounds.getCenter() + Vector3(random(-0.2, 0.2), random(-0.2, 0.2), 2) * bounds.getSize();
+        rays.push_back(Ray(origin, (bounds.getCenter() - origin).normalisedCopy()));
+    }
+    std::vector<RayTestResult> results(rays.size());
+    tree.intersects(rays.data(), rays.size(), results.data());
+    for (size_t i = 0; i < rays.size(); ++i)
+    {
+        RayTestResult expected = tree.intersects(rays[i]);
+        ASSERT_EQ(expected.first, results[i].first);
+        EXPECT_FLOAT_EQ(expected.second, results[i].second);
+    }
+}
+
+TEST_F(TriangleTreeTests, ManualObject)
+{
+    auto sceneMgr = mRoot->createSceneManager();
+    ManualObject* obj = sceneMgr->createManualObject();
+    sceneMgr->getRootSceneNode()->createChildSceneNode(Vector3(0, 0, -10))->attachObject(obj);
+
+    auto makeQuad = [obj](Real z) {
+        obj->position(-1, -1, z);
+        obj->position(1, -1, z);
+        obj->position(-1, 1, z);
+        obj->position(1, 1, z);
+        obj->end();
+    };
+
+    obj->begin("BaseWhite", RenderOperation::OT_TRIANGLE_STRIP);
+    makeQuad(0);
+
+    Ray ray(Vector3(0.5, 0.5, 0), Vector3::NEGATIVE_UNIT_Z);
+    size_t section = 1, triangle = 2;
+    RayTestResult hit = obj->raycast(ray, &section, &triangle);
+    ASSERT_TRUE(hit.first);
+    EXPECT_FLOAT_EQ(10, hit.second);
+    EXPECT_EQ(0u, section);
+    EXPECT_EQ(1u, triangle);
+    EXPECT_FALSE(obj->raycast(Ray(Vector3(2, 0, 0), Vector3::NEGATIVE_UNIT_Z)).first);
+
+    // the tree is rebuilt after updating the section
+    obj->beginUpdate(0);
+    makeQuad(2);
+    hit = obj->raycast(ray);
+    ASSERT_TRUE(hit.first);
+    EXPECT_FLOAT_EQ(8, hit.second);
+}
+
 TEST(MaterialLoading, LateShadowCaster)
 {
     Root root("");
@@ -708,6 +1615,250 @@ TEST(GpuProgramParams, Variability)
     EXPECT_EQ(params.getConstantDefinition("parameter").variability, GPV_PER_OBJECT);
 }
 
+TEST(GpuProgramParams, UpdateAutoParams)
+{
+    Root root("");
+    SceneManager* sm = root.createSceneManager();
+    Camera* cam = sm->createCamera("Camera");
+    sm->getRootSceneNode()->createChildSceneNode(Vector3(0, 0, 100))->attachObject(cam);
+    sm->_updateSceneGraph(cam);
+
+    auto constants = std::make_shared<GpuNamedConstants>();
+    for (auto name : {"world", "view", "ambient", "packedWorld"})
+    {
+        GpuConstantDefinition def;
+        def.constType = strcmp(name, "ambient") == 0 ? GCT_FLOAT4 : GCT_MATRIX_4X4;
+        def.elementSize = GpuConstantDefinition::getElementSize(def.constType, false);
+        def.physicalIndex = constants->bufferSize * 4;
+        def.arraySize = 1;
+        constants->bufferSize += def.elementSize;
+        constants->map[name] = def;
+    }
+
+    GpuProgramParameters params;
+    params._setNamedConstants(constants);
+    params.setNamedAutoConstant("world", GpuProgramParameters::ACT_WORLD_MATRIX);
+    params.setNamedAutoConstant("view", GpuProgramParameters::ACT_VIEW_MATRIX);
+    params.setNamedAutoConstant("ambient", GpuProgramParameters::ACT_AMBIENT_LIGHT_COLOUR);
+    // uses the generic path
+    params.setNamedAutoConstant("packedWorld", GpuProgramParameters::ACT_TRANSPOSE_WORLD_MATRIX);
+
+    Affine3 world = Affine3::getTrans(1, 2, 3) * Affine3::getScale(2, 2, 2);
+    AutoParamDataSource source;
+    source.setCurrentSceneManager(sm);
+    source.setCurrentCamera(cam, false);
+    source.setWorldMatrices(&world, 1);
+    source.setAmbientLightColour(ColourValue(0.1, 0.2, 0.3));
+
+    auto readMatrix = [&params](const char* name) {
+        float m[16];
+        params._readRawConstants(params.getConstantDefinition(name).physicalIndex, 16, m);
+        return Matrix4(m);
+    };
+
+    // only the per object autos are written
+    params._updateAutoParams(&source, GPV_PER_OBJECT);
+    EXPECT_EQ(readMatrix("world"), Matrix4(world));
+    EXPECT_EQ(readMatrix("packedWorld"), Matrix4(world).transpose());
+    EXPECT_EQ(readMatrix("view"), Matrix4::ZERO);
+
+    params._updateAutoParams(&source, GPV_GLOBAL);
+    EXPECT_EQ(readMatrix("view"), Matrix4(source.getViewMatrix()));
+    float ambient[4];
+    params._readRawConstants(params.getConstantDefinition("ambient").physicalIndex, 4, ambient);
+    EXPECT_EQ(ColourValue(ambient[0], ambient[1], ambient[2], ambient[3]), ColourValue(0.1, 0.2, 0.3));
+
+    // changing the autos and the layout is picked up
+    params.setTransposeMatrices(true);
+    params.clearNamedAutoConstant("packedWorld");
+    params._writeRawConstant(params.getConstantDefinition("packedWorld").physicalIndex, Matrix4::ZERO, 16);
+    params._updateAutoParams(&source, GPV_ALL);
+    EXPECT_EQ(readMatrix("world"), Matrix4(world).transpose());
+    EXPECT_EQ(readMatrix("view"), Matrix4(source.getViewMatrix()).transpose());
+    EXPECT_EQ(readMatrix("packedWorld"), Matrix4::ZERO);
+
+    // so are entries modified in place
+    GpuProgramParameters::AutoConstantEntry* entry = params.getAutoConstantEntry(1);
+    ASSERT_TRUE(entry);
+    EXPECT_EQ(entry->paramType, GpuProgramParameters::ACT_VIEW_MATRIX);
+    entry->paramType = GpuProgramParameters::ACT_WORLD_MATRIX;
+    params._updateAutoParams(&source, GPV_ALL);
+    EXPECT_EQ(readMatrix("view"), Matrix4(world).transpose());
+}
+
+TEST(GpuProgramParams, NamedConstantHandle)
+{
+    auto constants = std::make_shared<GpuNamedConstants>();
+    auto addConstant = [&constants](const String& name, GpuConstantType type, uint32 arraySize) {
+        GpuConstantDefinition def;
+        def.constType = type;
+        def.elementSize = GpuConstantDefinition::getElementSize(type, false);
+        def.arraySize = arraySize;
+        def.physicalIndex = constants->bufferSize * 4;
+        constants->bufferSize += def.elementSize * arraySize;
+        constants->map[name] = def;
+    };
+    // enough names to get hash collisions
+    for (int i = 0; i < 64; i++)
+        addConstant(StringUtil::format("param%d", i), GCT_FLOAT1, 1);
+    addConstant("colour", GCT_FLOAT4, 1);
+    addConstant("lights", GCT_FLOAT4, 4);
+    addConstant("counts", GCT_INT1, 2);
+
+    // programs index the definitions once they are complete
+    constants->generateHashIndex();
+    GpuProgramParameters params;
+    params._setNamedConstants(constants);
+
+    for (int i = 0; i < 64; i++)
+    {
+        String name = StringUtil::format("param%d", i);
+        EXPECT_EQ(params._findNamedConstantDefinition(name), &constants->map[name]);
+        params.setNamedConstant(name, float(i));
+    }
+    EXPECT_EQ(params._findNamedConstantDefinition("param64"), (GpuConstantDefinition*)NULL);
+    EXPECT_THROW(params.getNamedConstantHandle("param64"), InvalidParametersException);
+
+    GpuConstantHandle colour = params.getNamedConstantHandle("colour");
+    ASSERT_TRUE(colour.isValid());
+    params.setNamedConstant(colour, ColourValue(1, 2, 3, 4));
+    GpuConstantHandle light2 = params.getNamedConstantHandle("lights[2]");
+    EXPECT_EQ(light2.size, 8u);
+    params.setNamedConstant(light2, Vector4(5, 6, 7, 8));
+
+    float vals[4];
+    params._readRawConstants(params._findNamedConstantDefinition("param42")->physicalIndex, 1, vals);
+    EXPECT_EQ(vals[0], 42);
+    params._readRawConstants(params._findNamedConstantDefinition("colour")->physicalIndex, 4, vals);
+    EXPECT_EQ(Vector4(vals[0], vals[1], vals[2], vals[3]), Vector4(1, 2, 3, 4));
+    params._readRawConstants(params._findNamedConstantDefinition("lights")->physicalIndex + 2 * 16, 4, vals);
+    EXPECT_EQ(Vector4(vals[0], vals[1], vals[2], vals[3]), Vector4(5, 6, 7, 8));
+
+    // handles are shared by all parameters of a program
+    GpuProgramParameters params2;
+    params2._setNamedConstants(constants);
+    params2.setNamedConstant(light2, Vector4(1, 1, 1, 1));
+    params2._readRawConstants(light2.physicalIndex, 4, vals);
+    EXPECT_EQ(Vector4(vals[0], vals[1], vals[2], vals[3]), Vector4(1, 1, 1, 1));
+
+    // handles do not keep the name, it is looked up for the error
+    int counts[3] = {};
+    try
+    {
+        params.setNamedConstant("counts", counts, 3, 1);
+        ADD_FAILURE();
+    }
+    catch (const InvalidParametersException& e)
+    {
+        EXPECT_NE(e.getDescription().find("counts"), String::npos) << e.getDescription();
+    }
+
+    params.setIgnoreMissingParams(true);
+    EXPECT_FALSE(params.getNamedConstantHandle("missing").isValid());
+    params.setNamedConstant(GpuConstantHandle(), 1.0f);
+
+    // copies index their own map
+    GpuNamedConstants copy = *constants;
+    constants.reset();
+    EXPECT_EQ(copy.find("colour", 6), &copy.map["colour"]);
+
+    // and so do loaded definitions
+    const String file = "./NamedConstantHandle.constants";
+    copy.save(file);
+    DataStreamPtr stream = Root::openFileStream(file);
+    GpuNamedConstants loaded;
+    loaded.load(stream);
+    stream.reset();
+    std::remove(file.c_str());
+    EXPECT_TRUE(loaded.hasHashIndex());
+    EXPECT_EQ(loaded.find("colour", 6), &loaded.map["colour"]);
+}
+
+struct GeometryRenderable : public Renderable
+{
+    MaterialPtr mMaterial;
+    VertexData* mVertexData;
+
+    const MaterialPtr& getMaterial(void) const override { return mMaterial; }
+    void getRenderOperation(RenderOperation& op) override { op.vertexData = mVertexData; }
+    void getWorldTransforms(Matrix4* xform) const override { *xform = Matrix4::IDENTITY; }
+    Real getSquaredViewDepth(const Camera* cam) const override { return 0; }
+    const LightList& getLights(void) const override
+    {
+        static LightList lights;
+        return lights;
+    }
+};
+
+struct PassGroupCollector : public QueuedRenderableVisitor
+{
+    std::vector<std::vector<Renderable*>> groups;
+    void visit(RenderablePass* rp) override {}
+    void visit(const Pass* p, RenderableList& rs) override { groups.push_back(rs); }
+};
+
+TEST(RenderQueue, StateSortPassGroup)
+{
+    Root root("");
+    auto mat = MaterialManager::getSingleton().create("StateSort", RGN_DEFAULT);
+    Pass* pass = mat->createTechnique()->createPass();
+
+    VertexData geometry[3] = {{NULL, NULL}, {NULL, NULL}, {NULL, NULL}};
+    std::vector<GeometryRenderable> rends(12);
+    for (size_t i = 0; i < rends.size(); ++i)
+    {
+        rends[i].mMaterial = mat;
+        rends[i].mVertexData = &geometry[i % 3];
+    }
+
+    QueuedRenderableCollection collection;
+    collection.addOrganisationMode(QueuedRenderableCollection::OM_PASS_GROUP);
+    for (auto& r : rends)
+        collection.addRenderable(pass, &r);
+    collection.sort(NULL);
+
+    PassGroupCollector collector;
+    collection.acceptVisitor(&collector, QueuedRenderableCollection::OM_PASS_GROUP);
+    ASSERT_EQ(collector.groups.size(), 1u);
+    auto& group = collector.groups[0];
+    ASSERT_EQ(group.size(), rends.size());
+
+    // renderables sharing geometry are contiguous, in order of first appearance
+    // and keep their submission order within a run
+    for (size_t i = 0; i < group.size(); ++i)
+        EXPECT_EQ(group[i], &rends[(i % 4) * 3 + i / 4]);
+}
+
+TEST(RenderQueue, UnsortedTransparentsKeepOrder)
+{
+    Root root("");
+    auto mat = MaterialManager::getSingleton().create("UnsortedTransparents", RGN_DEFAULT);
+    Technique* tech = mat->createTechnique();
+    Pass* pass = tech->createPass();
+    pass->setSceneBlending(SBT_TRANSPARENT_ALPHA);
+    pass->setDepthWriteEnabled(false);
+    pass->setTransparentSortingEnabled(false);
+
+    VertexData geometry[3] = {{NULL, NULL}, {NULL, NULL}, {NULL, NULL}};
+    std::vector<GeometryRenderable> rends(12);
+    RenderPriorityGroup group(NULL, false, false, false);
+    for (size_t i = 0; i < rends.size(); ++i)
+    {
+        rends[i].mMaterial = mat;
+        rends[i].mVertexData = &geometry[i % 3];
+        group.addRenderable(&rends[i], tech);
+    }
+    group.sort(NULL);
+
+    // blending is not commutative, so these are drawn as submitted
+    PassGroupCollector collector;
+    group.getTransparentsUnsorted().acceptVisitor(&collector, QueuedRenderableCollection::OM_PASS_GROUP);
+    ASSERT_EQ(collector.groups.size(), 1u);
+    ASSERT_EQ(collector.groups[0].size(), rends.size());
+    for (size_t i = 0; i < rends.size(); ++i)
+        EXPECT_EQ(collector.groups[0][i], &rends[i]);
+}
+
 TEST(Billboard, TextureCoords)
 {
     Root root("");
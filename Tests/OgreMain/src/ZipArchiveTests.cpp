@@ -30,6 +30,10 @@ THE SOFTWARE.
 #include "OgreCommon.h"
 #include "OgreConfigFile.h"
 #include "OgreFileSystemLayer.h"
+#include "OgreException.h"
+
+#include <atomic>
+#include <thread>
 
 using namespace Ogre;
 
@@ -258,3 +262,79 @@ TEST_F(ZipArchiveTests,ReadInterleave)
     EXPECT_TRUE(stream2->eof());
 }
 //--------------------------------------------------------------------------
+TEST_F(ZipArchiveTests,ConcurrentRead)
+{
+    String expected[2];
+    expected[0] = arch->open("rootfile.txt")->getAsString();
+    expected[1] = arch->open("rootfile2.txt")->getAsString();
+
+    std::vector<std::thread> threads;
+    std::atomic<int> failures(0);
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([this, &expected, &failures, t]() {
+            for (int i = 0; i < 100; ++i)
+            {
+                int f = (i + t) % 2;
+                if (arch->open(f ? "rootfile2.txt" : "rootfile.txt")->getAsString() != expected[f])
+                    failures++;
+            }
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+    EXPECT_EQ(0, failures);
+
+    EXPECT_TRUE(arch->exists("rootfile2.txt"));
+    EXPECT_FALSE(arch->exists("missing.txt"));
+    EXPECT_THROW(arch->open("missing.txt"), FileNotFoundException);
+}
+//--------------------------------------------------------------------------
+TEST_F(ZipArchiveTests,StoredAndStreamedEntries)
+{
+    String testPath = arch->getName();
+    testPath = testPath.substr(0, testPath.rfind('/')) + "/ArchiveTestMethods.zip";
+    Archive* methods = ZipArchiveFactory().createInstance(testPath, true);
+    methods->load();
+
+    // stored entries are not copied
+    DataStreamPtr stored = methods->open("stored.txt");
+    auto storedMem = dynamic_cast<MemoryDataStream*>(stored.get());
+    ASSERT_TRUE(storedMem);
+    EXPECT_EQ(storedMem->getPtr(), static_cast<MemoryDataStream*>(methods->open("stored.txt").get())->getPtr());
+    EXPECT_EQ(String("stored line 0"), stored->getLine());
+    EXPECT_EQ(size_t(1490), stored->size());
+
+    String deflated = methods->open("deflated.txt")->getAsString();
+    EXPECT_EQ(size_t(74890), deflated.size());
+
+    ZipArchiveFactory::setStreamCompressedEntries(true);
+    DataStreamPtr streamed = methods->open("deflated.txt");
+    ZipArchiveFactory::setStreamCompressedEntries(false);
+
+    EXPECT_FALSE(dynamic_cast<MemoryDataStream*>(streamed.get()));
+    EXPECT_EQ(deflated.size(), streamed->size());
+    EXPECT_EQ(String("deflated line 0"), streamed->getLine());
+
+    // seek beyond the cached data in both directions
+    char buf[16];
+    streamed->seek(60000);
+    EXPECT_EQ(sizeof(buf), streamed->read(buf, sizeof(buf)));
+    EXPECT_EQ(deflated.substr(60000, sizeof(buf)), String(buf, sizeof(buf)));
+    streamed->seek(100);
+    EXPECT_EQ(sizeof(buf), streamed->read(buf, sizeof(buf)));
+    EXPECT_EQ(deflated.substr(100, sizeof(buf)), String(buf, sizeof(buf)));
+    EXPECT_EQ(deflated, streamed->getAsString());
+
+    // entries that are completely inflated by the first bytes
+    EXPECT_EQ(String("abc"), methods->open("tiny.txt")->getAsString());
+    ZipArchiveFactory::setStreamCompressedEntries(true);
+    EXPECT_EQ(String("abc"), methods->open("tiny.txt")->getAsString());
+    ZipArchiveFactory::setStreamCompressedEntries(false);
+
+    // streams keep the archive data alive
+    OGRE_DELETE methods;
+    stored->seek(0);
+    EXPECT_EQ(String("stored line 0"), stored->getLine());
+}
+//--------------------------------------------------------------------------
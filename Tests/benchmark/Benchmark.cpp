@@ -0,0 +1,250 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <regex>
+#include <sstream>
+#include <thread>
+
+namespace benchmark
+{
+    void State::PauseTiming()
+    {
+        if (mPaused)
+            return;
+        mRealTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - mRealStart).count();
+        mCpuTime += double(std::clock() - mCpuStart) / CLOCKS_PER_SEC;
+        mPaused = true;
+    }
+
+    void State::ResumeTiming()
+    {
+        if (!mPaused)
+            return;
+        mPaused = false;
+        mCpuStart = std::clock();
+        mRealStart = std::chrono::steady_clock::now();
+    }
+
+    static std::vector<std::unique_ptr<Benchmark>>& getBenchmarks()
+    {
+        static std::vector<std::unique_ptr<Benchmark>> benchmarks;
+        return benchmarks;
+    }
+
+    Benchmark* RegisterBenchmark(const char* name, Function func)
+    {
+        getBenchmarks().emplace_back(new Benchmark(name, func));
+        return getBenchmarks().back().get();
+    }
+
+    struct Result
+    {
+        std::string name;
+        size_t iterations;
+        double realTime; // ns per iteration
+        double cpuTime;  // ns per iteration
+        double itemsPerSecond;
+        double bytesPerSecond;
+        std::string label;
+    };
+
+    static std::string escapeJson(const std::string& str)
+    {
+        std::string ret;
+        for (char c : str)
+        {
+            if (c == '"' || c == '\\')
+                ret += '\\';
+            ret += c;
+        }
+        return ret;
+    }
+
+    static void writeJson(std::ostream& os, const std::vector<Result>& results, const char* executable)
+    {
+        char date[64];
+        std::time_t now = std::time(NULL);
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+        os << "{\n  \"context\": {\n";
+        os << "    \"date\": \"" << date << "\",\n";
+        os << "    \"executable\": \"" << escapeJson(executable) << "\",\n";
+        os << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+#ifdef NDEBUG
+        os << "    \"library_build_type\": \"release\"\n";
+#else
+        os << "    \"library_build_type\": \"debug\"\n";
+#endif
+        os << "  },\n  \"benchmarks\": [";
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const Result& r = results[i];
+            os << (i ? ",\n" : "\n") << "    {\n";
+            os << "      \"name\": \"" << escapeJson(r.name) << "\",\n";
+            os << "      \"run_name\": \"" << escapeJson(r.name) << "\",\n";
+            os << "      \"run_type\": \"iteration\",\n";
+            os << "      \"iterations\": " << r.iterations << ",\n";
+            os << "      \"real_time\": " << r.realTime << ",\n";
+            os << "      \"cpu_time\": " << r.cpuTime << ",\n";
+            os << "      \"time_unit\": \"ns\"";
+            if (r.itemsPerSecond > 0)
+                os << ",\n      \"items_per_second\": " << r.itemsPerSecond;
+            if (r.bytesPerSecond > 0)
+                os << ",\n      \"bytes_per_second\": " << r.bytesPerSecond;
+            if (!r.label.empty())
+                os << ",\n      \"label\": \"" << escapeJson(r.label) << "\"";
+            os << "\n    }";
+        }
+        os << "\n  ]\n}\n";
+    }
+
+    static void writeConsole(std::ostream& os, const Result& r)
+    {
+        char line[256];
+        std::snprintf(line, sizeof(line), "%-48s %14.0f ns %14.0f ns %10zu", r.name.c_str(), r.realTime,
+                      r.cpuTime, r.iterations);
+        os << line;
+        if (r.itemsPerSecond > 0)
+        {
+            std::snprintf(line, sizeof(line), " items_per_second=%.4g/s", r.itemsPerSecond);
+            os << line;
+        }
+        if (r.bytesPerSecond > 0)
+        {
+            std::snprintf(line, sizeof(line), " bytes_per_second=%.4g/s", r.bytesPerSecond);
+            os << line;
+        }
+        if (!r.label.empty())
+            os << " " << r.label;
+        os << std::endl;
+    }
+
+    struct Runner
+    {
+        double minTime;
+
+        Result run(const Benchmark& b, const std::string& name, const std::vector<int64_t>& args)
+        {
+            size_t iterations = 1;
+            while (true)
+            {
+                State state(iterations, args);
+                b.mFunc(state);
+                state.PauseTiming();
+
+                // same iteration growth as Google Benchmark
+                const size_t maxIterations = 1000000000;
+                if (state.mRealTime >= minTime || iterations >= maxIterations)
+                {
+                    Result r;
+                    r.name = name;
+                    r.iterations = iterations;
+                    r.realTime = state.mRealTime * 1e9 / iterations;
+                    r.cpuTime = state.mCpuTime * 1e9 / iterations;
+                    r.itemsPerSecond = state.mRealTime > 0 ? state.mItemsProcessed / state.mRealTime : 0;
+                    r.bytesPerSecond = state.mRealTime > 0 ? state.mBytesProcessed / state.mRealTime : 0;
+                    r.label = state.mLabel;
+                    return r;
+                }
+
+                double multiplier = state.mRealTime > 0 ? minTime * 1.4 / state.mRealTime : 10;
+                multiplier = std::min(std::max(multiplier, 2.0), 10.0);
+                iterations = std::min(size_t(iterations * multiplier), maxIterations);
+            }
+        }
+    };
+
+    static const char* getOption(const char* arg, const char* name)
+    {
+        size_t len = std::strlen(name);
+        if (std::strncmp(arg, name, len) == 0 && arg[len] == '=')
+            return arg + len + 1;
+        return NULL;
+    }
+
+    int RunBenchmarks(int argc, char** argv)
+    {
+        std::string filter = ".";
+        std::string format = "console";
+        std::string out;
+        Runner runner;
+        runner.minTime = 0.5;
+
+        for (int i = 1; i < argc; ++i)
+        {
+            const char* value;
+            if ((value = getOption(argv[i], "--benchmark_filter")))
+                filter = value;
+            else if ((value = getOption(argv[i], "--benchmark_min_time")))
+                runner.minTime = std::atof(value);
+            else if ((value = getOption(argv[i], "--benchmark_format")))
+                format = value;
+            else if ((value = getOption(argv[i], "--benchmark_out")))
+                out = value;
+            else
+            {
+                std::cerr << "usage: " << argv[0]
+                          << " [--benchmark_filter=<regex>] [--benchmark_min_time=<seconds>]"
+                             " [--benchmark_format=<console|json>] [--benchmark_out=<file>]"
+                          << std::endl;
+                return 1;
+            }
+        }
+
+        std::regex re(filter);
+        bool console = format != "json";
+        if (console)
+        {
+            char header[256];
+            std::snprintf(header, sizeof(header), "%-48s %17s %17s %10s", "Benchmark", "Time", "CPU",
+                          "Iterations");
+            std::cout << header << "\n" << std::string(std::strlen(header), '-') << std::endl;
+        }
+
+        std::vector<Result> results;
+        for (const auto& b : getBenchmarks())
+        {
+            std::vector<std::vector<int64_t>> argSets = b->mArgs;
+            if (argSets.empty())
+                argSets.emplace_back();
+
+            for (const auto& args : argSets)
+            {
+                std::string name = b->mName;
+                for (int64_t arg : args)
+                    name += "/" + std::to_string(arg);
+                if (!std::regex_search(name, re))
+                    continue;
+
+                results.push_back(runner.run(*b, name, args));
+                if (console)
+                    writeConsole(std::cout, results.back());
+            }
+        }
+
+        if (!console)
+            writeJson(std::cout, results, argv[0]);
+
+        if (!out.empty())
+        {
+            std::ofstream file(out.c_str());
+            if (!file)
+            {
+                std::cerr << "could not open " << out << std::endl;
+                return 1;
+            }
+            writeJson(file, results, argv[0]);
+        }
+
+        return 0;
+    }
+}
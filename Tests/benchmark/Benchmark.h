@@ -0,0 +1,155 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+#ifndef TESTS_BENCHMARK_BENCHMARK_H_
+#define TESTS_BENCHMARK_BENCHMARK_H_
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+
+/** Minimal micro-benchmark harness.
+
+    Implements the subset of the Google Benchmark API used by the OGRE benchmarks, so they can be
+    built without further dependencies, while the command line options and the JSON output are
+    compatible with the Google Benchmark tools (e.g. compare.py):
+
+    - @c --benchmark_filter=<regex> only runs the matching benchmarks
+    - @c --benchmark_min_time=<seconds> minimum time per benchmark, 0 runs a single iteration
+    - @c --benchmark_format=<console|json> format written to stdout
+    - @c --benchmark_out=<file> additionally writes JSON results to the file
+*/
+namespace benchmark
+{
+    class State
+    {
+    public:
+        struct Value
+        {
+            // non trivial, so unused loop variables do not trigger warnings
+            Value() {}
+            ~Value() {}
+        };
+
+        class Iterator
+        {
+        public:
+            explicit Iterator(State* state) : mState(state), mRemaining(state ? state->mIterations : 0) {}
+            Value operator*() const { return Value(); }
+            Iterator& operator++()
+            {
+                --mRemaining;
+                return *this;
+            }
+            bool operator!=(const Iterator&)
+            {
+                if (mRemaining)
+                    return true;
+                mState->finishKeepRunning();
+                return false;
+            }
+
+        private:
+            State* mState;
+            size_t mRemaining;
+        };
+
+        State(size_t iterations, const std::vector<int64_t>& args)
+            : mIterations(iterations), mArgs(args), mItemsProcessed(0), mBytesProcessed(0), mPaused(true),
+              mRealTime(0), mCpuTime(0)
+        {
+        }
+
+        Iterator begin()
+        {
+            ResumeTiming();
+            return Iterator(this);
+        }
+        Iterator end() { return Iterator(NULL); }
+
+        /// Argument n of the current run, see Benchmark::Arg
+        int64_t range(size_t n = 0) const { return mArgs.at(n); }
+        size_t iterations() const { return mIterations; }
+
+        /// Exclude the following code from the measurement, until ResumeTiming is called
+        void PauseTiming();
+        void ResumeTiming();
+
+        /// Total number of items processed by all iterations, reported as items per second
+        void SetItemsProcessed(int64_t items) { mItemsProcessed = items; }
+        /// Total number of bytes processed by all iterations, reported as bytes per second
+        void SetBytesProcessed(int64_t bytes) { mBytesProcessed = bytes; }
+        void SetLabel(const std::string& label) { mLabel = label; }
+
+    private:
+        friend struct Runner;
+        void finishKeepRunning() { PauseTiming(); }
+
+        size_t mIterations;
+        std::vector<int64_t> mArgs;
+        int64_t mItemsProcessed;
+        int64_t mBytesProcessed;
+        std::string mLabel;
+
+        bool mPaused;
+        std::chrono::steady_clock::time_point mRealStart;
+        std::clock_t mCpuStart;
+        double mRealTime;
+        double mCpuTime;
+    };
+
+    typedef void (*Function)(State&);
+
+    class Benchmark
+    {
+    public:
+        Benchmark(const char* name, Function func) : mName(name), mFunc(func) {}
+
+        /// Run the benchmark once for each given argument
+        Benchmark* Arg(int64_t arg)
+        {
+            mArgs.push_back(std::vector<int64_t>(1, arg));
+            return this;
+        }
+        /// Run the benchmark once for each given set of arguments
+        Benchmark* Args(const std::vector<int64_t>& args)
+        {
+            mArgs.push_back(args);
+            return this;
+        }
+
+    private:
+        friend struct Runner;
+        friend int RunBenchmarks(int argc, char** argv);
+        std::string mName;
+        Function mFunc;
+        std::vector<std::vector<int64_t>> mArgs;
+    };
+
+    Benchmark* RegisterBenchmark(const char* name, Function func);
+
+    /// Parses the command line and runs the registered benchmarks, returns the exit code
+    int RunBenchmarks(int argc, char** argv);
+
+    /// Prevents the compiler from optimising away the computation of value
+    template <class T> inline void DoNotOptimize(T const& value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static volatile const void* sink;
+        sink = &value;
+#endif
+    }
+}
+
+#define OGRE_BENCHMARK_CONCAT2(a, b) a##b
+#define OGRE_BENCHMARK_CONCAT(a, b) OGRE_BENCHMARK_CONCAT2(a, b)
+/// Registers the function as a benchmark, arguments can be appended as in BENCHMARK(func)->Arg(10)
+#define BENCHMARK(func)                                                                                      \
+    static benchmark::Benchmark* OGRE_BENCHMARK_CONCAT(sBenchmark_, __LINE__) =                              \
+        benchmark::RegisterBenchmark(#func, func)
+
+#endif /* TESTS_BENCHMARK_BENCHMARK_H_ */
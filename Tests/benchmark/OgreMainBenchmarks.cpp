@@ -0,0 +1,839 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+#include "Benchmark.h"
+
+#include "Ogre.h"
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreFileSystemLayer.h"
+#include "OgreOptimisedUtil.h"
+#include "OgreMeshSerializer.h"
+#include "OgreSkeletonSerializer.h"
+#include "OgreRenderQueueSortingGrouping.h"
+#include "OgreTriangleTree.h"
+
+#include <random>
+
+using namespace Ogre;
+
+//--------------------------------------------------------------------------
+// Scene graph
+//--------------------------------------------------------------------------
+static void createRandomTree(SceneManager* mgr, size_t nodeCount, int spread)
+{
+    // we want cross platform consistent sequence
+    std::minstd_rand rng;
+
+    std::vector<SceneNode*> nodes(1, mgr->getRootSceneNode());
+    for (size_t n = 0; n < nodeCount; ++n)
+    {
+        SceneNode* parent = nodes[rng() % nodes.size()];
+        SceneNode* node = parent->createChildSceneNode(
+            Vector3(int(rng() % spread) - spread / 2, int(rng() % spread) - spread / 2, int(rng() % spread) - spread / 2),
+            Quaternion(Degree(rng() % 360), Vector3::UNIT_Y));
+        if (n % 3 == 0)
+            node->attachObject(mgr->createEntity("sphere.mesh"));
+        nodes.push_back(node);
+    }
+}
+
+/// range(0): number of nodes, range(1): parallel update
+static void BM_SceneGraphUpdate(benchmark::State& state)
+{
+    SceneManager* mgr = Root::getSingleton().createSceneManager();
+    mgr->setParallelSceneGraphUpdate(state.range(1));
+    createRandomTree(mgr, state.range(0), 100);
+
+    for (auto _ : state)
+    {
+        // update all nodes, not only the changed ones
+        mgr->getRootSceneNode()->needUpdate();
+        mgr->_updateSceneGraph(NULL);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+
+    Root::getSingleton().destroySceneManager(mgr);
+}
+BENCHMARK(BM_SceneGraphUpdate)->Args({1000, 0})->Args({10000, 0})->Args({10000, 1});
+
+/// range(0): number of nodes, range(1): parallel culling
+static void BM_FindVisibleObjects(benchmark::State& state)
+{
+    SceneManager* mgr = Root::getSingleton().createSceneManager();
+    mgr->setParallelFindVisibleObjects(state.range(1));
+    createRandomTree(mgr, state.range(0), 1000);
+
+    Camera* cam = mgr->createCamera("Camera");
+    SceneNode* camNode = mgr->getRootSceneNode()->createChildSceneNode(Vector3(0, 0, 2000));
+    camNode->attachObject(cam);
+    mgr->_updateSceneGraph(cam);
+
+    VisibleObjectsBoundsInfo bounds;
+    for (auto _ : state)
+    {
+        bounds.reset();
+        mgr->_findVisibleObjects(cam, &bounds, false);
+        mgr->getRenderQueue()->clear();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+
+    Root::getSingleton().destroySceneManager(mgr);
+}
+BENCHMARK(BM_FindVisibleObjects)->Args({1000, 0})->Args({10000, 0})->Args({10000, 1});
+
+/// scatters count entities at a constant density, so the number of overlaps grows linearly
+static void createRandomEntities(SceneManager* mgr, size_t count)
+{
+    std::minstd_rand rng;
+    std::uniform_real_distribution<float> pos(-500 * std::cbrt(float(count)), 500 * std::cbrt(float(count)));
+    for (size_t n = 0; n < count; ++n)
+    {
+        SceneNode* node = mgr->getRootSceneNode()->createChildSceneNode(Vector3(pos(rng), pos(rng), pos(rng)));
+        node->attachObject(mgr->createEntity("sphere.mesh"));
+    }
+    mgr->_updateSceneGraph(NULL);
+}
+
+/// range(0): number of entities
+static void BM_RaySceneQuery(benchmark::State& state)
+{
+    SceneManager* mgr = Root::getSingleton().createSceneManager();
+    createRandomEntities(mgr, state.range(0));
+
+    std::minstd_rand rng;
+    std::uniform_real_distribution<float> dir(-1, 1);
+    RaySceneQuery* query = mgr->createRayQuery(Ray());
+    size_t hits = 0;
+    for (auto _ : state)
+    {
+        query->setRay(Ray(Vector3::ZERO, Vector3(dir(rng), dir(rng), dir(rng)).normalisedCopy()));
+        hits += query->execute().size();
+    }
+    benchmark::DoNotOptimize(hits);
+    state.SetItemsProcessed(state.iterations());
+
+    Root::getSingleton().destroySceneManager(mgr);
+}
+BENCHMARK(BM_RaySceneQuery)->Arg(1000)->Arg(10000);
+
+/// range(0): number of entities
+static void BM_IntersectionSceneQuery(benchmark::State& state)
+{
+    SceneManager* mgr = Root::getSingleton().createSceneManager();
+    createRandomEntities(mgr, state.range(0));
+
+    IntersectionSceneQuery* query = mgr->createIntersectionQuery();
+    size_t pairs = 0;
+    for (auto _ : state)
+        pairs += query->execute().movables2movables.size();
+    benchmark::DoNotOptimize(pairs);
+    state.SetItemsProcessed(state.iterations());
+
+    Root::getSingleton().destroySceneManager(mgr);
+}
+BENCHMARK(BM_IntersectionSceneQuery)->Arg(1000)->Arg(10000);
+
+/// range(0): number of entities, range(1): number of entities moved before each query
+static void BM_SceneQueryAfterUpdate(benchmark::State& state)
+{
+    SceneManager* mgr = Root::getSingleton().createSceneManager();
+    createRandomEntities(mgr, state.range(0));
+
+    std::vector<Node*> nodes(mgr->getRootSceneNode()->getChildren());
+    AxisAlignedBoxSceneQuery* query = mgr->createAABBQuery(AxisAlignedBox(Vector3(-1000), Vector3(1000)));
+    size_t found = 0, n = 0;
+    for (auto _ : state)
+    {
+        for (int64_t i = 0; i < state.range(1); ++i)
+            nodes[n++ % nodes.size()]->translate(Vector3(1, 0, 0));
+        mgr->_updateSceneGraph(NULL);
+        found += query->execute().movables.size();
+    }
+    benchmark::DoNotOptimize(found);
+    state.SetItemsProcessed(state.iterations());
+
+    Root::getSingleton().destroySceneManager(mgr);
+}
+BENCHMARK(BM_SceneQueryAfterUpdate)->Args({10000, 0})->Args({10000, 100});
+
+static std::vector<Vector3> getTriangles(const Mesh* mesh)
+{
+    std::vector<Vector3> triangles;
+    for (auto sub : mesh->getSubMeshes())
+    {
+        const VertexData* vertexData = sub->useSharedVertices ? mesh->sharedVertexData : sub->vertexData;
+        auto posElem = vertexData->vertexDeclaration->findElementBySemantic(VES_POSITION);
+        auto vbuf = vertexData->vertexBufferBinding->getBuffer(posElem->getSource());
+        const auto& ibuf = sub->indexData->indexBuffer;
+        HardwareBufferLockGuard vertexLock(vbuf, HardwareBuffer::HBL_READ_ONLY);
+        HardwareBufferLockGuard indexLock(ibuf, HardwareBuffer::HBL_READ_ONLY);
+        for (size_t i = 0; i < sub->indexData->indexCount; ++i)
+        {
+            uint32 index = ibuf->getType() == HardwareIndexBuffer::IT_32BIT ? static_cast<uint32*>(indexLock.pData)[i]
+                                                                            : static_cast<uint16*>(indexLock.pData)[i];
+            float* pos;
+            posElem->baseVertexPointerToElement(static_cast<uchar*>(vertexLock.pData) + index * vbuf->getVertexSize(),
+                                                &pos);
+            triangles.push_back(Vector3(pos[0], pos[1], pos[2]));
+        }
+    }
+    return triangles;
+}
+
+/// range(0): 0 tests all triangles, 1 uses Entity::raycast, 2 casts packets through the TriangleTree
+static void BM_EntityRaycast(benchmark::State& state)
+{
+    SceneManager* mgr = Root::getSingleton().createSceneManager();
+    Entity* entity = mgr->createEntity("Sinbad.mesh");
+    mgr->getRootSceneNode()->attachObject(entity);
+    const AxisAlignedBox& box = entity->getMesh()->getBounds();
+
+    // coherent rays towards the front of the mesh
+    std::minstd_rand rng;
+    std::uniform_real_distribution<float> offset(-0.5, 0.5);
+    std::vector<Ray> rays(64);
+    for (auto& ray : rays)
+    {
+        Vector3 origin = box.getCenter() + Vector3(offset(rng), offset(rng), 2) * box.getSize();
+        Vector3 target = box.getCenter() + Vector3(offset(rng), offset(rng), 0) * box.getSize();
+        ray = Ray(origin, (target - origin).normalisedCopy());
+    }
+
+    std::vector<Vector3> triangles = getTriangles(entity->getMesh().get());
+    std::vector<RayTestResult> results(rays.size());
+    entity->raycast(rays[0]); // build the trees
+    size_t hits = 0;
+    for (auto _ : state)
+    {
+        if (state.range(0) == 0)
+        {
+            for (const auto& ray : rays)
+            {
+                // the closest hit requires testing all triangles
+                RayTestResult closest(false, Math::POS_INFINITY);
+                for (size_t i = 0; i < triangles.size(); i += 3)
+                {
+                    RayTestResult hit = Math::intersects(ray, triangles[i], triangles[i + 1], triangles[i + 2]);
+                    if (hit.first && hit.second < closest.second)
+                        closest = hit;
+                }
+                hits += closest.first;
+            }
+        }
+        else if (state.range(0) == 1)
+        {
+            for (const auto& ray : rays)
+                hits += entity->raycast(ray).first;
+        }
+        else
+        {
+            for (auto sub : entity->getMesh()->getSubMeshes())
+            {
+                sub->_getTriangleTree().intersects(rays.data(), rays.size(), results.data());
+                for (const auto& r : results)
+                    hits += r.first;
+            }
+        }
+    }
+    benchmark::DoNotOptimize(hits);
+    state.SetItemsProcessed(state.iterations() * rays.size());
+
+    Root::getSingleton().destroySceneManager(mgr);
+}
+BENCHMARK(BM_EntityRaycast)->Arg(0)->Arg(1)->Arg(2);
+
+static std::vector<AxisAlignedBox> createRandomBoxes(size_t count)
+{
+    std::minstd_rand rng;
+    std::uniform_real_distribution<float> pos(-1000, 1000), size(1, 50);
+
+    std::vector<AxisAlignedBox> boxes;
+    for (size_t i = 0; i < count; ++i)
+    {
+        Vector3 min(pos(rng), pos(rng), pos(rng));
+        boxes.emplace_back(min, min + Vector3(size(rng), size(rng), size(rng)));
+    }
+    return boxes;
+}
+
+/// range(0): number of boxes
+static void BM_FrustumIsVisible(benchmark::State& state)
+{
+    Frustum frustum;
+    auto boxes = createRandomBoxes(state.range(0));
+
+    for (auto _ : state)
+    {
+        size_t visible = 0;
+        for (const auto& box : boxes)
+            visible += frustum.isVisible(box);
+        benchmark::DoNotOptimize(visible);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FrustumIsVisible)->Arg(10000);
+
+/// range(0): number of boxes
+static void BM_FrustumIsVisibleBatched(benchmark::State& state)
+{
+    Frustum frustum;
+    auto boxes = createRandomBoxes(state.range(0));
+
+    std::vector<float> extents[6];
+    for (const auto& box : boxes)
+    {
+        for (int c = 0; c < 3; ++c)
+        {
+            extents[c].push_back(box.getMinimum()[c]);
+            extents[c + 3].push_back(box.getMaximum()[c]);
+        }
+    }
+    const float* minimum[3] = {extents[0].data(), extents[1].data(), extents[2].data()};
+    const float* maximum[3] = {extents[3].data(), extents[4].data(), extents[5].data()};
+    std::vector<uint32> visibleMask((boxes.size() + 31) / 32);
+
+    for (auto _ : state)
+    {
+        frustum.isVisible(minimum, maximum, boxes.size(), visibleMask.data());
+        benchmark::DoNotOptimize(visibleMask.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FrustumIsVisibleBatched)->Arg(10000);
+
+//--------------------------------------------------------------------------
+// Render queue
+//--------------------------------------------------------------------------
+struct BenchmarkRenderable : public Renderable
+{
+    MaterialPtr mMaterial;
+    Vector3 mPosition;
+    VertexData* mVertexData = NULL;
+
+    const MaterialPtr& getMaterial(void) const override { return mMaterial; }
+    void getRenderOperation(RenderOperation& op) override { op.vertexData = mVertexData; }
+    void getWorldTransforms(Matrix4* xform) const override { xform->makeTrans(mPosition); }
+    Real getSquaredViewDepth(const Camera* cam) const override
+    {
+        return cam->getDerivedPosition().squaredDistance(mPosition);
+    }
+    const LightList& getLights(void) const override
+    {
+        static LightList lights;
+        return lights;
+    }
+};
+
+/// range(0): number of renderables, range(1): QueuedRenderableCollection::OrganisationMode
+static void BM_RenderQueueSort(benchmark::State& state)
+{
+    SceneManager* mgr = Root::getSingleton().createSceneManager();
+    Camera* cam = mgr->createCamera("Camera");
+
+    // 64 materials, so pass grouping has something to do
+    std::vector<MaterialPtr> materials;
+    for (int i = 0; i < 64; ++i)
+    {
+        String name = "Benchmark/RenderQueueSort/" + std::to_string(i);
+        materials.push_back(MaterialManager::getSingleton().getByName(name, RGN_DEFAULT));
+        if (!materials.back())
+            materials.back() = MaterialManager::getSingleton().create(name, RGN_DEFAULT);
+    }
+
+    // 16 meshes, so the state sort within a pass group has something to do
+    std::vector<std::unique_ptr<VertexData>> geometry;
+    for (int i = 0; i < 16; ++i)
+        geometry.emplace_back(new VertexData(NULL, NULL));
+
+    std::minstd_rand rng;
+    std::uniform_real_distribution<float> pos(-1000, 1000);
+    std::vector<BenchmarkRenderable> renderables(state.range(0));
+    for (auto& r : renderables)
+    {
+        r.mMaterial = materials[rng() % materials.size()];
+        r.mPosition = Vector3(pos(rng), pos(rng), pos(rng));
+        r.mVertexData = geometry[rng() % geometry.size()].get();
+    }
+
+    QueuedRenderableCollection collection;
+    collection.addOrganisationMode(QueuedRenderableCollection::OrganisationMode(state.range(1)));
+
+    for (auto _ : state)
+    {
+        collection.clear();
+        for (auto& r : renderables)
+            collection.addRenderable(r.mMaterial->getTechnique(0)->getPass(0), &r);
+        collection.sort(cam);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+
+    Root::getSingleton().destroySceneManager(mgr);
+}
+BENCHMARK(BM_RenderQueueSort)
+    ->Args({10000, QueuedRenderableCollection::OM_PASS_GROUP})
+    ->Args({10000, QueuedRenderableCollection::OM_SORT_DESCENDING});
+
+//--------------------------------------------------------------------------
+// OptimisedUtil kernels
+//--------------------------------------------------------------------------
+static std::vector<float> createRandomFloats(size_t count, float min, float max)
+{
+    std::minstd_rand rng;
+    std::uniform_real_distribution<float> dist(min, max);
+    std::vector<float> ret(count);
+    for (auto& f : ret)
+        f = dist(rng);
+    return ret;
+}
+
+/// range(0): number of vertices
+static void BM_SoftwareVertexSkinning(benchmark::State& state)
+{
+    const size_t numVertices = state.range(0), numWeights = 4, numMatrices = 64;
+
+    std::vector<Affine3> matrices(numMatrices);
+    std::vector<const Affine3*> blendMatrices;
+    for (auto& m : matrices)
+    {
+        m.makeTransform(Vector3(1, 2, 3), Vector3::UNIT_SCALE, Quaternion(Degree(blendMatrices.size()), Vector3::UNIT_Y));
+        blendMatrices.push_back(&m);
+    }
+
+    // interleaved positions and normals, like a typical software skinned mesh
+    auto vertices = createRandomFloats(numVertices * 6, -1, 1);
+    std::vector<float> dst(numVertices * 6);
+    auto weights = createRandomFloats(numVertices * numWeights, 0, 0.25);
+    std::vector<uchar> indices(numVertices * numWeights);
+    for (size_t i = 0; i < indices.size(); ++i)
+        indices[i] = uchar(i * 7 % numMatrices);
+
+    for (auto _ : state)
+    {
+        OptimisedUtil::getImplementation()->softwareVertexSkinning(
+            vertices.data(), dst.data(), vertices.data() + 3, dst.data() + 3, weights.data(), indices.data(),
+            blendMatrices.data(), 24, 24, 24, 24, 16, 4, numWeights, numVertices);
+        benchmark::DoNotOptimize(dst.data());
+    }
+    state.SetItemsProcessed(state.iterations() * numVertices);
+}
+BENCHMARK(BM_SoftwareVertexSkinning)->Arg(10000);
+
+/// range(0): number of vertices, range(1): morph normals
+static void BM_SoftwareVertexMorph(benchmark::State& state)
+{
+    const size_t numVertices = state.range(0);
+    const bool morphNormals = state.range(1);
+    const size_t vertexSize = morphNormals ? 24 : 12;
+
+    auto src1 = createRandomFloats(numVertices * vertexSize / 4, -1, 1);
+    auto src2 = createRandomFloats(numVertices * vertexSize / 4, -1, 1);
+    std::vector<float> dst(src1.size());
+
+    for (auto _ : state)
+    {
+        OptimisedUtil::getImplementation()->softwareVertexMorph(
+            0.3f, src1.data(), src2.data(), dst.data(), vertexSize, vertexSize, vertexSize, numVertices,
+            morphNormals);
+        benchmark::DoNotOptimize(dst.data());
+    }
+    state.SetItemsProcessed(state.iterations() * numVertices);
+}
+BENCHMARK(BM_SoftwareVertexMorph)->Args({10000, 0})->Args({10000, 1});
+
+/// range(0): number of skeleton instances, range(1): use the batched evaluation
+static void BM_SkeletonAnimation(benchmark::State& state)
+{
+    SceneManager* sceneMgr = Root::getSingleton().createSceneManager();
+    std::vector<Entity*> entities;
+    for (int i = 0; i < state.range(0); ++i)
+    {
+        Entity* ent = sceneMgr->createEntity("Sinbad.mesh");
+        AnimationState* animState = ent->getAnimationState("RunBase");
+        animState->setEnabled(true);
+        animState->setTimePosition(Math::UnitRandom() * animState->getLength());
+        entities.push_back(ent);
+    }
+
+    size_t numBones = entities[0]->getSkeleton()->getNumBones();
+    for (auto _ : state)
+    {
+        for (auto ent : entities)
+        {
+            AnimationState* animState = ent->getAnimationState("RunBase");
+            animState->addTime(1 / 60.0f);
+
+            SkeletonInstance* skeleton = ent->getSkeleton();
+            if (state.range(1))
+            {
+                skeleton->setAnimationState(*ent->getAllAnimationStates());
+                continue;
+            }
+
+            // the tracks one by one, as done before the batched evaluation
+            skeleton->reset();
+            Animation* anim = skeleton->getAnimation("RunBase");
+            TimeIndex timeIndex = anim->_getTimeIndex(animState->getTimePosition());
+            for (const auto& t : anim->_getNodeTrackList())
+                t.second->applyToNode(skeleton->getBone(t.first), timeIndex, animState->getWeight());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * numBones);
+
+    Root::getSingleton().destroySceneManager(sceneMgr);
+}
+BENCHMARK(BM_SkeletonAnimation)->Args({100, 0})->Args({100, 1});
+
+/// range(0): number of bones, range(1): use the SoA batch
+static void BM_BoneOffsetTransforms(benchmark::State& state)
+{
+    SkeletonPtr skeleton = SkeletonManager::getSingleton().create("Benchmark/BoneOffsetTransforms", RGN_DEFAULT);
+    for (int i = 0; i < state.range(0); ++i)
+    {
+        Bone* bone = skeleton->createBone(i);
+        bone->setPosition(Math::RangeRandom(-1, 1), Math::RangeRandom(-1, 1), Math::RangeRandom(-1, 1));
+        bone->setOrientation(Quaternion(Radian(Math::RangeRandom(-3, 3)), Vector3::UNIT_Y));
+    }
+    skeleton->setBindingPose();
+    for (auto bone : skeleton->getBones())
+        bone->roll(Degree(30));
+    skeleton->_updateTransforms();
+
+    const Skeleton::BoneList& bones = skeleton->getBones();
+    std::vector<Affine3> matrices(bones.size());
+    for (auto _ : state)
+    {
+        if (state.range(1))
+        {
+            Bone::_getOffsetTransforms(bones.data(), bones.size(), matrices.data());
+        }
+        else
+        {
+            for (size_t i = 0; i < bones.size(); ++i)
+                bones[i]->_getOffsetTransform(matrices[i]);
+        }
+        benchmark::DoNotOptimize(matrices.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+
+    SkeletonManager::getSingleton().remove(skeleton);
+}
+BENCHMARK(BM_BoneOffsetTransforms)->Args({256, 0})->Args({256, 1});
+
+/// range(0): number of matrices
+static void BM_ConcatenateAffineMatrices(benchmark::State& state)
+{
+    std::vector<Affine3> src(state.range(0), Affine3::IDENTITY), dst(state.range(0));
+    Affine3 base;
+    base.makeTransform(Vector3(1, 2, 3), Vector3(2), Quaternion(Degree(30), Vector3::UNIT_X));
+
+    for (auto _ : state)
+    {
+        OptimisedUtil::getImplementation()->concatenateAffineMatrices(base, src.data(), dst.data(), src.size());
+        benchmark::DoNotOptimize(dst.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ConcatenateAffineMatrices)->Arg(256);
+
+/// range(0): number of triangles
+static void BM_CalculateFaceNormals(benchmark::State& state)
+{
+    const size_t numTriangles = state.range(0), numVertices = numTriangles / 2;
+    auto positions = createRandomFloats(numVertices * 3, -10, 10);
+
+    std::minstd_rand rng;
+    std::vector<EdgeData::Triangle> triangles(numTriangles);
+    for (auto& t : triangles)
+    {
+        for (auto& i : t.vertIndex)
+            i = rng() % numVertices;
+    }
+    std::vector<Vector4> faceNormals(numTriangles);
+
+    for (auto _ : state)
+    {
+        OptimisedUtil::getImplementation()->calculateFaceNormals(positions.data(), triangles.data(),
+                                                                 faceNormals.data(), numTriangles);
+        benchmark::DoNotOptimize(faceNormals.data());
+    }
+    state.SetItemsProcessed(state.iterations() * numTriangles);
+}
+BENCHMARK(BM_CalculateFaceNormals)->Arg(10000);
+
+/// range(0): number of faces
+static void BM_CalculateLightFacing(benchmark::State& state)
+{
+    auto values = createRandomFloats(state.range(0) * 4, -1, 1);
+    std::vector<Vector4> faceNormals(state.range(0));
+    for (size_t i = 0; i < faceNormals.size(); ++i)
+        faceNormals[i] = Vector4(&values[i * 4]);
+    std::vector<char> lightFacings(state.range(0));
+
+    for (auto _ : state)
+    {
+        OptimisedUtil::getImplementation()->calculateLightFacing(Vector4(1, 2, 3, 1), faceNormals.data(),
+                                                                 lightFacings.data(), faceNormals.size());
+        benchmark::DoNotOptimize(lightFacings.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CalculateLightFacing)->Arg(10000);
+
+/// range(0): number of vertices, range(1): point light
+static void BM_ExtrudeVertices(benchmark::State& state)
+{
+    auto src = createRandomFloats(state.range(0) * 3, -10, 10);
+    std::vector<float> dst(src.size());
+    Vector4 lightPos(20, 30, 40, state.range(1) ? 1 : 0);
+
+    for (auto _ : state)
+    {
+        OptimisedUtil::getImplementation()->extrudeVertices(lightPos, 100, src.data(), dst.data(), state.range(0));
+        benchmark::DoNotOptimize(dst.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ExtrudeVertices)->Args({10000, 0})->Args({10000, 1});
+
+//--------------------------------------------------------------------------
+// GpuProgramParameters
+//--------------------------------------------------------------------------
+static void BM_UpdateAutoParams(benchmark::State& state)
+{
+    typedef GpuProgramParameters GPP;
+    const std::pair<const char*, GPP::AutoConstantType> autoConstants[] = {
+        {"worldMatrix", GPP::ACT_WORLD_MATRIX},
+        {"worldViewProj", GPP::ACT_WORLDVIEWPROJ_MATRIX},
+        {"inverseTransposeWorld", GPP::ACT_INVERSE_TRANSPOSE_WORLD_MATRIX},
+        {"viewMatrix", GPP::ACT_VIEW_MATRIX},
+        {"cameraPosition", GPP::ACT_CAMERA_POSITION_OBJECT_SPACE},
+        {"lightPosition", GPP::ACT_LIGHT_POSITION_OBJECT_SPACE},
+        {"lightDiffuse", GPP::ACT_LIGHT_DIFFUSE_COLOUR},
+        {"ambient", GPP::ACT_AMBIENT_LIGHT_COLOUR},
+        {"fogParams", GPP::ACT_FOG_PARAMS},
+    };
+
+    auto constants = std::make_shared<GpuNamedConstants>();
+    for (const auto& ac : autoConstants)
+    {
+        const GPP::AutoConstantDefinition* acDef = GPP::getAutoConstantDefinition(ac.second);
+        GpuConstantDefinition def;
+        def.constType = acDef->elementCount == 16 ? GCT_MATRIX_4X4 : GCT_FLOAT4;
+        def.elementSize = GpuConstantDefinition::getElementSize(def.constType, false);
+        def.physicalIndex = constants->bufferSize * 4;
+        def.logicalIndex = constants->map.size();
+        def.arraySize = 1;
+        constants->bufferSize += def.elementSize;
+        constants->map[ac.first] = def;
+    }
+
+    GPP params;
+    params._setNamedConstants(constants);
+    for (const auto& ac : autoConstants)
+        params.setNamedAutoConstant(ac.first, ac.second);
+
+    SceneManager* mgr = Root::getSingleton().createSceneManager();
+    Camera* cam = mgr->createCamera("Camera");
+    mgr->getRootSceneNode()->createChildSceneNode(Vector3(0, 0, 100))->attachObject(cam);
+    Light* light = mgr->createLight();
+    mgr->getRootSceneNode()->createChildSceneNode(Vector3(100, 100, 0))->attachObject(light);
+    mgr->_updateSceneGraph(cam);
+    LightList lights;
+    lights.push_back(light);
+
+    BenchmarkRenderable rend;
+    rend.mPosition = Vector3(1, 2, 3);
+    Affine3 world = Affine3::getTrans(rend.mPosition);
+
+    AutoParamDataSource source;
+    source.setCurrentSceneManager(mgr);
+    source.setCurrentCamera(cam, false);
+    source.setCurrentLightList(&lights);
+
+    for (auto _ : state)
+    {
+        // a new object each iteration, so the per object values are recomputed
+        source.setCurrentRenderable(&rend);
+        source.setWorldMatrices(&world, 1);
+        params._updateAutoParams(&source, GPV_ALL);
+    }
+    state.SetItemsProcessed(state.iterations() * (sizeof(autoConstants) / sizeof(autoConstants[0])));
+
+    Root::getSingleton().destroySceneManager(mgr);
+}
+BENCHMARK(BM_UpdateAutoParams);
+
+static void BM_SetNamedConstant(benchmark::State& state)
+{
+    auto constants = std::make_shared<GpuNamedConstants>();
+    std::vector<String> names;
+    for (int i = 0; i < 32; i++)
+    {
+        GpuConstantDefinition def;
+        def.constType = GCT_FLOAT4;
+        def.elementSize = 4;
+        def.physicalIndex = constants->bufferSize * 4;
+        constants->bufferSize += def.elementSize;
+        names.push_back(StringUtil::format("customParameter%d", i));
+        constants->map[names.back()] = def;
+    }
+
+    GpuProgramParameters params;
+    params._setNamedConstants(constants);
+
+    std::vector<GpuConstantHandle> handles;
+    for (const auto& name : names)
+        handles.push_back(params.getNamedConstantHandle(name));
+
+    const bool useHandles = state.range(0);
+    Vector4 val(1, 2, 3, 4);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < names.size(); i++)
+        {
+            if (useHandles)
+                params.setNamedConstant(handles[i], val);
+            else
+                params.setNamedConstant(names[i], val);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * names.size());
+}
+BENCHMARK(BM_SetNamedConstant)->Arg(0)->Arg(1);
+
+//--------------------------------------------------------------------------
+// Serialization
+//--------------------------------------------------------------------------
+static void BM_MeshExport(benchmark::State& state)
+{
+    MeshPtr mesh = MeshManager::getSingleton().load("Sinbad.mesh", RGN_AUTODETECT);
+    MeshSerializer serializer;
+    auto stream = std::make_shared<MemoryDataStream>(16 << 20);
+
+    for (auto _ : state)
+    {
+        stream->seek(0);
+        serializer.exportMesh(mesh.get(), stream);
+    }
+    state.SetBytesProcessed(state.iterations() * stream->tell());
+}
+BENCHMARK(BM_MeshExport);
+
+static void BM_MeshImport(benchmark::State& state)
+{
+    MeshPtr mesh = MeshManager::getSingleton().load("Sinbad.mesh", RGN_AUTODETECT);
+    MeshSerializer serializer;
+    auto stream = std::make_shared<MemoryDataStream>(16 << 20);
+    serializer.exportMesh(mesh.get(), stream);
+    size_t size = stream->tell();
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        MeshPtr dst = MeshManager::getSingleton().createManual("Benchmark/MeshImport", RGN_DEFAULT);
+        DataStreamPtr src = std::make_shared<MemoryDataStream>(stream->getPtr(), size, false, true);
+        state.ResumeTiming();
+
+        serializer.importMesh(src, dst.get());
+
+        state.PauseTiming();
+        MeshManager::getSingleton().remove(dst);
+        state.ResumeTiming();
+    }
+    state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_MeshImport);
+
+static void BM_SkeletonExport(benchmark::State& state)
+{
+    SkeletonPtr skeleton = static_pointer_cast<Skeleton>(
+        SkeletonManager::getSingleton().load("Sinbad.skeleton", RGN_AUTODETECT));
+    SkeletonSerializer serializer;
+    auto stream = std::make_shared<MemoryDataStream>(16 << 20);
+
+    for (auto _ : state)
+    {
+        stream->seek(0);
+        serializer.exportSkeleton(skeleton.get(), stream);
+    }
+    state.SetBytesProcessed(state.iterations() * stream->tell());
+}
+BENCHMARK(BM_SkeletonExport);
+
+static void BM_SkeletonImport(benchmark::State& state)
+{
+    SkeletonPtr skeleton = static_pointer_cast<Skeleton>(
+        SkeletonManager::getSingleton().load("Sinbad.skeleton", RGN_AUTODETECT));
+    SkeletonSerializer serializer;
+    auto stream = std::make_shared<MemoryDataStream>(16 << 20);
+    serializer.exportSkeleton(skeleton.get(), stream);
+    size_t size = stream->tell();
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        SkeletonPtr dst = SkeletonManager::getSingleton().create("Benchmark/SkeletonImport", RGN_DEFAULT, true);
+        DataStreamPtr src = std::make_shared<MemoryDataStream>(stream->getPtr(), size, false, true);
+        state.ResumeTiming();
+
+        serializer.importSkeleton(src, dst.get());
+
+        state.PauseTiming();
+        SkeletonManager::getSingleton().remove(dst);
+        state.ResumeTiming();
+    }
+    state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_SkeletonImport);
+
+//--------------------------------------------------------------------------
+// Image
+//--------------------------------------------------------------------------
+/// range(0): source size, range(1): Image::Filter
+static void BM_ImageScale(benchmark::State& state)
+{
+    uint32 size = state.range(0);
+    Image src(PF_BYTE_RGBA, size, size), dst(PF_BYTE_RGBA, size * 3 / 4, size * 3 / 4);
+    for (size_t i = 0; i < src.getSize(); ++i)
+        src.getData()[i] = uchar(i * 31);
+
+    for (auto _ : state)
+    {
+        Image::scale(src.getPixelBox(), dst.getPixelBox(), Image::Filter(state.range(1)));
+        benchmark::DoNotOptimize(dst.getData());
+    }
+    state.SetBytesProcessed(state.iterations() * src.getSize());
+}
+BENCHMARK(BM_ImageScale)->Args({1024, Image::FILTER_NEAREST})->Args({1024, Image::FILTER_BILINEAR});
+
+//--------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    // headless setup, same as RootWithoutRenderSystemFixture
+    LogManager* logMgr = new LogManager();
+    logMgr->createLog("OgreBenchmark.log", true, false);
+    logMgr->setMinLogLevel(LML_WARNING);
+
+    std::unique_ptr<Root> root(new Root(""));
+    std::unique_ptr<FileSystemLayer> fsLayer(new FileSystemLayer(OGRE_VERSION_NAME));
+    std::unique_ptr<HardwareBufferManager> hbm(new DefaultHardwareBufferManager);
+    MaterialManager::getSingleton().initialise();
+
+    ConfigFile cf;
+    cf.load(fsLayer->getConfigFilePath("resources.cfg"));
+    for (const auto& e : cf.getSettingsBySection())
+    {
+        for (const auto& s : e.second)
+            ResourceGroupManager::getSingleton().addResourceLocation(s.second, s.first, e.first);
+    }
+
+    root->getWorkQueue()->startup();
+    int ret = benchmark::RunBenchmarks(argc, argv);
+    root->getWorkQueue()->shutdown();
+
+    root.reset();
+    hbm.reset();
+    fsLayer.reset();
+    delete logMgr;
+    return ret;
+}